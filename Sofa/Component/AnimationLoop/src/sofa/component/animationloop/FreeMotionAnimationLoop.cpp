@@ -85,6 +85,18 @@ FreeMotionAnimationLoop::FreeMotionAnimationLoop() :
 FreeMotionAnimationLoop::~FreeMotionAnimationLoop()
 = default;
 
+void FreeMotionAnimationLoop::reset()
+{
+    m_asyncEngineUpdater.wait();
+    Inherit1::reset();
+}
+
+void FreeMotionAnimationLoop::cleanup()
+{
+    m_asyncEngineUpdater.wait();
+    Inherit1::cleanup();
+}
+
 void FreeMotionAnimationLoop::init()
 {
     Inherit::init();
@@ -155,6 +167,12 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
 
     dmsg_info() << "################### step begin ###################";
 
+    // the asynchronous updates launched at the end of the previous step read the data modified by this step
+    {
+        SCOPED_TIMER("WaitAsyncEngineUpdates");
+        m_asyncEngineUpdater.wait();
+    }
+
     if (dt == 0)
         dt = node->getDt();
     
@@ -316,6 +334,12 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
         node->execute<UpdateBoundingBoxVisitor>(params);
     }
 
+    // the positions of the time step are final: the dirty asynchronous engines can be updated until the next step
+    {
+        SCOPED_TIMER("LaunchAsyncEngineUpdates");
+        m_asyncEngineUpdater.launch(node);
+    }
+
 #ifdef SOFA_DUMP_VISITOR_INFO
     simulation::Visitor::printCloseNode("Step");
 #endif
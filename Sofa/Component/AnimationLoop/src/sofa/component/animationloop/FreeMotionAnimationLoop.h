@@ -23,6 +23,7 @@
 #include <sofa/component/animationloop/config.h>
 
 #include <sofa/simulation/CollisionAnimationLoop.h>
+#include <sofa/simulation/AsyncDataEngineUpdater.h>
 #include <sofa/core/MultiVecId.h>
 #include <sofa/core/objectmodel/RenamedData.h>
 
@@ -42,6 +43,8 @@ public:
 public:
     void step (const sofa::core::ExecParams* params, SReal dt) override;
     void init() override;
+    void reset() override;
+    void cleanup() override;
 
 
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_ANIMATIONLOOP()
@@ -59,6 +62,9 @@ protected:
     ///< The ConstraintSolver used in this animation loop (required)
     SingleLink<FreeMotionAnimationLoop, sofa::core::behavior::ConstraintSolver, BaseLink::FLAG_STOREPATH|BaseLink::FLAG_STRONGLINK> l_constraintSolver;
 
+    /// Updates the engines with asyncUpdate between the end of a time step and the beginning of the next one
+    sofa::simulation::AsyncDataEngineUpdater m_asyncEngineUpdater;
+
     void computeFreeMotionAndCollisionDetection(const sofa::core::ExecParams* params, const core::ConstraintParams& cparams, SReal dt,
                                          sofa::core::MultiVecId pos,
                                          sofa::core::MultiVecId freePos,
@@ -0,0 +1,354 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/animationloop/MultiRateAnimationLoop.h>
+
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/core/BaseMapping.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/AnimateBeginEvent.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/IntegrateBeginEvent.h>
+#include <sofa/simulation/IntegrateEndEvent.h>
+#include <sofa/simulation/UpdateMappingEndEvent.h>
+#include <sofa/simulation/UpdateBoundingBoxVisitor.h>
+#include <sofa/simulation/PropagateEventVisitor.h>
+#include <sofa/simulation/BehaviorUpdatePositionVisitor.h>
+#include <sofa/simulation/UpdateInternalDataVisitor.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
+#include <sofa/simulation/UpdateMappingVisitor.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalResetConstraintVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalResetConstraintVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalIntegrationVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalIntegrationVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor;
+
+#include <set>
+
+using namespace sofa::simulation;
+
+namespace sofa::component::animationloop
+{
+
+void registerMultiRateAnimationLoop(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("Multirate animation loop: the tagged ODE solvers are integrated with several sub-steps per time step.")
+        .add< MultiRateAnimationLoop >());
+}
+
+namespace
+{
+
+/// Integrate only the ODE solvers of either the slow or the fast subsystems
+class SubsystemIntegrationVisitor : public MechanicalIntegrationVisitor
+{
+public:
+    SubsystemIntegrationVisitor(const sofa::core::ExecParams* params, SReal dt, const MultiRateAnimationLoop* loop, bool fast)
+        : MechanicalIntegrationVisitor(params, dt), m_loop(loop), m_fast(fast)
+    {}
+
+    Result fwdOdeSolver(simulation::Node* node, sofa::core::behavior::OdeSolver* obj) override
+    {
+        if (m_loop->isFast(obj) != m_fast)
+        {
+            return RESULT_PRUNE;
+        }
+        return MechanicalIntegrationVisitor::fwdOdeSolver(node, obj);
+    }
+
+    Result fwdInteractionForceField(simulation::Node* node, sofa::core::behavior::BaseInteractionForceField* obj) override
+    {
+        // the interaction force fields outside of the solvers are accumulated once per time step
+        if (m_fast)
+        {
+            return RESULT_CONTINUE;
+        }
+        return MechanicalIntegrationVisitor::fwdInteractionForceField(node, obj);
+    }
+
+    const char* getClassName() const override { return "SubsystemIntegrationVisitor"; }
+
+private:
+    const MultiRateAnimationLoop* m_loop { nullptr };
+    bool m_fast { false };
+};
+
+}
+
+MultiRateAnimationLoop::MultiRateAnimationLoop()
+    : d_fastTags(initData(&d_fastTags, "fastTags", "Tags of the ODE solvers integrated with sub-steps"))
+    , d_nbSubSteps(initData(&d_nbSubSteps, 1u, "nbSubSteps", "Number of sub-steps of the fast ODE solvers in a time step"))
+    , d_interpolateCoupling(initData(&d_interpolateCoupling, true, "interpolateCoupling",
+        "If true, the states of the slow subsystems are interpolated during the sub-steps of the fast subsystems. "
+        "Otherwise, their state at the end of the time step is used"))
+{
+}
+
+MultiRateAnimationLoop::~MultiRateAnimationLoop()
+{
+}
+
+void MultiRateAnimationLoop::init()
+{
+    Inherit::init();
+
+    if (d_fastTags.getValue().empty())
+    {
+        msg_warning() << "No fast tags defined: all the ODE solvers are integrated once per time step.";
+    }
+    if (d_nbSubSteps.getValue() == 0)
+    {
+        msg_warning() << "The number of sub-steps must be positive. Set to 1.";
+        d_nbSubSteps.setValue(1);
+    }
+}
+
+bool MultiRateAnimationLoop::isFast(const sofa::core::behavior::OdeSolver* solver) const
+{
+    const auto& solverTags = solver->getTags();
+    for (const auto& tag : d_fastTags.getValue())
+    {
+        if (solverTags.includes(tag))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MultiRateAnimationLoop::integrateSubsystems(const sofa::core::ExecParams* params, SReal dt, bool fast)
+{
+    {
+        IntegrateBeginEvent evBegin;
+        PropagateEventVisitor eventPropagation( params, &evBegin);
+        eventPropagation.execute(getContext());
+    }
+
+    SubsystemIntegrationVisitor act( params, dt, this, fast );
+    act.setTags(this->getTags());
+    act.execute( getContext() );
+
+    {
+        IntegrateEndEvent evEnd;
+        PropagateEventVisitor eventPropagation( params, &evEnd);
+        eventPropagation.execute(getContext());
+    }
+}
+
+void MultiRateAnimationLoop::collectSlowStates()
+{
+    m_slowStates.clear();
+    m_slowNodes.clear();
+
+    std::set<sofa::core::behavior::BaseMechanicalState*> visited;
+    for (auto* solver : getContext()->getObjects<sofa::core::behavior::OdeSolver>(core::objectmodel::BaseContext::SearchDown))
+    {
+        if (isFast(solver))
+        {
+            continue;
+        }
+
+        if (auto* solverNode = dynamic_cast<simulation::Node*>(solver->getContext()))
+        {
+            m_slowNodes.push_back(solverNode);
+        }
+
+        for (auto* state : solver->getContext()->getObjects<sofa::core::behavior::BaseMechanicalState>(core::objectmodel::BaseContext::SearchDown))
+        {
+            // only the independent states are saved, the mapped states are computed from them
+            const auto* stateNode = dynamic_cast<const simulation::Node*>(state->getContext());
+            if (!stateNode || stateNode->mechanicalMapping.get() != nullptr || !visited.insert(state).second)
+            {
+                continue;
+            }
+
+            SlowState& slowState = m_slowStates.emplace_back();
+            slowState.state = state;
+            slowState.interpolatePosition = state->getCoordDimension() == state->getDerivDimension();
+        }
+    }
+}
+
+void MultiRateAnimationLoop::saveSlowStates(bool start)
+{
+    for (auto& slowState : m_slowStates)
+    {
+        auto* state = slowState.state;
+        auto& position = start ? slowState.startPosition : slowState.endPosition;
+        auto& velocity = start ? slowState.startVelocity : slowState.endVelocity;
+
+        position.resize(state->getSize() * state->getCoordDimension());
+        velocity.resize(state->getSize() * state->getDerivDimension());
+
+        unsigned int offset = 0;
+        state->copyToBaseVector(&position, core::VecCoordId::position(), offset);
+        offset = 0;
+        state->copyToBaseVector(&velocity, core::VecDerivId::velocity(), offset);
+    }
+}
+
+void MultiRateAnimationLoop::interpolateSlowStates(const sofa::core::ExecParams* params, SReal alpha)
+{
+    linearalgebra::FullVector<SReal> interpolated;
+
+    const auto interpolate = [&interpolated, alpha](const linearalgebra::FullVector<SReal>& start, const linearalgebra::FullVector<SReal>& end)
+    {
+        interpolated.resize(end.size());
+        for (linearalgebra::FullVector<SReal>::Index i = 0; i < end.size(); ++i)
+        {
+            interpolated[i] = (1 - alpha) * start[i] + alpha * end[i];
+        }
+    };
+
+    for (auto& slowState : m_slowStates)
+    {
+        // the topology may have changed during the time step
+        if (slowState.startVelocity.size() != slowState.endVelocity.size())
+        {
+            continue;
+        }
+
+        unsigned int offset = 0;
+        if (slowState.interpolatePosition)
+        {
+            interpolate(slowState.startPosition, slowState.endPosition);
+            slowState.state->copyFromBaseVector(core::VecCoordId::position(), &interpolated, offset);
+        }
+
+        offset = 0;
+        interpolate(slowState.startVelocity, slowState.endVelocity);
+        slowState.state->copyFromBaseVector(core::VecDerivId::velocity(), &interpolated, offset);
+    }
+
+    sofa::core::MechanicalParams mparams(*params);
+    for (auto* node : m_slowNodes)
+    {
+        MechanicalPropagateOnlyPositionAndVelocityVisitor(&mparams).execute(node);
+    }
+}
+
+void MultiRateAnimationLoop::step(const sofa::core::ExecParams* params, SReal dt)
+{
+    auto node = dynamic_cast<sofa::simulation::Node*>(this->l_node.get());
+
+    if (dt == 0)
+        dt = node->getDt();
+
+    SCOPED_TIMER_VARNAME(animationStepTimer, "AnimationStep");
+
+#ifdef SOFA_DUMP_VISITOR_INFO
+    simulation::Visitor::printNode("Step");
+#endif
+
+    {
+        AnimateBeginEvent ev ( dt );
+        PropagateEventVisitor act ( params, &ev );
+        node->execute ( act );
+    }
+
+    const SReal startTime = node->getTime();
+
+    BehaviorUpdatePositionVisitor beh(params , dt);
+    node->execute ( beh );
+
+    UpdateInternalDataVisitor uid(params);
+    node->execute ( uid );
+
+    sofa::core::ConstraintParams cparams(*params);
+
+    MechanicalResetConstraintVisitor(&cparams).execute(node);
+    computeCollision(params);
+
+    const unsigned int nbSubSteps = std::max(d_nbSubSteps.getValue(), 1u);
+    const bool interpolateCoupling = d_interpolateCoupling.getValue() && nbSubSteps > 1;
+
+    if (interpolateCoupling)
+    {
+        collectSlowStates();
+        saveSlowStates(true);
+    }
+
+    {
+        SCOPED_TIMER("SlowIntegration");
+        integrateSubsystems(params, dt, false);
+    }
+
+    if (interpolateCoupling)
+    {
+        saveSlowStates(false);
+    }
+
+    {
+        SCOPED_TIMER("FastIntegration");
+        const SReal subStepDt = dt / nbSubSteps;
+        for (unsigned int i = 0; i < nbSubSteps; ++i)
+        {
+            node->setTime ( startTime + i * subStepDt );
+            node->execute<UpdateSimulationContextVisitor>(params);  // propagate time
+
+            if (interpolateCoupling)
+            {
+                // state of the slow subsystems at the end of the sub-step
+                interpolateSlowStates(params, static_cast<SReal>(i + 1) / nbSubSteps);
+            }
+
+            integrateSubsystems(params, subStepDt, true);
+        }
+    }
+
+    node->setTime ( startTime + dt );
+    node->execute<UpdateSimulationContextVisitor>(params);  // propagate time
+
+    {
+        AnimateEndEvent ev ( dt );
+        PropagateEventVisitor act ( params, &ev );
+        node->execute ( act );
+    }
+
+    //Visual Information update: Ray Pick add a MechanicalMapping used as VisualMapping
+    {
+        SCOPED_TIMER_VARNAME(updateMappingTimer, "UpdateMapping");
+        node->execute<UpdateMappingVisitor>(params);
+    }
+    {
+        UpdateMappingEndEvent ev ( dt );
+        PropagateEventVisitor act ( params , &ev );
+        node->execute ( act );
+    }
+
+    if (d_computeBoundingBox.getValue())
+    {
+        SCOPED_TIMER("UpdateBBox");
+        node->execute<UpdateBoundingBoxVisitor>(params);
+    }
+
+#ifdef SOFA_DUMP_VISITOR_INFO
+    simulation::Visitor::printCloseNode("Step");
+#endif
+}
+
+} // namespace sofa::component::animationloop
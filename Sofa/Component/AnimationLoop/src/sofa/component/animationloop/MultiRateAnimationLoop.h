@@ -0,0 +1,97 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/animationloop/config.h>
+
+#include <sofa/core/behavior/BaseAnimationLoop.h>
+#include <sofa/simulation/CollisionAnimationLoop.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/linearalgebra/FullVector.h>
+
+namespace sofa::core::behavior
+{
+class OdeSolver;
+}
+
+namespace sofa::component::animationloop
+{
+
+/** Multirate animation loop: the ODE solvers tagged with one of the fastTags (e.g. stiff cables or tendons)
+ * are integrated with nbSubSteps sub-steps per time step, while the other ODE solvers (e.g. soft tissues)
+ * are integrated once with the full time step.
+ *
+ * The slow subsystems are integrated first. During the sub-steps of the fast subsystems, the states of the
+ * slow subsystems are linearly interpolated between the beginning and the end of the time step, so that the
+ * coupling forces seen by the fast subsystems evolve across the time step instead of jumping at its end.
+ * The positions of states whose coordinates are not vectors (e.g. rigids) are not interpolated.
+ *
+ * The fast solvers must not be in a subtree of a slow solver.
+ */
+class SOFA_COMPONENT_ANIMATIONLOOP_API MultiRateAnimationLoop : public sofa::simulation::CollisionAnimationLoop
+{
+public:
+    typedef sofa::simulation::CollisionAnimationLoop Inherit;
+    SOFA_CLASS(MultiRateAnimationLoop, sofa::simulation::CollisionAnimationLoop);
+protected:
+    MultiRateAnimationLoop();
+
+    ~MultiRateAnimationLoop() override;
+public:
+    void init() override;
+
+    void step (const sofa::core::ExecParams* params, SReal dt) override;
+
+    /// Return true if the solver belongs to a fast subsystem
+    bool isFast(const sofa::core::behavior::OdeSolver* solver) const;
+
+    Data<sofa::core::objectmodel::TagSet> d_fastTags; ///< Tags of the ODE solvers integrated with sub-steps
+    Data<unsigned int> d_nbSubSteps; ///< Number of sub-steps of the fast ODE solvers in a time step
+    Data<bool> d_interpolateCoupling; ///< If true, the states of the slow subsystems are interpolated during the sub-steps of the fast subsystems. Otherwise, their state at the end of the time step is used
+
+protected:
+
+    /// Integrate either the slow or the fast subsystems
+    void integrateSubsystems(const sofa::core::ExecParams* params, SReal dt, bool fast);
+
+    /// Independent state of a slow subsystem, saved at the beginning and at the end of the time step
+    struct SlowState
+    {
+        sofa::core::behavior::BaseMechanicalState* state { nullptr };
+        bool interpolatePosition { false };
+        linearalgebra::FullVector<SReal> startPosition, endPosition, startVelocity, endVelocity;
+    };
+
+    /// Gather the independent states of the slow subsystems
+    void collectSlowStates();
+
+    /// Save the states of the slow subsystems at the beginning (start=true) or at the end of the time step
+    void saveSlowStates(bool start);
+
+    /// Set the states of the slow subsystems to (1-alpha) * start + alpha * end
+    void interpolateSlowStates(const sofa::core::ExecParams* params, SReal alpha);
+
+    std::vector<SlowState> m_slowStates;
+    std::vector<sofa::simulation::Node*> m_slowNodes;
+};
+
+} // namespace sofa::component::animationloop
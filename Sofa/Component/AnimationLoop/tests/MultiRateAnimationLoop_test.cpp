@@ -0,0 +1,222 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/animationloop/MultiRateAnimationLoop.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <sofa/testing/BaseTest.h>
+
+namespace sofa
+{
+
+using namespace sofa::defaulttype;
+using sofa::component::animationloop::MultiRateAnimationLoop;
+using sofa::component::statecontainer::MechanicalObject;
+using sofa::core::objectmodel::New;
+
+namespace
+{
+
+/// ODE solver moving the first point of its state with a constant acceleration. At each call, it records the time
+/// step, the time and the state of another subsystem.
+class RecordingSolver : public sofa::core::behavior::OdeSolver
+{
+public:
+    SOFA_CLASS(RecordingSolver, sofa::core::behavior::OdeSolver);
+
+    void solve(const core::ExecParams*, SReal dt, core::MultiVecCoordId, core::MultiVecDerivId) override
+    {
+        dts.push_back(dt);
+        times.push_back(getContext()->getTime());
+
+        if (observed)
+        {
+            observedPositions.push_back(observed->readPositions()[0]);
+            observedVelocities.push_back(observed->readVelocities()[0]);
+        }
+
+        if (state)
+        {
+            auto x = state->writePositions();
+            auto v = state->writeVelocities();
+            x[0] += v[0] * dt + acceleration * (dt * dt / 2);
+            v[0] += acceleration * dt;
+        }
+    }
+
+    MechanicalObject<Vec3Types>* state { nullptr };
+    type::Vec3 acceleration;
+
+    MechanicalObject<Vec3Types>* observed { nullptr };
+    std::vector<SReal> dts, times;
+    std::vector<type::Vec3> observedPositions, observedVelocities;
+};
+
+}
+
+/// A slow subsystem integrated once per time step, observed by a fast subsystem integrated with sub-steps
+struct MultiRateAnimationLoop_test : public sofa::testing::BaseTest
+{
+    simulation::Node::SPtr root;
+    MultiRateAnimationLoop::SPtr loop;
+    RecordingSolver::SPtr slowSolver, fastSolver;
+    MechanicalObject<Vec3Types>::SPtr slowState, fastState;
+
+    const type::Vec3 slowStartPosition { 1, 2, 3 };
+    const type::Vec3 slowStartVelocity { -1, 0.5, 2 };
+    const type::Vec3 slowAcceleration { 0, -10, 4 };
+
+    void createScene(unsigned int nbSubSteps, bool interpolateCoupling)
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+
+        loop = New<MultiRateAnimationLoop>();
+        loop->d_fastTags.setValue(core::objectmodel::TagSet(core::objectmodel::Tag("fast")));
+        loop->d_nbSubSteps.setValue(nbSubSteps);
+        loop->d_interpolateCoupling.setValue(interpolateCoupling);
+        root->addObject(loop);
+
+        const simulation::Node::SPtr slow = root->createChild("Slow");
+        slowSolver = New<RecordingSolver>();
+        slow->addObject(slowSolver);
+        slowState = New<MechanicalObject<Vec3Types> >();
+        slowState->resize(1);
+        slowState->writePositions()[0] = slowStartPosition;
+        slowState->writeVelocities()[0] = slowStartVelocity;
+        slow->addObject(slowState);
+        slowSolver->state = slowState.get();
+        slowSolver->acceleration = slowAcceleration;
+
+        const simulation::Node::SPtr fast = root->createChild("Fast");
+        fastSolver = New<RecordingSolver>();
+        fastSolver->addTag(core::objectmodel::Tag("fast"));
+        fastSolver->observed = slowState.get();
+        fast->addObject(fastSolver);
+        fastState = New<MechanicalObject<Vec3Types> >();
+        fastState->resize(1);
+        fast->addObject(fastState);
+        fastSolver->state = fastState.get();
+
+        sofa::simulation::node::initRoot(root.get());
+    }
+};
+
+TEST_F(MultiRateAnimationLoop_test, nbSubStepsPerTimeStep)
+{
+    createScene(5, true);
+
+    for (unsigned int i = 1; i <= 3; ++i)
+    {
+        sofa::simulation::node::animate(root.get(), 0.01);
+        EXPECT_EQ(slowSolver->dts.size(), i);
+        EXPECT_EQ(fastSolver->dts.size(), 5 * i);
+    }
+}
+
+TEST_F(MultiRateAnimationLoop_test, timeStepPropagation)
+{
+    constexpr unsigned int nbSubSteps = 4;
+    constexpr SReal dt = 0.02;
+    createScene(nbSubSteps, true);
+
+    constexpr unsigned int nbTimeSteps = 3;
+    for (unsigned int i = 0; i < nbTimeSteps; ++i)
+    {
+        sofa::simulation::node::animate(root.get(), dt);
+    }
+
+    ASSERT_EQ(slowSolver->dts.size(), nbTimeSteps);
+    ASSERT_EQ(fastSolver->dts.size(), nbTimeSteps * nbSubSteps);
+    for (unsigned int i = 0; i < nbTimeSteps; ++i)
+    {
+        EXPECT_DOUBLE_EQ(slowSolver->dts[i], dt);
+        EXPECT_NEAR(slowSolver->times[i], i * dt, 1e-12);
+
+        for (unsigned int j = 0; j < nbSubSteps; ++j)
+        {
+            const unsigned int subStep = i * nbSubSteps + j;
+            EXPECT_DOUBLE_EQ(fastSolver->dts[subStep], dt / nbSubSteps);
+            EXPECT_NEAR(fastSolver->times[subStep], i * dt + j * dt / nbSubSteps, 1e-12);
+        }
+    }
+    EXPECT_NEAR(root->getTime(), nbTimeSteps * dt, 1e-12);
+}
+
+TEST_F(MultiRateAnimationLoop_test, couplingInterpolation)
+{
+    constexpr unsigned int nbSubSteps = 4;
+    constexpr SReal dt = 0.1;
+    createScene(nbSubSteps, true);
+
+    sofa::simulation::node::animate(root.get(), dt);
+
+    const type::Vec3 slowEndPosition = slowStartPosition + slowStartVelocity * dt + slowAcceleration * (dt * dt / 2);
+    const type::Vec3 slowEndVelocity = slowStartVelocity + slowAcceleration * dt;
+
+    // during the sub-step j, the fast subsystem sees the linear blend of the slow states at its end
+    ASSERT_EQ(fastSolver->observedPositions.size(), nbSubSteps);
+    for (unsigned int j = 0; j < nbSubSteps; ++j)
+    {
+        const SReal alpha = static_cast<SReal>(j + 1) / nbSubSteps;
+        const type::Vec3 expectedPosition = slowStartPosition * (1 - alpha) + slowEndPosition * alpha;
+        const type::Vec3 expectedVelocity = slowStartVelocity * (1 - alpha) + slowEndVelocity * alpha;
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(fastSolver->observedPositions[j][c], expectedPosition[c], 1e-12) << "sub-step " << j;
+            EXPECT_NEAR(fastSolver->observedVelocities[j][c], expectedVelocity[c], 1e-12) << "sub-step " << j;
+        }
+    }
+
+    // the slow subsystem ends the time step in its integrated state
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+        EXPECT_NEAR(slowState->readPositions()[0][c], slowEndPosition[c], 1e-12);
+        EXPECT_NEAR(slowState->readVelocities()[0][c], slowEndVelocity[c], 1e-12);
+    }
+}
+
+TEST_F(MultiRateAnimationLoop_test, noCouplingInterpolation)
+{
+    constexpr unsigned int nbSubSteps = 4;
+    constexpr SReal dt = 0.1;
+    createScene(nbSubSteps, false);
+
+    sofa::simulation::node::animate(root.get(), dt);
+
+    const type::Vec3 slowEndPosition = slowStartPosition + slowStartVelocity * dt + slowAcceleration * (dt * dt / 2);
+
+    // the fast subsystem sees the slow state at the end of the time step during all the sub-steps
+    ASSERT_EQ(fastSolver->observedPositions.size(), nbSubSteps);
+    for (unsigned int j = 0; j < nbSubSteps; ++j)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(fastSolver->observedPositions[j][c], slowEndPosition[c], 1e-12) << "sub-step " << j;
+        }
+    }
+}
+
+}
@@ -30,6 +30,7 @@
 #include <sofa/defaulttype/RigidTypes.h>
 
 #include <sofa/core/objectmodel/RenamedData.h>
+#include <sofa/component/engine/select/ROIPointGrid.h>
 
 namespace sofa::component::engine::select
 {
@@ -126,6 +127,7 @@ public:
     Data<bool> d_drawHexahedra; ///< Draw Tetrahedra. (default = false)
     Data<float> d_drawSize; ///< rendering size for ROI and topological elements
     Data<bool> d_doUpdate; ///< If true, updates the selection at the beginning of simulation steps. (default = true)
+    Data<bool> d_parallelUpdate; ///< If true, the points and the elements are classified in parallel. (default = false)
 
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_ENGINE_SELECT()
     sofa::core::objectmodel::RenamedData<VecCoord> d_X0;
@@ -144,6 +146,10 @@ protected:
     // main function to implement from this interface
     virtual bool isPointInROI(const CPos& p) const = 0;
 
+    /// Axis-aligned box containing the whole ROI: the points outside of it are classified as outside
+    /// of the ROI without calling isPointInROI. Returns false if the ROI cannot be bounded (default).
+    virtual bool roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const;
+
     // special cases can be implemented by overriding those functions
     virtual bool isEdgeInROI(const Edge& e) const;
     virtual bool isEdgeInStrictROI(const Edge& e) const;
@@ -155,6 +161,35 @@ protected:
     virtual bool isTetrahedronInStrictROI(const Tetra& t) const;
     virtual bool isHexahedronInROI(const Hexa& t) const;
     virtual bool isHexahedronInStrictROI(const Hexa& t) const;
+
+    /// Returns false if p is outside of the bounding box of the ROI, so that it does not need to be tested
+    bool isPointInROIBoundingBox(const CPos& p) const;
+
+    /// Sum of the counters of all the Data of the ROI but its positions and its outputs: it changes
+    /// whenever the ROI itself (boxes, spheres, topology, options...) is modified
+    std::size_t computeParametersCounter();
+
+    template <class F>
+    void forEachRange(std::size_t size, const F& f) const;
+
+    /// Classification of the points and the elements computed by the last update. When only the
+    /// positions changed since, only the points which moved and the elements using them are tested again.
+    type::vector<char> m_isPointInROI;
+    type::vector<char> m_hasPointMoved;
+    type::vector<char> m_isEdgeInROI, m_isTriangleInROI, m_isQuadInROI, m_isTetrahedronInROI, m_isHexahedronInROI;
+    VecCoord m_previousPositions;
+    std::size_t m_parametersCounter { 0 };
+    bool m_isClassificationValid { false };
+
+    /// true while the elements are classified: the strict tests can then use m_isPointInROI
+    bool m_isPointClassificationAvailable { false };
+
+    /// Spatial grid over d_positions, rebuilt when the positions change
+    ROIPointGrid<DataTypes> m_grid;
+    int m_gridCounter { -1 };
+
+    bool m_isROIBounded { false };
+    CPos m_roiMinBBox, m_roiMaxBBox;
 };
 
 } // namespace sofa::component::engine::select
@@ -24,9 +24,13 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/type/BoundingBox.h>
 #include <limits>
+#include <algorithm>
+#include <cstring>
 #include <sofa/core/topology/BaseTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
 #include <sofa/helper/accessor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::engine::select
 {
@@ -91,6 +95,7 @@ BaseROI<DataTypes>::BaseROI()
     , d_drawHexahedra( initData(&d_drawHexahedra,false,"drawHexahedra","Draw Tetrahedra.") )
     , d_drawSize(initData(&d_drawSize, 1.0f, "drawSize", "rendering size for ROI and topological elements"))
     , d_doUpdate( initData(&d_doUpdate,(bool)true,"doUpdate","If true, updates the selection at the beginning of simulation steps.") )
+    , d_parallelUpdate( initData(&d_parallelUpdate, false, "parallelUpdate", "If true, the points and the elements are classified in parallel.") )
 {
     sofa::helper::getWriteOnlyAccessor(d_indices).push_back(0);
 
@@ -271,7 +276,68 @@ bool BaseROI<DataTypes>::isPointIn(const PointID pid) const
 {
     const VecCoord& positions = d_positions.getValue();
     const CPos& p = DataTypes::getCPos(positions[pid]);
-    return isPointInROI(p);
+    return isPointInROIBoundingBox(p) && isPointInROI(p);
+}
+
+template <class DataTypes>
+bool BaseROI<DataTypes>::roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const
+{
+    SOFA_UNUSED(minBBox);
+    SOFA_UNUSED(maxBBox);
+    return false;
+}
+
+template <class DataTypes>
+bool BaseROI<DataTypes>::isPointInROIBoundingBox(const CPos& p) const
+{
+    if (!m_isROIBounded)
+        return true;
+
+    for (std::size_t d = 0; d < DataTypes::spatial_dimensions; ++d)
+    {
+        if (p[d] < m_roiMinBBox[d] || p[d] > m_roiMaxBBox[d])
+            return false;
+    }
+    return true;
+}
+
+template <class DataTypes>
+std::size_t BaseROI<DataTypes>::computeParametersCounter()
+{
+    const auto& outputs = this->getOutputs();
+    std::size_t counter = 0;
+    for (const auto* data : this->getDataFields())
+    {
+        if (data == &d_positions || data == &this->f_bbox || data == &this->d_componentState
+            || std::find(outputs.begin(), outputs.end(), data) != outputs.end())
+            continue;
+        counter += static_cast<std::size_t>(data->getCounter());
+    }
+    return counter;
+}
+
+template <class DataTypes>
+template <class F>
+void BaseROI<DataTypes>::forEachRange(std::size_t size, const F& f) const
+{
+    if (!d_parallelUpdate.getValue() || size == 0)
+    {
+        f(std::size_t(0), size);
+        return;
+    }
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size,
+        [&f](const simulation::Range<std::size_t>& range)
+        {
+            f(range.start, range.end);
+        });
 }
 
 // The update method is called when the engine is marked as dirty.
@@ -367,11 +433,87 @@ void BaseROI<DataTypes>::doUpdate()
         const ReadAccessor< Data<vector<Quad> > > quads = d_quads;
 
         const VecCoord& positions = d_positions.getValue();
+        const std::size_t nbPoints = positions.size();
+
+        // If only the positions changed since the last update, the classification of the points
+        // which did not move still holds, so as the one of the elements made of these points
+        // The bounding box of the ROI may also depend on outputs, not counted in the parameters
+        // (e.g. the box of MeshROI, computed from its mesh)
+        const std::size_t parametersCounter = computeParametersCounter();
+        CPos roiMinBBox, roiMaxBBox;
+        const bool isROIBounded = roiGetBoundingBox(roiMinBBox, roiMaxBBox);
+        const bool hasROIBBoxChanged = isROIBounded != m_isROIBounded
+            || (isROIBounded && (!std::equal(roiMinBBox.begin(), roiMinBBox.end(), m_roiMinBBox.begin())
+                                 || !std::equal(roiMaxBBox.begin(), roiMaxBBox.end(), m_roiMaxBBox.begin())));
+        const bool fullUpdate = !m_isClassificationValid
+            || parametersCounter != m_parametersCounter
+            || hasROIBBoxChanged
+            || m_isPointInROI.size() != nbPoints
+            || m_previousPositions.size() != nbPoints;
+        m_parametersCounter = parametersCounter;
+        m_isROIBounded = isROIBounded;
+        m_roiMinBBox = roiMinBBox;
+        m_roiMaxBBox = roiMaxBBox;
 
         //Points
-        for( unsigned i=0; i<positions.size(); ++i )
+        m_isPointInROI.resize(nbPoints);
+        m_hasPointMoved.resize(nbPoints);
+        if (fullUpdate)
+        {
+            std::fill(m_hasPointMoved.begin(), m_hasPointMoved.end(), 1);
+            if (m_isROIBounded)
+            {
+                // only the points in the cells of the grid overlapping the ROI can be inside
+                if (m_gridCounter != d_positions.getCounter())
+                {
+                    m_grid.build(positions);
+                    m_gridCounter = d_positions.getCounter();
+                }
+
+                sofa::type::vector<sofa::Index> candidates;
+                m_grid.forEachPointNearBox(m_roiMinBBox, m_roiMaxBBox, [&candidates](const sofa::Index i) { candidates.push_back(i); });
+
+                std::fill(m_isPointInROI.begin(), m_isPointInROI.end(), 0);
+                forEachRange(candidates.size(), [this, &candidates](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t k = begin; k < end; ++k)
+                    {
+                        m_isPointInROI[candidates[k]] = isPointIn(candidates[k]);
+                    }
+                });
+            }
+            else
+            {
+                forEachRange(nbPoints, [this](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        m_isPointInROI[i] = isPointIn(static_cast<PointID>(i));
+                    }
+                });
+            }
+        }
+        else
         {
-            if (isPointIn(i))
+            forEachRange(nbPoints, [this, &positions](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    // bitwise comparison: operator== tolerates small differences, which would miss
+                    // a point crossing the ROI boundary by a tiny displacement
+                    m_hasPointMoved[i] = std::memcmp(&positions[i], &m_previousPositions[i], sizeof(Coord)) != 0;
+                    if (m_hasPointMoved[i])
+                    {
+                        m_isPointInROI[i] = isPointIn(static_cast<PointID>(i));
+                    }
+                }
+            });
+        }
+        m_previousPositions = positions;
+
+        for( unsigned i=0; i<nbPoints; ++i )
+        {
+            if (m_isPointInROI[i])
             {
                 indices.push_back(i);
                 pointsInROI.push_back(positions[i]);
@@ -383,14 +525,28 @@ void BaseROI<DataTypes>::doUpdate()
             }
         }
 
-        auto testROI = [&](const auto& elements, const auto& predicate, const auto& strictPredicate, bool strict, 
+        auto testROI = [&](const auto& elements, auto& isElementInROI, const auto& predicate, const auto& strictPredicate, bool strict,
             auto& inIndices, auto& inROI, auto& outIndices, auto& outROI)
             {
+                // the elements made of points which did not move keep their classification
+                const bool testAll = fullUpdate || isElementInROI.size() != elements.size();
+                isElementInROI.resize(elements.size());
+                forEachRange(elements.size(), [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        const auto& e = elements[i];
+                        if (testAll || std::any_of(e.begin(), e.end(), [this](const auto eid) { return m_hasPointMoved[eid] != 0; }))
+                        {
+                            isElementInROI[i] = (strict) ? strictPredicate(e) : predicate(e);
+                        }
+                    }
+                });
+
                 for (std::size_t i = 0; i < elements.size(); i++)
                 {
                     const auto& e = elements[i];
-                    const bool isInROI = (strict) ? strictPredicate(e) : predicate(e);
-                    if (isInROI)
+                    if (isElementInROI[i])
                     {
                         inIndices.push_back(static_cast<sofa::Index>(i));
                         inROI.push_back(e);
@@ -403,10 +559,12 @@ void BaseROI<DataTypes>::doUpdate()
                 }
             };
 
+        m_isPointClassificationAvailable = true;
+
         //Edges
         if (d_computeEdges.getValue())
         {
-            testROI(edges, [this](auto&& x) {return isEdgeInROI(std::forward<decltype(x)>(x));}, 
+            testROI(edges, m_isEdgeInROI, [this](auto&& x) {return isEdgeInROI(std::forward<decltype(x)>(x));},
                            [this](auto&& x) {return isEdgeInStrictROI(std::forward<decltype(x)>(x)); }, 
                     strict, edgeIndices, edgesInROI, edgeOutIndices, edgesOutROI);
         }
@@ -414,7 +572,7 @@ void BaseROI<DataTypes>::doUpdate()
         //Triangles
         if (d_computeTriangles.getValue())
         {
-            testROI(triangles, [this](auto&& x) {return isTriangleInROI(std::forward<decltype(x)>(x)); },
+            testROI(triangles, m_isTriangleInROI, [this](auto&& x) {return isTriangleInROI(std::forward<decltype(x)>(x)); },
                 [this](auto&& x) {return isTriangleInStrictROI(std::forward<decltype(x)>(x)); },
                 strict, triangleIndices, trianglesInROI, triangleOutIndices, trianglesOutROI);
         }
@@ -422,7 +580,7 @@ void BaseROI<DataTypes>::doUpdate()
         //Quads
         if (d_computeQuads.getValue())
         {
-            testROI(quads, [this](auto&& x) {return isQuadInROI(std::forward<decltype(x)>(x)); },
+            testROI(quads, m_isQuadInROI, [this](auto&& x) {return isQuadInROI(std::forward<decltype(x)>(x)); },
                 [this](auto&& x) {return isQuadInStrictROI(std::forward<decltype(x)>(x)); },
                 strict, quadIndices, quadInROI, quadOutIndices, quadsOutROI);
 
@@ -431,7 +589,7 @@ void BaseROI<DataTypes>::doUpdate()
         //Tetrahedra
         if (d_computeTetrahedra.getValue())
         {
-            testROI(tetrahedra, [this](auto&& x) {return isTetrahedronInROI(std::forward<decltype(x)>(x)); },
+            testROI(tetrahedra, m_isTetrahedronInROI, [this](auto&& x) {return isTetrahedronInROI(std::forward<decltype(x)>(x)); },
                 [this](auto&& x) {return isTetrahedronInStrictROI(std::forward<decltype(x)>(x)); },
                 strict, tetrahedronIndices, tetrahedraInROI, tetrahedronOutIndices, tetrahedraOutROI);
         }
@@ -439,11 +597,14 @@ void BaseROI<DataTypes>::doUpdate()
         //Hexahedra
         if (d_computeHexahedra.getValue())
         {
-            testROI(hexahedra, [this](auto&& x) {return isHexahedronInROI(std::forward<decltype(x)>(x)); },
+            testROI(hexahedra, m_isHexahedronInROI, [this](auto&& x) {return isHexahedronInROI(std::forward<decltype(x)>(x)); },
                 [this](auto&& x) {return isHexahedronInStrictROI(std::forward<decltype(x)>(x)); },
                 strict, hexahedronIndices, hexahedraInROI, hexahedronOutIndices, hexahedraOutROI);
         }
 
+        m_isPointClassificationAvailable = false;
+        m_isClassificationValid = true;
+
         d_nbIndices.setValue(sofa::Size(indices.size()));
     }
 }
@@ -663,6 +824,9 @@ bool BaseROI<DataTypes>::isInROI(const Element& e) const
 {
     const VecCoord& positions = d_positions.getValue();
 
+    if (!isPointInROIBoundingBox(getCenter<DataTypes>(e, positions)))
+        return false;
+
     return isElementInROI<DataTypes, Element>(e, positions, [this](auto&& x) {
         return isPointInROI(std::forward<decltype(x)>(x));
         }) ;
@@ -672,6 +836,12 @@ template <class DataTypes>
 template <typename Element>
 bool BaseROI<DataTypes>::isInStrictROI(const Element& e) const
 {
+    if (m_isPointClassificationAvailable)
+    {
+        // the points have just been classified by doUpdate
+        return std::all_of(e.cbegin(), e.cend(), [this](const auto eid) { return m_isPointInROI[eid] != 0; });
+    }
+
     const VecCoord& positions = d_positions.getValue();
 
     return isElementInStrictROI<DataTypes, Element>(e, positions, [this](auto&& x) {
@@ -102,6 +102,7 @@ protected:
     void getPointsFromOrientedBox(const Vec10& box, type::vector<type::Vec3> &points) const;
 
     bool isPointInROI(const CPos& p) const override;
+    bool roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const override;
 };
 
 #if !defined(SOFA_COMPONENT_ENGINE_BOXROI_CPP)
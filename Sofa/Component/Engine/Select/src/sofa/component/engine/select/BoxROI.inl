@@ -220,6 +220,28 @@ bool BoxROI<DataTypes>::isPointInROI(const CPos& p) const
     return false;
 }
 
+template <class DataTypes>
+bool BoxROI<DataTypes>::roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const
+{
+    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
+
+    // the oriented boxes are not bounded here
+    if (alignedBoxes.empty() || (DataTypes::spatial_dimensions == 3 && !m_orientedBoxes.empty()))
+        return false;
+
+    for (typename type::Vec6::size_type i = 0; i < DataTypes::spatial_dimensions; ++i)
+    {
+        minBBox[i] = alignedBoxes[0][i];
+        maxBBox[i] = alignedBoxes[0][i + 3];
+        for (const auto& box : alignedBoxes)
+        {
+            minBBox[i] = std::min(minBBox[i], static_cast<Real>(box[i]));
+            maxBBox[i] = std::max(maxBBox[i], static_cast<Real>(box[i + 3]));
+        }
+    }
+    return true;
+}
+
 template <class DataTypes>
 bool BoxROI<DataTypes>::roiDoUpdate()
 {
@@ -76,6 +76,7 @@ protected:
     bool isPointInBoundingBox(const CPos& p) const;
 
     bool isPointInROI(const CPos& p) const override;
+    bool roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const override;
     bool isEdgeInROI(const Edge& e) const override;
     bool isEdgeInStrictROI(const Edge& e) const override;
     bool isTriangleInROI(const Triangle& t) const override;
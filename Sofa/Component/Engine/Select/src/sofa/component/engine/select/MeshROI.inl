@@ -249,6 +249,18 @@ bool MeshROI<DataTypes>::isPointInROI(const CPos& p) const
     return false;
 }
 
+template <class DataTypes>
+bool MeshROI<DataTypes>::roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const
+{
+    // without the mesh, all the points are in the ROI
+    if(!d_computeTemplateTriangles.getValue()) return false;
+
+    const auto& b = d_box.getValue();
+    minBBox[0] = b[0]; minBBox[1] = b[1]; minBBox[2] = b[2];
+    maxBBox[0] = b[3]; maxBBox[1] = b[4]; maxBBox[2] = b[5];
+    return true;
+}
+
 template <class DataTypes>
 bool MeshROI<DataTypes>::isPointInIndices(const unsigned int pointId, const SetIndex& indices)
 {
@@ -31,6 +31,7 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/config.h>
 #include <sofa/topology/Edge.h>
+#include <sofa/helper/kdTree.h>
 
 namespace sofa::component::engine::select
 {
@@ -55,6 +56,7 @@ public:
     typedef typename DataTypes::Coord Coord;
     typedef typename DataTypes::Deriv Deriv;
     typedef typename DataTypes::Real Real;
+    typedef typename DataTypes::CPos CPos;
 
     typedef core::objectmodel::Data<VecCoord> DataVecCoord;
     typedef core::objectmodel::Data<VecDeriv> DataVecDeriv;
@@ -66,6 +68,7 @@ public:
     SetIndex d_inputIndices2; ///< Only these indices are considered in the second model
     Data<Real> f_radius; ///< Radius to search corresponding fixed point
     Data<bool> d_useRestPosition; ///< If true will use restPosition only at init
+    Data<bool> d_parallelSearch; ///< If true, the nearest points are searched in parallel
 
     /// Output Data
     ///@{
@@ -87,6 +90,17 @@ public:
 
 protected:
     void computeNearestPointMaps(const VecCoord& x1, const VecCoord& x2);
+
+    /// Rebuild the k-d tree over the points of the first model, only if they changed since the last build
+    void updateKdTree(const DataVecCoord& x1Data, const SetIndexArray& filterIndices1);
+
+    /// The k-d tree is used when the distance between two Coord is the euclidean distance (not for rigids)
+    static constexpr bool useKdTree = std::is_same_v<Coord, CPos>;
+
+    helper::kdTree<CPos> m_kdTree;
+    const DataVecCoord* m_kdTreePositions { nullptr };
+    int m_kdTreePositionsCounter { -1 };
+    SetIndexArray m_kdTreeIndices;
 };
 
 
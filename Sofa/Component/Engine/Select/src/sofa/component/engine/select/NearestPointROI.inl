@@ -22,6 +22,9 @@
 #pragma once
 #include <sofa/component/engine/select/NearestPointROI.h>
 #include <sofa/core/visual/VisualParams.h>
+#include <sofa/helper/kdTree.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::engine::select
 {
@@ -34,6 +37,7 @@ NearestPointROI<DataTypes>::NearestPointROI(core::behavior::MechanicalState<Data
     , d_inputIndices2( initData(&d_inputIndices2,"inputIndices2","Indices of the points to consider on the first model") )
     , f_radius( initData(&f_radius,(Real)1,"radius", "Radius to search corresponding fixed point") )
     , d_useRestPosition(initData(&d_useRestPosition, true, "useRestPosition", "If true will use restPosition only at init"))
+    , d_parallelSearch(initData(&d_parallelSearch, false, "parallelSearch", "If true, the nearest points are searched in parallel"))
     , f_indices1( initData(&f_indices1,"indices1","Indices from the first model associated to a dof from the second model") )
     , f_indices2( initData(&f_indices2,"indices2","Indices from the second model associated to a dof from the first model") )
     , d_edges(initData(&d_edges, "edges", "List of edge indices"))
@@ -105,25 +109,56 @@ void NearestPointROI<DataTypes>::doUpdate()
     if (this->mstate1 && this->mstate2)
     {
         const auto vecCoordId = d_useRestPosition.getValue() ? core::ConstVecCoordId::restPosition() : core::ConstVecCoordId::position();
-        const VecCoord& x1 = this->mstate1->read(vecCoordId)->getValue();
+        const DataVecCoord* x1Data = this->mstate1->read(vecCoordId);
+        const VecCoord& x1 = x1Data->getValue();
         const VecCoord& x2 = this->mstate2->read(vecCoordId)->getValue();
 
         if (x1.empty() || x2.empty())
             return;
 
+        if constexpr (useKdTree)
+        {
+            if (m_kdTreePositions != x1Data)
+            {
+                m_kdTreePositions = x1Data;
+                m_kdTreePositionsCounter = -1;
+            }
+        }
+
         computeNearestPointMaps(x1, x2);
     }
 }
 
 
+template <class DataTypes>
+void NearestPointROI<DataTypes>::updateKdTree(const DataVecCoord& x1Data, const SetIndexArray& filterIndices1)
+{
+    if constexpr (useKdTree)
+    {
+        if (m_kdTreePositionsCounter == x1Data.getCounter() && m_kdTreeIndices == filterIndices1)
+            return;
+
+        m_kdTreePositionsCounter = x1Data.getCounter();
+        m_kdTreeIndices = filterIndices1;
+
+        // the tree requires each point once
+        SetIndexArray uniqueIndices1 = filterIndices1;
+        std::sort(uniqueIndices1.begin(), uniqueIndices1.end());
+        uniqueIndices1.erase(std::unique(uniqueIndices1.begin(), uniqueIndices1.end()), uniqueIndices1.end());
+
+        m_kdTree.build(x1Data.getValue(), uniqueIndices1);
+    }
+    else
+    {
+        SOFA_UNUSED(x1Data);
+        SOFA_UNUSED(filterIndices1);
+    }
+}
+
 template <class DataTypes>
 void NearestPointROI<DataTypes>::computeNearestPointMaps(const VecCoord& x1, const VecCoord& x2)
 {
-    Coord pt2;
     constexpr auto dist = [](const Coord& a, const Coord& b) { return (b - a).norm2(); };
-    const auto cmp = [&pt2, &x1, &dist](const Index a, const Index b) {
-        return dist(x1[a], pt2) < dist(x1[b], pt2);
-    };
 
     auto filterIndices1 = sofa::helper::getWriteAccessor(d_inputIndices1);
     auto filterIndices2 = sofa::helper::getWriteAccessor(d_inputIndices2);
@@ -155,15 +190,57 @@ void NearestPointROI<DataTypes>::computeNearestPointMaps(const VecCoord& x1, con
     const Real maxR = f_radius.getValue();
     const auto maxRSquared = maxR * maxR;
 
-    for (const auto i2 : filterIndices2)
+    if constexpr (useKdTree)
     {
-        pt2 = x2[i2];
+        updateKdTree(*m_kdTreePositions, filterIndices1.ref());
+    }
 
-        //find the nearest element from pt2 in x1
-        auto i1 = *std::min_element(std::begin(filterIndices1), std::end(filterIndices1), cmp);
-        const auto& pt1 = x1[i1];
+    //find the nearest element in x1 from each point of x2
+    const auto& queryIndices = filterIndices2.ref();
+    const auto& candidateIndices = filterIndices1.ref();
+    type::vector<Index> nearest(queryIndices.size());
+    type::vector<Real> nearestDistances(queryIndices.size());
+    const auto searchNearest = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t k = begin; k < end; ++k)
+        {
+            const Coord& pt2 = x2[queryIndices[k]];
+            Index i1;
+            if constexpr (useKdTree)
+            {
+                i1 = m_kdTree.getClosest(pt2, x1);
+            }
+            else
+            {
+                i1 = *std::min_element(std::begin(candidateIndices), std::end(candidateIndices),
+                    [&pt2, &x1, &dist](const Index a, const Index b) { return dist(x1[a], pt2) < dist(x1[b], pt2); });
+            }
+            nearest[k] = i1;
+            nearestDistances[k] = dist(x1[i1], pt2);
+        }
+    };
 
-        const auto d = dist(pt1, pt2);
+    if (d_parallelSearch.getValue())
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), queryIndices.size(),
+            [&searchNearest](const simulation::Range<std::size_t>& range) { searchNearest(range.start, range.end); });
+    }
+    else
+    {
+        searchNearest(0, queryIndices.size());
+    }
+
+    for (std::size_t k = 0; k < queryIndices.size(); ++k)
+    {
+        const auto i2 = queryIndices[k];
+        const auto i1 = nearest[k];
+        const auto d = nearestDistances[k];
         if (d < maxRSquared)
         {
             indices1->push_back(i1);
@@ -30,6 +30,7 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
+#include <sofa/helper/kdTree.h>
 
 namespace sofa::component::engine::select
 {
@@ -104,6 +105,11 @@ public:
     Data<bool> p_drawSphere; ///< Draw shpere(s)
     Data<bool> p_drawPoints; ///< Draw Points
     Data<double> _drawSize; ///< rendering size for box and topological elements
+
+protected:
+    /// k-d tree over the positions, rebuilt only when they change (not when the spheres move)
+    helper::kdTree<Coord> m_kdTree;
+    int m_kdTreeCounter { -1 };
 };
 
 #if !defined(SOFA_COMPONENT_ENGINE_PROXIMITYROI_CPP)
@@ -28,6 +28,7 @@
 #include <sofa/component/engine/select/ProximityROI.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/type/RGBAColor.h>
+#include <sofa/helper/kdTree.inl>
 
 namespace sofa::component::engine::select
 {
@@ -179,15 +180,29 @@ void ProximityROI<DataTypes>::doUpdate()
 
     std::make_heap(sortingheap.begin(), sortingheap.end());
 
-    for( unsigned i=0; i<x0->size(); ++i )
+    if (m_kdTreeCounter != f_X0.getCounter())
+    {
+        m_kdTree.build(*x0);
+        m_kdTreeCounter = f_X0.getCounter();
+    }
+
+    // distance from each point to the closest center among the spheres containing it,
+    // only the points in each sphere being visited
+    type::vector<Real> mindists(x0->size(), std::numeric_limits<Real>::max());
+    type::vector<typename helper::kdTree<Coord>::distanceToPoint> pointsInSphere;
+    for (unsigned int j=0; j<cen.size(); ++j)
     {
-        Real mindist=std::numeric_limits<Real>::max();
-        for (unsigned int j=0; j<cen.size(); ++j)
+        m_kdTree.getInRadius(pointsInSphere, cen[j], *x0, rad[j]);
+        for (const auto& [dist, i] : pointsInSphere)
         {
-            Real dist=(cen[j]-(*x0)[i]).norm();
-            if(dist < rad[j] && mindist > dist)
-                mindist = dist;
+            if(mindists[i] > dist)
+                mindists[i] = dist;
         }
+    }
+
+    for( unsigned i=0; i<x0->size(); ++i )
+    {
+        const Real mindist = mindists[i];
 
         if(mindist==std::numeric_limits<Real>::max())
         {
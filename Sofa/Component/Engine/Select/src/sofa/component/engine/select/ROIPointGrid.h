@@ -0,0 +1,180 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/select/config.h>
+
+#include <sofa/type/vector.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace sofa::component::engine::select
+{
+
+/**
+ * Uniform grid over a set of points, storing the indices of the points of each cell
+ * contiguously (the cells are sorted as in a CSR matrix).
+ *
+ * It is used by the ROI engines to only visit the points close to a region, instead of
+ * testing all of them. The grid is rebuilt with a counting sort, linear in the number of
+ * points, whenever the points move.
+ */
+template <class DataTypes>
+class ROIPointGrid
+{
+public:
+    using VecCoord = VecCoord_t<DataTypes>;
+    using CPos = typename DataTypes::CPos;
+    using Real = Real_t<DataTypes>;
+    static constexpr sofa::Size NbDimensions = DataTypes::spatial_dimensions;
+
+    /// Build the grid so that its cells contain about nbPointsPerCell points
+    void build(const VecCoord& positions, sofa::Size nbPointsPerCell = 4)
+    {
+        const std::size_t nbPoints = positions.size();
+        m_pointIndices.resize(nbPoints);
+        if (nbPoints == 0)
+        {
+            m_cellBegin.assign(2, 0);
+            m_nbCells.fill(1);
+            return;
+        }
+
+        m_min = DataTypes::getCPos(positions[0]);
+        CPos max = m_min;
+        for (const auto& x : positions)
+        {
+            const CPos& p = DataTypes::getCPos(x);
+            for (sofa::Size d = 0; d < NbDimensions; ++d)
+            {
+                m_min[d] = std::min(m_min[d], p[d]);
+                max[d] = std::max(max[d], p[d]);
+            }
+        }
+
+        const Real nbCellsPerAxis = std::pow(std::max(Real(1), Real(nbPoints) / Real(nbPointsPerCell)), Real(1) / Real(NbDimensions));
+        std::size_t nbCells = 1;
+        for (sofa::Size d = 0; d < NbDimensions; ++d)
+        {
+            const Real extent = max[d] - m_min[d];
+            m_nbCells[d] = extent > 0 ? std::clamp<sofa::Size>(static_cast<sofa::Size>(std::ceil(nbCellsPerAxis)), 1, 1024) : 1;
+            m_invCellSize[d] = extent > 0 ? Real(m_nbCells[d]) / extent : Real(0);
+            nbCells *= m_nbCells[d];
+        }
+
+        // counting sort of the points by cell
+        m_cellBegin.assign(nbCells + 1, 0);
+        m_pointCells.resize(nbPoints);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            m_pointCells[i] = getCellIndex(DataTypes::getCPos(positions[i]));
+            ++m_cellBegin[m_pointCells[i] + 1];
+        }
+        for (std::size_t c = 0; c < nbCells; ++c)
+        {
+            m_cellBegin[c + 1] += m_cellBegin[c];
+        }
+        type::vector<sofa::Index> fill(m_cellBegin.begin(), m_cellBegin.end() - 1);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            m_pointIndices[fill[m_pointCells[i]]++] = static_cast<sofa::Index>(i);
+        }
+    }
+
+    /// Call f(i) for each point i in a cell overlapping the box [minBox, maxBox]. The points outside
+    /// of these cells are outside of the box.
+    template <class F>
+    void forEachPointNearBox(const CPos& minBox, const CPos& maxBox, F&& f) const
+    {
+        std::array<sofa::Size, NbDimensions> begin, end;
+        for (sofa::Size d = 0; d < NbDimensions; ++d)
+        {
+            if (m_pointIndices.empty() || maxBox[d] < m_min[d] || !(minBox[d] <= maxBox[d]))
+            {
+                return;
+            }
+            begin[d] = getAxisCell(minBox[d], d);
+            end[d] = getAxisCell(maxBox[d], d) + 1;
+            if (end[d] <= begin[d])
+            {
+                return;
+            }
+        }
+
+        // visit the cells of the range, the first axis varying the fastest
+        std::array<sofa::Size, NbDimensions> cell = begin;
+        while (true)
+        {
+            std::size_t cellIndex = 0;
+            for (sofa::Size d = NbDimensions; d-- > 0;)
+            {
+                cellIndex = cellIndex * m_nbCells[d] + cell[d];
+            }
+            for (sofa::Index k = m_cellBegin[cellIndex]; k < m_cellBegin[cellIndex + 1]; ++k)
+            {
+                f(m_pointIndices[k]);
+            }
+
+            sofa::Size d = 0;
+            while (d < NbDimensions && ++cell[d] == end[d])
+            {
+                cell[d] = begin[d];
+                ++d;
+            }
+            if (d == NbDimensions)
+            {
+                break;
+            }
+        }
+    }
+
+protected:
+    sofa::Size getAxisCell(Real x, sofa::Size d) const
+    {
+        const Real c = (x - m_min[d]) * m_invCellSize[d];
+        if (!(c > 0))
+        {
+            return 0;
+        }
+        return std::min(static_cast<sofa::Size>(c), m_nbCells[d] - 1);
+    }
+
+    sofa::Index getCellIndex(const CPos& p) const
+    {
+        std::size_t cellIndex = 0;
+        for (sofa::Size d = NbDimensions; d-- > 0;)
+        {
+            cellIndex = cellIndex * m_nbCells[d] + getAxisCell(p[d], d);
+        }
+        return static_cast<sofa::Index>(cellIndex);
+    }
+
+    CPos m_min;
+    std::array<sofa::Size, NbDimensions> m_nbCells {};
+    std::array<Real, NbDimensions> m_invCellSize {};
+
+    type::vector<sofa::Index> m_cellBegin { 0, 0 };  ///< offsets of each cell in m_pointIndices
+    type::vector<sofa::Index> m_pointIndices;       ///< indices of the points, sorted by cell
+    type::vector<sofa::Index> m_pointCells;         ///< cell of each point
+};
+
+} // namespace sofa::component::engine::select
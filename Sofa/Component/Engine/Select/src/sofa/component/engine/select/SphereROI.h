@@ -65,6 +65,7 @@ protected:
     bool isPointInSphere(const CPos& c, const Real& r, const CPos& p) const;
 
     bool isPointInROI(const CPos& p) const override;
+    bool roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const override;
     bool isEdgeInROI(const Edge& e) const override;
     bool isEdgeInStrictROI(const Edge& e) const override;
     bool isTriangleInROI(const Triangle& t) const override;
@@ -78,6 +78,28 @@ bool SphereROI<DataTypes>::isPointInROI(const CPos& p) const
     return isInSpheres;
 }
 
+template <class DataTypes>
+bool SphereROI<DataTypes>::roiGetBoundingBox(CPos& minBBox, CPos& maxBBox) const
+{
+    const auto& centers = d_centers.getValue();
+    const auto& radii = d_radii.getValue();
+    const std::size_t nbSpheres = std::min(centers.size(), radii.size());
+    if (nbSpheres == 0)
+        return false;
+
+    for (std::size_t j = 0; j < nbSpheres; ++j)
+    {
+        // slightly enlarged so that the rounding errors of isPointInSphere cannot exclude a point
+        const Real r = std::abs(radii[j]) * static_cast<Real>(1 + 1e-6);
+        for (std::size_t d = 0; d < DataTypes::spatial_dimensions; ++d)
+        {
+            minBBox[d] = (j == 0) ? centers[j][d] - r : std::min(minBBox[d], centers[j][d] - r);
+            maxBBox[d] = (j == 0) ? centers[j][d] + r : std::max(maxBBox[d], centers[j][d] + r);
+        }
+    }
+    return true;
+}
+
 template <class DataTypes>
 bool SphereROI<DataTypes>::testEdgeAngle(const Edge& e) const
 {
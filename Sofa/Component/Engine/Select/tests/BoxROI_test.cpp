@@ -324,6 +324,57 @@ struct BoxROITest :  public sofa::testing::BaseTest
     }
 
 
+    /// Test the selection when the points then the box move between two updates
+    void isPointInMovingBoxTest()
+    {
+        m_boxroi->findData("box")->read("0. 0. 0. 1. 1. 1.");
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 1. 1. 2. 2. 2. 0.5 0.5 0.5");
+        m_boxroi->findData("edges")->read("0 1 1 2 2 3");
+        m_boxroi->init();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1 3");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"0");
+
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 1. 1. 0.5 0.5 0.5 2. 2. 2.");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1 2");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"0 1");
+
+        m_boxroi->findData("box")->read("1.5 1.5 1.5 3. 3. 3.");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"3");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"");
+    }
+
+    /// Test the selection when a point crosses the box boundary by displacements smaller than the
+    /// tolerance of the Coord comparison operator
+    void isPointInBoxSmallDisplacementsTest()
+    {
+        using VecCoord = typename TDataType::VecCoord;
+        m_boxroi->findData("box")->read("0. 0. 0. 1. 1. 1.");
+        m_boxroi->findData("position")->read("0.5 0.5 0.5  0.5 0.5 0.5");
+        m_boxroi->init();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1");
+
+        auto* positionData = dynamic_cast<sofa::Data<VecCoord>*>(m_boxroi->findData("position"));
+        ASSERT_NE(positionData, nullptr);
+
+        // the point moves from 1 - 1.5e-6 to 1 + 1.5e-6 by steps of 3e-7
+        for (int step = -5; step <= 5; ++step)
+        {
+            {
+                sofa::helper::WriteAccessor<sofa::Data<VecCoord> > positions = *positionData;
+                TDataType::set(positions[1], 1. + 3e-7 * step, 0.5, 0.5);
+            }
+            m_boxroi->update();
+
+            EXPECT_EQ(m_boxroi->findData("indices")->getValueString(), step <= 0 ? "0 1" : "0") << "step " << step;
+        }
+    }
+
     /// Test computeBBox computation with a simple example
     void computeBBoxTest()
     {
@@ -412,6 +463,14 @@ TYPED_TEST(BoxROITest, isPointInBoxesTest) {
     ASSERT_NO_THROW(this->isPointInBoxesTest());
 }
 
+TYPED_TEST(BoxROITest, isPointInMovingBoxTest) {
+    ASSERT_NO_THROW(this->isPointInMovingBoxTest());
+}
+
+TYPED_TEST(BoxROITest, isPointInBoxSmallDisplacementsTest) {
+    ASSERT_NO_THROW(this->isPointInBoxSmallDisplacementsTest());
+}
+
 TYPED_TEST(BoxROITest, computeBBoxTest) {
     ASSERT_NO_THROW(this->computeBBoxTest());
 }
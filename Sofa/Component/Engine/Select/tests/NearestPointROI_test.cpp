@@ -0,0 +1,122 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/component/engine/select/NearestPointROI.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+namespace sofa
+{
+
+using sofa::component::engine::select::NearestPointROI;
+using sofa::defaulttype::Vec3Types;
+
+struct NearestPointROI_test : public sofa::testing::BaseTest
+{
+    simulation::Node::SPtr m_root;
+
+    void SetUp() override
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Engine.Select");
+
+        // several threads, even on a single core machine
+        sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+
+        m_root = sofa::simulation::getSimulation()->createNewGraph("root");
+    }
+
+    void TearDown() override
+    {
+        if (m_root != nullptr)
+        {
+            sofa::simulation::node::unload(m_root);
+        }
+    }
+
+    static std::string toString(const Vec3Types::VecCoord& positions)
+    {
+        std::ostringstream out;
+        out << positions;
+        return out.str();
+    }
+};
+
+/// The query points are at the centers of the cells of a lattice: the 8 corners of each cell are equidistant. As a
+/// linear search, the nearest point is the one of lowest index.
+TEST_F(NearestPointROI_test, equidistantCandidates)
+{
+    Vec3Types::VecCoord lattice;
+    for (int k = 0; k < 4; ++k)
+        for (int j = 0; j < 4; ++j)
+            for (int i = 0; i < 4; ++i)
+                lattice.emplace_back(i, j, k);
+    // the order of the points is not related to their position
+    std::shuffle(lattice.begin(), lattice.end(), std::mt19937(42));
+
+    Vec3Types::VecCoord queries;
+    for (int k = 0; k < 3; ++k)
+        for (int j = 0; j < 3; ++j)
+            for (int i = 0; i < 3; ++i)
+                queries.emplace_back(i + 0.5, j + 0.5, k + 0.5);
+
+    sofa::simpleapi::createObject(m_root, "MechanicalObject", {{"name", "lattice"}, {"template", "Vec3"}, {"position", toString(lattice)}});
+    sofa::simpleapi::createObject(m_root, "MechanicalObject", {{"name", "queries"}, {"template", "Vec3"}, {"position", toString(queries)}});
+    const auto object = sofa::simpleapi::createObject(m_root, "NearestPointROI", {{"template", "Vec3"}, {"object1", "@lattice"}, {"object2", "@queries"}, {"radius", "10"}});
+    auto* roi = dynamic_cast<NearestPointROI<Vec3Types>*>(object.get());
+    ASSERT_NE(roi, nullptr);
+
+    sofa::simulation::node::initRoot(m_root.get());
+
+    for (const bool parallelSearch : {false, true})
+    {
+        roi->d_parallelSearch.setValue(parallelSearch);
+        roi->reinit();
+
+        const auto& indices1 = roi->f_indices1.getValue();
+        const auto& indices2 = roi->f_indices2.getValue();
+        ASSERT_EQ(indices1.size(), queries.size());
+        ASSERT_EQ(indices2.size(), queries.size());
+        for (std::size_t k = 0; k < queries.size(); ++k)
+        {
+            const auto& query = queries[indices2[k]];
+            unsigned int expected = 0;
+            for (unsigned int i = 1; i < lattice.size(); ++i)
+            {
+                if ((lattice[i] - query).norm2() < (lattice[expected] - query).norm2())
+                {
+                    expected = i;
+                }
+            }
+            EXPECT_EQ(indices1[k], expected) << "query " << indices2[k] << ", parallelSearch " << parallelSearch;
+        }
+    }
+}
+
+} // namespace sofa
@@ -0,0 +1,54 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/io/mesh/MeshBinaryLoader.h>
+#include <sofa/core/ObjectFactory.h>
+
+namespace sofa::component::io::mesh
+{
+
+int MeshBinaryLoaderClass = core::RegisterObject("Specific mesh loader for the binary mesh format of SOFA (.sofamesh).")
+        .add< MeshBinaryLoader >()
+        ;
+
+bool MeshBinaryLoader::doLoad()
+{
+    if (!canLoad())
+    {
+        msg_error() << "Can't load file " << d_filename.getFullPath();
+        return false;
+    }
+
+    if (!readBinaryMesh(d_filename.getFullPath()))
+    {
+        msg_error() << "Not a valid binary mesh file, or written with another precision: '" << d_filename << "'.";
+        return false;
+    }
+
+    return true;
+}
+
+void MeshBinaryLoader::doClearBuffers()
+{
+    /// Nothing to do if no output is added to the "filename" dataTrackerEngine.
+}
+
+} //namespace sofa::component::io::mesh
@@ -32,6 +32,7 @@
 #include <sofa/core/topology/BaseMeshTopology.h>
 
 using sofa::core::objectmodel::ComponentState ;
+using sofa::simulation::ExportFileStream ;
 
 namespace sofa::component::_meshexporter_
 {
@@ -199,7 +200,7 @@ bool MeshExporter::writeMeshVTKXML()
 
     const std::string filename = getMeshFilename(".vtu");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if (!outfile.is_open())
     {
         msg_error() << "Unable to create file '"<<filename << "'";
@@ -360,7 +361,7 @@ bool MeshExporter::writeMeshVTK()
 
     const std::string filename = getMeshFilename(".vtk");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if( !outfile.is_open() )
     {
         msg_error() << "Unable to create file '"<<filename << "'";
@@ -479,7 +480,7 @@ bool MeshExporter::writeMeshGmsh()
 
     const std::string filename = getMeshFilename(".gmsh");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if( !outfile.is_open() )
     {
         msg_error() << "Unable to create file '"<<filename << "'";
@@ -590,7 +591,7 @@ bool MeshExporter::writeMeshNetgen()
 
     const std::string filename = getMeshFilename(".mesh");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if (!outfile.is_open())
     {
         msg_error() << "Unable to create file '"<<filename << "'";
@@ -682,7 +683,7 @@ bool MeshExporter::writeMeshTetgen()
 
     std::string filename = getMeshFilename(".node");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if(!outfile.is_open())
     {
         msg_error() << "Unable to create file '"<<filename << "'";
@@ -715,7 +716,7 @@ bool MeshExporter::writeMeshTetgen()
     {
         // http://tetgen.berlios.de/fformats.ele.html
         filename = getMeshFilename(".ele");
-        std::ofstream outfile(filename.c_str());
+        ExportFileStream outfile(getExportQueue(), filename);
         if (!outfile.is_open())
         {
             msg_error() << "Unable to create file '"<<filename << "'";
@@ -750,7 +751,7 @@ bool MeshExporter::writeMeshTetgen()
     {
         // http://tetgen.berlios.de/fformats.face.html
         filename = getMeshFilename(".face");
-        std::ofstream outfile(filename.c_str());
+        ExportFileStream outfile(getExportQueue(), filename);
         if (!outfile.is_open())
         {
             msg_error() << "Unable to create file '"<<filename << "'";
@@ -812,7 +813,7 @@ bool MeshExporter::writeMeshObj()
 
     const std::string filename = getMeshFilename(".obj");
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if( !outfile.is_open() )
     {
         msg_error() << "Unable to create file '"<<filename << "'";
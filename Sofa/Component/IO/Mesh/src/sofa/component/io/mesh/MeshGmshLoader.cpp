@@ -127,6 +127,11 @@ void MeshGmshLoader::doClearBuffers()
     /// Nothing to do if no output is added to the "filename" dataTrackerEngine.
 }
 
+std::string MeshGmshLoader::getBinaryCacheParameters() const
+{
+    return getClassName();
+}
+
 void MeshGmshLoader::addInGroup(type::vector< sofa::core::loader::PrimitiveGroup>& group,int tag,int /*eid*/) {
     for (auto& group_i : group) {
         if (tag == group_i.p0) {
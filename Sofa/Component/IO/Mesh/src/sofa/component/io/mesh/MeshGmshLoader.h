@@ -37,6 +37,7 @@ public:
 protected:
 
     void doClearBuffers() override;
+    std::string getBinaryCacheParameters() const override;
 
     bool readGmsh(std::ifstream &file, const unsigned int gmshFormat);
 
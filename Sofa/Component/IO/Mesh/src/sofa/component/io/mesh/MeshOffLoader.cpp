@@ -68,6 +68,11 @@ bool MeshOffLoader::doLoad()
 
 void MeshOffLoader::doClearBuffers() {}
 
+std::string MeshOffLoader::getBinaryCacheParameters() const
+{
+    return getClassName();
+}
+
 bool MeshOffLoader::readOFF (std::ifstream &file, const char* /* filename */ )
 {
     msg_info() << "MeshOffLoader::readOFF" ;
@@ -37,6 +37,7 @@ public:
 protected:
 
     void doClearBuffers() override;
+    std::string getBinaryCacheParameters() const override;
     bool readOFF(std::ifstream &file, const char* filename);
 
 
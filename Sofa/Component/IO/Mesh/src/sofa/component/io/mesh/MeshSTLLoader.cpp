@@ -339,4 +339,11 @@ void MeshSTLLoader::doClearBuffers()
     /// Nothing to do if no output is added to the "filename" dataTrackerEngine.
 }
 
+std::string MeshSTLLoader::getBinaryCacheParameters() const
+{
+    std::ostringstream parameters;
+    parameters << getClassName() << ' ' << d_headerSize.getValue() << ' ' << d_forceBinary.getValue() << ' ' << d_mergePositionUsingMap.getValue();
+    return parameters.str();
+}
+
 } //namespace sofa::component::io::mesh
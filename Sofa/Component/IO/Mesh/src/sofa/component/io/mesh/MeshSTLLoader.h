@@ -46,6 +46,7 @@ protected:
 
 private:
     void doClearBuffers() override;
+    std::string getBinaryCacheParameters() const override;
     bool doLoad() override;
 
 public:
@@ -35,6 +35,7 @@ using sofa::core::objectmodel::GUIEvent ;
 using sofa::core::objectmodel::BaseContext ;
 using sofa::core::objectmodel::BaseData ;
 using sofa::core::objectmodel::ComponentState ;
+using sofa::simulation::ExportFileStream ;
 
 namespace sofa::component::_stlexporter_
 {
@@ -117,7 +118,7 @@ bool STLExporter::writeSTL(bool autonumbering)
     std::string filename = getOrCreateTargetPath(d_filename.getValue(), d_exportEveryNbSteps.getValue() && autonumbering) ;
     filename += ".stl";
 
-    std::ofstream outfile(filename.c_str());
+    ExportFileStream outfile(getExportQueue(), filename);
     if( !outfile.is_open() )
     {
         msg_error() << "Unable to open file '" << filename << "'";
@@ -206,7 +207,7 @@ bool STLExporter::writeSTLBinary(bool autonumbering)
                                                  d_exportEveryNbSteps.getValue() && autonumbering) ;
     filename += ".stl";
 
-    std::ofstream outfile(filename.c_str(), std::ios::out | std::ios::binary);
+    ExportFileStream outfile(getExportQueue(), filename, std::ios::out | std::ios::binary);
     if( !outfile.is_open() )
     {
         msg_error() << "Unable to open file '" << filename << "'";
@@ -27,6 +27,9 @@
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/core/objectmodel/KeypressedEvent.h>
 
+#include <sstream>
+#include <type_traits>
+
 namespace sofa::component::_vtkexporter_
 {
 
@@ -49,6 +52,8 @@ VTKExporter::VTKExporter()
     , d_exportAtBegin(initData(&d_exportAtBegin, false, "exportAtBegin", "export file at the initialization"))
     , d_exportAtEnd(initData(&d_exportAtEnd, false, "exportAtEnd", "export file when the simulation is finished"))
     , d_overwrite(initData(&d_overwrite, false, "overwrite", "overwrite the file, otherwise create a new file at each export, with suffix in the filename"))
+    , d_binaryFormat(initData(&d_binaryFormat, false, "binary", "XML format only: write the arrays as raw binary appended data, faster to write and read than ascii"))
+    , d_asyncExport(initData(&d_asyncExport, false, "asyncExport", "format and write the files in a background thread, the simulation only waits if the previous exports are not written yet"))
 {
 
     vtkFilename.setParent(&d_vtkFilename);
@@ -69,10 +74,154 @@ VTKExporter::VTKExporter()
 
 VTKExporter::~VTKExporter()
 {
+    // write the pending files while the component still exists
+    m_exportQueue.reset();
     if (outfile)
         delete outfile;
 }
 
+struct VTKExporter::MeshSnapshot
+{
+    defaulttype::Vec3Types::VecCoord positions;
+    sofa::core::topology::BaseMeshTopology::SeqEdges edges;
+    sofa::core::topology::BaseMeshTopology::SeqTriangles triangles;
+    sofa::core::topology::BaseMeshTopology::SeqQuads quads;
+    sofa::core::topology::BaseMeshTopology::SeqTetrahedra tetras;
+    sofa::core::topology::BaseMeshTopology::SeqHexahedra hexas;
+
+    std::string pointData; ///< formatted point data arrays
+    std::string cellData; ///< formatted cell data arrays
+    std::string appendedData; ///< binary XML format: raw data of the arrays, each one preceded by its size in bytes
+
+    std::size_t getNbCells() const
+    {
+        return edges.size() + triangles.size() + quads.size() + tetras.size() + hexas.size();
+    }
+
+    /// Call f(nbVertices, vtkCellType, cell) for each cell, in the order of the cells in the file
+    template<class F>
+    void forEachCell(F&& f) const
+    {
+        for (const auto& e : edges) f(2, 3, e);
+        for (const auto& t : triangles) f(3, 5, t);
+        for (const auto& q : quads) f(4, 9, q);
+        for (const auto& t : tetras) f(4, 10, t);
+        for (const auto& h : hexas) f(8, 12, h);
+    }
+};
+
+namespace
+{
+
+/// Append a data array to the appended data of a VTK XML file, with its size in a UInt64 header
+void appendRawData(std::string& appendedData, const void* data, std::uint64_t nbBytes)
+{
+    appendedData.append(reinterpret_cast<const char*>(&nbBytes), sizeof(nbBytes));
+    appendedData.append(static_cast<const char*>(data), nbBytes);
+}
+
+bool isBigEndian()
+{
+    const std::uint16_t one = 1;
+    return *reinterpret_cast<const unsigned char*>(&one) == 0;
+}
+
+/// VTK type of the coordinates of the points
+constexpr const char* positionType()
+{
+    return sizeof(SReal) == sizeof(float) ? "Float32" : "Float64";
+}
+
+}
+
+std::shared_ptr<VTKExporter::MeshSnapshot> VTKExporter::takeMeshSnapshot()
+{
+    // a snapshot only referenced here is not used by a pending export anymore: its buffers are reused
+    std::shared_ptr<MeshSnapshot> snapshot;
+    for (const auto& s : m_snapshots)
+    {
+        if (s.use_count() == 1)
+        {
+            snapshot = s;
+            break;
+        }
+    }
+    if (!snapshot)
+    {
+        snapshot = std::make_shared<MeshSnapshot>();
+        m_snapshots.push_back(snapshot);
+    }
+
+    // The values are copied here, on the thread of the simulation: the Data are modified by the next time steps while
+    // the file is written. The buffers of a reused snapshot are kept, so that the copies do not allocate.
+    auto& positions = snapshot->positions;
+    if (!d_position.getValue().empty())
+    {
+        const auto& position = d_position.getValue();
+        positions.assign(position.begin(), position.end());
+    }
+    else
+    {
+        const size_t nbp = m_topology->getNbPoints();
+        positions.resize(nbp);
+        if (m_mstate && m_mstate->getSize() == (size_t)nbp)
+        {
+            for (size_t i = 0; i < nbp; i++)
+                positions[i] = type::Vec3(m_mstate->getPX(i), m_mstate->getPY(i), m_mstate->getPZ(i));
+        }
+        else
+        {
+            for (size_t i = 0; i < nbp; i++)
+                positions[i] = type::Vec3(m_topology->getPX(i), m_topology->getPY(i), m_topology->getPZ(i));
+        }
+    }
+
+    const auto takeCells = [](auto& cells, bool write, const auto& topologyCells)
+    {
+        if (write)
+            cells.assign(topologyCells.begin(), topologyCells.end());
+        else
+            cells.clear();
+    };
+    takeCells(snapshot->edges, d_writeEdges.getValue(), m_topology->getEdges());
+    takeCells(snapshot->triangles, d_writeTriangles.getValue(), m_topology->getTriangles());
+    takeCells(snapshot->quads, d_writeQuads.getValue(), m_topology->getQuads());
+    takeCells(snapshot->tetras, d_writeTetras.getValue(), m_topology->getTetrahedra());
+    takeCells(snapshot->hexas, d_writeHexas.getValue(), m_topology->getHexahedra());
+
+    snapshot->pointData.clear();
+    snapshot->cellData.clear();
+    snapshot->appendedData.clear();
+    return snapshot;
+}
+
+void VTKExporter::exportMesh(std::function<bool()> job, const std::string& filename)
+{
+    if (d_asyncExport.getValue())
+    {
+        if (!m_exportQueue)
+            m_exportQueue = std::make_unique<simulation::ExportQueue>();
+        reportExportErrors();
+        m_exportQueue->push([queue = m_exportQueue.get(), job = std::move(job), filename]()
+        {
+            if (!job())
+                queue->addError("Error writing file " + filename);
+        });
+    }
+    else if (!job())
+    {
+        msg_error() << "Error writing file " << filename;
+    }
+}
+
+void VTKExporter::reportExportErrors()
+{
+    if (!m_exportQueue)
+        return;
+    for (const std::string& error : m_exportQueue->takeErrors())
+        msg_error() << error;
+}
+
 void VTKExporter::init()
 {
     const sofa::core::objectmodel::BaseContext* context = this->getContext();
@@ -144,7 +293,7 @@ void VTKExporter::fetchDataFields(const type::vector<std::string>& strData, type
     }
 }
 
-void VTKExporter::writeData(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names)
+void VTKExporter::writeData(std::ostream& out, const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names)
 {
     const sofa::core::objectmodel::BaseContext* context = this->getContext();
 
@@ -197,9 +346,9 @@ void VTKExporter::writeData(const type::vector<std::string>& objects, const type
             //if this is a scalar
             if (!line.empty())
             {
-                *outfile << "SCALARS" << " " << names[i] << " ";
-                *outfile << line << std::endl;
-                *outfile << "LOOKUP_TABLE default" << std::endl;
+                out << "SCALARS" << " " << names[i] << " ";
+                out << line << std::endl;
+                out << "LOOKUP_TABLE default" << std::endl;
             }
             else
             {
@@ -214,19 +363,19 @@ void VTKExporter::writeData(const type::vector<std::string>& objects, const type
                     line = "double";
                     sizeSeg = 3;
                 }
-                *outfile << "VECTORS" << " " << names[i] << " ";
-                *outfile << line << std::endl;
+                out << "VECTORS" << " " << names[i] << " ";
+                out << line << std::endl;
             }
 
-            *outfile << segmentString(field->getValueString(),sizeSeg) << std::endl;
-            *outfile << std::endl;
+            out << segmentString(field->getValueString(),sizeSeg) << std::endl;
+            out << std::endl;
 
 
         }
     }
 }
 
-void VTKExporter::writeDataArray(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names)
+void VTKExporter::writeDataArray(std::ostream& out, const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names, std::string* appendedData)
 {
     const sofa::core::objectmodel::BaseContext* context = this->getContext();
 
@@ -312,12 +461,28 @@ void VTKExporter::writeDataArray(const type::vector<std::string>& objects, const
                     sizeSeg = 3;
                 }
             }
-            *outfile << "        <DataArray type=\""<< type << "\" Name=\"" << names[i];
+            const defaulttype::AbstractTypeInfo* info = field->getValueTypeInfo();
+            if (appendedData && !type.empty() && info->ValidInfo() && !info->Text())
+            {
+                const void* values = field->getValueVoidPtr();
+                std::vector<double> scalars(info->size(values));
+                for (sofa::Size j = 0; j < scalars.size(); ++j)
+                    scalars[j] = info->getScalarValue(values, j);
+
+                out << "        <DataArray type=\"Float64\" Name=\"" << names[i];
+                if(sizeSeg > 1)
+                    out << "\" NumberOfComponents=\"" << sizeSeg;
+                out << "\" format=\"appended\" offset=\"" << appendedData->size() << "\"/>" << std::endl;
+                appendRawData(*appendedData, scalars.data(), scalars.size() * sizeof(double));
+                continue;
+            }
+
+            out << "        <DataArray type=\""<< type << "\" Name=\"" << names[i];
             if(sizeSeg > 1)
-                *outfile << "\" NumberOfComponents=\"" << sizeSeg;
-            *outfile << "\" format=\"ascii\">" << std::endl;
-            *outfile << segmentString(field->getValueString(),sizeSeg) << std::endl;
-            *outfile << "        </DataArray>" << std::endl;
+                out << "\" NumberOfComponents=\"" << sizeSeg;
+            out << "\" format=\"ascii\">" << std::endl;
+            out << segmentString(field->getValueString(),sizeSeg) << std::endl;
+            out << "        </DataArray>" << std::endl;
         }
     }
 }
@@ -390,156 +555,81 @@ void VTKExporter::writeVTKSimple()
         filename += ".vtu";
     }*/
 
-    outfile = new std::ofstream(filename.c_str());
-    if( !outfile->is_open() )
+    auto file = std::make_shared<std::ofstream>(filename.c_str());
+    if( !file->is_open() )
     {
         msg_error() << "Error creating file "<<filename;
-        delete outfile;
-        outfile = nullptr;
         return;
     }
 
-    const type::vector<std::string>& pointsData = d_dPointsDataFields.getValue();
-    const type::vector<std::string>& cellsData = d_dCellsDataFields.getValue();
-
-    helper::ReadAccessor<Data<defaulttype::Vec3Types::VecCoord> > pointsPos = d_position;
-
-    const size_t nbp = (!pointsPos.empty()) ? pointsPos.size() : m_topology->getNbPoints();
+    // the points, cells and data are taken here, the file is formatted and written by exportMesh
+    auto mesh = takeMeshSnapshot();
+    const size_t nbp = mesh->positions.size();
+    const size_t numberOfCells = mesh->getNbCells();
 
-    //Write header
-    *outfile << "# vtk DataFile Version 2.0" << std::endl;
-
-    //write Title
-    *outfile << "Exported VTK file" << std::endl;
-
-    //write Data type
-    *outfile << "ASCII" << std::endl;
-
-    *outfile << std::endl;
-
-    //write dataset (geometry, unstructured grid)
-    *outfile << "DATASET " << "UNSTRUCTURED_GRID" << std::endl;
-
-    *outfile << "POINTS " << nbp << " float" << std::endl;
-    //write Points
-    if (!pointsPos.empty())
+    //write dataset attributes
+    if (!d_dPointsDataFields.getValue().empty())
     {
-        for (size_t i=0 ; i<nbp; i++)
-        {
-            *outfile << pointsPos[i] << std::endl;
-        }
+        std::ostringstream out;
+        out << "POINT_DATA " << nbp << std::endl;
+        writeData(out, pointsDataObject, pointsDataField, pointsDataName);
+        mesh->pointData = out.str();
     }
-    else if (m_mstate && m_mstate->getSize() == (size_t)nbp)
+    if (!d_dCellsDataFields.getValue().empty())
     {
-        for (size_t i=0 ; i<m_mstate->getSize() ; i++)
-        {
-            *outfile << m_mstate->getPX(i) << " " << m_mstate->getPY(i) << " " << m_mstate->getPZ(i) << std::endl;
-        }
-    }
-    else
-    {
-        for (size_t i=0 ; i<nbp ; i++)
-        {
-            *outfile << m_topology->getPX(i) << " " << m_topology->getPY(i) << " " << m_topology->getPZ(i) << std::endl;
-        }
+        std::ostringstream out;
+        out << "CELL_DATA " << numberOfCells << std::endl;
+        writeData(out, cellsDataObject, cellsDataField, cellsDataName);
+        mesh->cellData = out.str();
     }
 
-    *outfile << std::endl;
+    ++nbFiles;
 
-    //Write Cells
-    size_t numberOfCells, totalSize;
-    numberOfCells = ((d_writeEdges.getValue()) ? m_topology->getNbEdges() : 0 )
-            +((d_writeTriangles.getValue()) ? m_topology->getNbTriangles() : 0 )
-            +((d_writeQuads.getValue()) ? m_topology->getNbQuads() : 0 )
-            +((d_writeTetras.getValue()) ? m_topology->getNbTetras() : 0 )
-            +((d_writeHexas.getValue()) ? m_topology->getNbHexas() : 0 );
-    totalSize =     ((d_writeEdges.getValue()) ? 3 * m_topology->getNbEdges() : 0 )
-            +((d_writeTriangles.getValue()) ? 4 * m_topology->getNbTriangles() : 0 )
-            +((d_writeQuads.getValue()) ? 5 * m_topology->getNbQuads() : 0 )
-            +((d_writeTetras.getValue()) ? 5 * m_topology->getNbTetras() : 0 )
-            +((d_writeHexas.getValue()) ? 9 * m_topology->getNbHexas() : 0 );
+    exportMesh([file, mesh, nbp, numberOfCells]()
+    {
+        std::ofstream& out = *file;
 
+        //Write header
+        out << "# vtk DataFile Version 2.0\n";
 
-    *outfile << "CELLS " << numberOfCells << " " << totalSize << std::endl;
+        //write Title
+        out << "Exported VTK file\n";
 
-    if (d_writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << 2 << " " << m_topology->getEdge(i) << std::endl;
-    }
-
-    if (d_writeTriangles.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << 3 << " " <<  m_topology->getTriangle(i) << std::endl;
-    }
-    if (d_writeQuads.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << 4 << " " << m_topology->getQuad(i) << std::endl;
-    }
+        //write Data type
+        out << "ASCII\n";
 
-    if (d_writeTetras.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << 4 << " " <<  m_topology->getTetra(i) << std::endl;
-    }
-    if (d_writeHexas.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << 8 << " " <<  m_topology->getHexa(i) << std::endl;
-    }
+        out << "\n";
 
-    *outfile << std::endl;
+        //write dataset (geometry, unstructured grid)
+        out << "DATASET " << "UNSTRUCTURED_GRID\n";
 
-    *outfile << "CELL_TYPES " << numberOfCells << std::endl;
+        out << "POINTS " << nbp << " float\n";
+        //write Points
+        for (const auto& p : mesh->positions)
+            out << p << "\n";
 
-    if (d_writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << 3 << std::endl;
-    }
+        out << "\n";
 
-    if (d_writeTriangles.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << 5 << std::endl;
-    }
-    if (d_writeQuads.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << 9 << std::endl;
-    }
+        //Write Cells
+        size_t totalSize = 0;
+        mesh->forEachCell([&totalSize](unsigned int nbVertices, int, const auto&) { totalSize += nbVertices + 1; });
 
-    if (d_writeTetras.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << 10 << std::endl;
-    }
-    if (d_writeHexas.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << 12 << std::endl;
-    }
+        out << "CELLS " << numberOfCells << " " << totalSize << "\n";
+        mesh->forEachCell([&out](unsigned int nbVertices, int, const auto& cell) { out << nbVertices << " " << cell << "\n"; });
 
-    *outfile << std::endl;
+        out << "\n";
 
-    //write dataset attributes
-    if (!pointsData.empty())
-    {
-        *outfile << "POINT_DATA " << nbp << std::endl;
-        writeData(pointsDataObject, pointsDataField, pointsDataName);
-    }
+        out << "CELL_TYPES " << numberOfCells << "\n";
+        mesh->forEachCell([&out](unsigned int, int cellType, const auto&) { out << cellType << "\n"; });
 
-    if (!cellsData.empty())
-    {
-        *outfile << "CELL_DATA " << numberOfCells << std::endl;
-        writeData(cellsDataObject, cellsDataField, cellsDataName);
-    }
+        out << "\n";
 
-    outfile->close();
+        out << mesh->pointData;
+        out << mesh->cellData;
 
-    ++nbFiles;
+        out.close();
+        return !out.fail();
+    }, filename);
 
     msg_info() << "Export VTK in file " << filename << "  done.";
 }
@@ -563,200 +653,152 @@ void VTKExporter::writeVTKXML()
         filename += ".vtu";
     }
 
-    outfile = new std::ofstream(filename.c_str());
-    if( !outfile->is_open() )
+    auto file = std::make_shared<std::ofstream>(filename.c_str(), std::ios::out | std::ios::binary);
+    if( !file->is_open() )
     {
         msg_error() << "Error creating file "<<filename;
-        delete outfile;
-        outfile = nullptr;
         return;
     }
-    const type::vector<std::string>& pointsData = d_dPointsDataFields.getValue();
-    const type::vector<std::string>& cellsData = d_dCellsDataFields.getValue();
 
-    helper::ReadAccessor<Data<defaulttype::Vec3Types::VecCoord> > pointsPos = d_position;
-
-    const size_t nbp = (!pointsPos.empty()) ? pointsPos.size() : m_topology->getNbPoints();
-
-    size_t numberOfCells;
-    numberOfCells = ((d_writeEdges.getValue()) ? m_topology->getNbEdges() : 0 )
-            +((d_writeTriangles.getValue()) ? m_topology->getNbTriangles() : 0 )
-            +((d_writeQuads.getValue()) ? m_topology->getNbQuads() : 0 )
-            +((d_writeTetras.getValue()) ? m_topology->getNbTetras() : 0 )
-            +((d_writeHexas.getValue()) ? m_topology->getNbHexas() : 0 );
+    // the points, cells and data are taken here, the file is formatted and written by exportMesh
+    auto mesh = takeMeshSnapshot();
+    const size_t nbp = mesh->positions.size();
+    const size_t numberOfCells = mesh->getNbCells();
+    const bool binary = d_binaryFormat.getValue();
 
     msg_info() << "### VTKExporter[" << this->getName() << "] ###" << msgendl
                << "Nb points: " << nbp << msgendl
-               << "Nb edges: " << ((d_writeEdges.getValue()) ? m_topology->getNbEdges() : 0 ) << msgendl
-               << "Nb triangles: " << ((d_writeTriangles.getValue()) ? m_topology->getNbTriangles() : 0 ) << msgendl
-               << "Nb quads: " << ((d_writeQuads.getValue()) ? m_topology->getNbQuads() : 0 ) << msgendl
-               << "Nb tetras: " << ((d_writeTetras.getValue()) ? m_topology->getNbTetras() : 0 ) << msgendl
-               << "Nb hexas: " << ((d_writeHexas.getValue()) ? m_topology->getNbHexas() : 0 ) << msgendl
+               << "Nb edges: " << mesh->edges.size() << msgendl
+               << "Nb triangles: " << mesh->triangles.size() << msgendl
+               << "Nb quads: " << mesh->quads.size() << msgendl
+               << "Nb tetras: " << mesh->tetras.size() << msgendl
+               << "Nb hexas: " << mesh->hexas.size() << msgendl
                << "### ###" << msgendl
                << "Total nb cells: " << numberOfCells << msgendl;
 
-    //write header
-    *outfile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">" << std::endl;
-    *outfile << "  <UnstructuredGrid>" << std::endl;
-
-    //write piece
-    *outfile << "    <Piece NumberOfPoints=\"" << nbp << "\" NumberOfCells=\""<< numberOfCells << "\">" << std::endl;
+    std::string* appendedData = binary ? &mesh->appendedData : nullptr;
 
     //write point data
-    if (!pointsData.empty())
+    if (!d_dPointsDataFields.getValue().empty())
     {
-        *outfile << "      <PointData>" << std::endl;
-        writeDataArray(pointsDataObject, pointsDataField, pointsDataName);
-        *outfile << "      </PointData>" << std::endl;
+        std::ostringstream out;
+        out << "      <PointData>" << std::endl;
+        writeDataArray(out, pointsDataObject, pointsDataField, pointsDataName, appendedData);
+        out << "      </PointData>" << std::endl;
+        mesh->pointData = out.str();
     }
     //write cell data
-    if (!cellsData.empty())
+    if (!d_dCellsDataFields.getValue().empty())
     {
-        *outfile << "      <CellData>" << std::endl;
-        writeDataArray(cellsDataObject, cellsDataField, cellsDataName);
-        *outfile << "      </CellData>" << std::endl;
+        std::ostringstream out;
+        out << "      <CellData>" << std::endl;
+        writeDataArray(out, cellsDataObject, cellsDataField, cellsDataName, appendedData);
+        out << "      </CellData>" << std::endl;
+        mesh->cellData = out.str();
     }
 
+    ++nbFiles;
 
-
-    //write points
-    *outfile << "      <Points>" << std::endl;
-    *outfile << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">" << std::endl;
-    if (!pointsPos.empty())
-    {
-        for (size_t i = 0 ; i < nbp; i++)
-        {
-            *outfile << "\t" << pointsPos[i] << std::endl;
-        }
-    }
-    else if (m_mstate && m_mstate->getSize() == (size_t)nbp)
+    exportMesh([file, mesh, nbp, numberOfCells, binary]()
     {
-        for (size_t i = 0; i < m_mstate->getSize(); i++)
-            *outfile << "          " << m_mstate->getPX(i) << " " << m_mstate->getPY(i) << " " << m_mstate->getPZ(i) << std::endl;
-    }
-    else
-    {
-        for (size_t i = 0; i < nbp; i++)
-            *outfile << "          " << m_topology->getPX(i) << " " << m_topology->getPY(i) << " " << m_topology->getPZ(i) << std::endl;
-    }
-    *outfile << "        </DataArray>" << std::endl;
-    *outfile << "      </Points>" << std::endl;
+        std::ofstream& out = *file;
+        std::string& appended = mesh->appendedData;
 
-    //write cells
-    *outfile << "      <Cells>" << std::endl;
-    //write connectivity
-    *outfile << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">" << std::endl;
-    if (d_writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << "          " << m_topology->getEdge(i) << std::endl;
-    }
+        //write header
+        if (binary)
+            out << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << (isBigEndian() ? "BigEndian" : "LittleEndian") << "\" header_type=\"UInt64\">\n";
+        else
+            out << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+        out << "  <UnstructuredGrid>\n";
 
-    if (d_writeTriangles.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << "          " <<  m_topology->getTriangle(i) << std::endl;
-    }
-    if (d_writeQuads.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << "          " << m_topology->getQuad(i) << std::endl;
-    }
-    if (d_writeTetras.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << "          " <<  m_topology->getTetra(i) << std::endl;
-    }
-    if (d_writeHexas.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << "          " <<  m_topology->getHexa(i) << std::endl;
-    }
-    *outfile << "        </DataArray>" << std::endl;
-    //write offsets
-    int num = 0;
-    *outfile << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">" << std::endl;
-    *outfile << "          ";
-    if (d_writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
+        //write piece
+        out << "    <Piece NumberOfPoints=\"" << nbp << "\" NumberOfCells=\""<< numberOfCells << "\">\n";
+
+        //write point and cell data
+        out << mesh->pointData;
+        out << mesh->cellData;
+
+        //write points
+        out << "      <Points>\n";
+        if (binary)
         {
-            num += 2;
-            *outfile << num << " ";
+            const auto& positions = mesh->positions;
+            out << "        <DataArray type=\"" << positionType() << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << appended.size() << "\"/>\n";
+            appendRawData(appended, positions.data(), positions.size() * sizeof(type::Vec3));
         }
-    }
-    if (d_writeTriangles.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
+        else
         {
-            num += 3;
-            *outfile << num << " ";
+            out << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
+            for (const auto& p : mesh->positions)
+                out << "          " << p << "\n";
+            out << "        </DataArray>\n";
         }
-    }
-    if (d_writeQuads.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
+        out << "      </Points>\n";
+
+        //write cells
+        out << "      <Cells>\n";
+        if (binary)
         {
-            num += 4;
-            *outfile << num << " ";
+            std::vector<std::int64_t> connectivity, offsets;
+            std::vector<std::uint8_t> types;
+            offsets.reserve(numberOfCells);
+            types.reserve(numberOfCells);
+            mesh->forEachCell([&](unsigned int nbVertices, int cellType, const auto& cell)
+            {
+                for (unsigned int v = 0; v < nbVertices; ++v)
+                    connectivity.push_back(cell[v]);
+                offsets.push_back(std::int64_t(connectivity.size()));
+                types.push_back(std::uint8_t(cellType));
+            });
+
+            out << "        <DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\"" << appended.size() << "\"/>\n";
+            appendRawData(appended, connectivity.data(), connectivity.size() * sizeof(std::int64_t));
+            out << "        <DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\"" << appended.size() << "\"/>\n";
+            appendRawData(appended, offsets.data(), offsets.size() * sizeof(std::int64_t));
+            out << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"" << appended.size() << "\"/>\n";
+            appendRawData(appended, types.data(), types.size());
         }
-    }
-    if (d_writeTetras.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
+        else
         {
-            num += 4;
-            *outfile << num << " ";
+            //write connectivity
+            out << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
+            mesh->forEachCell([&out](unsigned int, int, const auto& cell) { out << "          " << cell << "\n"; });
+            out << "        </DataArray>\n";
+            //write offsets
+            int num = 0;
+            out << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
+            out << "          ";
+            mesh->forEachCell([&out, &num](unsigned int nbVertices, int, const auto&)
+            {
+                num += nbVertices;
+                out << num << " ";
+            });
+            out << "\n";
+            out << "        </DataArray>\n";
+            //write types
+            out << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">\n";
+            out << "          ";
+            mesh->forEachCell([&out](unsigned int, int cellType, const auto&) { out << cellType << " "; });
+            out << "\n";
+            out << "        </DataArray>\n";
         }
-    }
-    if (d_writeHexas.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
+        out << "      </Cells>\n";
+
+        //write end
+        out << "    </Piece>\n";
+        out << "  </UnstructuredGrid>\n";
+        if (binary)
         {
-            num += 8;
-            *outfile << num << " ";
+            out << "  <AppendedData encoding=\"raw\">\n";
+            out << "   _";
+            out.write(appended.data(), std::streamsize(appended.size()));
+            out << "\n";
+            out << "  </AppendedData>\n";
         }
-    }
-    *outfile << std::endl;
-    *outfile << "        </DataArray>" << std::endl;
-    //write types
-    *outfile << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">" << std::endl;
-    *outfile << "          ";
-    if (d_writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << 3 << " ";
-    }
-    if (d_writeTriangles.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << 5 << " ";
-    }
-    if (d_writeQuads.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << 9 << " ";
-    }
-    if (d_writeTetras.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << 10 << " ";
-    }
-    if (d_writeHexas.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << 12 << " ";
-    }
-    *outfile << std::endl;
-    *outfile << "        </DataArray>" << std::endl;
-    *outfile << "      </Cells>" << std::endl;
-
-    //write end
-    *outfile << "    </Piece>" << std::endl;
-    *outfile << "  </UnstructuredGrid>" << std::endl;
-    *outfile << "</VTKFile>" << std::endl;
-    outfile->close();
-    ++nbFiles;
+        out << "</VTKFile>\n";
+        out.close();
+        return !out.fail();
+    }, filename);
 
     msg_info() << "Export VTK XML in file " << filename << "  done.";
 }
@@ -1012,6 +1054,12 @@ void VTKExporter::cleanup()
 {
     if (d_exportAtEnd.getValue())
         (d_fileFormat.getValue()) ? writeVTKXML() : writeVTKSimple();
+
+    if (m_exportQueue)
+    {
+        m_exportQueue->flush();
+        reportExportErrors();
+    }
 }
 
 } // namespace sofa::component::_vtkexporter_
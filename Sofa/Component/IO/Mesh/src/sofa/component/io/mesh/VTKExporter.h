@@ -27,8 +27,11 @@
 #include <sofa/core/objectmodel/DataFileName.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simulation/ExportQueue.h>
 
 #include <fstream>
+#include <functional>
+#include <memory>
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
@@ -47,12 +50,26 @@ protected:
 
     std::ofstream* outfile;
 
+    /// Copy of the points and cells to export, so that the file can be formatted in the background
+    struct MeshSnapshot;
+    type::vector<std::shared_ptr<MeshSnapshot> > m_snapshots;
+    std::unique_ptr<simulation::ExportQueue> m_exportQueue;
+
+    /// Return a snapshot of the current points and cells, reusing the buffers of a previous one not used anymore
+    std::shared_ptr<MeshSnapshot> takeMeshSnapshot();
+    /// Run the job writing the file in the background if asyncExport is set, or immediately otherwise.
+    /// The job returns false if the file could not be written.
+    void exportMesh(std::function<bool()> job, const std::string& filename);
+    /// Report the errors of the files written in the background since the last call
+    void reportExportErrors();
+
     void fetchDataFields(const type::vector<std::string>& strData, type::vector<std::string>& objects, type::vector<std::string>& fields, type::vector<std::string>& names);
     void writeVTKSimple();
     void writeVTKXML();
     void writeParallelFile();
-    void writeData(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names);
-    void writeDataArray(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names);
+    void writeData(std::ostream& out, const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names);
+    /// Write the data arrays, as appended raw data if appendedData is not null
+    void writeDataArray(std::ostream& out, const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names, std::string* appendedData = nullptr);
     std::string segmentString(std::string str, unsigned int n);
 
 public:
@@ -115,6 +132,8 @@ public:
     Data<bool> d_exportAtBegin; ///< export file at the initialization
     Data<bool> d_exportAtEnd; ///< export file when the simulation is finished
     Data<bool> d_overwrite; ///< overwrite the file, otherwise create a new file at each export, with suffix in the filename
+    Data<bool> d_binaryFormat; ///< XML format only: write the arrays as raw binary appended data
+    Data<bool> d_asyncExport; ///< format and write the files in a background thread
 
     int nbFiles;
 
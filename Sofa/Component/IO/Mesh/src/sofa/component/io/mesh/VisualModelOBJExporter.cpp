@@ -28,6 +28,7 @@ using sofa::simulation::ExportVisualModelOBJVisitor ;
 
 #include <sofa/core/objectmodel/KeypressedEvent.h>
 using sofa::core::objectmodel::KeypressedEvent ;
+using sofa::simulation::ExportFileStream ;
 
 namespace sofa::component::_visualmodelobjexporter_
 {
@@ -59,13 +60,13 @@ bool VisualModelOBJExporter::writeOBJ()
 
     if ( !(objfilename.size() > 3 && objfilename.substr(objfilename.size()-4)==".obj"))
         objfilename += ".obj";
-    std::ofstream outfile(objfilename.c_str());
+    ExportFileStream outfile(getExportQueue(), objfilename);
 
     if ( !(mtlfilename.size() > 3 && mtlfilename.substr(objfilename.size()-4)==".obj"))
         mtlfilename += ".mtl";
     else
         mtlfilename = mtlfilename.substr(0, mtlfilename.size()-4) + ".mtl";
-    std::ofstream mtlfile(mtlfilename.c_str());
+    ExportFileStream mtlfile(getExportQueue(), mtlfilename);
 
     if(!outfile.is_open())
     {
@@ -0,0 +1,179 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <sofa/testing/BaseTest.h>
+
+#include <sofa/component/io/mesh/MeshBinaryLoader.h>
+#include <sofa/component/io/mesh/MeshOffLoader.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using namespace sofa::component::io::mesh;
+using sofa::testing::BaseTest;
+
+namespace sofa
+{
+
+class MeshBinaryLoader_test : public BaseTest
+{
+public:
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / "MeshBinaryLoader_test";
+        std::filesystem::create_directories(m_directory);
+        m_filename = (m_directory / "mesh.off").string();
+        std::filesystem::remove(m_filename + ".sofamesh");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_directory);
+    }
+
+    void writeOff(double x) const
+    {
+        std::ofstream file(m_filename);
+        file << "OFF\n5 2 0\n"
+             << "0 0 0\n" << x << " 0 0\n1 1 0\n0 1 0\n2 0 0\n"
+             << "4 0 1 2 3\n3 1 4 2\n";
+    }
+
+    static MeshOffLoader::SPtr createOffLoader(const std::string& filename)
+    {
+        auto loader = sofa::core::objectmodel::New<MeshOffLoader>();
+        loader->d_binaryCache.setValue(true);
+        loader->d_filename.setValue(filename);
+        return loader;
+    }
+
+    template<class T>
+    static void expectSameBuffers(const sofa::Data<sofa::type::vector<T>>& a, const sofa::Data<sofa::type::vector<T>>& b)
+    {
+        ASSERT_EQ(a.getValue().size(), b.getValue().size());
+        for (std::size_t i = 0; i < a.getValue().size(); ++i)
+        {
+            EXPECT_TRUE(std::equal(a.getValue()[i].begin(), a.getValue()[i].end(), b.getValue()[i].begin()));
+        }
+    }
+
+    std::filesystem::path m_directory;
+    std::string m_filename;
+};
+
+TEST_F(MeshBinaryLoader_test, binaryCache)
+{
+    writeOff(1.0);
+
+    const auto parsed = createOffLoader(m_filename);
+    ASSERT_TRUE(parsed->load());
+    EXPECT_FALSE(parsed->isLoadedFromBinaryCache());
+    ASSERT_TRUE(std::filesystem::exists(m_filename + ".sofamesh"));
+
+    const auto cached = createOffLoader(m_filename);
+    ASSERT_TRUE(cached->load());
+    EXPECT_TRUE(cached->isLoadedFromBinaryCache());
+    expectSameBuffers(cached->d_positions, parsed->d_positions);
+    expectSameBuffers(cached->d_triangles, parsed->d_triangles);
+    expectSameBuffers(cached->d_quads, parsed->d_quads);
+    EXPECT_EQ(cached->d_positions.getValue().size(), 5);
+    EXPECT_EQ(cached->d_triangles.getValue().size(), 1);
+    EXPECT_EQ(cached->d_quads.getValue().size(), 1);
+
+    // a modified file does not match the cache anymore
+    writeOff(3.0);
+    const auto modified = createOffLoader(m_filename);
+    ASSERT_TRUE(modified->load());
+    EXPECT_FALSE(modified->isLoadedFromBinaryCache());
+    EXPECT_EQ(modified->d_positions.getValue()[1][0], 3.0);
+
+    // the rewritten cache is used by the next load
+    const auto cachedModified = createOffLoader(m_filename);
+    ASSERT_TRUE(cachedModified->load());
+    EXPECT_TRUE(cachedModified->isLoadedFromBinaryCache());
+    expectSameBuffers(cachedModified->d_positions, modified->d_positions);
+}
+
+TEST_F(MeshBinaryLoader_test, load)
+{
+    writeOff(1.0);
+    const auto parsed = createOffLoader(m_filename);
+    ASSERT_TRUE(parsed->load());
+
+    const auto loader = sofa::core::objectmodel::New<MeshBinaryLoader>();
+    loader->d_filename.setValue(m_filename + ".sofamesh");
+    ASSERT_TRUE(loader->load());
+    expectSameBuffers(loader->d_positions, parsed->d_positions);
+    expectSameBuffers(loader->d_triangles, parsed->d_triangles);
+    expectSameBuffers(loader->d_quads, parsed->d_quads);
+
+    // a text file is not a binary mesh
+    EXPECT_MSG_EMIT(Error);
+    loader->d_filename.setValue(m_filename);
+    EXPECT_FALSE(loader->load());
+}
+
+TEST_F(MeshBinaryLoader_test, corruptedSizes)
+{
+    writeOff(1.0);
+    const auto parsed = createOffLoader(m_filename);
+    ASSERT_TRUE(parsed->load());
+    const std::string binaryFilename = m_filename + ".sofamesh";
+
+    // the number of positions follows the header: magic, version, endianness, real and index sizes, and key
+    constexpr std::streamoff positionsSizeOffset = 8 + 4 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+    const auto writeSize = [&binaryFilename](std::streamoff offset, std::uint64_t size)
+    {
+        std::fstream file(binaryFilename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    };
+
+    const auto loader = sofa::core::objectmodel::New<MeshBinaryLoader>();
+    loader->d_filename.setValue(binaryFilename);
+
+    // a size that cannot be allocated
+    writeSize(positionsSizeOffset, std::uint64_t(1) << 60);
+    {
+        EXPECT_MSG_EMIT(Error);
+        EXPECT_FALSE(loader->load());
+        // reading the positions loads the file again, as the loader is still dirty
+        EXPECT_TRUE(loader->d_positions.getValue().empty());
+    }
+
+    // a size slightly larger than the file
+    const auto fileSize = static_cast<std::uint64_t>(std::filesystem::file_size(binaryFilename));
+    writeSize(positionsSizeOffset, fileSize / sizeof(sofa::type::Vec3) + 1);
+    {
+        EXPECT_MSG_EMIT(Error);
+        EXPECT_FALSE(loader->load());
+        EXPECT_TRUE(loader->d_positions.getValue().empty());
+    }
+
+    // the original size is read again
+    writeSize(positionsSizeOffset, 5);
+    EXPECT_TRUE(loader->load());
+    expectSameBuffers(loader->d_positions, parsed->d_positions);
+}
+
+} // namespace sofa
@@ -25,6 +25,8 @@ using std::vector;
 #include <string>
 using std::string;
 
+#include <fstream>
+
 #include <sofa/testing/BaseSimulationTest.h>
 using sofa::testing::BaseSimulationTest;
 
@@ -135,7 +137,7 @@ public:
     }
 
 
-    void checkSimulationWriteEachNbStep(const TestParam& params, const string& filename, std::vector<string> pathes, unsigned int numstep)
+    void checkSimulationWriteEachNbStep(const TestParam& params, const string& filename, std::vector<string> pathes, unsigned int numstep, bool asyncExport = false)
     {
         dataPath = pathes;
         const string extension = params.extension;
@@ -149,7 +151,7 @@ public:
                 "   <DefaultAnimationLoop/>                                        \n"
                 "   <MechanicalObject position='0 1 2 3 4 5 6 7 8 9'/>             \n"
                 "   <RegularGridTopology name='grid' n='6 6 6' min='-10 -10 -10' max='10 10 10' p0='-30 -10 -10' computeHexaList='1'/> \n"
-                "   <MeshExporter name='exporterA' format='" << format << "' printLog='false' filename='" << filename << "' exportEveryNumberOfSteps='5' /> \n"
+                "   <MeshExporter name='exporterA' format='" << format << "' printLog='false' filename='" << filename << "' exportEveryNumberOfSteps='5' asyncExport='" << asyncExport << "' /> \n"
                 "</Node>                                                           \n";
 
         const Node::SPtr root = SceneLoaderXML::loadFromMemory("testscene", scene1.str().c_str());
@@ -162,9 +164,14 @@ public:
             sofa::simulation::node::animate(root.get(), 0.5);
         }
 
+        // the pending asynchronous exports are written when the scene is unloaded
+        sofa::simulation::node::unload(root);
+
         for (auto& pathToCheck : pathes)
         {
             EXPECT_TRUE(FileSystem::exists(pathToCheck)) << "Problem with '" << pathToCheck << "'";
+            std::ifstream file(pathToCheck);
+            EXPECT_TRUE(file.peek() != std::ifstream::traits_type::eof()) << "Empty file '" << pathToCheck << "'";
         }
     }
 };
@@ -259,6 +266,27 @@ TEST_P(MeshExporter_test, checkSimulationWriteEachNbStep)
     ASSERT_NO_THROW(this->checkSimulationWriteEachNbStep(params, tempdir, paths, nbTimeSteps)) ;
 }
 
+TEST_P(MeshExporter_test, checkSimulationWriteEachNbStepAsync)
+{
+    const TestParam& params = GetParam();
+    constexpr std::string_view filename = "exporterA";
+    std::vector<std::string> paths;
+    constexpr unsigned int nbTimeSteps { 20 };
+    constexpr unsigned int exportEveryNumberOfSteps { 5 };
+    for (unsigned int i = 0; i < nbTimeSteps / exportEveryNumberOfSteps; ++i)
+    {
+        std::stringstream ss;
+        ss << std::setw(5) << std::setfill('0') << (i+1);
+
+        paths.push_back(FileSystem::append(tempdir, std::string(filename) + ss.str() + "." + params.extension));
+        for (const auto& addExtension : params.additionalExtensions)
+        {
+            paths.push_back(FileSystem::append(tempdir, std::string(filename) + ss.str() + "." + addExtension));
+        }
+    }
+    ASSERT_NO_THROW(this->checkSimulationWriteEachNbStep(params, tempdir, paths, nbTimeSteps, true)) ;
+}
+
 INSTANTIATE_TEST_SUITE_P(checkAllBehavior,
                          MeshExporter_test,
                          ::testing::ValuesIn(params));
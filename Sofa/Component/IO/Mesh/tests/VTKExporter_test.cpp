@@ -0,0 +1,235 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simulation/Node.h>
+using sofa::simulation::Node ;
+
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <sofa/simulation/common/SceneLoaderXML.h>
+using sofa::simulation::SceneLoaderXML ;
+
+#include <sofa/helper/system/FileSystem.h>
+using sofa::helper::system::FileSystem ;
+
+#include <sofa/helper/system/FileRepository.h>
+using sofa::helper::system::FileRepository;
+
+#include <sofa/core/behavior/BaseMechanicalState.h>
+
+namespace
+{
+const std::string tempdir = FileRepository().getTempPath() ;
+
+/// Size in bytes of a data array of the appended data, read from its UInt64 header
+std::uint64_t readArraySize(const std::string& appendedData, std::size_t offset)
+{
+    std::uint64_t nbBytes = 0;
+    std::memcpy(&nbBytes, appendedData.data() + offset, sizeof(nbBytes));
+    return nbBytes;
+}
+
+class VTKExporter_test : public BaseSimulationTest
+{
+public:
+    std::vector<std::string> dataPath ;
+
+    void SetUp() override
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Topology.Container.Grid");
+        sofa::simpleapi::importPlugin("Sofa.Component.IO.Mesh");
+    }
+
+    void TearDown() override
+    {
+        for (const auto& pathToRemove : dataPath)
+        {
+            if (FileSystem::exists(pathToRemove))
+                FileSystem::removeFile(pathToRemove);
+        }
+    }
+
+    Node::SPtr loadScene(const std::string& exporterAttributes)
+    {
+        std::stringstream scene;
+        scene <<
+                "<?xml version='1.0'?> \n"
+                "<Node name='Root' gravity='0 0 0' time='0' animate='0'>                 \n"
+                "   <DefaultAnimationLoop/>                                              \n"
+                "   <RegularGridTopology name='grid' n='3 3 3' min='0 0 0' max='2 2 2' computeHexaList='1'/> \n"
+                "   <MechanicalObject name='mstate' template='Vec3'/>                    \n"
+                "   <VTKExporter name='exporter' printLog='0' edges='0' hexas='1' pointsDataFields='mstate.position' " << exporterAttributes << "/> \n"
+                "</Node>                                                                 \n" ;
+
+        Node::SPtr root = SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        EXPECT_NE(root.get(), nullptr) << scene.str() ;
+        if (root)
+            sofa::simulation::node::initRoot(root.get());
+        return root;
+    }
+
+    /// Check that the file is a complete binary VTU file of the grid: the arrays declared in the
+    /// header are found at their offset in the appended data, with the expected sizes
+    void checkBinaryFile(const std::string& filename, const sofa::core::behavior::BaseMechanicalState* mstate)
+    {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        ASSERT_TRUE(file.is_open()) << filename;
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        ASSERT_NE(content.find("header_type=\"UInt64\""), std::string::npos);
+        ASSERT_NE(content.find("<Piece NumberOfPoints=\"27\" NumberOfCells=\"8\">"), std::string::npos);
+
+        const std::string appendedTag = "<AppendedData encoding=\"raw\">\n   _";
+        const std::size_t appendedBegin = content.find(appendedTag);
+        ASSERT_NE(appendedBegin, std::string::npos);
+        const std::string appendedEnd = "\n  </AppendedData>\n</VTKFile>\n";
+        ASSERT_GE(content.size(), appendedBegin + appendedTag.size() + appendedEnd.size());
+        ASSERT_EQ(content.substr(content.size() - appendedEnd.size()), appendedEnd) << "incomplete file " << filename;
+        const std::string appendedData = content.substr(appendedBegin + appendedTag.size(),
+                                                        content.size() - appendedEnd.size() - appendedBegin - appendedTag.size());
+
+        // position data field (always Float64), points, connectivity, offsets and types, in the order of the file
+        const std::size_t positionSize = sizeof(SReal) == sizeof(float) ? sizeof(float) : sizeof(double);
+        const std::vector<std::uint64_t> expectedSizes {
+            27 * 3 * sizeof(double), 27 * 3 * positionSize, 8 * 8 * sizeof(std::int64_t), 8 * sizeof(std::int64_t), 8 };
+
+        std::vector<std::size_t> offsets;
+        const std::string offsetAttribute = "offset=\"";
+        for (std::size_t pos = content.find(offsetAttribute); pos < appendedBegin; pos = content.find(offsetAttribute, pos + 1))
+            offsets.push_back(std::stoul(content.substr(pos + offsetAttribute.size())));
+        ASSERT_EQ(offsets.size(), expectedSizes.size());
+
+        std::size_t expectedOffset = 0;
+        for (std::size_t i = 0; i < offsets.size(); ++i)
+        {
+            EXPECT_EQ(offsets[i], expectedOffset) << "array " << i;
+            ASSERT_LE(offsets[i] + sizeof(std::uint64_t), appendedData.size());
+            EXPECT_EQ(readArraySize(appendedData, offsets[i]), expectedSizes[i]) << "array " << i;
+            expectedOffset = offsets[i] + sizeof(std::uint64_t) + expectedSizes[i];
+        }
+        EXPECT_EQ(expectedOffset, appendedData.size());
+
+        // the points
+        const char* points = appendedData.data() + offsets[1] + sizeof(std::uint64_t);
+        for (std::size_t i = 0; i < 27; ++i)
+        {
+            SReal p[3];
+            std::memcpy(p, points + i * sizeof(p), sizeof(p));
+            EXPECT_EQ(p[0], mstate->getPX(i));
+            EXPECT_EQ(p[1], mstate->getPY(i));
+            EXPECT_EQ(p[2], mstate->getPZ(i));
+        }
+
+        // the types: hexahedra
+        const char* types = appendedData.data() + offsets[4] + sizeof(std::uint64_t);
+        for (std::size_t i = 0; i < 8; ++i)
+            EXPECT_EQ(int(types[i]), 12);
+    }
+
+    void checkBinaryExport()
+    {
+        const std::string filename = FileSystem::append(tempdir, "vtkexporterBinary");
+        dataPath = { filename + ".vtu" };
+
+        EXPECT_MSG_NOEMIT(Error) ;
+        const Node::SPtr root = loadScene("XMLformat='1' binary='1' overwrite='1' filename='" + filename + "' exportAtBegin='1'");
+        ASSERT_NE(root.get(), nullptr);
+
+        sofa::simulation::node::animate(root.get(), 0.5);
+
+        const auto* mstate = root->get<sofa::core::behavior::BaseMechanicalState>();
+        ASSERT_NE(mstate, nullptr);
+        checkBinaryFile(dataPath[0], mstate);
+
+        sofa::simulation::node::unload(root);
+    }
+
+    void checkAsyncExport(bool binary)
+    {
+        const std::string filename = FileSystem::append(tempdir, binary ? "vtkexporterAsyncBinary" : "vtkexporterAsync");
+        constexpr unsigned int nbSteps = 6;
+        dataPath.clear();
+        for (unsigned int i = 0; i < nbSteps; ++i)
+            dataPath.push_back(filename + std::to_string(i) + ".vtu");
+
+        EXPECT_MSG_NOEMIT(Error) ;
+        const Node::SPtr root = loadScene(std::string("XMLformat='1' asyncExport='1' exportEveryNumberOfSteps='1' binary='")
+                                          + (binary ? "1" : "0") + "' filename='" + filename + "'");
+        ASSERT_NE(root.get(), nullptr);
+
+        for (unsigned int i = 0; i < nbSteps; ++i)
+            sofa::simulation::node::animate(root.get(), 0.5);
+
+        // keep the positions to check the files
+        sofa::core::behavior::BaseMechanicalState::SPtr mstate = root->get<sofa::core::behavior::BaseMechanicalState>();
+        ASSERT_NE(mstate.get(), nullptr);
+
+        // the pending exports are written when the scene is unloaded
+        sofa::simulation::node::unload(root);
+
+        for (const auto& path : dataPath)
+        {
+            if (binary)
+            {
+                checkBinaryFile(path, mstate.get());
+            }
+            else
+            {
+                std::ifstream file(path);
+                ASSERT_TRUE(file.is_open()) << path;
+                const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                const std::string end = "</VTKFile>\n";
+                ASSERT_GE(content.size(), end.size()) << path;
+                EXPECT_EQ(content.substr(content.size() - end.size()), end) << "incomplete file " << path;
+                EXPECT_NE(content.find("<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">"), std::string::npos) << path;
+            }
+        }
+    }
+};
+
+TEST_F(VTKExporter_test, binaryExport)
+{
+    this->checkBinaryExport();
+}
+
+TEST_F(VTKExporter_test, asyncExport)
+{
+    this->checkAsyncExport(false);
+}
+
+TEST_F(VTKExporter_test, asyncBinaryExport)
+{
+    this->checkAsyncExport(true);
+}
+
+}
@@ -29,6 +29,7 @@
 #include <sofa/linearalgebra/SparseMatrix.h>
 #include <sofa/linearalgebra/BTDMatrix.h>
 #include <sofa/linearalgebra/BlockVector.h>
+#include <sofa/helper/OptionsGroup.h>
 #include <cmath>
 #include <sofa/type/Mat.h>
 #include <sofa/component/linearsolver/direct/MatrixLinearSystem[BTDMatrix].h>
@@ -38,8 +39,13 @@ namespace sofa::component::linearsolver::direct
 {
 /// Linear system solver using Thomas Algorithm for Block Tridiagonal matrices
 ///
+/// The system can also be solved using a block cyclic reduction: at each level, the even
+/// block rows are eliminated independently from each other, so the work of a level can be
+/// distributed on the task scheduler. It is suited for very long chains of blocks.
+///
 /// References:
 /// Conte, S.D., and deBoor, C. (1972). Elementary Numerical Analysis. McGraw-Hill, New York
+/// Heller, D. (1976). Some Aspects of the Cyclic Reduction Algorithm for Block Tridiagonal Linear Systems. SIAM J. Numer. Anal.
 /// http://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
 /// http://www.cfd-online.com/Wiki/Tridiagonal_matrix_algorithm_-_TDMA_(Thomas_algorithm)
 /// http://www4.ncsu.edu/eos/users/w/white/www/white/ma580/chap2.5.PDF
@@ -53,6 +59,8 @@ public:
     Data<bool> d_problem; ///< display debug informations about subpartSolve computation
     Data<bool> d_subpartSolve; ///< Allows for the computation of a subpart of the system
     Data<bool> d_verification; ///< verification of the subpartSolve
+    Data<sofa::helper::OptionsGroup> d_algorithm; ///< Algorithm used to factorize and solve the system
+    Data<bool> d_parallelCyclicReduction; ///< Distribute the eliminations of each level of the cyclic reduction on the task scheduler
 
     SOFA_ATTRIBUTE_DISABLED__BTDLINEARSOLVER_DATABLOCKSIZE("d_blockSize has been deleted, as it was never actually used.")
     DeprecatedAndRemoved d_blockSize;
@@ -89,15 +97,52 @@ public:
 
     type::vector<Index> nBlockComputedMinv;
     Vector Y;
+
+    /// Blocks of one level of the block cyclic reduction.
+    /// The block rows at an odd position in a level are kept in the next level, the others are eliminated.
+    struct CyclicReductionLevel
+    {
+        type::vector<Index> rows; ///< index of the block rows of the level in the original system
+        type::vector<BlocType> A; ///< diagonal blocks
+        type::vector<BlocType> B; ///< lower diagonal blocks (null for the first row)
+        type::vector<BlocType> C; ///< upper diagonal blocks (null for the last row)
+        type::vector<BlocType> Ainv; ///< inverse of the diagonal blocks of the eliminated rows
+        type::vector<BlocType> alpha, gamma; ///< factors eliminating the lower and upper neighbors of the kept rows
+        type::vector<type::Vec<Matrix::getSubMatrixDim(), Real> > rhs; ///< right-hand side of the level, used during the solve
+    };
+    type::vector<CyclicReductionLevel> m_cyclicReductionLevels;
+
 protected:
     BTDLinearSolver()
         : d_verbose( initData(&d_verbose,false,"verbose","Dump system state at each iteration") )
         , d_problem(initData(&d_problem, false,"showProblem", "display debug informations about subpartSolve computation") )
         , d_subpartSolve(initData(&d_subpartSolve, false,"subpartSolve", "Allows for the computation of a subpart of the system") )
         , d_verification(initData(&d_verification, false,"verification", "verification of the subpartSolve"))
+        , d_algorithm(initData(&d_algorithm, helper::OptionsGroup{{"Thomas", "CyclicReduction"}}, "algorithm", "Algorithm used to factorize and solve the system:\n"
+                                                                                                            "- Thomas: sequential block LU factorization\n"
+                                                                                                            "- CyclicReduction: block cyclic reduction, where the eliminations of a level are independent (not compatible with subpartSolve)"))
+        , d_parallelCyclicReduction(initData(&d_parallelCyclicReduction, false, "parallelCyclicReduction", "Distribute the eliminations of each level of the cyclic reduction on the task scheduler"))
     {
 
     }
+
+    bool useCyclicReduction() const;
+
+    /// Factorize the system with the Thomas algorithm. getBlock(i, j, block) must provide the block (i, j) of the matrix.
+    template<class GetBlock>
+    void factorizeThomas(Index nb, const GetBlock& getBlock);
+
+    /// Compute the Thomas factorization from the blocks stored for the cyclic reduction if it was not computed
+    /// in invert, and allocate the storage of the inverse blocks
+    void prepareMinv();
+
+    void factorizeCyclicReduction(Matrix& M);
+
+    void solveCyclicReduction(Vector& x, const Vector& b);
+
+    bool m_isThomasFactorized { false };
+    bool m_isMinvAllocated { false };
+
 public:
     void my_identity(SubMatrix& Id, const Index size_id);
 
@@ -22,6 +22,9 @@
 #pragma once
 #include <sofa/component/linearsolver/direct/BTDLinearSolver.h>
 #include <sofa/linearalgebra/FullMatrix.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::linearsolver::direct
 {
@@ -106,6 +109,12 @@ void BTDLinearSolver<Matrix,Vector>::invert(SubMatrix& Inv, const BlocType& m)
     //return false;
 }
 
+template<class Matrix, class Vector>
+bool BTDLinearSolver<Matrix,Vector>::useCyclicReduction() const
+{
+    return d_algorithm.getValue().getSelectedId() == 1 && !d_subpartSolve.getValue();
+}
+
 template<class Matrix, class Vector>
 void BTDLinearSolver<Matrix,Vector>::invert(Matrix& M)
 {
@@ -116,10 +125,16 @@ void BTDLinearSolver<Matrix,Vector>::invert(Matrix& M)
     constexpr Index bsize = Matrix::getSubMatrixDim();
     const Index nb = M.rowSize() / bsize;
     if (nb == 0) return;
-    //alpha.resize(nb);
-    alpha_inv.resize(nb);
-    lambda.resize(nb-1);
-    B.resize(nb);
+
+    m_isThomasFactorized = false;
+    m_isMinvAllocated = false;
+
+    if (useCyclicReduction())
+    {
+        // the Thomas factorization will be computed only if the blocks of the inverse are required
+        factorizeCyclicReduction(M);
+        return;
+    }
 
     /////////////////////////// subpartSolve init ////////////
 
@@ -128,19 +143,50 @@ void BTDLinearSolver<Matrix,Vector>::invert(Matrix& M)
         this->init_partial_inverse(nb,bsize);
     }
 
+    factorizeThomas(nb, [&M](Index i, Index j, SubMatrix& block)
+    {
+        M.getAlignedSubMatrix(i, j, bsize, bsize, block);
+    });
+
+    if(d_subpartSolve.getValue() )
+    {
+        SubMatrix iHi; // bizarre: pb compilation avec SubMatrix nHn_1 = B[i] *alpha_inv[i];
+        my_identity(iHi, bsize);
+        H.insert( make_pair(  IndexPair(nb-1, nb-1), iHi  ) );
+
+        // on calcule les blocks diagonaux jusqu'au bout!!
+        // TODO : ajouter un compteur "first_block" qui évite de descendre les déplacements jusqu'au block 0 dans partial_solve si ce block n'a pas été appelé
+        computeMinvBlock(0, 0);
+    }
+}
+
+template<class Matrix, class Vector>
+template<class GetBlock>
+void BTDLinearSolver<Matrix,Vector>::factorizeThomas(Index nb, const GetBlock& getBlock)
+{
+    const bool verbose = d_verbose.getValue();
+
+    //alpha.resize(nb);
+    alpha_inv.resize(nb);
+    lambda.resize(nb-1);
+    B.resize(nb);
+
     SubMatrix A, C;
     //Index ndiag = 0;
-    M.getAlignedSubMatrix(0,0,bsize,bsize,A);
-    M.getAlignedSubMatrix(0,1,bsize,bsize,C);
+    getBlock(0,0,A);
     invert(alpha_inv[0],A);
     msg_info_when(verbose) << "alpha_inv[0] = " << alpha_inv[0] ;
-    lambda[0] = alpha_inv[0]*C;
-    msg_info_when(verbose) << "lambda[0] = " << lambda[0] ;
+    if (nb > 1)
+    {
+        getBlock(0,1,C);
+        lambda[0] = alpha_inv[0]*C;
+        msg_info_when(verbose) << "lambda[0] = " << lambda[0] ;
+    }
 
     for (Index i=1; i<nb; ++i)
     {
-        M.getAlignedSubMatrix((i  ),(i  ),bsize,bsize,A);
-        M.getAlignedSubMatrix((i  ),(i-1),bsize,bsize,B[i]);
+        getBlock((i  ),(i  ),A);
+        getBlock((i  ),(i-1),B[i]);
 
         BlocType Temp1= B[i]*lambda[i-1];
         BlocType Temp2= A - Temp1;
@@ -149,35 +195,240 @@ void BTDLinearSolver<Matrix,Vector>::invert(Matrix& M)
         msg_info_when(verbose) << "alpha_inv["<<i<<"] = " << alpha_inv[i] ;
         if (i<nb-1)
         {
-            M.getAlignedSubMatrix((i  ),(i+1),bsize,bsize,C);
+            getBlock((i  ),(i+1),C);
             lambda[i] = alpha_inv[i]*C;
 
             msg_info_when(verbose) << "lambda["<<i<<"] = " << lambda[i] ;
         }
     }
-    nBlockComputedMinv.resize(nb);
-    for (Index i=0; i<nb; ++i)
-        nBlockComputedMinv[i] = 0;
+    m_isThomasFactorized = true;
+}
 
-    // WARNING : cost of resize here : ???
-    Minv.resize(nb*bsize,nb*bsize);
-    Minv.setAlignedSubMatrix((nb-1),(nb-1),bsize,bsize,alpha_inv[nb-1]);
+template<class Matrix, class Vector>
+void BTDLinearSolver<Matrix,Vector>::prepareMinv()
+{
+    if (!m_isThomasFactorized)
+    {
+        if (m_cyclicReductionLevels.empty())
+        {
+            return;
+        }
 
-    nBlockComputedMinv[nb-1] = 1;
+        // the first level of the cyclic reduction contains the blocks of the original matrix
+        const CyclicReductionLevel& level = m_cyclicReductionLevels.front();
+        factorizeThomas(static_cast<Index>(level.rows.size()), [&level](Index i, Index j, SubMatrix& block)
+        {
+            if (i == j)
+                block = level.A[i];
+            else if (j < i)
+                block = level.B[i];
+            else
+                block = level.C[i];
+        });
+    }
 
-    if(d_subpartSolve.getValue() )
+    if (!m_isMinvAllocated)
     {
-        SubMatrix iHi; // bizarre: pb compilation avec SubMatrix nHn_1 = B[i] *alpha_inv[i];
-        my_identity(iHi, bsize);
-        H.insert( make_pair(  IndexPair(nb-1, nb-1), iHi  ) );
+        constexpr Index bsize = Matrix::getSubMatrixDim();
+        const Index nb = static_cast<Index>(alpha_inv.size());
+        if (nb == 0)
+        {
+            return;
+        }
 
-        // on calcule les blocks diagonaux jusqu'au bout!!
-        // TODO : ajouter un compteur "first_block" qui évite de descendre les déplacements jusqu'au block 0 dans partial_solve si ce block n'a pas été appelé
-        computeMinvBlock(0, 0);
+        nBlockComputedMinv.resize(nb);
+        for (Index i=0; i<nb; ++i)
+            nBlockComputedMinv[i] = 0;
+
+        // WARNING : cost of resize here : ???
+        // The dense storage of the inverse is only allocated when blocks of the inverse are required
+        Minv.resize(nb*bsize,nb*bsize);
+        Minv.setAlignedSubMatrix((nb-1),(nb-1),bsize,bsize,alpha_inv[nb-1]);
+
+        nBlockComputedMinv[nb-1] = 1;
+        m_isMinvAllocated = true;
     }
 }
 
+template<class Matrix, class Vector>
+void BTDLinearSolver<Matrix,Vector>::factorizeCyclicReduction(Matrix& M)
+{
+    SCOPED_TIMER_VARNAME(factorizationTimer, "CyclicReductionFactorization");
 
+    constexpr Index bsize = Matrix::getSubMatrixDim();
+    const Index nb = M.rowSize() / bsize;
+
+    const simulation::ForEachExecutionPolicy execution = d_parallelCyclicReduction.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (d_parallelCyclicReduction.getValue() && taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    m_cyclicReductionLevels.clear();
+    m_cyclicReductionLevels.emplace_back();
+
+    {
+        CyclicReductionLevel& level = m_cyclicReductionLevels.back();
+        level.rows.resize(nb);
+        level.A.resize(nb);
+        level.B.resize(nb);
+        level.C.resize(nb);
+        for (Index i = 0; i < nb; ++i)
+        {
+            level.rows[i] = i;
+            level.A[i] = M.asub(i, i, bsize, bsize);
+            if (i > 0)
+                level.B[i] = M.asub(i, i - 1, bsize, bsize);
+            if (i < nb - 1)
+                level.C[i] = M.asub(i, i + 1, bsize, bsize);
+        }
+    }
+
+    while (true)
+    {
+        // the reference to the current level must be taken at each iteration, as the vector of levels grows
+        CyclicReductionLevel& level = m_cyclicReductionLevels.back();
+        const Index m = static_cast<Index>(level.rows.size());
+        const Index nbKept = m / 2;
+
+        // inversion of the diagonal blocks of the eliminated rows (even positions)
+        level.Ainv.resize(m);
+        simulation::forEachRange(execution, *taskScheduler, Index(0), (m + 1) / 2,
+            [&level, this](const auto& range)
+            {
+                SubMatrix inverse;
+                for (auto e = range.start; e != range.end; ++e)
+                {
+                    invert(inverse, level.A[2 * e]);
+                    level.Ainv[2 * e] = inverse;
+                }
+            });
+
+        if (nbKept == 0)
+        {
+            break;
+        }
+
+        CyclicReductionLevel next;
+        next.rows.resize(nbKept);
+        next.A.resize(nbKept);
+        next.B.resize(nbKept);
+        next.C.resize(nbKept);
+        level.alpha.resize(nbKept);
+        level.gamma.resize(nbKept);
+
+        // elimination of the neighbors of the kept rows (odd positions)
+        simulation::forEachRange(execution, *taskScheduler, Index(0), nbKept,
+            [&level, &next, m](const auto& range)
+            {
+                for (auto k = range.start; k != range.end; ++k)
+                {
+                    const Index p = 2 * k + 1;
+                    BlocType& alpha = level.alpha[k];
+                    BlocType& gamma = level.gamma[k];
+
+                    alpha = -(level.B[p] * level.Ainv[p - 1]);
+                    next.A[k] = level.A[p] + alpha * level.C[p - 1];
+                    next.B[k] = alpha * level.B[p - 1];
+
+                    if (p + 1 < m)
+                    {
+                        gamma = -(level.C[p] * level.Ainv[p + 1]);
+                        next.A[k] += gamma * level.B[p + 1];
+                        next.C[k] = gamma * level.C[p + 1];
+                    }
+                    else
+                    {
+                        gamma.clear();
+                        next.C[k].clear();
+                    }
+                    next.rows[k] = level.rows[p];
+                }
+            });
+
+        m_cyclicReductionLevels.push_back(std::move(next));
+    }
+}
+
+template<class Matrix, class Vector>
+void BTDLinearSolver<Matrix,Vector>::solveCyclicReduction(Vector& x, const Vector& b)
+{
+    SCOPED_TIMER_VARNAME(solveTimer, "CyclicReductionSolve");
+
+    constexpr Index bsize = Matrix::getSubMatrixDim();
+
+    const simulation::ForEachExecutionPolicy execution = d_parallelCyclicReduction.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    const Index nbLevels = static_cast<Index>(m_cyclicReductionLevels.size());
+
+    {
+        CyclicReductionLevel& first = m_cyclicReductionLevels.front();
+        first.rhs.resize(first.rows.size());
+        for (std::size_t i = 0; i < first.rows.size(); ++i)
+        {
+            first.rhs[i] = b.asub(i, bsize);
+        }
+    }
+
+    // forward reduction of the right-hand side
+    for (Index l = 0; l + 1 < nbLevels; ++l)
+    {
+        const CyclicReductionLevel& level = m_cyclicReductionLevels[l];
+        CyclicReductionLevel& next = m_cyclicReductionLevels[l + 1];
+        const Index m = static_cast<Index>(level.rows.size());
+        next.rhs.resize(next.rows.size());
+
+        simulation::forEachRange(execution, *taskScheduler, Index(0), Index(next.rows.size()),
+            [&level, &next, m](const auto& range)
+            {
+                for (auto k = range.start; k != range.end; ++k)
+                {
+                    const Index p = 2 * k + 1;
+                    next.rhs[k] = level.rhs[p] + level.alpha[k] * level.rhs[p - 1];
+                    if (p + 1 < m)
+                    {
+                        next.rhs[k] += level.gamma[k] * level.rhs[p + 1];
+                    }
+                }
+            });
+    }
+
+    // back substitution: the kept rows are solved at the upper level, the eliminated rows are deduced
+    for (sofa::SignedIndex l = nbLevels - 1; l >= 0; --l)
+    {
+        const CyclicReductionLevel& level = m_cyclicReductionLevels[l];
+        const Index m = static_cast<Index>(level.rows.size());
+
+        simulation::forEachRange(execution, *taskScheduler, Index(0), (m + 1) / 2,
+            [&level, &x, m](const auto& range)
+            {
+                for (auto e = range.start; e != range.end; ++e)
+                {
+                    const Index p = 2 * e;
+                    type::Vec<bsize, Real> r = level.rhs[p];
+                    if (p > 0)
+                    {
+                        r -= level.B[p] * x.asub(level.rows[p - 1], bsize);
+                    }
+                    if (p + 1 < m)
+                    {
+                        r -= level.C[p] * x.asub(level.rows[p + 1], bsize);
+                    }
+                    x.asub(level.rows[p], bsize) = level.Ainv[p] * r;
+                }
+            });
+    }
+}
 
 ///
 ///                    [ inva0-l0(Minv10)     Minv10t          Minv20t      Minv30t ]
@@ -195,6 +446,8 @@ void BTDLinearSolver<Matrix,Vector>::computeMinvBlock(Index i, Index j)
         // for the computation, we use the lower diagonal matrix
         const Index t = i; i = j; j = t;
     }
+    prepareMinv();
+
     if (nBlockComputedMinv[i] > i-j) return; // the block was already computed
 
 
@@ -318,6 +571,13 @@ void BTDLinearSolver<Matrix,Vector>::solve (Matrix& /*M*/, Vector& x, Vector& b)
     const Index nb = b.size() / bsize;
     if (nb == 0) return;
 
+    if (useCyclicReduction())
+    {
+        solveCyclicReduction(x, b);
+        msg_info_when(verbose) << "solve, solution = "<<x;
+        return;
+    }
+
     x.asub(0,bsize) = alpha_inv[0] * b.asub(0,bsize);
     for (Index i=1; i<nb; ++i)
     {
@@ -718,6 +978,8 @@ template<class Matrix, class Vector>
 template<class RMatrix, class JMatrix>
 bool BTDLinearSolver<Matrix,Vector>::addJMInvJt(RMatrix& result, JMatrix& J, double fact)
 {
+    prepareMinv();
+
     const Index Jcols = J.colSize();
     if (Jcols != Minv.rowSize())
     {
@@ -25,6 +25,8 @@
 #include <sofa/helper/ScopedAdvancedTimer.h>
 #include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
 #include <sofa/component/linearsolver/direct/SparseCommon.h>
+#include <sofa/component/linearsolver/direct/SymbolicFactorizationCache.h>
+#include <sofa/core/objectmodel/DataFileName.h>
 #include <sofa/helper/OptionsGroup.h>
 #include <sofa/linearalgebra/DiagonalSystemSolver.h>
 #include <sofa/linearalgebra/TriangularSystemSolver.h>
@@ -168,12 +170,16 @@ protected :
     Data<bool> d_precomputeSymbolicDecomposition; ///< If true the solver will reuse the precomputed symbolic decomposition. Otherwise it will recompute it at each step.
     core::objectmodel::lifecycle::DeprecatedData d_applyPermutation{this, "v24.06", "v24.12", "applyPermutation", "Ordering method is now defined using ordering components"};
     Data<int> d_L_nnz; ///< Number of non-zero values in the lower triangular matrix of the factorization. The lower, the faster the system is solved.
+    Data<bool> d_useSymbolicFactorizationCache; ///< If true, the ordering and the symbolic factorization are shared through a cache keyed by the matrix pattern, so they are not recomputed for an already known pattern (e.g. after a reinit).
+    sofa::core::objectmodel::DataFileName d_symbolicFactorizationFile; ///< File used to persist the ordering and the symbolic factorization between runs. It is read if it matches the matrix pattern, and written otherwise.
 
 
     SparseLDLSolverImpl()
     : d_precomputeSymbolicDecomposition(initData(&d_precomputeSymbolicDecomposition, true ,"precomputeSymbolicDecomposition", "If true, the solver will reuse the precomputed symbolic decomposition, meaning that it will store the shape of [factor matrix] on the first step, or when its shape changes, and then it will only update its coefficients. When the shape of the matrix changes, a new factorization is computed."
                                                                                                                               "If false, the solver will compute the entire decomposition at each step"))
     , d_L_nnz(initData(&d_L_nnz, 0, "L_nnz", "Number of non-zero values in the lower triangular matrix of the factorization. The lower, the faster the system is solved.", true, true))
+    , d_useSymbolicFactorizationCache(initData(&d_useSymbolicFactorizationCache, false, "useSymbolicFactorizationCache", "If true, the ordering and the symbolic factorization are shared through a cache keyed by the matrix pattern, so they are not recomputed for an already known pattern (e.g. after a reinit)."))
+    , d_symbolicFactorizationFile(initData(&d_symbolicFactorizationFile, "symbolicFactorizationFile", "File used to persist the ordering and the symbolic factorization between runs. It is read if it matches the matrix pattern, and written otherwise."))
     {}
 
     template<class VecInt,class VecReal>
@@ -262,6 +268,90 @@ protected :
         CSPARSE_numeric<Real>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),Y.data());
     }
 
+    bool isSymbolicFactorizationCacheEnabled() const
+    {
+        return d_useSymbolicFactorizationCache.getValue() || !d_symbolicFactorizationFile.getValue().empty();
+    }
+
+    std::size_t computeSymbolicFingerprint(int n, const int* M_colptr, const int* M_rowind) const
+    {
+        const std::string orderingMethodName = this->l_orderingMethod ? this->l_orderingMethod->methodName() : std::string();
+        return SymbolicFactorizationCache::computeFingerprint(n, M_colptr, M_rowind, orderingMethodName);
+    }
+
+    /// Fill the permutation, the elimination tree and the column pointers of L from
+    /// the in-memory cache or from the file. Return false if the pattern is unknown.
+    template<class VecInt,class VecReal>
+    bool retrieveSymbolicFactorization(const int* M_colptr, const int* M_rowind, SparseLDLImplInvertData<VecInt,VecReal> * data)
+    {
+        if (!isSymbolicFactorizationCacheEnabled())
+        {
+            return false;
+        }
+
+        const std::size_t fingerprint = computeSymbolicFingerprint(data->n, M_colptr, M_rowind);
+
+        SymbolicFactorizationCache::SPtr symbolic = SymbolicFactorizationCache::find(fingerprint, data->n, M_colptr, M_rowind);
+
+        if (!symbolic && !d_symbolicFactorizationFile.getValue().empty())
+        {
+            symbolic = SymbolicFactorizationCache::readFromFile(d_symbolicFactorizationFile.getFullPath());
+            if (symbolic && (symbolic->fingerprint != fingerprint || !symbolic->hasPattern(data->n, M_colptr, M_rowind)))
+            {
+                msg_info() << "The symbolic factorization stored in '" << d_symbolicFactorizationFile.getFullPath() << "' does not match the matrix pattern";
+                symbolic.reset();
+            }
+            SymbolicFactorizationCache::insert(symbolic);
+        }
+
+        if (!symbolic)
+        {
+            return false;
+        }
+
+        msg_info() << "Reusing the symbolic factorization of a matrix with the same pattern";
+
+        std::copy(symbolic->perm.begin(), symbolic->perm.end(), data->perm.begin());
+        std::copy(symbolic->invperm.begin(), symbolic->invperm.end(), data->invperm.begin());
+        std::copy(symbolic->parent.begin(), symbolic->parent.end(), data->Parent.begin());
+        std::copy(symbolic->L_colptr.begin(), symbolic->L_colptr.end(), data->L_colptr.begin());
+
+        // working arrays of the numeric factorization, normally allocated in LDL_symbolic
+        Lnz.clear(); Lnz.resize(data->n);
+        Flag.clear(); Flag.resize(data->n);
+        Pattern.clear(); Pattern.resize(data->n);
+
+        return true;
+    }
+
+    template<class VecInt,class VecReal>
+    void storeSymbolicFactorization(const int* M_colptr, const int* M_rowind, SparseLDLImplInvertData<VecInt,VecReal> * data)
+    {
+        if (!isSymbolicFactorizationCacheEnabled())
+        {
+            return;
+        }
+
+        const auto n = data->n;
+        auto symbolic = std::make_shared<SymbolicFactorization>();
+        symbolic->fingerprint = computeSymbolicFingerprint(n, M_colptr, M_rowind);
+        symbolic->n = n;
+        symbolic->colptr.assign(M_colptr, M_colptr + n + 1);
+        symbolic->rowind.assign(M_rowind, M_rowind + M_colptr[n]);
+        symbolic->perm.assign(data->perm.begin(), data->perm.end());
+        symbolic->invperm.assign(data->invperm.begin(), data->invperm.end());
+        symbolic->parent.assign(data->Parent.begin(), data->Parent.end());
+        symbolic->L_colptr.assign(data->L_colptr.begin(), data->L_colptr.end());
+
+        const std::string& filename = d_symbolicFactorizationFile.getFullPath();
+        if (!filename.empty() && !SymbolicFactorizationCache::writeToFile(filename, *symbolic))
+        {
+            msg_warning() << "Cannot write the symbolic factorization in '" << filename << "'";
+        }
+
+        SymbolicFactorizationCache::insert(std::move(symbolic));
+    }
+
     template<class VecInt,class VecReal>
     void factorize(int n,int * M_colptr, int * M_rowind, Real * M_values, SparseLDLImplInvertData<VecInt,VecReal> * data)
     {
@@ -293,15 +383,20 @@ protected :
             memcpy(data->P_colptr.data(),M_colptr,(data->n+1) * sizeof(int));
             memcpy(data->P_rowind.data(),M_rowind,data->P_nnz * sizeof(int));
 
-            //ordering function
-            LDL_ordering( data->n , data->P_nnz, M_colptr , M_rowind , M_values, data->perm.data(), data->invperm.data() );
-
             data->Parent.clear();
             data->Parent.resize(data->n);
 
-            //symbolic factorization
-            LDL_symbolic(data->n,M_colptr,M_rowind,data->L_colptr.data(),
-                         data->perm.data(),data->invperm.data(),data->Parent.data());
+            if (!retrieveSymbolicFactorization(M_colptr, M_rowind, data))
+            {
+                //ordering function
+                LDL_ordering( data->n , data->P_nnz, M_colptr , M_rowind , M_values, data->perm.data(), data->invperm.data() );
+
+                //symbolic factorization
+                LDL_symbolic(data->n,M_colptr,M_rowind,data->L_colptr.data(),
+                             data->perm.data(),data->invperm.data(),data->Parent.data());
+
+                storeSymbolicFactorization(M_colptr, M_rowind, data);
+            }
 
             data->L_nnz = data->L_colptr[data->n];
             d_L_nnz.setValue(data->L_nnz);
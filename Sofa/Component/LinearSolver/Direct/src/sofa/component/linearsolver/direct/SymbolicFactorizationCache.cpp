@@ -0,0 +1,230 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/linearsolver/direct/SymbolicFactorizationCache.h>
+#include <sofa/helper/hash.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+
+namespace sofa::component::linearsolver::direct
+{
+
+namespace
+{
+constexpr char fileSignature[8] = {'S', 'O', 'F', 'A', 'S', 'Y', 'M', 'B'};
+constexpr std::uint32_t fileVersion = 1;
+
+std::mutex cacheMutex;
+std::deque<SymbolicFactorizationCache::SPtr> cacheEntries;
+
+void writeVector(std::ofstream& out, const type::vector<int>& v)
+{
+    const std::uint64_t size = v.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(size * sizeof(int)));
+}
+
+bool readVector(std::ifstream& in, type::vector<int>& v)
+{
+    std::uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)))
+    {
+        return false;
+    }
+
+    // a corrupted size must not lead to a huge allocation: the values must fit in the rest of the file
+    const std::streampos position = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff remaining = in.tellg() - position;
+    in.seekg(position);
+    if (remaining < 0 || size > static_cast<std::uint64_t>(remaining) / sizeof(int))
+    {
+        return false;
+    }
+
+    v.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(size * sizeof(int))));
+}
+
+/// Check that the array sizes match the matrix size, so that they can be copied into the solver data
+bool isConsistent(const SymbolicFactorization& symbolic)
+{
+    if (symbolic.n < 0)
+    {
+        return false;
+    }
+    const auto n = static_cast<std::size_t>(symbolic.n);
+    return symbolic.colptr.size() == n + 1
+        && symbolic.rowind.size() == static_cast<std::size_t>(symbolic.colptr.back())
+        && symbolic.perm.size() == n
+        && symbolic.invperm.size() == n
+        && symbolic.parent.size() == n
+        && symbolic.L_colptr.size() == n + 1;
+}
+}
+
+bool SymbolicFactorization::hasPattern(int n, const int* colptr, const int* rowind) const
+{
+    if (this->n != n || this->colptr.size() != static_cast<std::size_t>(n + 1))
+    {
+        return false;
+    }
+    if (!std::equal(this->colptr.begin(), this->colptr.end(), colptr))
+    {
+        return false;
+    }
+    return this->rowind.size() == static_cast<std::size_t>(colptr[n])
+        && std::equal(this->rowind.begin(), this->rowind.end(), rowind);
+}
+
+std::size_t SymbolicFactorizationCache::computeFingerprint(int n, const int* colptr, const int* rowind, const std::string& orderingMethodName)
+{
+    std::size_t seed = std::hash<std::string>()(orderingMethodName);
+    hash_combine(seed, n);
+    for (int i = 0; i <= n; ++i)
+    {
+        hash_combine(seed, colptr[i]);
+    }
+    for (int i = 0; i < colptr[n]; ++i)
+    {
+        hash_combine(seed, rowind[i]);
+    }
+    return seed;
+}
+
+SymbolicFactorizationCache::SPtr SymbolicFactorizationCache::find(std::size_t fingerprint, int n, const int* colptr, const int* rowind)
+{
+    std::lock_guard lock(cacheMutex);
+    const auto it = std::find_if(cacheEntries.begin(), cacheEntries.end(), [&](const SPtr& entry)
+    {
+        return entry->fingerprint == fingerprint && entry->hasPattern(n, colptr, rowind);
+    });
+    return it != cacheEntries.end() ? *it : nullptr;
+}
+
+void SymbolicFactorizationCache::insert(SPtr symbolic)
+{
+    if (!symbolic)
+    {
+        return;
+    }
+
+    std::lock_guard lock(cacheMutex);
+    cacheEntries.erase(std::remove_if(cacheEntries.begin(), cacheEntries.end(), [&symbolic](const SPtr& entry)
+    {
+        return entry->fingerprint == symbolic->fingerprint;
+    }), cacheEntries.end());
+
+    cacheEntries.push_back(std::move(symbolic));
+    while (cacheEntries.size() > maxNbEntries)
+    {
+        cacheEntries.pop_front();
+    }
+}
+
+void SymbolicFactorizationCache::clear()
+{
+    std::lock_guard lock(cacheMutex);
+    cacheEntries.clear();
+}
+
+std::size_t SymbolicFactorizationCache::size()
+{
+    std::lock_guard lock(cacheMutex);
+    return cacheEntries.size();
+}
+
+SymbolicFactorizationCache::SPtr SymbolicFactorizationCache::readFromFile(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+    {
+        return nullptr;
+    }
+
+    char signature[sizeof(fileSignature)];
+    std::uint32_t version = 0;
+    if (!in.read(signature, sizeof(signature)) || std::memcmp(signature, fileSignature, sizeof(fileSignature)) != 0
+        || !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != fileVersion)
+    {
+        msg_warning("SymbolicFactorizationCache") << "File '" << filename << "' is not a valid symbolic factorization file";
+        return nullptr;
+    }
+
+    auto symbolic = std::make_shared<SymbolicFactorization>();
+    std::uint64_t fingerprint = 0;
+    std::int64_t n = 0;
+    const bool success = in.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint))
+        && in.read(reinterpret_cast<char*>(&n), sizeof(n))
+        && readVector(in, symbolic->colptr)
+        && readVector(in, symbolic->rowind)
+        && readVector(in, symbolic->perm)
+        && readVector(in, symbolic->invperm)
+        && readVector(in, symbolic->parent)
+        && readVector(in, symbolic->L_colptr);
+
+    if (!success)
+    {
+        msg_warning("SymbolicFactorizationCache") << "File '" << filename << "' is truncated";
+        return nullptr;
+    }
+
+    symbolic->fingerprint = static_cast<std::size_t>(fingerprint);
+    symbolic->n = static_cast<int>(n);
+
+    if (!isConsistent(*symbolic) || n != symbolic->n)
+    {
+        msg_warning("SymbolicFactorizationCache") << "File '" << filename << "' contains an inconsistent symbolic factorization";
+        return nullptr;
+    }
+
+    return symbolic;
+}
+
+bool SymbolicFactorizationCache::writeToFile(const std::string& filename, const SymbolicFactorization& symbolic)
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    const std::uint64_t fingerprint = symbolic.fingerprint;
+    const std::int64_t n = symbolic.n;
+    out.write(fileSignature, sizeof(fileSignature));
+    out.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+    out.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    writeVector(out, symbolic.colptr);
+    writeVector(out, symbolic.rowind);
+    writeVector(out, symbolic.perm);
+    writeVector(out, symbolic.invperm);
+    writeVector(out, symbolic.parent);
+    writeVector(out, symbolic.L_colptr);
+
+    return out.good();
+}
+
+} // namespace sofa::component::linearsolver::direct
@@ -0,0 +1,93 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/direct/config.h>
+
+#include <sofa/type/vector.h>
+#include <memory>
+#include <string>
+
+namespace sofa::component::linearsolver::direct
+{
+
+/**
+ * Result of the ordering and the symbolic analysis of a sparse symmetric matrix:
+ * the fill-reducing permutation, the elimination tree and the column pointers
+ * of the factor L. It only depends on the sparsity pattern of the matrix and
+ * on the ordering method, so it can be shared between factorizations of
+ * matrices with the same pattern.
+ */
+struct SOFA_COMPONENT_LINEARSOLVER_DIRECT_API SymbolicFactorization
+{
+    /// Fingerprint of the pattern and the ordering method (see SymbolicFactorizationCache::computeFingerprint)
+    std::size_t fingerprint { 0 };
+
+    int n { 0 };
+
+    /// Pattern of the analyzed matrix, in CSR format. It is stored to detect fingerprint collisions.
+    type::vector<int> colptr, rowind;
+
+    type::vector<int> perm, invperm;
+    type::vector<int> parent;
+    type::vector<int> L_colptr;
+
+    /// Return true if the pattern (n, colptr, rowind) is the one which has been analyzed
+    bool hasPattern(int n, const int* colptr, const int* rowind) const;
+};
+
+/**
+ * Process-wide cache of symbolic factorizations, keyed by a fingerprint of the
+ * sparsity pattern and the ordering method name.
+ *
+ * The cache allows solvers to skip the ordering and the symbolic analysis when
+ * a matrix with a known pattern is factorized again, for example after a reinit
+ * or when the same scene is loaded several times. Entries can also be
+ * persisted on disk, so that the analysis is skipped at the next startup.
+ */
+class SOFA_COMPONENT_LINEARSOLVER_DIRECT_API SymbolicFactorizationCache
+{
+public:
+    using SPtr = std::shared_ptr<const SymbolicFactorization>;
+
+    static std::size_t computeFingerprint(int n, const int* colptr, const int* rowind, const std::string& orderingMethodName);
+
+    /// Return the cached symbolic factorization of the pattern, or nullptr if it has never been computed
+    static SPtr find(std::size_t fingerprint, int n, const int* colptr, const int* rowind);
+
+    static void insert(SPtr symbolic);
+
+    /// Remove all the entries from the in-memory cache
+    static void clear();
+
+    static std::size_t size();
+
+    /// Load a symbolic factorization previously saved with writeToFile. Return nullptr if the file cannot be read.
+    static SPtr readFromFile(const std::string& filename);
+
+    /// Save a symbolic factorization in a binary file. Return false if the file cannot be written.
+    static bool writeToFile(const std::string& filename, const SymbolicFactorization& symbolic);
+
+    /// Maximum number of patterns kept in memory. The oldest entries are dropped first.
+    static constexpr std::size_t maxNbEntries = 16;
+};
+
+} // namespace sofa::component::linearsolver::direct
@@ -0,0 +1,105 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/direct/BTDLinearSolver.h>
+#include <sofa/helper/RandomGenerator.h>
+
+
+namespace
+{
+
+using MatrixType = sofa::linearalgebra::BTDMatrix<6, SReal>;
+using VectorType = sofa::linearalgebra::BlockVector<6, SReal>;
+using Solver = sofa::component::linearsolver::direct::BTDLinearSolver<MatrixType, VectorType>;
+
+/// Fill a diagonally dominant block tridiagonal matrix
+void generateMatrix(MatrixType& matrix, const sofa::Index nbBlocks, sofa::helper::RandomGenerator& randomGenerator)
+{
+    const sofa::Index n = nbBlocks * 6;
+    matrix.resize(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        for (sofa::Index j = 0; j < n; ++j)
+        {
+            if (std::abs(static_cast<int>(i / 6) - static_cast<int>(j / 6)) <= 1 && i != j)
+            {
+                matrix.add(i, j, randomGenerator.random<SReal>(-1, 1));
+            }
+        }
+        matrix.add(i, i, 40_sreal);
+    }
+}
+
+VectorType solve(const std::string& algorithm, MatrixType& matrix, VectorType& rhs)
+{
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    sofa::helper::WriteAccessor(solver->d_algorithm)->setSelectedItem(algorithm);
+
+    VectorType solution;
+    solution.resize(rhs.size());
+
+    solver->invert(matrix);
+    solver->solve(matrix, solution, rhs);
+    return solution;
+}
+
+}
+
+class BTDLinearSolverTest : public sofa::testing::BaseTest, public ::testing::WithParamInterface<sofa::Index>
+{};
+
+TEST_P(BTDLinearSolverTest, CyclicReductionMatchesThomas)
+{
+    const sofa::Index nbBlocks = GetParam();
+
+    sofa::helper::RandomGenerator randomGenerator(12345);
+    MatrixType matrix;
+    generateMatrix(matrix, nbBlocks, randomGenerator);
+
+    VectorType rhs;
+    rhs.resize(nbBlocks * 6);
+    for (VectorType::Index i = 0; i < rhs.size(); ++i)
+    {
+        rhs[i] = randomGenerator.random<SReal>(-10, 10);
+    }
+
+    const VectorType thomas = solve("Thomas", matrix, rhs);
+    const VectorType cyclicReduction = solve("CyclicReduction", matrix, rhs);
+
+    for (VectorType::Index i = 0; i < rhs.size(); ++i)
+    {
+        EXPECT_NEAR(thomas[i], cyclicReduction[i], 1e-10) << "i = " << i;
+    }
+
+    // residual of the cyclic reduction solution
+    for (VectorType::Index i = 0; i < rhs.size(); ++i)
+    {
+        SReal r = -rhs[i];
+        for (VectorType::Index j = 0; j < rhs.size(); ++j)
+        {
+            r += matrix.element(i, j) * cyclicReduction[j];
+        }
+        EXPECT_NEAR(r, 0, 1e-10) << "i = " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(BTDLinearSolver, BTDLinearSolverTest, ::testing::Values(1, 2, 3, 8, 13));
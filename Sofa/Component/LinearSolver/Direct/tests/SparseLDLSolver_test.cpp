@@ -22,12 +22,16 @@
 #include <sofa/testing/BaseTest.h>
 #include <sofa/component/linearsolver/direct/SparseLDLSolver.h>
 #include <sofa/component/linearsolver/direct/SparseCommon.h>
+#include <sofa/component/linearsolver/direct/SymbolicFactorizationCache.h>
 #include <sofa/component/linearsystem/MatrixLinearSystem.h>
 #include <sofa/simulation/Node.h>
 #include <sofa/simulation/graph/DAGSimulation.h>
 #include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/helper/system/FileRepository.h>
 
 #include <sofa/testing/NumericTest.h>
+#include <fstream>
+#include <limits>
 
 
 TEST(SparseLDLSolver, EmptySystem)
@@ -138,3 +142,145 @@ TEST(SparseLDLSolver, AssociatedLinearSystem)
 
     EXPECT_EQ(MatrixSystem::GetCustomTemplateName(), MatrixType::Name());
 }
+
+namespace
+{
+sofa::linearalgebra::CompressedRowSparseMatrix<SReal> createLaplacianMatrix(const sofa::Index n)
+{
+    sofa::linearalgebra::CompressedRowSparseMatrix<SReal> matrix;
+    matrix.resize(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        matrix.add(i, i, 2_sreal);
+        if (i > 0)
+        {
+            matrix.add(i, i - 1, -1_sreal);
+            matrix.add(i - 1, i, -1_sreal);
+        }
+    }
+    matrix.compress();
+    return matrix;
+}
+}
+
+TEST(SparseLDLSolver, SymbolicFactorizationCache)
+{
+    using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    using VectorType = sofa::linearalgebra::FullVector<SReal>;
+    using Solver = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType >;
+    using sofa::component::linearsolver::direct::SymbolicFactorizationCache;
+
+    SymbolicFactorizationCache::clear();
+
+    static constexpr sofa::Index n = 20;
+    MatrixType matrix = createLaplacianMatrix(n);
+
+    VectorType rhs(n), solution(n), cachedSolution(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        rhs[i] = static_cast<SReal>(i);
+    }
+
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    solver->findData("useSymbolicFactorizationCache")->read("true");
+    solver->init();
+    solver->invert(matrix);
+    solver->solve(matrix, solution, rhs);
+
+    EXPECT_EQ(SymbolicFactorizationCache::size(), std::size_t{1});
+
+    // a second solver factorizing a matrix with the same pattern reuses the cached analysis
+    const Solver::SPtr cachedSolver = sofa::core::objectmodel::New<Solver>();
+    cachedSolver->findData("useSymbolicFactorizationCache")->read("true");
+    cachedSolver->init();
+    cachedSolver->invert(matrix);
+    cachedSolver->solve(matrix, cachedSolution, rhs);
+
+    EXPECT_EQ(SymbolicFactorizationCache::size(), std::size_t{1});
+    EXPECT_EQ(solver->findData("L_nnz")->getValueString(), cachedSolver->findData("L_nnz")->getValueString());
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(solution[i], cachedSolution[i], 1e-12);
+    }
+
+    SymbolicFactorizationCache::clear();
+}
+
+TEST(SparseLDLSolver, SymbolicFactorizationFile)
+{
+    using sofa::component::linearsolver::direct::SymbolicFactorization;
+    using sofa::component::linearsolver::direct::SymbolicFactorizationCache;
+
+    const auto matrix = createLaplacianMatrix(5);
+    const int* colptr = (const int*)matrix.getRowBegin().data();
+    const int* rowind = (const int*)matrix.getColsIndex().data();
+
+    SymbolicFactorization symbolic;
+    symbolic.n = 5;
+    symbolic.fingerprint = SymbolicFactorizationCache::computeFingerprint(5, colptr, rowind, "AMD");
+    symbolic.colptr.assign(colptr, colptr + 6);
+    symbolic.rowind.assign(rowind, rowind + colptr[5]);
+    symbolic.perm.assign({4, 3, 2, 1, 0});
+    symbolic.invperm.assign({4, 3, 2, 1, 0});
+    symbolic.parent.assign({1, 2, 3, 4, -1});
+    symbolic.L_colptr.assign({0, 1, 2, 3, 4, 4});
+
+    const std::string filename = sofa::helper::system::FileRepository().getTempPath() + "/SparseLDLSolver_symbolic.bin";
+    ASSERT_TRUE(SymbolicFactorizationCache::writeToFile(filename, symbolic));
+
+    const auto loaded = SymbolicFactorizationCache::readFromFile(filename);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->fingerprint, symbolic.fingerprint);
+    EXPECT_TRUE(loaded->hasPattern(5, colptr, rowind));
+    EXPECT_EQ(loaded->perm, symbolic.perm);
+    EXPECT_EQ(loaded->invperm, symbolic.invperm);
+    EXPECT_EQ(loaded->parent, symbolic.parent);
+    EXPECT_EQ(loaded->L_colptr, symbolic.L_colptr);
+
+    EXPECT_NE(SymbolicFactorizationCache::computeFingerprint(5, colptr, rowind, "Natural"), symbolic.fingerprint);
+}
+
+TEST(SparseLDLSolver, SymbolicFactorizationFileInconsistentSizes)
+{
+    using sofa::component::linearsolver::direct::SymbolicFactorization;
+    using sofa::component::linearsolver::direct::SymbolicFactorizationCache;
+
+    const auto matrix = createLaplacianMatrix(5);
+    const int* colptr = (const int*)matrix.getRowBegin().data();
+    const int* rowind = (const int*)matrix.getColsIndex().data();
+
+    SymbolicFactorization symbolic;
+    symbolic.n = 5;
+    symbolic.fingerprint = SymbolicFactorizationCache::computeFingerprint(5, colptr, rowind, "AMD");
+    symbolic.colptr.assign(colptr, colptr + 6);
+    symbolic.rowind.assign(rowind, rowind + colptr[5]);
+    symbolic.perm.assign({4, 3, 2, 1, 0});
+    symbolic.invperm.assign({4, 3, 2, 1, 0});
+    symbolic.parent.assign({1, 2, 3, 4, -1});
+    symbolic.L_colptr.assign({0, 1, 2, 3, 4, 4});
+
+    const std::string filename = sofa::helper::system::FileRepository().getTempPath() + "/SparseLDLSolver_symbolic_stale.bin";
+
+    // a stale file storing a permutation larger than the matrix would overflow the solver arrays
+    symbolic.perm.push_back(5);
+    ASSERT_TRUE(SymbolicFactorizationCache::writeToFile(filename, symbolic));
+    EXPECT_EQ(SymbolicFactorizationCache::readFromFile(filename), nullptr);
+    symbolic.perm.pop_back();
+
+    symbolic.parent.pop_back();
+    ASSERT_TRUE(SymbolicFactorizationCache::writeToFile(filename, symbolic));
+    EXPECT_EQ(SymbolicFactorizationCache::readFromFile(filename), nullptr);
+    symbolic.parent.push_back(-1);
+
+    ASSERT_TRUE(SymbolicFactorizationCache::writeToFile(filename, symbolic));
+    EXPECT_NE(SymbolicFactorizationCache::readFromFile(filename), nullptr);
+
+    // a corrupted array size must not be allocated
+    {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8 + sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::int64_t));
+        const std::uint64_t hugeSize = std::numeric_limits<std::uint64_t>::max() / 8;
+        file.write(reinterpret_cast<const char*>(&hugeSize), sizeof(hugeSize));
+    }
+    EXPECT_EQ(SymbolicFactorizationCache::readFromFile(filename), nullptr);
+}
@@ -60,6 +60,10 @@ protected:
     int timeStepCount{0};
     bool equilibriumReached{false};
 
+    /// Tolerance replacing d_tolerance when it is not negative (see setRelativeTolerance)
+    Real m_toleranceOverride { -1 };
+    unsigned m_nbIterationsOfLastSolve { 0 };
+
 public:
     void init() override;
     void reinit() override {};
@@ -70,6 +74,9 @@ public:
 
     /// Solve iteratively the linear system Ax=b following a conjugate gradient descent
     void solve (Matrix& A, Vector& x, Vector& b) override;
+
+    bool setRelativeTolerance(SReal tolerance) override;
+    unsigned getNbIterationsOfLastSolve() const override { return m_nbIterationsOfLastSolve; }
 };
 
 template<>
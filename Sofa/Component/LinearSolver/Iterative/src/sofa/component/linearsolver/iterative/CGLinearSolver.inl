@@ -89,6 +89,14 @@ void CGLinearSolver<TMatrix,TVector>::setSystemMBKMatrix(const sofa::core::Mecha
     Inherit::setSystemMBKMatrix(mparams);
 }
 
+/// Replace d_tolerance for the next solves, e.g. by an inexact Newton solver
+template<class TMatrix, class TVector>
+bool CGLinearSolver<TMatrix,TVector>::setRelativeTolerance(SReal tolerance)
+{
+    m_toleranceOverride = static_cast<Real>(tolerance);
+    return true;
+}
+
 /// Solve iteratively the linear system Ax=b following a conjugate gradient descent
 template<class TMatrix, class TVector>
 void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
@@ -127,6 +135,9 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     /// Compute the norm of the right-hand-side vector b
     const auto normb = b.norm();
 
+    // d_tolerance is a criterion on the squared norms, whereas the override is on the relative residual |r|/|b|
+    const Real tolerance = m_toleranceOverride < 0 ? d_tolerance.getValue() : m_toleranceOverride * m_toleranceOverride;
+
     std::map < std::string, sofa::type::vector<Real> >& graph = *d_graph.beginEdit();
     sofa::type::vector<Real>& graph_error = graph[std::string("Error")];
     graph_error.clear();
@@ -171,7 +182,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
 
 
             /// Break condition = TOLERANCE criterion regarding the error err=|r|²/|b|² is reached
-            if (err <= d_tolerance.getValue())
+            if (err <= tolerance)
             {
                 /// Tolerance met at first step, tolerance value might not be relevant
                 if(nb_iter == 1 && timeStepCount == 0)
@@ -192,7 +203,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
                     }
 
                     endcond = "tolerance";
-                    msg_info() << "error = " << err <<", tolerance = " << d_tolerance.getValue();
+                    msg_info() << "error = " << err <<", tolerance = " << tolerance;
 
 #ifdef SOFA_DUMP_VISITOR_INFO
                     if (simulation::Visitor::isPrintActivated())
@@ -325,6 +336,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     timeStepCount ++;
 
     sofa::helper::AdvancedTimer::valSet("CG iterations", nb_iter);
+    m_nbIterationsOfLastSolve = nb_iter;
 
     msg_info() << "solve, nbiter = "<<nb_iter<<" stop because of "<<endcond;
     msg_info() <<"solve, solution = "<< x ;
@@ -77,6 +77,9 @@ protected:
 public:
     void solve (Matrix& M, Vector& x, Vector& b) override;
     void init() override;
+
+    bool setRelativeTolerance(SReal tolerance) override;
+    unsigned getNbIterationsOfLastSolve() const override { return m_nbIterationsOfLastSolve; }
     void setSystemMBKMatrix(const core::MechanicalParams* mparams) override;
 
 private :
@@ -84,6 +87,10 @@ private :
     bool first;
     int newton_iter;
 
+    /// Tolerance replacing d_tolerance when it is not negative (see setRelativeTolerance)
+    double m_toleranceOverride { -1 };
+    unsigned m_nbIterationsOfLastSolve { 0 };
+
 protected:
     /// This method is separated from the rest to be able to use custom/optimized versions depending on the types of vectors.
     /// It computes: p = p*beta + r
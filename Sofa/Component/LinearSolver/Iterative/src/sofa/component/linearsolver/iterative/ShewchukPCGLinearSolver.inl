@@ -160,6 +160,13 @@ void ShewchukPCGLinearSolver<Matrix,Vector>::handleEvent(sofa::core::objectmodel
 }
 
 
+template<class TMatrix, class TVector>
+bool ShewchukPCGLinearSolver<TMatrix,TVector>::setRelativeTolerance(SReal tolerance)
+{
+    m_toleranceOverride = tolerance;
+    return true;
+}
+
 template<class TMatrix, class TVector>
 void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vector& b)
 {
@@ -182,7 +189,8 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
     const bool apply_precond = l_preconditioner.get()!=nullptr && d_use_precond.getValue();
 
     const double b_norm = b.dot(b);
-    const double tol = d_tolerance.getValue() * b_norm;
+    // d_tolerance is a criterion on the squared norms, whereas the override is on the relative residual |r|/|b|
+    const double tol = (m_toleranceOverride < 0 ? d_tolerance.getValue() : m_toleranceOverride * m_toleranceOverride) * b_norm;
 
     r = M * x;
     cgstep_beta(r,b,-1);// r = -1 * r + b  =   b - (M * x)
@@ -242,6 +250,7 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
     vtmp.deleteTempVector(&s);
 
     sofa::helper::AdvancedTimer::valSet("PCG iterations", iter);
+    m_nbIterationsOfLastSolve = iter;
 }
 
 } // namespace sofa::component::linearsolver::iterative
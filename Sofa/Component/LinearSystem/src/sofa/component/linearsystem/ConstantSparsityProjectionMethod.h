@@ -22,12 +22,23 @@
 #pragma once
 #include <sofa/component/linearsystem/MatrixProjectionMethod.h>
 #include <sofa/simulation/ParallelSparseMatrixProduct.h>
+#include <map>
 
 namespace sofa::component::linearsystem
 {
 
 /**
  * Matrix prjection method computing the matrix projection taking advantage of the constant sparsity pattern
+ *
+ * The symbolic part of the products (which entries of J and K contribute to each entry of J^T*K*J)
+ * is computed once for each pair of top most parents. The following projections only refresh the
+ * values, optionally in parallel. It is suited for matrices of constant structure, such as the
+ * geometric stiffness of mappings.
+ *
+ * If the sparsity patterns are checked, the patterns of the matrices are compared to the ones used
+ * to build each product, and only the products whose inputs changed are recomputed symbolically.
+ * This allows to use the method for matrices whose structure changes from time to time, such as
+ * mapped contact stiffness.
  */
 template<class TMatrix>
 class ConstantSparsityProjectionMethod : public MatrixProjectionMethod<TMatrix>
@@ -41,12 +52,21 @@ public:
     ~ConstantSparsityProjectionMethod() override;
 
     Data<bool> d_parallelProduct; ///< Compute the matrix product in parallel
+    Data<bool> d_checkSparsityPattern; ///< Detect the changes of sparsity pattern of the matrices and recompute only the products affected by them. If false, the patterns are assumed constant.
 
     void init() override;
     void reinit() override;
 
 protected:
+    using Inherit1::computeProjection;
+
+    void computeProjection(
+        const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor> > KMap,
+        const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
+        Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J) override;
+
     void computeProjection(
+        const PairMechanicalStates& topMostParents,
         const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor> > KMap,
         const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
         Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J) override;
@@ -57,8 +77,28 @@ protected:
     using JT_Type = const Eigen::Transpose<const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor> > >;
     using JTKJ_Type = Eigen::SparseMatrix<Block, Eigen::RowMajor>;
 
-    std::unique_ptr<linearalgebra::SparseMatrixProduct< K_Type, J_Type, KJ_Type> > m_matrixProductKJ;
-    std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, KJ_Type, JTKJ_Type> > m_matrixProductJTKJ;
+    /// The cached products required to project the matrix toward a pair of top most parents
+    struct ProductPlan
+    {
+        std::unique_ptr<linearalgebra::SparseMatrixProduct< K_Type, J_Type, KJ_Type> > m_matrixProductKJ;
+        std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, KJ_Type, JTKJ_Type> > m_matrixProductJTKJ;
+        std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, K_Type, JTKJ_Type> > m_matrixProductJTK;
+    };
+
+    ProductPlan& getProductPlan(const PairMechanicalStates& topMostParents);
+
+    template<class Lhs, class Rhs, class Result>
+    std::unique_ptr<linearalgebra::SparseMatrixProduct<Lhs, Rhs, Result> > makeProduct() const;
+
+    /// Compute a product, recomputing its intersection if the sparsity pattern of an input changed
+    template<class Lhs, class Rhs, class Result>
+    void computeProduct(linearalgebra::SparseMatrixProduct<Lhs, Rhs, Result>& product);
+
+    /// A product plan for each pair of top most parents
+    std::map<PairMechanicalStates, ProductPlan> m_productPlans;
+
+    /// Task scheduler used to compute the products in parallel. Null if the products are sequential.
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
 };
 
 #if !defined(SOFA_COMPONENT_LINEARSYSTEM_CONSTANTSPARSITYPROJECTIONMETHOD_CPP)
@@ -33,6 +33,7 @@ namespace sofa::component::linearsystem
 template <class TMatrix>
 ConstantSparsityProjectionMethod<TMatrix>::ConstantSparsityProjectionMethod()
     : d_parallelProduct(initData(&d_parallelProduct, true, "parallelProduct", "Compute the matrix product in parallel"))
+    , d_checkSparsityPattern(initData(&d_checkSparsityPattern, true, "checkSparsityPattern", "Detect the changes of sparsity pattern of the matrices and recompute only the products affected by them. If false, the patterns are assumed constant."))
 {}
 
 template <class TMatrix>
@@ -44,85 +45,121 @@ void ConstantSparsityProjectionMethod<TMatrix>::init()
 {
     Inherit1::init();
 
+    m_taskScheduler = nullptr;
     if (d_parallelProduct.getValue())
     {
-        auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
-        taskScheduler->init();
-
-        auto* matrixPrductKJ = new sofa::simulation::ParallelSparseMatrixProduct<
-            K_Type, J_Type, KJ_Type>();
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        m_taskScheduler->init();
+    }
 
-        m_matrixProductKJ = std::unique_ptr<sofa::simulation::ParallelSparseMatrixProduct<
-            K_Type, J_Type, KJ_Type>>(matrixPrductKJ);
+    m_productPlans.clear();
+}
 
-        matrixPrductKJ->taskScheduler = taskScheduler;
+template <class TMatrix>
+void ConstantSparsityProjectionMethod<TMatrix>::reinit()
+{
+    Inherit1::reinit();
 
+    //cached products are invalidated
+    m_productPlans.clear();
+}
 
-        auto* matrixPrductJTKJ = new sofa::simulation::ParallelSparseMatrixProduct<
-            JT_Type, KJ_Type, JTKJ_Type>();
+template <class TMatrix>
+template <class Lhs, class Rhs, class Result>
+std::unique_ptr<linearalgebra::SparseMatrixProduct<Lhs, Rhs, Result> >
+ConstantSparsityProjectionMethod<TMatrix>::makeProduct() const
+{
+    if (m_taskScheduler)
+    {
+        auto product = std::make_unique<sofa::simulation::ParallelSparseMatrixProduct<Lhs, Rhs, Result> >();
+        product->taskScheduler = m_taskScheduler;
+        return product;
+    }
+    return std::make_unique<sofa::linearalgebra::SparseMatrixProduct<Lhs, Rhs, Result> >();
+}
 
-        m_matrixProductJTKJ = std::unique_ptr<sofa::simulation::ParallelSparseMatrixProduct<
-            JT_Type, KJ_Type, JTKJ_Type>>(matrixPrductJTKJ);
+template <class TMatrix>
+template <class Lhs, class Rhs, class Result>
+void ConstantSparsityProjectionMethod<TMatrix>::computeProduct(linearalgebra::SparseMatrixProduct<Lhs, Rhs, Result>& product)
+{
+    // A product computed for the first time has no intersection yet: it is computed in any case
+    const bool hasPatternChanged = d_checkSparsityPattern.getValue() && !product.hasSameSparsityPattern();
+    msg_info_when(hasPatternChanged && product.getProductResult().nonZeros() > 0) << "Sparsity pattern changed: the product is recomputed";
+    product.computeProduct(hasPatternChanged);
+}
 
-        matrixPrductJTKJ->taskScheduler = taskScheduler;
-    }
-    else
+template <class TMatrix>
+auto ConstantSparsityProjectionMethod<TMatrix>::getProductPlan(const PairMechanicalStates& topMostParents)
+-> ProductPlan&
+{
+    auto it = m_productPlans.find(topMostParents);
+    if (it == m_productPlans.end())
     {
-        m_matrixProductKJ = std::make_unique<sofa::linearalgebra::SparseMatrixProduct<
-            K_Type, J_Type, KJ_Type>>();
-
-        m_matrixProductJTKJ = std::make_unique<sofa::linearalgebra::SparseMatrixProduct<
-            JT_Type, KJ_Type, JTKJ_Type>>();
+        ProductPlan plan;
+        plan.m_matrixProductKJ = makeProduct<K_Type, J_Type, KJ_Type>();
+        plan.m_matrixProductJTKJ = makeProduct<JT_Type, KJ_Type, JTKJ_Type>();
+        plan.m_matrixProductJTK = makeProduct<JT_Type, K_Type, JTKJ_Type>();
+        it = m_productPlans.emplace(topMostParents, std::move(plan)).first;
     }
+    return it->second;
 }
 
 template <class TMatrix>
-void ConstantSparsityProjectionMethod<TMatrix>::reinit()
+void ConstantSparsityProjectionMethod<TMatrix>::computeProjection(
+    const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor>> KMap,
+    const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
+    Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J)
 {
-    Inherit1::reinit();
-
-    //cached products are invalidated
-    m_matrixProductKJ->invalidateIntersection();
-    m_matrixProductJTKJ->invalidateIntersection();
+    computeProjection({this->l_mechanicalStates[0], this->l_mechanicalStates[1]}, KMap, J, JT_K_J);
 }
 
 template <class TMatrix>
 void ConstantSparsityProjectionMethod<TMatrix>::computeProjection(
+    const PairMechanicalStates& topMostParents,
     const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor>> KMap,
     const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
     Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J)
 {
+    // The products depend on the pair of top most parents: the intersections computed for a pair
+    // cannot be reused for another one.
+    ProductPlan& plan = getProductPlan(topMostParents);
+
     if (J[0] && J[1])
     {
         const auto JMap0 = this->makeEigenMap(*J[0]);
         const auto JMap1 = this->makeEigenMap(*J[1]);
 
-        m_matrixProductKJ->m_lhs = &KMap;
-        m_matrixProductKJ->m_rhs = &JMap1;
-        m_matrixProductKJ->computeProduct();
+        plan.m_matrixProductKJ->m_lhs = &KMap;
+        plan.m_matrixProductKJ->m_rhs = &JMap1;
+        computeProduct(*plan.m_matrixProductKJ);
 
         const JT_Type JMap0T = JMap0.transpose();
-        m_matrixProductJTKJ->m_lhs = &JMap0T;
-        m_matrixProductJTKJ->m_rhs = &m_matrixProductKJ->getProductResult();
-        m_matrixProductJTKJ->computeProduct();
+        plan.m_matrixProductJTKJ->m_lhs = &JMap0T;
+        plan.m_matrixProductJTKJ->m_rhs = &plan.m_matrixProductKJ->getProductResult();
+        computeProduct(*plan.m_matrixProductJTKJ);
 
-        JT_K_J = m_matrixProductJTKJ->getProductResult();
+        JT_K_J = plan.m_matrixProductJTKJ->getProductResult();
     }
     else if (J[0] && !J[1])
     {
         const auto JMap0 = this->makeEigenMap(*J[0]);
-        JT_K_J = JMap0.transpose() * KMap;
+
+        const JT_Type JMap0T = JMap0.transpose();
+        plan.m_matrixProductJTK->m_lhs = &JMap0T;
+        plan.m_matrixProductJTK->m_rhs = &KMap;
+        computeProduct(*plan.m_matrixProductJTK);
+
+        JT_K_J = plan.m_matrixProductJTK->getProductResult();
     }
     else if (!J[0] && J[1])
     {
         const auto JMap1 = this->makeEigenMap(*J[1]);
 
-        m_matrixProductKJ->m_lhs = &KMap;
-        m_matrixProductKJ->m_rhs = &JMap1;
-
-        m_matrixProductKJ->computeProduct();
+        plan.m_matrixProductKJ->m_lhs = &KMap;
+        plan.m_matrixProductKJ->m_rhs = &JMap1;
+        computeProduct(*plan.m_matrixProductKJ);
 
-        JT_K_J = m_matrixProductKJ->getProductResult();
+        JT_K_J = plan.m_matrixProductKJ->getProductResult();
     }
     else
     {
@@ -98,6 +98,13 @@ protected:
         const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
         Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J);
 
+    /// Compute the projection toward a pair of top most parents. By default, the pair is ignored.
+    virtual void computeProjection(
+        const PairMechanicalStates& topMostParents,
+        const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor> > KMap,
+        const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
+        Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J);
+
     Data<bool> d_areJacobiansConstant; ///< True if mapping jacobians are considered constant over time. They are computed only the first time.
 
     std::optional<sofa::type::fixed_array<MappingJacobians<TMatrix>, 2>> m_mappingJacobians;
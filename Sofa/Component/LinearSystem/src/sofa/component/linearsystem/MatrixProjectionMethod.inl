@@ -27,6 +27,7 @@
 #include <sofa/core/MechanicalParams.h>
 #include <sofa/simulation/mechanicalvisitor/MechanicalResetConstraintVisitor.h>
 #include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
 #include <Eigen/Sparse>
 
 
@@ -64,7 +65,7 @@ void computeProjection(
     Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J);
 
 template <class BlockType>
-void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, Eigen::SparseMatrix<BlockType, Eigen::RowMajor> JT_K_J, const type::Vec2u positionInGlobalMatrix);
+void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, const Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J, const type::Vec2u positionInGlobalMatrix);
 
 template <class TMatrix>
 void MatrixProjectionMethod<TMatrix>::addMappedMatrixToGlobalMatrixEigen(
@@ -138,8 +139,11 @@ void MatrixProjectionMethod<TMatrix>::addMappedMatrixToGlobalMatrixEigen(
                     << "[J1] Incompatible matrix size [cols] " << J[1]->cols() << " " << b->BaseMechanicalState::getMatrixSize();
         }
 
+        // timings are reported for each chain of mappings, from the mapped states to the top most parents
+        helper::ScopedAdvancedTimer chainTimer("projection " + this->getName() + " -> " + a->getName() + "/" + b->getName());
+
         Eigen::SparseMatrix<Block, Eigen::RowMajor> JT_K_J;
-        computeProjection(KMap, J, JT_K_J);
+        computeProjection({a, b}, KMap, J, JT_K_J);
 
         const type::Vec2u positionInGlobalMatrix = mappingGraph.getPositionInGlobalMatrix(a, b);
 
@@ -189,8 +193,19 @@ void MatrixProjectionMethod<TMatrix>::computeProjection(
     }
 }
 
+template <class TMatrix>
+void MatrixProjectionMethod<TMatrix>::computeProjection(
+    const PairMechanicalStates& topMostParents,
+    const Eigen::Map<Eigen::SparseMatrix<Block, Eigen::RowMajor>> KMap,
+    const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
+    Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J)
+{
+    SOFA_UNUSED(topMostParents);
+    computeProjection(KMap, J, JT_K_J);
+}
+
 template <class BlockType>
-void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, Eigen::SparseMatrix<BlockType, Eigen::RowMajor> JT_K_J, const type::Vec2u positionInGlobalMatrix)
+void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, const Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J, const type::Vec2u positionInGlobalMatrix)
 {
     for (int k = 0; k < JT_K_J.outerSize(); ++k)
     {
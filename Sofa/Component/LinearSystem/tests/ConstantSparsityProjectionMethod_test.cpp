@@ -0,0 +1,115 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsystem/ConstantSparsityProjectionMethod.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+
+namespace
+{
+
+using Matrix = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+using EigenMatrix = Eigen::SparseMatrix<SReal, Eigen::RowMajor>;
+
+/// Expose the protected projection of the component
+class TestConstantSparsityProjectionMethod : public sofa::component::linearsystem::ConstantSparsityProjectionMethod<Matrix>
+{
+public:
+    SOFA_CLASS(TestConstantSparsityProjectionMethod, sofa::component::linearsystem::ConstantSparsityProjectionMethod<Matrix>);
+
+    using Inherit1::computeProjection;
+    using Inherit1::getProductPlan;
+    using Inherit1::makeEigenMap;
+    using Inherit1::m_productPlans;
+};
+
+/// A matrix of the given size, with an entry on each row and the given number of entries per row
+std::shared_ptr<Matrix> makeMatrix(sofa::Index nbRows, sofa::Index nbCols, sofa::Index nbEntriesPerRow, sofa::Index shift, SReal scale)
+{
+    auto matrix = std::make_shared<Matrix>();
+    matrix->resize(nbRows, nbCols);
+    for (sofa::Index i = 0; i < nbRows; ++i)
+    {
+        for (sofa::Index k = 0; k < nbEntriesPerRow; ++k)
+        {
+            const sofa::Index j = (i + shift + k * 2) % nbCols;
+            matrix->add(i, j, scale * std::sin(1.0 + i + 3.0 * j));
+        }
+    }
+    matrix->compress();
+    return matrix;
+}
+
+EigenMatrix toEigen(const Eigen::Map<EigenMatrix>& map)
+{
+    return EigenMatrix(map);
+}
+
+}
+
+TEST(ConstantSparsityProjectionMethod, productPlanPerTopMostParents)
+{
+    const auto method = sofa::core::objectmodel::New<TestConstantSparsityProjectionMethod>();
+    method->d_parallelProduct.setValue(false);
+    // the patterns are assumed constant: each pair of top most parents must have its own products
+    method->d_checkSparsityPattern.setValue(false);
+    method->init();
+
+    const auto state0 = sofa::core::objectmodel::New<sofa::component::statecontainer::MechanicalObject<sofa::defaulttype::Vec3Types> >();
+    const auto state1 = sofa::core::objectmodel::New<sofa::component::statecontainer::MechanicalObject<sofa::defaulttype::Vec3Types> >();
+    const TestConstantSparsityProjectionMethod::PairMechanicalStates pairA { state0.get(), state0.get() };
+    const TestConstantSparsityProjectionMethod::PairMechanicalStates pairB { state0.get(), state1.get() };
+
+    const auto K = makeMatrix(8, 8, 2, 0, 1.0);
+    const auto JA = makeMatrix(8, 5, 1, 0, 1.0);
+    const auto JB = makeMatrix(8, 6, 2, 3, 1.0);
+
+    const auto KMap = method->makeEigenMap(*K);
+    const auto JAMap = method->makeEigenMap(*JA);
+    const auto JBMap = method->makeEigenMap(*JB);
+
+    EigenMatrix JT_K_J_A, JT_K_J_B;
+    method->computeProjection(pairA, KMap, {JA, JA}, JT_K_J_A);
+    method->computeProjection(pairB, KMap, {JA, JB}, JT_K_J_B);
+
+    EXPECT_EQ(method->m_productPlans.size(), 2);
+    EXPECT_NE(&method->getProductPlan(pairA), &method->getProductPlan(pairB));
+
+    const EigenMatrix expectedA = toEigen(JAMap).transpose() * toEigen(KMap) * toEigen(JAMap);
+    const EigenMatrix expectedB = toEigen(JAMap).transpose() * toEigen(KMap) * toEigen(JBMap);
+    EXPECT_LT((EigenMatrix(JT_K_J_A) - expectedA).norm(), 1e-12);
+    EXPECT_LT((EigenMatrix(JT_K_J_B) - expectedB).norm(), 1e-12);
+
+    // New values, same sparsity: the cached products are reused and give the same result as an uncached product
+    const auto K2 = makeMatrix(8, 8, 2, 0, -3.0);
+    const auto K2Map = method->makeEigenMap(*K2);
+    method->computeProjection(pairA, K2Map, {JA, JA}, JT_K_J_A);
+    method->computeProjection(pairB, K2Map, {JA, JB}, JT_K_J_B);
+
+    EXPECT_EQ(method->m_productPlans.size(), 2);
+
+    const EigenMatrix uncachedA = toEigen(JAMap).transpose() * toEigen(K2Map) * toEigen(JAMap);
+    const EigenMatrix uncachedB = toEigen(JAMap).transpose() * toEigen(K2Map) * toEigen(JBMap);
+    EXPECT_GT(uncachedA.norm(), 0);
+    EXPECT_LT((EigenMatrix(JT_K_J_A) - uncachedA).norm(), 1e-12);
+    EXPECT_LT((EigenMatrix(JT_K_J_B) - uncachedB).norm(), 1e-12);
+}
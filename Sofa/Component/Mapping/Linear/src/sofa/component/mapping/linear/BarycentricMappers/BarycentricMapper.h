@@ -73,6 +73,17 @@ public:
     virtual void applyOnePoint( const Index& hexaId, typename Out::VecCoord& out, const typename In::VecCoord& in);
     virtual void clear( std::size_t reserve=0 ) =0;
 
+    /// Allow init() to locate the output points in the input elements in parallel, if the mapper supports it
+    void setParallelInit(bool parallel) { m_parallelInit = parallel; }
+    bool isParallelInit() const { return m_parallelInit; }
+
+    /// Allow apply, applyJ and applyJT to process the points in parallel, if the mapper supports it
+    void setParallelApply(bool parallel) { m_parallelApply = parallel; }
+    bool isParallelApply() const { return m_parallelApply; }
+
+    /// Incremented each time the matrix returned by getJ is rebuilt
+    int getJacobianRevision() const { return m_jacobianRevision; }
+
     inline friend std::istream& operator >> ( std::istream& in, BarycentricMapper< In, Out > & ) {return in;}
     inline friend std::ostream& operator << ( std::ostream& out, const BarycentricMapper< In, Out > &  ) { return out; }
 
@@ -121,6 +132,10 @@ protected:
     BarycentricMapper() {}
     ~BarycentricMapper() override {}
 
+    bool m_parallelInit {false};
+    bool m_parallelApply {false};
+    int m_jacobianRevision {0};
+
 private:
     BarycentricMapper(const BarycentricMapper& n) ;
     BarycentricMapper& operator=(const BarycentricMapper& n) ;
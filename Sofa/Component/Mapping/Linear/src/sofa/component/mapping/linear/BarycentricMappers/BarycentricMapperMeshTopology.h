@@ -21,6 +21,8 @@
 ******************************************************************************/
 #pragma once
 #include <sofa/component/mapping/linear/BarycentricMappers/TopologyBarycentricMapper.h>
+#include <sofa/component/mapping/linear/BarycentricMappers/ElementSpatialIndex.h>
+#include <sofa/component/mapping/linear/SparseWeightMatrix.h>
 
 namespace sofa::component::mapping::linear
 {
@@ -97,10 +99,36 @@ protected:
 
     MatrixType* m_matrixJ {nullptr};
     bool        m_updateJ {false};
+
+    /// Weights of the input points for each output point, used by apply, applyJ, applyJT and getJ
+    SparseWeightMatrix<Real> m_weights;
+    bool        m_updateWeights {true};
+    std::size_t m_weightsNbInputs {0};         ///< number of input points when m_weights was built
+    int         m_weightsTopologyRevision {-1}; ///< revision of the topology when m_weights was built
+
+    /// Rebuild m_weights from the maps if they, the topology or the number of input points changed since the last call.
+    /// Return true if the weights have been rebuilt.
+    bool updateWeights(std::size_t nbInputs);
 private:
     void clearMap1dAndReserve(std::size_t size=0);
     void clearMap2dAndReserve(std::size_t size=0);
     void clearMap3dAndReserve(std::size_t size=0);
+
+    /// Call f(i) for i in [0, size), in parallel if the parallel initialization is enabled
+    template<class F>
+    void forEachIndex(std::size_t size, const F& f) const;
+
+    /// Bounding box of the points origin + frame^T * c, for c in corners
+    static void computeElementBox(const type::Vec3& origin, const Mat3x3& frame, const type::vector<type::Vec3>& corners,
+                                  type::Vec3& boxMin, type::Vec3& boxMax);
+
+    /// For each output point, find the element of lowest distance measure and the local coordinates of
+    /// the point in it. The elements containing the point are found using the spatial index, and the
+    /// element with the nearest center is used when no element contains the point.
+    template<class Distance>
+    void locatePoints(const typename Out::VecCoord& out, const ElementSpatialIndex& elementIndex,
+                      const type::vector<type::Matrix3>& bases, const type::vector<type::Vec3>& origins,
+                      const Distance& distance, type::vector<Index>& indices, type::vector<type::Vec3>& coefs) const;
 };
 
 #if !defined(SOFA_COMPONENT_MAPPING_BARYCENTRICMAPPERMESHTOPOLOGY_CPP)
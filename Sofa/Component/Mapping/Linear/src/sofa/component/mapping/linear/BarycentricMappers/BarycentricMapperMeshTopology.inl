@@ -25,6 +25,8 @@
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/State.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::mapping::linear
 {
@@ -67,6 +69,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::init ( const typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
     m_updateJ = true;
+    m_updateWeights = true;
 
     const SeqTetrahedra& tetras = this->m_fromTopology->getTetrahedra();
     const SeqHexahedra& hexas = this->m_fromTopology->getHexahedra();
@@ -75,6 +78,23 @@ void BarycentricMapperMeshTopology<In,Out>::init ( const typename Out::VecCoord&
     const SeqQuads& quads = this->m_fromTopology->getQuads();
     type::vector<Matrix3> bases;
     type::vector<Vec3> centers;
+    type::vector<Vec3> origins;
+    type::vector<Vec3> boxMin;
+    type::vector<Vec3> boxMax;
+    type::vector<Index> indices;
+    type::vector<Vec3> coefs;
+    ElementSpatialIndex elementIndex;
+
+    // Local coordinates delimiting the region where a point is considered inside an element
+    static const type::vector<Vec3> triangleCorners {
+        Vec3(0,0,-0.01), Vec3(1,0,-0.01), Vec3(0,1,-0.01), Vec3(0,0,0.01), Vec3(1,0,0.01), Vec3(0,1,0.01) };
+    static const type::vector<Vec3> quadCorners {
+        Vec3(0,0,-0.01), Vec3(1,0,-0.01), Vec3(0,1,-0.01), Vec3(1,1,-0.01), Vec3(0,0,0.01), Vec3(1,0,0.01), Vec3(0,1,0.01), Vec3(1,1,0.01) };
+    static const type::vector<Vec3> tetraCorners {
+        Vec3(0,0,0), Vec3(1,0,0), Vec3(0,1,0), Vec3(0,0,1) };
+    static const type::vector<Vec3> hexaCorners {
+        Vec3(0,0,0), Vec3(1,0,0), Vec3(0,1,0), Vec3(1,1,0), Vec3(0,0,1), Vec3(1,0,1), Vec3(0,1,1), Vec3(1,1,1) };
+
     if ( tetras.empty() && hexas.empty() )
     {
         if ( triangles.empty() && quads.empty() )
@@ -114,123 +134,204 @@ void BarycentricMapperMeshTopology<In,Out>::init ( const typename Out::VecCoord&
         else
         {
             clearMap2dAndReserve ( (out.size()) );
-            Size nbTriangles = Size(triangles.size());
-            bases.resize ( triangles.size() +quads.size() );
-            centers.resize ( triangles.size() +quads.size() );
-            for ( std::size_t t = 0; t < triangles.size(); t++ )
+            const Size nbTriangles = Size(triangles.size());
+            const Size nbElements = nbTriangles + Size(quads.size());
+            bases.resize ( nbElements );
+            centers.resize ( nbElements );
+            origins.resize ( nbElements );
+            boxMin.resize ( nbElements );
+            boxMax.resize ( nbElements );
+            forEachIndex ( nbElements, [&](std::size_t e)
             {
                 Mat3x3 m,mt;
-                m[0] = in[triangles[t][1]]-in[triangles[t][0]];
-                m[1] = in[triangles[t][2]]-in[triangles[t][0]];
-                m[2] = cross ( m[0],m[1] );
+                if ( e < nbTriangles )
+                {
+                    const Triangle& t = triangles[e];
+                    m[0] = in[t[1]]-in[t[0]];
+                    m[1] = in[t[2]]-in[t[0]];
+                    m[2] = cross ( m[0],m[1] );
+                    centers[e] = ( in[t[0]]+in[t[1]]+in[t[2]] ) /3;
+                    origins[e] = in[t[0]];
+                    computeElementBox ( origins[e], m, triangleCorners, boxMin[e], boxMax[e] );
+                }
+                else
+                {
+                    const Quad& q = quads[e-nbTriangles];
+                    m[0] = in[q[1]]-in[q[0]];
+                    m[1] = in[q[3]]-in[q[0]];
+                    m[2] = cross ( m[0],m[1] );
+                    centers[e] = ( in[q[0]]+in[q[1]]+in[q[2]]+in[q[3]] ) *0.25;
+                    origins[e] = in[q[0]];
+                    computeElementBox ( origins[e], m, quadCorners, boxMin[e], boxMax[e] );
+                }
                 mt.transpose ( m );
-                const bool canInvert = bases[t].invert ( mt );
+                const bool canInvert = bases[e].invert ( mt );
                 assert(canInvert);
                 SOFA_UNUSED(canInvert);
-                centers[t] = ( in[triangles[t][0]]+in[triangles[t][1]]+in[triangles[t][2]] ) /3;
-            }
-            for ( std::size_t q = 0; q < quads.size(); q++ )
+            });
+            elementIndex.build ( boxMin, boxMax, centers );
+
+            locatePoints ( out, elementIndex, bases, origins, [nbTriangles](Index e, const Vec3& v)
             {
-                Mat3x3 m,mt;
-                m[0] = in[quads[q][1]]-in[quads[q][0]];
-                m[1] = in[quads[q][3]]-in[quads[q][0]];
-                m[2] = cross ( m[0],m[1] );
-                mt.transpose ( m );
-                const bool canInvert = bases[nbTriangles+q].invert ( mt );
-                assert(canInvert);
-                SOFA_UNUSED(canInvert);
-                centers[nbTriangles+q] = ( in[quads[q][0]]+in[quads[q][1]]+in[quads[q][2]]+in[quads[q][3]] ) *0.25;
-            }
+                if ( e < nbTriangles )
+                    return std::max ( std::max (SReal(-v[0]), SReal(-v[1]) ),std::max ( SReal( ( v[2]<0?-v[2]:v[2] )-0.01), SReal(v[0]+v[1]-1 )));
+                return std::max ( std::max (SReal(-v[0]), SReal(-v[1])),std::max ( std::max (SReal(v[1]-1), SReal(v[0]-1)),std::max (SReal(v[2]-0.01), SReal(-v[2]-0.01) ) ) );
+            }, indices, coefs );
+
             for ( std::size_t i=0; i<out.size(); i++ )
             {
-                const auto outPos = Out::getCPos(out[i]);
-                sofa::type::Vec3 coefs;
-                Index index = sofa::InvalidID;
-                SReal distance = 1e10;
-                for ( Index t = 0; t < triangles.size(); t++ )
-                {
-                    const auto v = bases[t] * ( outPos - in[triangles[t][0]] );
-                    SReal d = std::max ( std::max (SReal(-v[0]), SReal(-v[1]) ),std::max ( SReal( ( v[2]<0?-v[2]:v[2] )-0.01), SReal(v[0]+v[1]-1 )));
-                    if ( d>0 ) d = ( outPos-centers[t] ).norm2();
-                    if ( d<distance ) { coefs = v; distance = d; index = (t); }
-                }
-                for ( Index q = 0; q < quads.size(); q++ )
-                {
-                    const auto v = bases[nbTriangles+q] * ( outPos - in[quads[q][0]] );
-                    SReal d = std::max ( std::max (SReal(-v[0]), SReal(-v[1])),std::max ( std::max (SReal(v[1]-1), SReal(v[0]-1)),std::max (SReal(v[2]-0.01), SReal(-v[2]-0.01) ) ) );
-                    if ( d>0 ) d = ( outPos-centers[nbTriangles+q] ).norm2();
-                    if ( d<distance ) { coefs = v; distance = d; index = nbTriangles+q; }
-                }
-                if ( index < (nbTriangles) )
-                    addPointInTriangle ( index, coefs.ptr() );
+                if ( indices[i] < nbTriangles )
+                    addPointInTriangle ( indices[i], coefs[i].ptr() );
                 else
-                    addPointInQuad ( index-nbTriangles, coefs.ptr() );
+                    addPointInQuad ( indices[i]-nbTriangles, coefs[i].ptr() );
             }
         }
     }
     else
     {
         clearMap3dAndReserve ( out.size() );
-        Size nbTetras = Size(tetras.size());
-        bases.resize ( tetras.size() + hexas.size() );
-        centers.resize ( tetras.size() + hexas.size() );
-        for ( std::size_t t = 0; t < tetras.size(); t++ )
+        const Size nbTetras = Size(tetras.size());
+        const Size nbElements = nbTetras + Size(hexas.size());
+        bases.resize ( nbElements );
+        centers.resize ( nbElements );
+        origins.resize ( nbElements );
+        boxMin.resize ( nbElements );
+        boxMax.resize ( nbElements );
+        forEachIndex ( nbElements, [&](std::size_t e)
         {
             Mat3x3 m,mt;
-            m[0] = in[tetras[t][1]]-in[tetras[t][0]];
-            m[1] = in[tetras[t][2]]-in[tetras[t][0]];
-            m[2] = in[tetras[t][3]]-in[tetras[t][0]];
+            if ( e < nbTetras )
+            {
+                const Tetra& t = tetras[e];
+                m[0] = in[t[1]]-in[t[0]];
+                m[1] = in[t[2]]-in[t[0]];
+                m[2] = in[t[3]]-in[t[0]];
+                centers[e] = ( in[t[0]]+in[t[1]]+in[t[2]]+in[t[3]] ) *0.25;
+                origins[e] = in[t[0]];
+                computeElementBox ( origins[e], m, tetraCorners, boxMin[e], boxMax[e] );
+            }
+            else
+            {
+                const Hexa& h = hexas[e-nbTetras];
+                m[0] = in[h[1]]-in[h[0]];
+                m[1] = in[h[3]]-in[h[0]];
+                m[2] = in[h[4]]-in[h[0]];
+                centers[e] = ( in[h[0]]+in[h[1]]+in[h[2]]+in[h[3]]+in[h[4]]+in[h[5]]+in[h[6]]+in[h[7]] ) *0.125;
+                origins[e] = in[h[0]];
+                computeElementBox ( origins[e], m, hexaCorners, boxMin[e], boxMax[e] );
+            }
             mt.transpose ( m );
-            const bool canInvert = bases[t].invert ( mt );
+            const bool canInvert = bases[e].invert ( mt );
             assert(canInvert);
             SOFA_UNUSED(canInvert);
-            centers[t] = ( in[tetras[t][0]]+in[tetras[t][1]]+in[tetras[t][2]]+in[tetras[t][3]] ) *0.25;
-        }
-        for ( std::size_t h = 0; h < hexas.size(); h++ )
+        });
+        elementIndex.build ( boxMin, boxMax, centers );
+
+        locatePoints ( out, elementIndex, bases, origins, [nbTetras](Index e, const Vec3& v)
         {
-            Mat3x3 m,mt;
-            m[0] = in[hexas[h][1]]-in[hexas[h][0]];
-            m[1] = in[hexas[h][3]]-in[hexas[h][0]];
-            m[2] = in[hexas[h][4]]-in[hexas[h][0]];
-            mt.transpose ( m );
-            const bool canInvert = bases[nbTetras+h].invert ( mt );
-            assert(canInvert);
-            SOFA_UNUSED(canInvert);
-            centers[nbTetras+h] = ( in[hexas[h][0]]+in[hexas[h][1]]+in[hexas[h][2]]+in[hexas[h][3]]+in[hexas[h][4]]+in[hexas[h][5]]+in[hexas[h][6]]+in[hexas[h][7]] ) *0.125;
-        }
+            if ( e < nbTetras )
+                return std::max ( std::max ( SReal(-v[0]), SReal(-v[1]) ),std::max (SReal(-v[2]), SReal(v[0]+v[1]+v[2]-1) ) );
+            return std::max ( std::max (SReal(-v[0]), SReal(-v[1]) ),std::max ( std::max (SReal(-v[2]), SReal(v[0]-1) ),std::max (SReal(v[1]-1), SReal(v[2]-1) ) ) );
+        }, indices, coefs );
+
         for ( std::size_t i=0; i<out.size(); i++ )
         {
-            auto pos = Out::getCPos(out[i]);
-            sofa::type::Vec3 coefs;
-            Index index = sofa::InvalidID;
-            double distance = 1e10;
-            for (Index t = 0; t < tetras.size(); t++ )
-            {
-                const auto v = bases[t] * ( pos - in[tetras[t][0]] );
-                SReal d = std::max ( std::max ( SReal(-v[0]), SReal(-v[1]) ),std::max (SReal(-v[2]), SReal(v[0]+v[1]+v[2]-1) ) );
-                if ( d>0 ) d = ( pos-centers[t] ).norm2();
-                if ( d<distance ) { coefs = v; distance = d; index = (t); }
-            }
-            for (Index h = 0; h < hexas.size(); h++ )
-            {
-                const auto v = bases[nbTetras+h] * ( pos - in[hexas[h][0]] );
-                SReal d = std::max ( std::max (SReal(-v[0]), SReal(-v[1]) ),std::max ( std::max (SReal(-v[2]), SReal(v[0]-1) ),std::max (SReal(v[1]-1), SReal(v[2]-1) ) ) );
-                if ( d>0 ) d = ( pos-centers[nbTetras+h] ).norm2();
-                if ( d<distance ) { coefs = v; distance = d; index = (nbTetras+h); }
-            }
-            if ( index < (nbTetras) )
-                addPointInTetra ( index, coefs.ptr() );
+            if ( indices[i] < nbTetras )
+                addPointInTetra ( indices[i], coefs[i].ptr() );
             else
-                addPointInCube ( index-nbTetras, coefs.ptr() );
+                addPointInCube ( indices[i]-nbTetras, coefs[i].ptr() );
         }
     }
 }
 
 
+template <class In, class Out>
+template <class F>
+void BarycentricMapperMeshTopology<In,Out>::forEachIndex ( std::size_t size, const F& f ) const
+{
+    const auto range = [&f](const simulation::Range<std::size_t>& r)
+    {
+        for ( std::size_t i = r.start; i < r.end; ++i )
+            f ( i );
+    };
+
+    if ( this->m_parallelInit )
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size, range);
+    }
+    else
+    {
+        range(simulation::Range<std::size_t>(0, size));
+    }
+}
+
+
+template <class In, class Out>
+void BarycentricMapperMeshTopology<In,Out>::computeElementBox ( const Vec3& origin, const Mat3x3& frame,
+                                                                const type::vector<Vec3>& corners,
+                                                                Vec3& boxMin, Vec3& boxMax )
+{
+    for ( std::size_t c = 0; c < corners.size(); c++ )
+    {
+        const Vec3 p = origin + frame[0]*corners[c][0] + frame[1]*corners[c][1] + frame[2]*corners[c][2];
+        for ( unsigned int i = 0; i < 3; i++ )
+        {
+            boxMin[i] = ( c == 0 ) ? p[i] : std::min ( boxMin[i], p[i] );
+            boxMax[i] = ( c == 0 ) ? p[i] : std::max ( boxMax[i], p[i] );
+        }
+    }
+}
+
+
+template <class In, class Out>
+template <class Distance>
+void BarycentricMapperMeshTopology<In,Out>::locatePoints ( const typename Out::VecCoord& out,
+                                                           const ElementSpatialIndex& elementIndex,
+                                                           const type::vector<Matrix3>& bases,
+                                                           const type::vector<Vec3>& origins,
+                                                           const Distance& distance,
+                                                           type::vector<Index>& indices,
+                                                           type::vector<Vec3>& coefs ) const
+{
+    indices.resize ( out.size() );
+    coefs.resize ( out.size() );
+
+    forEachIndex ( out.size(), [&](std::size_t i)
+    {
+        const Vec3 pos = Out::getCPos(out[i]);
+        Index index = sofa::InvalidID;
+        SReal nearest = 0;
+
+        // Among the elements containing the point, keep the one of lowest distance measure
+        elementIndex.forEachElementContaining ( pos, [&](Index e)
+        {
+            const Vec3 v = bases[e] * ( pos - origins[e] );
+            const SReal d = distance ( e, v );
+            if ( d <= 0 && ( index == sofa::InvalidID || d < nearest ) ) { coefs[i] = v; nearest = d; index = e; }
+        });
+
+        // Outside of the mesh, the point is mapped to the element with the nearest center
+        if ( index == sofa::InvalidID )
+        {
+            index = elementIndex.findNearestCenter ( pos );
+            coefs[i] = bases[index] * ( pos - origins[index] );
+        }
+        indices[i] = index;
+    });
+}
+
+
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap1dAndReserve ( std::size_t size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map1d.clear();
     if ( size>0 ) m_map1d.reserve ( size );
 }
@@ -240,6 +341,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap2dAndReserve ( std::size_t size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map2d.clear();
     if ( size>0 ) m_map2d.reserve ( size );
 }
@@ -249,6 +351,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap3dAndReserve ( std::size_t size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map3d.clear();
     if ( size>0 ) m_map3d.reserve ( size );
 }
@@ -258,6 +361,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clear ( std::size_t size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     clearMap1dAndReserve(size);
     clearMap2dAndReserve(size);
     clearMap3dAndReserve(size);
@@ -698,18 +802,13 @@ void BarycentricMapperMeshTopology<In,Out>::draw  (const core::visual::VisualPar
 }
 
 template <class In, class Out>
-const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::getJ(int outSize, int inSize)
+bool BarycentricMapperMeshTopology<In,Out>::updateWeights(std::size_t nbInputs)
 {
-
-    if (m_matrixJ && !m_updateJ && m_matrixJ->rowBSize() == (MatrixTypeIndex)outSize && m_matrixJ->colBSize() == (MatrixTypeIndex)inSize)
-        return m_matrixJ;
-    if (outSize > 0 && m_map1d.size()+m_map2d.size()+m_map3d.size() == 0)
-        return nullptr; // error: maps not yet created ?
-    if (!m_matrixJ) m_matrixJ = new MatrixType;
-    if (m_matrixJ->rowBSize() != (MatrixTypeIndex)outSize || m_matrixJ->colBSize() != (MatrixTypeIndex)inSize)
-        m_matrixJ->resize(outSize*NOut, inSize*NIn);
-    else
-        m_matrixJ->clear();
+    // m_weights.cols() may exceed nbInputs if an element refers to a point out of the input range
+    const int topologyRevision = this->m_fromTopology->getRevision();
+    if (!m_updateWeights && m_weights.rows() == m_map1d.size()+m_map2d.size()+m_map3d.size()
+        && m_weightsNbInputs == nbInputs && m_weightsTopologyRevision == topologyRevision)
+        return false;
 
     const SeqLines& lines = this->m_fromTopology->getLines();
     const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
@@ -717,21 +816,19 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::ge
     const SeqTetrahedra& tetrahedra = this->m_fromTopology->getTetrahedra();
     const SeqHexahedra& cubes = this->m_fromTopology->getHexahedra();
 
-    // Index of the current row. The matrix structure is composed of 3 parts: 1d elements first, then the 2d elements,
-    // and finally the 3d elements. This variable is incremented at each element, and never reinitialized, so the
-    // contributions go into the appropriate submatrix.
-    int rowId {};
+    // The rows are composed of 3 parts: 1d elements first, then the 2d elements, and finally the 3d elements.
+    m_weights.clear();
 
     // 1D elements
     {
         for ( const auto& map1d : m_map1d)
         {
-            const auto fx = map1d.baryCoords[0];
+            m_weights.addRow();
+            const Real fx = map1d.baryCoords[0];
             const auto index = map1d.in_index;
             const Edge& line = lines[index];
-            this->addMatrixContrib(m_matrixJ, rowId, line[0],  1 - fx);
-            this->addMatrixContrib(m_matrixJ, rowId, line[1],  fx);
-            ++rowId;
+            m_weights.addEntry(line[0], 1 - fx);
+            m_weights.addEntry(line[1], fx);
         }
     }
     // 2D elements
@@ -739,25 +836,25 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::ge
         const size_t c0 = triangles.size();
         for ( const auto& map2d : m_map2d)
         {
+            m_weights.addRow();
             const Real fx = map2d.baryCoords[0];
             const Real fy = map2d.baryCoords[1];
             const size_t index = map2d.in_index;
             if ( index < c0 )
             {
                 const Triangle& triangle = triangles[index];
-                this->addMatrixContrib(m_matrixJ, rowId, triangle[0],  ( 1-fx-fy ));
-                this->addMatrixContrib(m_matrixJ, rowId, triangle[1],  fx);
-                this->addMatrixContrib(m_matrixJ, rowId, triangle[2],  fy);
+                m_weights.addEntry(triangle[0], ( 1-fx-fy ));
+                m_weights.addEntry(triangle[1], fx);
+                m_weights.addEntry(triangle[2], fy);
             }
             else
             {
                 const Quad& quad = quads[index-c0];
-                this->addMatrixContrib(m_matrixJ, rowId, quad[0],  ( ( 1-fx ) * ( 1-fy ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, quad[1],  ( ( fx ) * ( 1-fy ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, quad[3],  ( ( 1-fx ) * ( fy ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, quad[2],  ( ( fx ) * ( fy ) ));
+                m_weights.addEntry(quad[0], ( ( 1-fx ) * ( 1-fy ) ));
+                m_weights.addEntry(quad[1], ( ( fx ) * ( 1-fy ) ));
+                m_weights.addEntry(quad[3], ( ( 1-fx ) * ( fy ) ));
+                m_weights.addEntry(quad[2], ( ( fx ) * ( fy ) ));
             }
-            ++rowId;
         }
     }
     // 3D elements
@@ -765,6 +862,7 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::ge
         const size_t c0 = tetrahedra.size();
         for ( const auto& map3d : m_map3d)
         {
+            m_weights.addRow();
             const Real fx = map3d.baryCoords[0];
             const Real fy = map3d.baryCoords[1];
             const Real fz = map3d.baryCoords[2];
@@ -772,223 +870,84 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::ge
             if ( index<c0 )
             {
                 const Tetra& tetra = tetrahedra[index];
-                this->addMatrixContrib(m_matrixJ, rowId, tetra[0],  ( 1-fx-fy-fz ));
-                this->addMatrixContrib(m_matrixJ, rowId, tetra[1],  fx);
-                this->addMatrixContrib(m_matrixJ, rowId, tetra[2],  fy);
-                this->addMatrixContrib(m_matrixJ, rowId, tetra[3],  fz);
+                m_weights.addEntry(tetra[0], ( 1-fx-fy-fz ));
+                m_weights.addEntry(tetra[1], fx);
+                m_weights.addEntry(tetra[2], fy);
+                m_weights.addEntry(tetra[3], fz);
             }
             else
             {
                 const Hexa& cube = cubes[index-c0];
 
-                this->addMatrixContrib(m_matrixJ, rowId, cube[0],  ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, cube[1],  ( ( fx ) * ( 1-fy ) * ( 1-fz ) ));
+                m_weights.addEntry(cube[0], ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) ));
+                m_weights.addEntry(cube[1], ( ( fx ) * ( 1-fy ) * ( 1-fz ) ));
 
-                this->addMatrixContrib(m_matrixJ, rowId, cube[3],  ( ( 1-fx ) * ( fy ) * ( 1-fz ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, cube[2],  ( ( fx ) * ( fy ) * ( 1-fz ) ));
+                m_weights.addEntry(cube[3], ( ( 1-fx ) * ( fy ) * ( 1-fz ) ));
+                m_weights.addEntry(cube[2], ( ( fx ) * ( fy ) * ( 1-fz ) ));
 
-                this->addMatrixContrib(m_matrixJ, rowId, cube[4],  ( ( 1-fx ) * ( 1-fy ) * ( fz ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, cube[5],  ( ( fx ) * ( 1-fy ) * ( fz ) ));
+                m_weights.addEntry(cube[4], ( ( 1-fx ) * ( 1-fy ) * ( fz ) ));
+                m_weights.addEntry(cube[5], ( ( fx ) * ( 1-fy ) * ( fz ) ));
 
-                this->addMatrixContrib(m_matrixJ, rowId, cube[7],  ( ( 1-fx ) * ( fy ) * ( fz ) ));
-                this->addMatrixContrib(m_matrixJ, rowId, cube[6],  ( ( fx ) * ( fy ) * ( fz ) ));
+                m_weights.addEntry(cube[7], ( ( 1-fx ) * ( fy ) * ( fz ) ));
+                m_weights.addEntry(cube[6], ( ( fx ) * ( fy ) * ( fz ) ));
             }
-            ++rowId;
         }
     }
-    assert(static_cast<std::size_t>(rowId) == m_map1d.size() + m_map2d.size() + m_map3d.size());
-
-    m_matrixJ->compress();
-    m_updateJ = false;
-    return m_matrixJ;
+    m_weights.finalize(nbInputs);
+    m_weightsNbInputs = nbInputs;
+    m_weightsTopologyRevision = topologyRevision;
+    m_updateWeights = false;
+    return true;
 }
 
 
 template <class In, class Out>
-void BarycentricMapperMeshTopology<In,Out>::applyJT ( typename In::VecDeriv& out, const typename Out::VecDeriv& in )
+const sofa::linearalgebra::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::getJ(int outSize, int inSize)
 {
-    const SeqLines& lines = this->m_fromTopology->getLines();
-    const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
-    const SeqQuads& quads = this->m_fromTopology->getQuads();
-    const SeqTetrahedra& tetrahedra = this->m_fromTopology->getTetrahedra();
-    const SeqHexahedra& cubes = this->m_fromTopology->getHexahedra();
+    if (updateWeights(std::size_t(inSize)))
+        m_updateJ = true;
 
-    const size_t i1d = m_map1d.size();
-    const size_t i2d = m_map2d.size();
-    const size_t i3d = m_map3d.size();
+    if (m_matrixJ && !m_updateJ && m_matrixJ->rowBSize() == (MatrixTypeIndex)outSize && m_matrixJ->colBSize() == (MatrixTypeIndex)inSize)
+        return m_matrixJ;
+    if (outSize > 0 && m_map1d.size()+m_map2d.size()+m_map3d.size() == 0)
+        return nullptr; // error: maps not yet created ?
+    if (!m_matrixJ) m_matrixJ = new MatrixType;
+    if (m_matrixJ->rowBSize() != (MatrixTypeIndex)outSize || m_matrixJ->colBSize() != (MatrixTypeIndex)inSize)
+        m_matrixJ->resize(outSize*NOut, inSize*NIn);
+    else
+        m_matrixJ->clear();
 
-    for( size_t i=0 ; i<in.size() ; ++i)
+    for (std::size_t rowId = 0; rowId < m_weights.rows(); ++rowId)
     {
-        // 1D elements
-        if (i < i1d)
+        m_weights.forEachEntry(rowId, [this, rowId](Index col, Real weight)
         {
-            const typename Out::DPos v = Out::getDPos(in[i]);
-            const OutReal fx = ( OutReal ) m_map1d[i].baryCoords[0];
-            const size_t index = m_map1d[i].in_index;
-            {
-                const Edge& line = lines[index];
-                out[line[0]] += v * ( 1-fx );
-                out[line[1]] += v * fx;
-            }
-        }
-        // 2D elements
-        else if (i < i1d+i2d)
-        {
-            const size_t i0 = m_map1d.size();
-            const size_t c0 = triangles.size();
-            const typename Out::DPos v = Out::getDPos(in[i]);
-            const OutReal fx = ( OutReal ) m_map2d[i-i0].baryCoords[0];
-            const OutReal fy = ( OutReal ) m_map2d[i-i0].baryCoords[1];
-            const size_t index = m_map2d[i-i0].in_index;
-            if ( index<c0 )
-            {
-                const Triangle& triangle = triangles[index];
-                out[triangle[0]] += v * ( 1-fx-fy );
-                out[triangle[1]] += v * fx;
-                out[triangle[2]] += v * fy;
-            }
-            else
-            {
-                const Quad& quad = quads[index-c0];
-                out[quad[0]] += v * ( ( 1-fx ) * ( 1-fy ) );
-                out[quad[1]] += v * ( ( fx ) * ( 1-fy ) );
-                out[quad[3]] += v * ( ( 1-fx ) * ( fy ) );
-                out[quad[2]] += v * ( ( fx ) * ( fy ) );
-            }
-        }
-        // 3D elements
-        else if (i < i1d+i2d+i3d)
-        {
-            const size_t i0 = m_map1d.size() + m_map2d.size();
-            const size_t c0 = tetrahedra.size();
-            const typename Out::DPos v = Out::getDPos(in[i]);
-            const OutReal fx = ( OutReal ) m_map3d[i-i0].baryCoords[0];
-            const OutReal fy = ( OutReal ) m_map3d[i-i0].baryCoords[1];
-            const OutReal fz = ( OutReal ) m_map3d[i-i0].baryCoords[2];
-            const size_t index = m_map3d[i-i0].in_index;
-            if ( index<c0 )
-            {
-                const Tetra& tetra = tetrahedra[index];
-                out[tetra[0]] += v * ( 1-fx-fy-fz );
-                out[tetra[1]] += v * fx;
-                out[tetra[2]] += v * fy;
-                out[tetra[3]] += v * fz;
-            }
-            else
-            {
-
-                const Hexa& cube = cubes[index-c0];
-
-                out[cube[0]] += v * ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) );
-                out[cube[1]] += v * ( ( fx ) * ( 1-fy ) * ( 1-fz ) );
+            this->addMatrixContrib(m_matrixJ, int(rowId), int(col), weight);
+        });
+    }
 
-                out[cube[3]] += v * ( ( 1-fx ) * ( fy ) * ( 1-fz ) );
-                out[cube[2]] += v * ( ( fx ) * ( fy ) * ( 1-fz ) );
+    m_matrixJ->compress();
+    m_updateJ = false;
+    ++this->m_jacobianRevision;
+    return m_matrixJ;
+}
 
-                out[cube[4]] += v * ( ( 1-fx ) * ( 1-fy ) * ( fz ) );
-                out[cube[5]] += v * ( ( fx ) * ( 1-fy ) * ( fz ) );
 
-                out[cube[7]] += v * ( ( 1-fx ) * ( fy ) * ( fz ) );
-                out[cube[6]] += v * ( ( fx ) * ( fy ) * ( fz ) );
+template <class In, class Out>
+void BarycentricMapperMeshTopology<In,Out>::applyJT ( typename In::VecDeriv& out, const typename Out::VecDeriv& in )
+{
+    updateWeights(out.size());
 
-            }
-        }
-    }
+    m_weights.addMultiplyTransposed(out, [&in](Index i) { return Out::getDPos(in[i]); }, this->m_parallelApply);
 }
 
 
-
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::applyJ ( typename Out::VecDeriv& out, const typename In::VecDeriv& in )
 {
-    out.resize( m_map1d.size() +m_map2d.size() +m_map3d.size() );
-
-    const SeqLines& lines = this->m_fromTopology->getLines();
-    const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
-    const SeqQuads& quads = this->m_fromTopology->getQuads();
-    const SeqTetrahedra& tetrahedra = this->m_fromTopology->getTetrahedra();
-    const SeqHexahedra& cubes = this->m_fromTopology->getHexahedra();
-
-    const size_t sizeMap1d=m_map1d.size();
-    const size_t sizeMap2d=m_map2d.size();
-    const size_t sizeMap3d=m_map3d.size();
-
-    const size_t idxStart1=sizeMap1d;
-    const size_t idxStart2=sizeMap1d+sizeMap2d;
-    const size_t idxStart3=sizeMap1d+sizeMap2d+sizeMap3d;
-
-    for( size_t i=0 ; i<out.size() ; ++i)
-    {
-        // 1D elements
-        if (i < idxStart1)
-        {
-            const Real fx = m_map1d[i].baryCoords[0];
-            const Index index = m_map1d[i].in_index;
-            {
-                const Edge& line = lines[index];
-                Out::setDPos(out[i] , in[line[0]] * ( 1-fx )
-                        + in[line[1]] * fx );
-            }
-        }
-        // 2D elements
-        else if (i < idxStart2)
-        {
-            const size_t i0 = idxStart1;
-            const size_t c0 = triangles.size();
-
-            const Real fx = m_map2d[i-i0].baryCoords[0];
-            const Real fy = m_map2d[i-i0].baryCoords[1];
-            const size_t index = m_map2d[i-i0].in_index;
-
-            if ( index<c0 )
-            {
-                const Triangle& triangle = triangles[index];
-                Out::setDPos(out[i] , in[triangle[0]] * ( 1-fx-fy )
-                        + in[triangle[1]] * fx
-                        + in[triangle[2]] * fy );
-            }
-            else
-            {
-                const Quad& quad = quads[index-c0];
-                Out::setDPos(out[i] , in[quad[0]] * ( ( 1-fx ) * ( 1-fy ) )
-                        + in[quad[1]] * ( ( fx ) * ( 1-fy ) )
-                        + in[quad[3]] * ( ( 1-fx ) * ( fy ) )
-                        + in[quad[2]] * ( ( fx ) * ( fy ) ) );
-            }
-        }
-        // 3D elements
-        else if (i < idxStart3)
-        {
-            const size_t i0 = idxStart2;
-            const size_t c0 = tetrahedra.size();
-            const Real fx = m_map3d[i-i0].baryCoords[0];
-            const Real fy = m_map3d[i-i0].baryCoords[1];
-            const Real fz = m_map3d[i-i0].baryCoords[2];
-            const size_t index = m_map3d[i-i0].in_index;
-            if ( index<c0 )
-            {
-                const Tetra& tetra = tetrahedra[index];
-                Out::setDPos(out[i] , in[tetra[0]] * ( 1-fx-fy-fz )
-                        + in[tetra[1]] * fx
-                        + in[tetra[2]] * fy
-                        + in[tetra[3]] * fz );
-            }
-            else
-            {
-                const Hexa& cube = cubes[index-c0];
-
-                Out::setDPos(out[i] , in[cube[0]] * ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) )
-                        + in[cube[1]] * ( ( fx ) * ( 1-fy ) * ( 1-fz ) )
-                        + in[cube[3]] * ( ( 1-fx ) * ( fy ) * ( 1-fz ) )
-                        + in[cube[2]] * ( ( fx ) * ( fy ) * ( 1-fz ) )
-                        + in[cube[4]] * ( ( 1-fx ) * ( 1-fy ) * ( fz ) )
-                        + in[cube[5]] * ( ( fx ) * ( 1-fy ) * ( fz ) )
-                        + in[cube[7]] * ( ( 1-fx ) * ( fy ) * ( fz ) )
-                        + in[cube[6]] * ( ( fx ) * ( fy ) * ( fz ) ) );
-            }
-        }
-    }
+    updateWeights(in.size());
+    out.resize( m_weights.rows() );
 
+    m_weights.multiply(in, [&out](std::size_t i, const InDeriv& inPos) { Out::setDPos(out[i] , inPos); }, this->m_parallelApply);
 }
 
 
@@ -1002,89 +961,10 @@ void BarycentricMapperMeshTopology<In,Out>::resize( core::State<Out>* toModel )
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::apply ( typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
-    out.resize( m_map1d.size() +m_map2d.size() +m_map3d.size() );
-
-    const SeqLines& lines = this->m_fromTopology->getLines();
-    const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
-    const SeqQuads& quads = this->m_fromTopology->getQuads();
-    const SeqTetrahedra& tetrahedra = this->m_fromTopology->getTetrahedra();
-    const SeqHexahedra& cubes = this->m_fromTopology->getHexahedra();
-
-    // 1D elements
-    {
-        for ( std::size_t i=0; i<m_map1d.size(); i++ )
-        {
-            const Real fx = m_map1d[i].baryCoords[0];
-            const Index index = m_map1d[i].in_index;
-            {
-                const Edge& line = lines[index];
-                Out::setCPos(out[i] , in[line[0]] * ( 1-fx )
-                        + in[line[1]] * fx );
-            }
-        }
-    }
-    // 2D elements
-    {
-        const std::size_t i0 = m_map1d.size();
-        const std::size_t c0 = triangles.size();
-        for ( std::size_t i=0; i<m_map2d.size(); i++ )
-        {
-            const Real fx = m_map2d[i].baryCoords[0];
-            const Real fy = m_map2d[i].baryCoords[1];
-            const Index index = m_map2d[i].in_index;
-            if ( index<c0 )
-            {
-                const Triangle& triangle = triangles[index];
-                Out::setCPos(out[i+i0] , in[triangle[0]] * ( 1-fx-fy )
-                        + in[triangle[1]] * fx
-                        + in[triangle[2]] * fy );
-            }
-            else
-            {
-                if (quads.size())
-                {
-                    const Quad& quad = quads[index-c0];
-                    Out::setCPos(out[i+i0] , in[quad[0]] * ( ( 1-fx ) * ( 1-fy ) )
-                            + in[quad[1]] * ( ( fx ) * ( 1-fy ) )
-                            + in[quad[3]] * ( ( 1-fx ) * ( fy ) )
-                            + in[quad[2]] * ( ( fx ) * ( fy ) ) );
-                }
-            }
-        }
-    }
-    // 3D elements
-    {
-        const std::size_t i0 = m_map1d.size() + m_map2d.size();
-        const std::size_t c0 = tetrahedra.size();
-        for ( std::size_t i=0; i<m_map3d.size(); i++ )
-        {
-            const Real fx = m_map3d[i].baryCoords[0];
-            const Real fy = m_map3d[i].baryCoords[1];
-            const Real fz = m_map3d[i].baryCoords[2];
-            const Index index = m_map3d[i].in_index;
-            if ( index<c0 )
-            {
-                const Tetra& tetra = tetrahedra[index];
-                Out::setCPos(out[i+i0] , in[tetra[0]] * ( 1-fx-fy-fz )
-                        + in[tetra[1]] * fx
-                        + in[tetra[2]] * fy
-                        + in[tetra[3]] * fz );
-            }
-            else
-            {
-                const Hexa& cube = cubes[index-c0];
+    updateWeights(in.size());
+    out.resize( m_weights.rows() );
 
-                Out::setCPos(out[i+i0] , in[cube[0]] * ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) )
-                        + in[cube[1]] * ( ( fx ) * ( 1-fy ) * ( 1-fz ) )
-                        + in[cube[3]] * ( ( 1-fx ) * ( fy ) * ( 1-fz ) )
-                        + in[cube[2]] * ( ( fx ) * ( fy ) * ( 1-fz ) )
-                        + in[cube[4]] * ( ( 1-fx ) * ( 1-fy ) * ( fz ) )
-                        + in[cube[5]] * ( ( fx ) * ( 1-fy ) * ( fz ) )
-                        + in[cube[7]] * ( ( 1-fx ) * ( fy ) * ( fz ) )
-                        + in[cube[6]] * ( ( fx ) * ( fy ) * ( fz ) ) );
-            }
-        }
-    }
+    m_weights.multiply(in, [&out](std::size_t i, const typename In::Coord& inPos) { Out::setCPos(out[i] , inPos); }, this->m_parallelApply);
 }
 
 template <class In, class Out>
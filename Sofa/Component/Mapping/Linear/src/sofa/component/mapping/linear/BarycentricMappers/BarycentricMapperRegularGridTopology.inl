@@ -207,6 +207,7 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperRegularGridTopology<In,O
         this->addMatrixContrib(m_matrixJ, out, cube[6], ( ( fx ) * ( fy ) * ( fz ) ));
     }
     m_updateJ = false;
+    ++this->m_jacobianRevision;
     return m_matrixJ;
 }
 
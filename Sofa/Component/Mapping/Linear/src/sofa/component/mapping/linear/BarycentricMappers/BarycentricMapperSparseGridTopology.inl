@@ -177,6 +177,7 @@ const sofa::linearalgebra::BaseMatrix* BarycentricMapperSparseGridTopology<In,Ou
     }
     m_matrixJ->compress();
     m_updateJ = false;
+    ++this->m_jacobianRevision;
     return m_matrixJ;
 }
 
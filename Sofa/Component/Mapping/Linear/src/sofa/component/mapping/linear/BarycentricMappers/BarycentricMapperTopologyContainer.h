@@ -21,6 +21,7 @@
 ******************************************************************************/
 #pragma once
 #include <sofa/component/mapping/linear/BarycentricMappers/TopologyBarycentricMapper.h>
+#include <sofa/component/mapping/linear/SparseWeightMatrix.h>
 
 #include <sofa/core/topology/TopologyData.inl>
 #include <unordered_map>
@@ -133,6 +134,11 @@ protected:
     MatrixType* m_matrixJ {nullptr};
     bool m_updateJ {false};
 
+    /// Weights of the input points for each output point, used by apply, applyJ, applyJT and getJ
+    SparseWeightMatrix<Real> m_weights;
+    int m_weightsMapCounter {-1}; ///< counter of d_map when m_weights was built
+    std::size_t m_weightsNbInputs {0}; ///< number of input points when m_weights was built
+
     type::vector<Mat3x3d> m_bases;
     type::vector<Vec3> m_centers;
 
@@ -166,6 +172,10 @@ protected:
                                   NearestParams& nearestParams);
 
 
+    /// Rebuild m_weights if d_map or the number of input points changed since the last call.
+    /// Return true if the weights have been rebuilt.
+    bool updateWeights(std::size_t nbInputs);
+
     /// Compute the datas needed to find the nearest element
     /// \param in is the vector of points
     void computeBasesAndCenters( const typename In::VecCoord& in );
@@ -266,9 +266,39 @@ void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT
 
 
 
+template <class In, class Out, class MappingDataType, class Element>
+bool BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::updateWeights(std::size_t nbInputs)
+{
+    const auto& map = d_map.getValue();
+    // m_weights.cols() may exceed nbInputs if an element refers to a point out of the input range
+    if (m_weightsMapCounter == d_map.getCounter() && m_weights.rows() == map.size() && m_weightsNbInputs == nbInputs)
+        return false;
+
+    const type::vector<Element>& elements = getElements();
+
+    m_weights.clear();
+    for (const auto& data : map)
+    {
+        const Element& element = elements[data.in_index];
+
+        const type::vector<SReal> baryCoef = getBaryCoef(data.baryCoords);
+        m_weights.addRow();
+        for (unsigned int j=0; j<element.size(); j++)
+            m_weights.addEntry(element[j], Real(baryCoef[j]));
+    }
+    m_weights.finalize(nbInputs);
+    m_weightsNbInputs = nbInputs;
+    m_weightsMapCounter = d_map.getCounter();
+    return true;
+}
+
+
 template <class In, class Out, class MappingDataType, class Element>
 const linearalgebra::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,MappingDataType, Element>::getJ(int outSize, int inSize)
 {
+    if (updateWeights(std::size_t(inSize)))
+        m_updateJ = true;
+
     if (m_matrixJ && !m_updateJ)
         return m_matrixJ;
 
@@ -278,20 +308,17 @@ const linearalgebra::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,Mappi
     else
         m_matrixJ->clear();
 
-    const type::vector<Element>& elements = getElements();
-
-    const auto& map = d_map.getValue();
-    for( size_t outId=0 ; outId< map.size() ; ++outId)
+    for (std::size_t outId = 0; outId < m_weights.rows(); ++outId)
     {
-        const Element& element = elements[map[outId].in_index];
-
-        type::vector<SReal> baryCoef = getBaryCoef(map[outId].baryCoords);
-        for (unsigned int j=0; j<element.size(); j++)
-            this->addMatrixContrib(m_matrixJ, int(outId), element[j], baryCoef[j]);
+        m_weights.forEachEntry(outId, [this, outId](Index inId, Real weight)
+        {
+            this->addMatrixContrib(m_matrixJ, int(outId), int(inId), weight);
+        });
     }
 
     m_matrixJ->compress();
     m_updateJ = false;
+    ++this->m_jacobianRevision;
     return m_matrixJ;
 }
 
@@ -299,41 +326,18 @@ const linearalgebra::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,Mappi
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT ( typename In::VecDeriv& out, const typename Out::VecDeriv& in )
 {
-    const type::vector<Element>& elements = getElements();
-
-    for( size_t i=0 ; i<in.size() ; ++i)
-    {
-        Index index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
+    updateWeights(out.size());
 
-        const typename Out::DPos inPos = Out::getDPos(in[i]);
-        type::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        for (unsigned int j=0; j<element.size(); j++)
-        {
-            out[element[j]] += inPos * baryCoef[j];
-        }
-    }
+    m_weights.addMultiplyTransposed(out, [&in](Index i) { return Out::getDPos(in[i]); }, this->m_parallelApply);
 }
 
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJ ( typename Out::VecDeriv& out, const typename In::VecDeriv& in )
 {
-    out.resize( d_map.getValue().size() );
-
-    const type::vector<Element>& elements = getElements();
-
-    for( size_t i=0 ; i<out.size() ; ++i)
-    {
-        Index index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
-
-        type::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        InDeriv inPos{0.,0.,0.};
-        for (unsigned int j=0; j<element.size(); j++)
-            inPos += in[element[j]] * baryCoef[j];
+    updateWeights(in.size());
+    out.resize( m_weights.rows() );
 
-        Out::setDPos(out[i] , inPos);
-    }
+    m_weights.multiply(in, [&out](std::size_t i, const InDeriv& inPos) { Out::setDPos(out[i] , inPos); }, this->m_parallelApply);
 }
 
 
@@ -354,21 +358,10 @@ bool BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::isEmpty
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::apply ( typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
-    out.resize( d_map.getValue().size() );
-
-    const type::vector<Element>& elements = getElements();
-    for ( unsigned int i=0; i<d_map.getValue().size(); i++ )
-    {
-        Index index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
+    updateWeights(in.size());
+    out.resize( m_weights.rows() );
 
-        type::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        InDeriv inPos{0.,0.,0.};
-        for (unsigned int j=0; j<element.size(); j++)
-            inPos += in[element[j]] * baryCoef[j];
-
-        Out::setCPos(out[i] , inPos);
-    }
+    m_weights.multiply(in, [&out](std::size_t i, const typename In::Coord& inPos) { Out::setCPos(out[i] , inPos); }, this->m_parallelApply);
 }
 
 
@@ -0,0 +1,255 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/mapping/linear/BarycentricMappers/ElementSpatialIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sofa::component::mapping::linear
+{
+
+void ElementSpatialIndex::clear()
+{
+    m_cellSize = 0;
+    m_gridSize = Vec3i(0, 0, 0);
+    m_boxMin.clear();
+    m_boxMax.clear();
+    m_centers.clear();
+    m_boxCellBegin.clear();
+    m_boxCellElements.clear();
+    m_centerCellBegin.clear();
+    m_centerCellElements.clear();
+}
+
+void ElementSpatialIndex::build(const type::vector<Vec3>& boxMin, const type::vector<Vec3>& boxMax, const type::vector<Vec3>& centers)
+{
+    clear();
+
+    assert(boxMin.size() == centers.size() && boxMax.size() == centers.size());
+    const std::size_t nbElements = centers.size();
+    if (nbElements == 0)
+        return;
+
+    m_boxMin = boxMin;
+    m_boxMax = boxMax;
+    m_centers = centers;
+
+    // Enlarge the boxes and compute the bounds of the grid. The cell size is the
+    // mean size of the elements, so that a cell overlaps only a few elements.
+    m_origin = m_boxMin[0];
+    m_gridMax = m_boxMax[0];
+    SReal meanSize = 0;
+    for (std::size_t e = 0; e < nbElements; ++e)
+    {
+        const Vec3 margin(1, 1, 1);
+        const SReal diagonal = (m_boxMax[e] - m_boxMin[e]).norm();
+        m_boxMin[e] -= margin * (1e-6 * diagonal);
+        m_boxMax[e] += margin * (1e-6 * diagonal);
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            m_origin[i] = std::min(m_origin[i], m_boxMin[e][i]);
+            m_gridMax[i] = std::max(m_gridMax[i], m_boxMax[e][i]);
+        }
+        const Vec3 extent = m_boxMax[e] - m_boxMin[e];
+        meanSize += std::max({extent[0], extent[1], extent[2]});
+    }
+    meanSize /= SReal(nbElements);
+
+    const Vec3 gridExtent = m_gridMax - m_origin;
+    m_cellSize = meanSize;
+    if (m_cellSize <= 0)
+    {
+        m_cellSize = std::max({gridExtent[0], gridExtent[1], gridExtent[2], SReal(1)});
+    }
+
+    // Bound the number of cells to the number of elements
+    const double maxNbCells = 8.0 * double(nbElements) + 64.0;
+    Vec3 nbCells;
+    while (true)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+            nbCells[i] = std::max(SReal(1), std::ceil(gridExtent[i] / m_cellSize));
+        if (double(nbCells[0]) * double(nbCells[1]) * double(nbCells[2]) <= maxNbCells)
+            break;
+        m_cellSize *= 2;
+    }
+    m_gridSize = Vec3i(int(nbCells[0]), int(nbCells[1]), int(nbCells[2]));
+    const std::size_t totalNbCells = std::size_t(m_gridSize[0]) * m_gridSize[1] * m_gridSize[2];
+
+    // Boxes: count the elements overlapping each cell, then scatter them by increasing id
+    m_boxCellBegin.assign(totalNbCells + 1, 0);
+    const auto forEachCellOfBox = [this](Index e, const auto& f)
+    {
+        const Vec3i lo = findClampedCell(m_boxMin[e]);
+        const Vec3i hi = findClampedCell(m_boxMax[e]);
+        for (int z = lo[2]; z <= hi[2]; ++z)
+            for (int y = lo[1]; y <= hi[1]; ++y)
+                for (int x = lo[0]; x <= hi[0]; ++x)
+                    f(cellIndex(Vec3i(x, y, z)));
+    };
+
+    for (Index e = 0; e < Index(nbElements); ++e)
+    {
+        forEachCellOfBox(e, [this](std::size_t c) { ++m_boxCellBegin[c + 1]; });
+    }
+    for (std::size_t c = 0; c < totalNbCells; ++c)
+    {
+        m_boxCellBegin[c + 1] += m_boxCellBegin[c];
+    }
+    m_boxCellElements.resize(m_boxCellBegin[totalNbCells]);
+    {
+        type::vector<Index> fill(m_boxCellBegin.begin(), m_boxCellBegin.end() - 1);
+        for (Index e = 0; e < Index(nbElements); ++e)
+        {
+            forEachCellOfBox(e, [this, &fill, e](std::size_t c) { m_boxCellElements[fill[c]++] = e; });
+        }
+    }
+
+    // Centers: each one belongs to a single cell
+    m_centerCellBegin.assign(totalNbCells + 1, 0);
+    for (std::size_t e = 0; e < nbElements; ++e)
+    {
+        ++m_centerCellBegin[cellIndex(findClampedCell(m_centers[e])) + 1];
+    }
+    for (std::size_t c = 0; c < totalNbCells; ++c)
+    {
+        m_centerCellBegin[c + 1] += m_centerCellBegin[c];
+    }
+    m_centerCellElements.resize(nbElements);
+    {
+        type::vector<Index> fill(m_centerCellBegin.begin(), m_centerCellBegin.end() - 1);
+        for (Index e = 0; e < Index(nbElements); ++e)
+        {
+            m_centerCellElements[fill[cellIndex(findClampedCell(m_centers[e]))]++] = e;
+        }
+    }
+}
+
+bool ElementSpatialIndex::findCell(const Vec3& p, Vec3i& cell) const
+{
+    if (m_centers.empty())
+        return false;
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        if (p[i] < m_origin[i] || p[i] > m_gridMax[i])
+            return false;
+    }
+    cell = findClampedCell(p);
+    return true;
+}
+
+ElementSpatialIndex::Vec3i ElementSpatialIndex::findClampedCell(const Vec3& p) const
+{
+    Vec3i cell;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const SReal c = std::floor((p[i] - m_origin[i]) / m_cellSize);
+        cell[i] = c < 0 ? 0 : (c >= SReal(m_gridSize[i]) ? m_gridSize[i] - 1 : int(c));
+    }
+    return cell;
+}
+
+ElementSpatialIndex::Index ElementSpatialIndex::findNearestCenter(const Vec3& p) const
+{
+    if (m_centers.empty())
+        return sofa::InvalidID;
+
+    Index nearest = sofa::InvalidID;
+    SReal nearestDistance = std::numeric_limits<SReal>::max();
+    const auto check = [&](Index e)
+    {
+        const SReal d = (p - m_centers[e]).norm2();
+        if (d < nearestDistance || (d == nearestDistance && e < nearest))
+        {
+            nearestDistance = d;
+            nearest = e;
+        }
+    };
+
+    // Visit the cells by rings of increasing size around the cell of p, until the
+    // unexplored cells are further than the nearest center found so far
+    const Vec3i center = findClampedCell(p);
+    const int maxRing = std::max({m_gridSize[0], m_gridSize[1], m_gridSize[2]});
+    std::size_t nbVisitedCells = 0;
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        Vec3i lo, hi;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            lo[i] = std::max(center[i] - ring, 0);
+            hi[i] = std::min(center[i] + ring, m_gridSize[i] - 1);
+        }
+
+        for (int z = lo[2]; z <= hi[2]; ++z)
+        {
+            for (int y = lo[1]; y <= hi[1]; ++y)
+            {
+                for (int x = lo[0]; x <= hi[0]; ++x)
+                {
+                    ++nbVisitedCells;
+                    if (std::max({std::abs(x - center[0]), std::abs(y - center[1]), std::abs(z - center[2])}) != ring)
+                        continue;
+                    const std::size_t c = cellIndex(Vec3i(x, y, z));
+                    for (Index i = m_centerCellBegin[c]; i < m_centerCellBegin[c + 1]; ++i)
+                        check(m_centerCellElements[i]);
+                }
+            }
+        }
+
+        // Distance from p to the closest unexplored cell
+        SReal bound = std::numeric_limits<SReal>::max();
+        bool remaining = false;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            if (center[i] - ring > 0)
+            {
+                remaining = true;
+                bound = std::min(bound, p[i] - (m_origin[i] + (center[i] - ring) * m_cellSize));
+            }
+            if (center[i] + ring < m_gridSize[i] - 1)
+            {
+                remaining = true;
+                bound = std::min(bound, m_origin[i] + (center[i] + ring + 1) * m_cellSize - p[i]);
+            }
+        }
+        if (!remaining)
+            break;
+        bound = std::max(bound, SReal(0));
+        if (nearest != sofa::InvalidID && bound * bound > nearestDistance)
+            break;
+
+        // Far from the mesh the rings become large and nearly empty: a linear scan is cheaper
+        if (nbVisitedCells > m_centers.size())
+        {
+            for (Index e = 0; e < Index(m_centers.size()); ++e)
+                check(e);
+            break;
+        }
+    }
+
+    return nearest;
+}
+
+} // namespace sofa::component::mapping::linear
@@ -0,0 +1,109 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mapping/linear/config.h>
+
+#include <sofa/type/Vec.h>
+#include <sofa/type/vector.h>
+
+namespace sofa::component::mapping::linear
+{
+
+/**
+ * Uniform grid of buckets used to locate the elements of a mesh containing a point.
+ *
+ * Each element is described by the axis-aligned bounding box of the region where
+ * its barycentric coordinates are considered valid, and by its center. The boxes
+ * are stored in every cell they overlap, the centers in the single cell they belong
+ * to, both in compressed (CSR) arrays, so that a query only visits a few elements
+ * instead of the whole mesh. The index is read-only once built and can be queried
+ * concurrently from several threads.
+ */
+class SOFA_COMPONENT_MAPPING_LINEAR_API ElementSpatialIndex
+{
+public:
+    using Vec3 = sofa::type::Vec3;
+    using Vec3i = sofa::type::Vec<3, int>;
+    using Index = sofa::Index;
+
+    /// Build the grid from the bounding box (boxMin, boxMax) and the center of each element.
+    /// The boxes are slightly enlarged to be robust to the round-off of the barycentric coordinates.
+    void build(const type::vector<Vec3>& boxMin, const type::vector<Vec3>& boxMax, const type::vector<Vec3>& centers);
+
+    void clear();
+
+    std::size_t getNbElements() const { return m_centers.size(); }
+    SReal getCellSize() const { return m_cellSize; }
+    const Vec3i& getGridSize() const { return m_gridSize; }
+
+    /// Call f(elementId) for each element whose bounding box contains p, by increasing element id.
+    template<class F>
+    void forEachElementContaining(const Vec3& p, F&& f) const
+    {
+        Vec3i cell;
+        if (!findCell(p, cell))
+            return;
+
+        const std::size_t c = cellIndex(cell);
+        for (Index i = m_boxCellBegin[c]; i < m_boxCellBegin[c + 1]; ++i)
+        {
+            const Index e = m_boxCellElements[i];
+            if (p[0] >= m_boxMin[e][0] && p[0] <= m_boxMax[e][0]
+                && p[1] >= m_boxMin[e][1] && p[1] <= m_boxMax[e][1]
+                && p[2] >= m_boxMin[e][2] && p[2] <= m_boxMax[e][2])
+            {
+                f(e);
+            }
+        }
+    }
+
+    /// Return the element whose center is the nearest to p (the lowest id in case of equality),
+    /// or sofa::InvalidID if the index is empty.
+    Index findNearestCenter(const Vec3& p) const;
+
+protected:
+    /// Cell containing p, return false if p is outside of the grid
+    bool findCell(const Vec3& p, Vec3i& cell) const;
+    /// Cell containing p, clamped to the grid
+    Vec3i findClampedCell(const Vec3& p) const;
+
+    std::size_t cellIndex(const Vec3i& cell) const
+    {
+        return (std::size_t(cell[2]) * m_gridSize[1] + cell[1]) * m_gridSize[0] + cell[0];
+    }
+
+    Vec3 m_origin;
+    Vec3 m_gridMax;
+    SReal m_cellSize { 0 };
+    Vec3i m_gridSize { 0, 0, 0 };
+
+    type::vector<Vec3> m_boxMin;
+    type::vector<Vec3> m_boxMax;
+    type::vector<Vec3> m_centers;
+
+    type::vector<Index> m_boxCellBegin;      ///< offsets of each cell in m_boxCellElements
+    type::vector<Index> m_boxCellElements;   ///< elements whose box overlaps each cell
+    type::vector<Index> m_centerCellBegin;   ///< offsets of each cell in m_centerCellElements
+    type::vector<Index> m_centerCellElements;///< elements whose center lies in each cell
+};
+
+} // namespace sofa::component::mapping::linear
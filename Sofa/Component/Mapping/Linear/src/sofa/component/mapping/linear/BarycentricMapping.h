@@ -63,6 +63,8 @@ public:
 
 public:
     Data< bool > d_useRestPosition; ///< Use the rest position of the input and output models to initialize the mapping
+    Data< bool > d_parallelInit; ///< Locate the output points in the input elements in parallel during the initialization of the mapping
+    Data< bool > d_parallelApply; ///< Compute apply, applyJ and applyJT in parallel
 
     SingleLink<BarycentricMapping<In,Out>,Mapper,BaseLink::FLAG_STRONGLINK> d_mapper;
     SingleLink<BarycentricMapping<In,Out>,BaseMeshTopology,BaseLink::FLAG_STRONGLINK> d_input_topology;
@@ -96,6 +98,7 @@ protected:
 
     linearalgebra::BaseMatrix *internalMatrix;        ///< internally store a matrix for getJ/Compliant
     type::vector< linearalgebra::BaseMatrix* > js;
+    int m_jsRevision {-1}; ///< revision of the mapper Jacobian copied in internalMatrix
 private:
     void createMapperFromTopology();
     void populateTopologies();
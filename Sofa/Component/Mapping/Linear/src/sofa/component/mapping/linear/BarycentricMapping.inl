@@ -74,6 +74,8 @@ template <class TIn, class TOut>
 BarycentricMapping<TIn, TOut>::BarycentricMapping(core::State<In>* from, core::State<Out>* to, typename Mapper::SPtr mapper)
     : Inherit1 ( from, to )
     , d_useRestPosition(core::objectmodel::Base::initData(&d_useRestPosition, false, "useRestPosition", "Use the rest position of the input and output models to initialize the mapping"))
+    , d_parallelInit(core::objectmodel::Base::initData(&d_parallelInit, false, "parallelInit", "Locate the output points in the input elements in parallel during the initialization of the mapping"))
+    , d_parallelApply(core::objectmodel::Base::initData(&d_parallelApply, false, "parallelApply", "Compute apply, applyJ and applyJT in parallel"))
     , d_mapper(initLink("mapper","Internal mapper created depending on the type of topology"), mapper)
     , d_input_topology(initLink("input_topology", "Input topology container (usually the surrounding domain)."))
     , d_output_topology(initLink("output_topology", "Output topology container (usually the immersed domain)."))
@@ -89,6 +91,8 @@ template <class TIn, class TOut>
 BarycentricMapping<TIn, TOut>::BarycentricMapping (core::State<In>* from, core::State<Out>* to, BaseMeshTopology * input_topology )
     : Inherit1 ( from, to )
     , d_useRestPosition(core::objectmodel::Base::initData(&d_useRestPosition, false, "useRestPosition", "Use the rest position of the input and output models to initialize the mapping"))
+    , d_parallelInit(core::objectmodel::Base::initData(&d_parallelInit, false, "parallelInit", "Locate the output points in the input elements in parallel during the initialization of the mapping"))
+    , d_parallelApply(core::objectmodel::Base::initData(&d_parallelApply, false, "parallelApply", "Compute apply, applyJ and applyJT in parallel"))
     , d_mapper (initLink("mapper","Internal mapper created depending on the type of topology"))
     , d_input_topology(initLink("input_topology", "Input topology container (usually the surrounding domain)."))
     , d_output_topology(initLink("output_topology", "Output topology container (usually the immersed domain)."))
@@ -162,6 +166,7 @@ void BarycentricMapping<TIn, TOut>::createMapperFromTopology ()
     // Output topology container could be null, as most of the mappers do not need it.
 
     d_mapper = nullptr;
+    m_jsRevision = -1;
     RegularGridTopology* rgt = nullptr;
     SparseGridTopology* sgt = nullptr;
 
@@ -282,6 +287,8 @@ void BarycentricMapping<TIn, TOut>::initMapper()
 {
     if (d_mapper != nullptr && this->toModel != nullptr && this->fromModel != nullptr)
     {
+        d_mapper->setParallelInit(d_parallelInit.getValue());
+        d_mapper->setParallelApply(d_parallelApply.getValue());
         if (d_useRestPosition.getValue())
             d_mapper->init (((const core::State<Out> *)this->toModel)->read(core::ConstVecCoordId::restPosition())->getValue(), ((const core::State<In> *)this->fromModel)->read(core::ConstVecCoordId::restPosition())->getValue() );
         else
@@ -482,7 +489,12 @@ const type::vector< linearalgebra::BaseMatrix*>* BarycentricMapping<TIn, TOut>::
     if(mat==nullptr)
         throw std::runtime_error("Unable to downcast the matrix");
 
-    static_cast<EigenSparseMatrix<InDataTypes, OutDataTypes>*>(internalMatrix)->copyFrom(*mat);
+    // The copy is only updated when the mapper rebuilt its Jacobian
+    if (m_jsRevision != d_mapper->getJacobianRevision())
+    {
+        static_cast<EigenSparseMatrix<InDataTypes, OutDataTypes>*>(internalMatrix)->copyFrom(*mat);
+        m_jsRevision = d_mapper->getJacobianRevision();
+    }
 
     js.resize( 1 );
     js[0] = internalMatrix;
@@ -30,6 +30,7 @@
 #include <sofa/type/SVector.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/type/Mat.h>
+#include <sofa/type/DualQuat.h>
 #include <sofa/linearalgebra/EigenSparseMatrix.h>
 
 #include <sofa/core/objectmodel/RenamedData.h>
@@ -98,12 +99,24 @@ protected:
 
     Data<OutVecCoord> d_initPos; ///< initial child coordinates in the world reference frame.
 
+    // Influences of each child, padded to the same number of influences m_nbInfluences: the child i uses the
+    // slots [i*m_nbInfluences, (i+1)*m_nbInfluences). The unused slots have a null weight and local position.
+    unsigned int m_nbInfluences {0};
+    type::vector<unsigned int> m_influenceIndex; ///< parent index of each slot
+    type::vector<InReal> m_influenceWeight;      ///< normalized weight of each slot
+
     // data for linear blending
-    type::vector<type::vector<OutCoord> > f_localPos; /// initial child coordinates in local frame x weight :   dp = dMa_i (w_i \bar M_i f_localPos)
-    type::vector<type::vector<OutCoord> > f_rotatedPos;  /// rotated child coordinates :  dp = Omega_i x f_rotatedPos  :
+    type::vector<OutCoord> m_localPos; ///< initial child coordinates in local frame x weight :   dp = dMa_i (w_i \bar M_i m_localPos)
+    type::vector<OutCoord> m_rotatedPos; ///< rotated child coordinates x weight :  dp = Omega_i x m_rotatedPos
     SparseJMatrixEigen   _J; /// jacobian matrix for compliant API
+    bool m_updateJ {true}; ///< _J must be rebuilt from m_rotatedPos
+    type::vector<sofa::linearalgebra::BaseMatrix*> m_Js;
 
     // data for dual quat blending
+    InVecCoord m_restFrames; ///< parent frames in rest position
+    type::vector<type::DualQuatCoord3<InReal> > m_frameTransforms; ///< rigid transformation of each parent since its rest position
+    type::vector<InVecDeriv> m_partialForces; ///< per chunk of children accumulation of applyJT
+
     Data< type::vector<unsigned int> > d_nbRef; ///< Number of primitives influencing each point.
     Data< type::vector<sofa::type::SVector<unsigned int> > > d_index; ///< parent indices for each child.
     Data< type::vector<sofa::type::SVector<InReal> > > d_weight; ///< influence weights of the Dofs.
@@ -115,6 +128,8 @@ public:
 public:
     Data<unsigned int> d_showFromIndex; ///< Displayed From Index.
     Data<bool> d_showWeights; ///< Show influence.
+    Data<bool> d_useDualQuaternion; ///< Blend the parent transformations using dual quaternions instead of linear blending.
+    Data<bool> d_parallelApply; ///< Compute apply, applyJ and applyJT in parallel.
 protected:
     SkinningMapping ();
     virtual ~SkinningMapping();
@@ -142,6 +157,11 @@ public:
     SeqTriangles triangles; // Topology of toModel (used for weight display)
     void draw(const core::visual::VisualParams* vparams) override;
 
+protected:
+    /// Call f(begin, end) on ranges of [0, size), in parallel if d_parallelApply is set
+    template<class F>
+    void forEachRange(std::size_t size, const F& f) const;
+
 };
 
 #if !defined(SOFA_COMPONENT_MAPPING_SKINNINGMAPPING_CPP)
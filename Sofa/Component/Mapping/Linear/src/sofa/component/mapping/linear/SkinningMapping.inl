@@ -27,6 +27,8 @@
 #include <sofa/helper/io/Mesh.h>
 #include <limits>
 #include <sofa/type/Vec.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #include <string>
 #include <iostream>
@@ -43,6 +45,8 @@ SkinningMapping<TIn, TOut>::SkinningMapping ()
     , d_weight (initData (&d_weight, "weight", "influence weights of the Dofs." ) )
     , d_showFromIndex (initData (&d_showFromIndex, ( unsigned int ) 0, "showFromIndex", "Displayed From Index." ) )
     , d_showWeights (initData (&d_showWeights, false, "showWeights", "Show influence." ) )
+    , d_useDualQuaternion (initData (&d_useDualQuaternion, false, "useDualQuaternion", "Blend the parent transformations using dual quaternions instead of linear blending." ) )
+    , d_parallelApply (initData (&d_parallelApply, false, "parallelApply", "Compute apply, applyJ and applyJT in parallel." ) )
 {
     type::vector<unsigned int> defaultNbRef;
     defaultNbRef.push_back((unsigned ) 4);
@@ -110,29 +114,54 @@ void SkinningMapping<TIn, TOut>::reinit()
         if(w!=0) for (unsigned int j=0; j<nbref; j++ ) m_weights[i][j]/=w;
     }
 
-    // precompute local/rotated positions
+    // number of influences of each child: the blending stops at the first non positive weight
+    type::vector<unsigned int> nbInfluences(xto.size(), 0);
+    m_nbInfluences = 0;
+    for(unsigned int i=0; i<xto.size(); i++ )
     {
-        _J.resizeBlocks(out.size(), xfrom.size());
-        f_localPos.resize(out.size());
-        f_rotatedPos.resize(out.size());
+        if(d_nbRef.getValue().size() == m_weights.size())
+            nbref = d_nbRef.getValue()[i];
 
-        for(unsigned int i=0; i<out.size(); i++ )
-        {
-            if(d_nbRef.getValue().size() == m_weights.size())
-                nbref = d_nbRef.getValue()[i];
+        unsigned int j=0;
+        while (j<nbref && j<m_weights[i].size() && m_weights[i][j]>0.) j++;
+        nbInfluences[i] = j;
+        m_nbInfluences = std::max(m_nbInfluences, j);
+    }
+
+    // precompute local/rotated positions in the padded layout
+    {
+        const std::size_t nbSlots = xto.size() * m_nbInfluences;
+        m_influenceIndex.assign(nbSlots, 0);
+        m_influenceWeight.assign(nbSlots, 0);
+        m_localPos.assign(nbSlots, OutCoord());
+        m_rotatedPos.assign(nbSlots, OutCoord());
 
+        for(unsigned int i=0; i<xto.size(); i++ )
+        {
             sofa::type::Vec<3,InReal> cto; Out::get( cto[0],cto[1],cto[2], xto[i] );
-            f_localPos[i].resize(nbref);
-            f_rotatedPos[i].resize(nbref);
 
-            for (unsigned int j=0 ; j<nbref; j++ )
+            const std::size_t first = std::size_t(i) * m_nbInfluences;
+            for (unsigned int j=0 ; j<m_nbInfluences; j++ )
             {
-                f_localPos[i][j]= xfrom[index[i][j]].unprojectPoint(cto) * m_weights[i][j];
-                f_rotatedPos[i][j]= (cto - xfrom[index[i][j]].getCenter() ) * m_weights[i][j];
+                if (j < nbInfluences[i])
+                {
+                    m_influenceIndex[first+j] = index[i][j];
+                    m_influenceWeight[first+j] = m_weights[i][j];
+                    m_localPos[first+j] = xfrom[index[i][j]].unprojectPoint(cto) * m_weights[i][j];
+                    m_rotatedPos[first+j] = (cto - xfrom[index[i][j]].getCenter() ) * m_weights[i][j];
+                }
+                else if (j > 0)
+                {
+                    // padding: null contribution of a valid parent
+                    m_influenceIndex[first+j] = m_influenceIndex[first];
+                }
             }
         }
     }
 
+    m_restFrames.assign(xfrom.begin(), xfrom.end());
+    _J.resizeBlocks(out.size(), xfrom.size());
+    m_updateJ = true;
 }
 
 template <class TIn, class TOut>
@@ -196,6 +225,27 @@ void SkinningMapping<TIn, TOut>::setWeights(const type::vector<sofa::type::SVect
     d_nbRef = nbrefs;
 }
 
+template <class TIn, class TOut>
+template <class F>
+void SkinningMapping<TIn, TOut>::forEachRange(std::size_t size, const F& f) const
+{
+    if (d_parallelApply.getValue())
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size,
+            [&f](const simulation::Range<std::size_t>& range) { f(range.start, range.end); });
+    }
+    else
+    {
+        f(0, size);
+    }
+}
+
 template <class TIn, class TOut>
 void SkinningMapping<TIn, TOut>::apply( const sofa::core::MechanicalParams* mparams, OutDataVecCoord& outData, const InDataVecCoord& inData)
 {
@@ -204,39 +254,85 @@ void SkinningMapping<TIn, TOut>::apply( const sofa::core::MechanicalParams* mpar
     OutVecCoord& out = *outData.beginEdit();
     const InVecCoord& in = inData.getValue();
 
-    unsigned int nbref=d_nbRef.getValue()[0];
-    sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<InReal> > > > m_weights  ( this->d_weight );
-    const sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<unsigned int> > > > index (d_index );
-    MatBlock matblock;
+    const unsigned int nbInfluences = m_nbInfluences;
+    const std::size_t nbChildren = nbInfluences ? std::min(out.size(), m_influenceIndex.size() / nbInfluences) : 0;
+    for (std::size_t i = nbChildren; i < out.size(); i++)
+        out[i] = OutCoord();
+
+    if (!d_useDualQuaternion.getValue())
     {
-        _J.clear();
-        for ( unsigned int i = 0 ; i < out.size(); i++ )
+        forEachRange(nbChildren, [&](std::size_t begin, std::size_t end)
         {
-            out[i] = OutCoord ();
-
-            if(d_nbRef.getValue().size() == m_weights.size())
-                nbref = d_nbRef.getValue()[i];
-
-            _J.beginBlockRow(i);
-            for ( unsigned int j=0; j<nbref && m_weights[i][j]>0.; j++ )
+            for (std::size_t i = begin; i < end; i++)
             {
-                f_rotatedPos[i][j]=in[index[i][j]].rotate(f_localPos[i][j]);
-                out[i] += in[index[i][j]].getCenter() * m_weights[i][j] + f_rotatedPos[i][j];
-
-                // update the Jacobian Matrix
-                //                Real w=m_weights[i][j];
-                matblock[0][0] = (Real) m_weights[i][j]         ;    matblock[1][0] = (Real) 0                      ;    matblock[2][0] = (Real) 0                      ;
-                matblock[0][1] = (Real) 0                       ;    matblock[1][1] = (Real) m_weights[i][j]        ;    matblock[2][1] = (Real) 0                      ;
-                matblock[0][2] = (Real) 0                       ;    matblock[1][2] = (Real) 0                      ;    matblock[2][2] = (Real) m_weights[i][j]        ;
-                matblock[0][3] = (Real) 0                       ;    matblock[1][3] = (Real)-f_rotatedPos[i][j][2]  ;    matblock[2][3] = (Real) f_rotatedPos[i][j][1]  ;
-                matblock[0][4] = (Real) f_rotatedPos[i][j][2]   ;    matblock[1][4] = (Real) 0                      ;    matblock[2][4] = (Real)-f_rotatedPos[i][j][0]  ;
-                matblock[0][5] = (Real)-f_rotatedPos[i][j][1]   ;    matblock[1][5] = (Real) f_rotatedPos[i][j][0]  ;    matblock[2][5] = (Real) 0                      ;
-                _J.createBlock(index[i][j],matblock);
+                OutCoord p;
+                for (std::size_t s = i * nbInfluences; s < (i+1) * nbInfluences; s++)
+                {
+                    const InCoord& frame = in[m_influenceIndex[s]];
+                    m_rotatedPos[s] = frame.rotate(m_localPos[s]);
+                    p += frame.getCenter() * m_influenceWeight[s] + m_rotatedPos[s];
+                }
+                out[i] = p;
             }
-            _J.endBlockRow();
+        });
+    }
+    else
+    {
+        // rigid transformation of each parent from its rest position, as a dual quaternion
+        m_frameTransforms.resize(in.size());
+        for (std::size_t f = 0; f < in.size() && f < m_restFrames.size(); f++)
+        {
+            const auto rotation = in[f].getOrientation() * m_restFrames[f].getOrientation().inverse();
+            const auto translation = in[f].getCenter() - rotation.rotate(m_restFrames[f].getCenter());
+            m_frameTransforms[f] = type::DualQuatCoord3<InReal>(translation, rotation);
         }
-        _J.compress();
+
+        sofa::helper::ReadAccessor<Data<OutVecCoord> > xto (this->d_initPos);
+        forEachRange(nbChildren, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const std::size_t first = i * nbInfluences;
+
+                // blend in the hemisphere of the first parent to take the shortest path
+                type::DualQuatCoord3<InReal> blend;
+                const auto& pivot = m_frameTransforms[m_influenceIndex[first]].getOrientation();
+                for (std::size_t s = first; s < first + nbInfluences; s++)
+                {
+                    const auto& transform = m_frameTransforms[m_influenceIndex[s]];
+                    const InReal w = (transform.getOrientation() * pivot < 0) ? -m_influenceWeight[s] : m_influenceWeight[s];
+                    blend += transform * w;
+                }
+
+                // no positive weight (or weights cancelling out): the blend cannot be normalized, use the linear blending
+                if (blend.getOrientation().norm2() < std::numeric_limits<InReal>::epsilon())
+                {
+                    OutCoord p;
+                    for (std::size_t s = first; s < first + nbInfluences; s++)
+                    {
+                        const InCoord& frame = in[m_influenceIndex[s]];
+                        m_rotatedPos[s] = frame.rotate(m_localPos[s]);
+                        p += frame.getCenter() * m_influenceWeight[s] + m_rotatedPos[s];
+                    }
+                    out[i] = p;
+                    continue;
+                }
+                blend.normalize();
+
+                sofa::type::Vec<3,InReal> cto; Out::get( cto[0],cto[1],cto[2], xto[i] );
+                const sofa::type::Vec<3,InReal> p = blend.pointToParent(cto);
+                Out::set( out[i], p[0], p[1], p[2] );
+
+                // the Jacobian is the one of the linear blending, evaluated at the blended position
+                for (std::size_t s = first; s < first + nbInfluences; s++)
+                {
+                    m_rotatedPos[s] = (p - in[m_influenceIndex[s]].getCenter()) * m_influenceWeight[s];
+                }
+            }
+        });
     }
+
+    m_updateJ = true;
     outData.endEdit();
 }
 
@@ -249,23 +345,24 @@ void SkinningMapping<TIn, TOut>::applyJ( const sofa::core::MechanicalParams* mpa
     OutVecDeriv& out = *outData.beginWriteOnly();
     const InVecDeriv& in = inData.getValue();
 
-    unsigned int nbref=d_nbRef.getValue()[0];
-    sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<InReal> > > > m_weights  (d_weight );
-    const sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<unsigned int> > > > index (d_index );
+    const unsigned int nbInfluences = m_nbInfluences;
+    const std::size_t nbChildren = nbInfluences ? std::min(out.size(), m_influenceIndex.size() / nbInfluences) : 0;
+    for (std::size_t i = nbChildren; i < out.size(); i++)
+        out[i] = OutDeriv();
+
+    forEachRange(nbChildren, [&](std::size_t begin, std::size_t end)
     {
-        for( size_t i=0 ; i<out.size() ; ++i)
+        for (std::size_t i = begin; i < end; i++)
         {
-            out[i] = OutDeriv();
-
-            if(d_nbRef.getValue().size() == m_weights.size())
-                nbref = d_nbRef.getValue()[i];
-
-            for ( unsigned int j=0; j<nbref && m_weights[i][j]>0.; j++ )
+            OutDeriv v;
+            for (std::size_t s = i * nbInfluences; s < (i+1) * nbInfluences; s++)
             {
-                out[i] += getLinear( in[index[i][j]] ) * m_weights[i][j] + cross(getAngular(in[index[i][j]]), f_rotatedPos[i][j]);
+                const InDeriv& dframe = in[m_influenceIndex[s]];
+                v += getLinear( dframe ) * m_influenceWeight[s] + cross(getAngular(dframe), m_rotatedPos[s]);
             }
+            out[i] = v;
         }
-    }
+    });
 
     outData.endEdit();
 }
@@ -278,19 +375,45 @@ void SkinningMapping<TIn, TOut>::applyJT( const sofa::core::MechanicalParams* mp
     InVecDeriv& out = *outData.beginEdit();
     const OutVecDeriv& in = inData.getValue();
 
-    unsigned int nbref=d_nbRef.getValue()[0];
-    sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<InReal> > > > m_weights  (d_weight );
-    const sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<unsigned int> > > > index (d_index );
+    const unsigned int nbInfluences = m_nbInfluences;
+    const std::size_t nbChildren = nbInfluences ? std::min(in.size(), m_influenceIndex.size() / nbInfluences) : 0;
 
-    for( size_t i=0 ; i<index.size() ; ++i)
+    const auto accumulate = [&](InVecDeriv& f, std::size_t begin, std::size_t end)
     {
-        if(d_nbRef.getValue().size() == m_weights.size())
-            nbref = d_nbRef.getValue()[i];
+        for (std::size_t i = begin; i < end; i++)
+        {
+            for (std::size_t s = i * nbInfluences; s < (i+1) * nbInfluences; s++)
+            {
+                InDeriv& df = f[m_influenceIndex[s]];
+                getLinear(df)  += in[i] * m_influenceWeight[s];
+                getAngular(df) += cross(m_rotatedPos[s], in[i]);
+            }
+        }
+    };
 
-        for ( unsigned int j=0; j<nbref && m_weights[i][j]>0.; j++ )
+    // The children share their parents: in parallel, each chunk of children is accumulated separately,
+    // then the chunks are summed in order, so that the result does not depend on the number of threads.
+    static constexpr std::size_t chunkSize = 4096;
+    const std::size_t nbChunks = (nbChildren + chunkSize - 1) / chunkSize;
+    if (!d_parallelApply.getValue() || nbChunks < 2)
+    {
+        accumulate(out, 0, nbChildren);
+    }
+    else
+    {
+        m_partialForces.resize(nbChunks);
+        forEachRange(nbChunks, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; c++)
+            {
+                m_partialForces[c].assign(out.size(), InDeriv());
+                accumulate(m_partialForces[c], c * chunkSize, std::min(nbChildren, (c+1) * chunkSize));
+            }
+        });
+        for (std::size_t c = 0; c < nbChunks; c++)
         {
-            getLinear(out[index[i][j]])  += in[i] * m_weights[i][j];
-            getAngular(out[index[i][j]]) += cross(f_rotatedPos[i][j], in[i]);
+            for (std::size_t f = 0; f < out.size(); f++)
+                out[f] += m_partialForces[c][f];
         }
     }
 
@@ -307,9 +430,7 @@ void SkinningMapping<TIn, TOut>::applyJT ( const sofa::core::ConstraintParams* c
     InMatrixDeriv& parentJacobians = *outData.beginEdit();
     const OutMatrixDeriv& childJacobians = inData.getValue();
 
-    unsigned int nbref=d_nbRef.getValue()[0];
-    sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<InReal> > > > m_weights  (d_weight );
-    const sofa::helper::ReadAccessor<Data<type::vector<sofa::type::SVector<unsigned int> > > > index (d_index );
+    const unsigned int nbInfluences = m_nbInfluences;
 
     for (typename Out::MatrixDeriv::RowConstIterator childJacobian = childJacobians.begin(); childJacobian != childJacobians.end(); ++childJacobian)
     {
@@ -317,18 +438,15 @@ void SkinningMapping<TIn, TOut>::applyJT ( const sofa::core::ConstraintParams* c
 
         for (typename Out::MatrixDeriv::ColConstIterator childParticle = childJacobian.begin(); childParticle != childJacobian.end(); ++childParticle)
         {
-            unsigned int childIndex = childParticle.index();
+            const std::size_t childIndex = childParticle.index();
             const OutDeriv& childJacobianVec = childParticle.val();
 
-            if(d_nbRef.getValue().size() == m_weights.size())
-                nbref = d_nbRef.getValue()[childIndex];
-
-            for ( unsigned int j=0; j<nbref && m_weights[childIndex][j]>0.; j++ )
+            for (std::size_t s = childIndex * nbInfluences; s < (childIndex+1) * nbInfluences && m_influenceWeight[s]>0.; s++)
             {
                 InDeriv parentJacobianVec;
-                getLinear(parentJacobianVec)  += childJacobianVec * m_weights[childIndex][j];
-                getAngular(parentJacobianVec) += cross(f_rotatedPos[childIndex][j], childJacobianVec);
-                parentJacobian.addCol(index[childIndex][j],parentJacobianVec);
+                getLinear(parentJacobianVec)  += childJacobianVec * m_influenceWeight[s];
+                getAngular(parentJacobianVec) += cross(m_rotatedPos[s], childJacobianVec);
+                parentJacobian.addCol(m_influenceIndex[s],parentJacobianVec);
             }
         }
     }
@@ -338,12 +456,41 @@ void SkinningMapping<TIn, TOut>::applyJT ( const sofa::core::ConstraintParams* c
 template <class TIn, class TOut>
 const sofa::type::vector<sofa::linearalgebra::BaseMatrix*>* SkinningMapping<TIn, TOut>::getJs()
 {
-    return new sofa::type::vector<sofa::linearalgebra::BaseMatrix*>(1, (sofa::linearalgebra::BaseMatrix*)&_J);
+    m_Js.assign(1, (sofa::linearalgebra::BaseMatrix*)getJ());
+    return &m_Js;
 }
 
 template <class TIn, class TOut>
 const  sofa::linearalgebra::BaseMatrix* SkinningMapping<TIn, TOut>::getJ()
 {
+    // The Jacobian is only assembled on demand, from the rotated positions of the last apply
+    if (m_updateJ)
+    {
+        const unsigned int nbInfluences = m_nbInfluences;
+        const std::size_t nbChildren = nbInfluences ? m_influenceIndex.size() / nbInfluences : 0;
+
+        MatBlock matblock;
+        _J.clear();
+        for (std::size_t i = 0; i < nbChildren; i++)
+        {
+            _J.beginBlockRow(i);
+            for (std::size_t s = i * nbInfluences; s < (i+1) * nbInfluences && m_influenceWeight[s]>0.; s++)
+            {
+                const Real w = (Real) m_influenceWeight[s];
+                const OutCoord& r = m_rotatedPos[s];
+                matblock[0][0] = w             ;    matblock[1][0] = (Real) 0      ;    matblock[2][0] = (Real) 0      ;
+                matblock[0][1] = (Real) 0      ;    matblock[1][1] = w             ;    matblock[2][1] = (Real) 0      ;
+                matblock[0][2] = (Real) 0      ;    matblock[1][2] = (Real) 0      ;    matblock[2][2] = w             ;
+                matblock[0][3] = (Real) 0      ;    matblock[1][3] = (Real)-r[2]   ;    matblock[2][3] = (Real) r[1]   ;
+                matblock[0][4] = (Real) r[2]   ;    matblock[1][4] = (Real) 0      ;    matblock[2][4] = (Real)-r[0]   ;
+                matblock[0][5] = (Real)-r[1]   ;    matblock[1][5] = (Real) r[0]   ;    matblock[2][5] = (Real) 0      ;
+                _J.createBlock(m_influenceIndex[s],matblock);
+            }
+            _J.endBlockRow();
+        }
+        _J.compress();
+        m_updateJ = false;
+    }
     return (sofa::linearalgebra::BaseMatrix*)&_J;
 }
 
@@ -0,0 +1,181 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mapping/linear/config.h>
+
+#include <sofa/type/vector.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+namespace sofa::component::mapping::linear
+{
+
+/**
+ * Sparse matrix of scalar weights, stored in compressed rows (CSR) along with its
+ * transpose, for the linear mappings whose Jacobian blocks are multiples of the
+ * identity (out_i = sum_j w_ij in_j).
+ *
+ * The matrix is filled row by row, then finalized to build the transposed storage.
+ * Once finalized, the products J.x and J^T.x only read contiguous arrays. Both can be
+ * computed in parallel since each thread writes its own rows, including for J^T.x
+ * thanks to the transposed storage. The terms are accumulated in the order they were
+ * added, so the results do not depend on the parallelism.
+ */
+template<class TReal>
+class SparseWeightMatrix
+{
+public:
+    using Real = TReal;
+    using Index = sofa::Index;
+
+    void clear()
+    {
+        m_nbCols = 0;
+        m_rowBegin.assign(1, 0);
+        m_colIndices.clear();
+        m_values.clear();
+        m_colBegin.clear();
+        m_rowIndices.clear();
+        m_transposedValues.clear();
+    }
+
+    /// Start a new row, the following entries are added to it
+    void addRow()
+    {
+        if (m_rowBegin.empty())
+            m_rowBegin.push_back(0);
+        m_rowBegin.push_back(Index(m_colIndices.size()));
+    }
+
+    /// Add an entry to the last row
+    void addEntry(Index col, Real weight)
+    {
+        assert(m_rowBegin.size() > 1);
+        m_colIndices.push_back(col);
+        m_values.push_back(weight);
+        ++m_rowBegin.back();
+    }
+
+    /// Build the transposed storage, once all the rows have been added
+    void finalize(std::size_t nbCols)
+    {
+        m_nbCols = nbCols;
+        for (const Index col : m_colIndices)
+            m_nbCols = std::max(m_nbCols, std::size_t(col) + 1);
+
+        m_colBegin.assign(m_nbCols + 1, 0);
+        for (const Index col : m_colIndices)
+            ++m_colBegin[col + 1];
+        for (std::size_t c = 0; c < m_nbCols; ++c)
+            m_colBegin[c + 1] += m_colBegin[c];
+
+        m_rowIndices.resize(m_colIndices.size());
+        m_transposedValues.resize(m_values.size());
+        type::vector<Index> fill(m_colBegin.begin(), m_colBegin.end() - 1);
+        for (std::size_t r = 0; r < rows(); ++r)
+        {
+            for (Index k = m_rowBegin[r]; k < m_rowBegin[r + 1]; ++k)
+            {
+                const Index pos = fill[m_colIndices[k]]++;
+                m_rowIndices[pos] = Index(r);
+                m_transposedValues[pos] = m_values[k];
+            }
+        }
+    }
+
+    std::size_t rows() const { return m_rowBegin.empty() ? 0 : m_rowBegin.size() - 1; }
+    std::size_t cols() const { return m_nbCols; }
+    std::size_t nbEntries() const { return m_values.size(); }
+
+    /// Call f(col, weight) for each entry of the given row
+    template<class F>
+    void forEachEntry(std::size_t row, F&& f) const
+    {
+        for (Index k = m_rowBegin[row]; k < m_rowBegin[row + 1]; ++k)
+            f(m_colIndices[k], m_values[k]);
+    }
+
+    /// Compute the product J.in, and call set(i, value) with the value of each row i
+    template<class InVecType, class Set>
+    void multiply(const InVecType& in, Set&& set, bool parallel = false) const
+    {
+        using Value = typename InVecType::value_type;
+        forEachRange(rows(), parallel, [this, &in, &set](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t r = begin; r < end; ++r)
+            {
+                Value value;
+                for (Index k = m_rowBegin[r]; k < m_rowBegin[r + 1]; ++k)
+                    value += in[m_colIndices[k]] * m_values[k];
+                set(r, value);
+            }
+        });
+    }
+
+    /// Accumulate the product J^T.in into out, get(i) returning the vector to read from row i of in
+    template<class OutVecType, class Get>
+    void addMultiplyTransposed(OutVecType& out, Get&& get, bool parallel = false) const
+    {
+        const std::size_t nbCols = std::min(m_nbCols, std::size_t(out.size()));
+        forEachRange(nbCols, parallel, [this, &out, &get](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; ++c)
+            {
+                for (Index k = m_colBegin[c]; k < m_colBegin[c + 1]; ++k)
+                    out[c] += get(m_rowIndices[k]) * m_transposedValues[k];
+            }
+        });
+    }
+
+protected:
+    template<class F>
+    static void forEachRange(std::size_t size, bool parallel, const F& f)
+    {
+        if (parallel)
+        {
+            simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            assert(taskScheduler);
+            if (taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+            }
+            simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size,
+                [&f](const simulation::Range<std::size_t>& range) { f(range.start, range.end); });
+        }
+        else
+        {
+            f(0, size);
+        }
+    }
+
+    std::size_t m_nbCols { 0 };
+
+    type::vector<Index> m_rowBegin { 0 };     ///< offsets of each row in m_colIndices and m_values
+    type::vector<Index> m_colIndices;
+    type::vector<Real> m_values;
+
+    type::vector<Index> m_colBegin;           ///< offsets of each column in m_rowIndices and m_transposedValues
+    type::vector<Index> m_rowIndices;
+    type::vector<Real> m_transposedValues;
+};
+
+} // namespace sofa::component::mapping::linear
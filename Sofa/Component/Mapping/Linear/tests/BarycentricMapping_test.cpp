@@ -21,14 +21,20 @@
 ******************************************************************************/
 #include <sofa/component/mapping/linear/BarycentricMapping.h>
 #include <sofa/component/mapping/linear/BarycentricMappers/BarycentricMapperTriangleSetTopology.h>
+#include <sofa/component/mapping/linear/BarycentricMappers/BarycentricMapperMeshTopology.h>
 using sofa::component::mapping::linear::BarycentricMapperTriangleSetTopology;
+using sofa::component::mapping::linear::BarycentricMapperMeshTopology;
 using sofa::component::mapping::linear::BarycentricMapping;
 
 #include <sofa/component/topology/container/dynamic/TriangleSetTopologyContainer.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyContainer.h>
+#include <sofa/component/topology/container/grid/RegularGridTopology.h>
+#include <sofa/component/topology/container/constant/MeshTopology.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 using sofa::component::topology::container::dynamic::TriangleSetTopologyContainer;
 using sofa::component::topology::container::dynamic::TetrahedronSetTopologyContainer;
+using sofa::component::topology::container::grid::RegularGridTopology;
+using sofa::component::topology::container::constant::MeshTopology;
 using sofa::core::topology::BaseMeshTopology;
 
 #include <sofa/testing/BaseTest.h>
@@ -146,3 +152,194 @@ TEST_F(BarycentricMapperTriangleSetTopologyTest_d, initHashing)
 }
 
 
+
+TEST(BarycentricMapperMeshTopologyTest, parallelInit)
+{
+    using Mapper = BarycentricMapperMeshTopology<Vec3Types, Vec3Types>;
+
+    const RegularGridTopology::SPtr grid = New<RegularGridTopology>(6, 5, 4);
+    grid->setPos(0.0, 5.0, 0.0, 4.0, 0.0, 3.0);
+    grid->init();
+    ASSERT_EQ(grid->getNbHexahedra(), 60);
+
+    Vec3Types::VecCoord in(grid->getNbPoints());
+    for (sofa::Index i = 0; i < in.size(); ++i)
+    {
+        in[i] = Vec3(grid->getPX(i), grid->getPY(i), grid->getPZ(i));
+    }
+
+    // Points inside the grid, followed by points outside of it
+    Vec3Types::VecCoord out;
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+        out.push_back(Vec3(0.025 * i, 4.0 * std::abs(std::sin(0.37 * i)), 3.0 * std::abs(std::cos(0.53 * i))));
+    }
+    const std::size_t nbInsidePoints = out.size();
+    out.push_back(Vec3(-1.0, 2.0, 1.5));
+    out.push_back(Vec3(6.0, 5.0, 4.0));
+    out.push_back(Vec3(2.5, -0.5, 3.2));
+
+    const Mapper::SPtr sequentialMapper = New<Mapper>(grid.get(), nullptr);
+    sequentialMapper->init(out, in);
+
+    const Mapper::SPtr parallelMapper = New<Mapper>(grid.get(), nullptr);
+    parallelMapper->setParallelInit(true);
+    parallelMapper->init(out, in);
+
+    const auto& sequentialMap = *sequentialMapper->getMap3d();
+    const auto& parallelMap = *parallelMapper->getMap3d();
+    ASSERT_EQ(sequentialMap.size(), out.size());
+    ASSERT_EQ(parallelMap.size(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        EXPECT_EQ(sequentialMap[i].in_index, parallelMap[i].in_index);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            EXPECT_EQ(sequentialMap[i].baryCoords[j], parallelMap[i].baryCoords[j]);
+        }
+    }
+
+    // The points inside the grid are reproduced by the mapping
+    Vec3Types::VecCoord mapped(out.size());
+    parallelMapper->apply(mapped, in);
+    for (std::size_t i = 0; i < nbInsidePoints; ++i)
+    {
+        EXPECT_LT((mapped[i] - out[i]).norm(), 1e-10);
+    }
+}
+
+TEST(BarycentricMapperMeshTopologyTest, cachedJacobian)
+{
+    using Mapper = BarycentricMapperMeshTopology<Vec3Types, Vec3Types>;
+
+    const RegularGridTopology::SPtr grid = New<RegularGridTopology>(4, 4, 3);
+    grid->setPos(0.0, 3.0, 0.0, 3.0, 0.0, 2.0);
+    grid->init();
+
+    Vec3Types::VecCoord in(grid->getNbPoints());
+    for (sofa::Index i = 0; i < in.size(); ++i)
+    {
+        in[i] = Vec3(grid->getPX(i), grid->getPY(i), grid->getPZ(i));
+    }
+
+    Vec3Types::VecCoord out;
+    for (unsigned int i = 0; i < 50; ++i)
+    {
+        out.push_back(Vec3(0.06 * i, 3.0 * std::abs(std::sin(0.41 * i)), 2.0 * std::abs(std::cos(0.29 * i))));
+    }
+
+    const Mapper::SPtr mapper = New<Mapper>(grid.get(), nullptr);
+    mapper->init(out, in);
+
+    Vec3Types::VecDeriv dx(in.size());
+    for (std::size_t i = 0; i < dx.size(); ++i)
+    {
+        dx[i] = Vec3(std::sin(1.0 * i), std::cos(2.0 * i), 0.5 * std::sin(3.0 * i));
+    }
+    Vec3Types::VecDeriv f(out.size());
+    for (std::size_t i = 0; i < f.size(); ++i)
+    {
+        f[i] = Vec3(std::cos(0.7 * i), 1.0, std::sin(0.3 * i));
+    }
+
+    Vec3Types::VecDeriv sequentialJx, parallelJx;
+    Vec3Types::VecDeriv sequentialJTf(in.size()), parallelJTf(in.size());
+    mapper->applyJ(sequentialJx, dx);
+    mapper->applyJT(sequentialJTf, f);
+
+    mapper->setParallelApply(true);
+    mapper->applyJ(parallelJx, dx);
+    mapper->applyJT(parallelJTf, f);
+
+    ASSERT_EQ(sequentialJx.size(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        EXPECT_EQ(sequentialJx[i], parallelJx[i]);
+    }
+    for (std::size_t i = 0; i < in.size(); ++i)
+    {
+        EXPECT_EQ(sequentialJTf[i], parallelJTf[i]);
+    }
+
+    // The assembled Jacobian is built from the same weights, and only once
+    const sofa::linearalgebra::BaseMatrix* J = mapper->getJ(int(out.size()), int(in.size()));
+    ASSERT_NE(J, nullptr);
+    const int revision = mapper->getJacobianRevision();
+    EXPECT_EQ(mapper->getJ(int(out.size()), int(in.size())), J);
+    EXPECT_EQ(mapper->getJacobianRevision(), revision);
+
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            SReal value = 0;
+            for (std::size_t j = 0; j < in.size(); ++j)
+            {
+                value += J->element(3 * i + c, 3 * j + c) * dx[j][c];
+            }
+            EXPECT_NEAR(value, sequentialJx[i][c], 1e-12);
+        }
+    }
+
+    // Initializing the mapping again invalidates the weights and the Jacobian
+    mapper->init(out, in);
+    mapper->getJ(int(out.size()), int(in.size()));
+    EXPECT_GT(mapper->getJacobianRevision(), revision);
+}
+
+TEST(BarycentricMapperMeshTopologyTest, cachedWeights)
+{
+    using Mapper = BarycentricMapperMeshTopology<Vec3Types, Vec3Types>;
+
+    // A unit cube, followed by a point along x
+    Vec3Types::VecCoord in;
+    for (unsigned int k = 0; k < 2; ++k)
+        for (unsigned int j = 0; j < 2; ++j)
+            for (unsigned int i = 0; i < 2; ++i)
+                in.push_back(Vec3(i, j, k));
+    in.push_back(Vec3(2.0, 0.0, 0.0));
+
+    const MeshTopology::SPtr mesh = New<MeshTopology>();
+    const auto addElements = [&mesh, &in](const sofa::core::topology::Topology::Hexahedron& hexa)
+    {
+        for (const auto& p : in)
+            mesh->addPoint(p[0], p[1], p[2]);
+        mesh->addTetra(1, 5, 7, 8);
+        mesh->addHexa(hexa[0], hexa[1], hexa[2], hexa[3], hexa[4], hexa[5], hexa[6], hexa[7]);
+    };
+    addElements({0, 1, 3, 2, 4, 5, 7, 6});
+
+    const Mapper::SPtr mapper = New<Mapper>(mesh.get(), nullptr);
+    mapper->clear();
+    const SReal inCube[3] = { 0.25, 0.5, 0.75 };
+    mapper->addPointInCube(0, inCube);
+    const SReal inTetra[3] = { 0.0, 0.0, 0.0 };
+    mapper->addPointInTetra(0, inTetra);
+
+    Vec3Types::VecCoord mapped;
+    mapper->apply(mapped, in);
+    ASSERT_EQ(mapped.size(), 2);
+    EXPECT_LT((mapped[0] - Vec3(0.25, 0.5, 0.75)).norm(), 1e-12);
+    EXPECT_LT((mapped[1] - in[1]).norm(), 1e-12);
+
+    // The last point is not in the input of the products below, while the weights refer to it:
+    // the weights must not be rebuilt for each of them
+    const int nbInputs = int(in.size()) - 1;
+    const Vec3Types::VecDeriv f(mapped.size(), Vec3(1.0, 1.0, 1.0));
+    Vec3Types::VecDeriv JTf(nbInputs);
+    mapper->applyJT(JTf, f);
+    mapper->getJ(int(mapped.size()), nbInputs);
+    const int revision = mapper->getJacobianRevision();
+    mapper->applyJT(JTf, f);
+    mapper->getJ(int(mapped.size()), nbInputs);
+    EXPECT_EQ(mapper->getJacobianRevision(), revision);
+
+    // Same number of points, but the hexahedron is mirrored along x
+    mesh->clear();
+    addElements({1, 0, 2, 3, 5, 4, 6, 7});
+
+    mapper->apply(mapped, in);
+    EXPECT_LT((mapped[0] - Vec3(0.75, 0.5, 0.75)).norm(), 1e-12);
+    mapper->getJ(int(mapped.size()), int(in.size()));
+    EXPECT_GT(mapper->getJacobianRevision(), revision);
+}
@@ -0,0 +1,287 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/mapping/linear/SkinningMapping.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <sofa/testing/BaseTest.h>
+
+namespace sofa
+{
+
+using namespace sofa::defaulttype;
+using sofa::component::mapping::linear::SkinningMapping;
+using sofa::component::statecontainer::MechanicalObject;
+using sofa::core::objectmodel::New;
+
+/// Two rigid frames driving points laid between them, possibly blended with dual quaternions
+struct SkinningMapping_test : public sofa::testing::BaseTest
+{
+    using Mapping = SkinningMapping<Rigid3Types, Vec3Types>;
+
+    simulation::Node::SPtr root;
+    MechanicalObject<Rigid3Types>::SPtr frames;
+    MechanicalObject<Vec3Types>::SPtr points;
+    Mapping::SPtr mapping;
+
+    /// Points laid between the two frames
+    static Vec3Types::VecCoord createPoints(std::size_t nbPoints)
+    {
+        Vec3Types::VecCoord x(nbPoints);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            x[i] = type::Vec3(2.0 * i / nbPoints, 0.2 * std::sin(0.5 * i), 0.1 * std::cos(0.3 * i));
+        }
+        return x;
+    }
+
+    void createScene(bool useDualQuaternion, bool parallelApply, const Vec3Types::VecCoord& positions = createPoints(20))
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+        frames = New<MechanicalObject<Rigid3Types> >();
+        root->addObject(frames);
+        frames->resize(2);
+        {
+            auto x = frames->writePositions();
+            x[0] = Rigid3Types::Coord(type::Vec3(0, 0, 0), type::Quat<SReal>());
+            x[1] = Rigid3Types::Coord(type::Vec3(2, 0, 0), type::Quat<SReal>());
+        }
+        {
+            auto x0 = frames->writeRestPositions();
+            x0.resize(2);
+            x0[0] = frames->readPositions()[0];
+            x0[1] = frames->readPositions()[1];
+        }
+
+        const simulation::Node::SPtr child = root->createChild("child");
+        points = New<MechanicalObject<Vec3Types> >();
+        child->addObject(points);
+        points->resize(positions.size());
+        {
+            auto x = points->writePositions();
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                x[i] = positions[i];
+            }
+        }
+
+        mapping = New<Mapping>();
+        mapping->setModels(frames.get(), points.get());
+        mapping->findData("nbRef")->read("2");
+        mapping->d_useDualQuaternion.setValue(useDualQuaternion);
+        mapping->d_parallelApply.setValue(parallelApply);
+        child->addObject(mapping);
+
+        sofa::simulation::node::initRoot(root.get());
+    }
+
+    /// Applies the mapping to the current frame positions and returns the mapped positions
+    Vec3Types::VecCoord applyMapping()
+    {
+        core::BaseMapping* baseMapping = mapping.get();
+        baseMapping->apply(core::mechanicalparams::defaultInstance(), core::VecCoordId::position(), core::ConstVecCoordId::position());
+        return points->readPositions().ref();
+    }
+
+    /// Sets to zero the weights of the given child
+    void removeInfluences(std::size_t child)
+    {
+        auto* weightData = dynamic_cast<core::objectmodel::Data<type::vector<type::SVector<SReal> > >*>(mapping->findData("weight"));
+        ASSERT_NE(weightData, nullptr);
+        auto weights = sofa::helper::getWriteAccessor(*weightData);
+        weights[child].assign(weights[child].size(), 0);
+    }
+
+    /// Moves both frames with the same rigid motion and returns the mapped positions along with the expected ones
+    void applyRigidMotion(Vec3Types::VecCoord& mapped, Vec3Types::VecCoord& expected)
+    {
+        const type::Quat<SReal> rotation(type::Vec3(0, 0, 1), 0.7);
+        const type::Vec3 translation(0.3, -1.0, 0.5);
+
+        const auto rest = points->readPositions().ref();
+        {
+            auto x = frames->writePositions();
+            for (auto& frame : x)
+            {
+                frame.getCenter() = rotation.rotate(frame.getCenter()) + translation;
+                frame.getOrientation() = rotation * frame.getOrientation();
+            }
+        }
+
+        core::BaseMapping* baseMapping = mapping.get();
+        baseMapping->apply(core::mechanicalparams::defaultInstance(), core::VecCoordId::position(), core::ConstVecCoordId::position());
+
+        mapped = points->readPositions().ref();
+        expected.resize(rest.size());
+        for (std::size_t i = 0; i < rest.size(); ++i)
+        {
+            expected[i] = rotation.rotate(rest[i]) + translation;
+        }
+    }
+
+    void testRigidMotion(bool useDualQuaternion)
+    {
+        createScene(useDualQuaternion, false);
+
+        Vec3Types::VecCoord mapped, expected;
+        applyRigidMotion(mapped, expected);
+        ASSERT_EQ(mapped.size(), expected.size());
+        for (std::size_t i = 0; i < mapped.size(); ++i)
+        {
+            EXPECT_LT((mapped[i] - expected[i]).norm(), 1e-10) << "point " << i;
+        }
+    }
+
+    void TearDown() override
+    {
+        if (root)
+            sofa::simulation::node::unload(root);
+    }
+};
+
+TEST_F(SkinningMapping_test, linearBlendingRigidMotion)
+{
+    testRigidMotion(false);
+}
+
+TEST_F(SkinningMapping_test, dualQuaternionRigidMotion)
+{
+    testRigidMotion(true);
+}
+
+TEST_F(SkinningMapping_test, parallelApply)
+{
+    // enough children for applyJT to accumulate several chunks separately
+    const auto positions = createPoints(3 * 4096 + 100);
+
+    // several threads, even on a single core machine
+    simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+    const auto computeForces = [this]()
+    {
+        Data<Vec3Types::VecDeriv> childForces(Vec3Types::VecDeriv(points->getSize(), type::Vec3(0.1, -0.2, 0.3)));
+        Data<Rigid3Types::VecDeriv> parentForces(Rigid3Types::VecDeriv(frames->getSize()));
+        mapping->applyJT(core::mechanicalparams::defaultInstance(), parentForces, childForces);
+        return parentForces.getValue();
+    };
+
+    Vec3Types::VecCoord sequentialPositions, parallelPositions, expected;
+    createScene(false, false, positions);
+    applyRigidMotion(sequentialPositions, expected);
+    const Rigid3Types::VecDeriv sequentialForces = computeForces();
+    sofa::simulation::node::unload(root);
+
+    createScene(false, true, positions);
+    applyRigidMotion(parallelPositions, expected);
+    ASSERT_EQ(sequentialPositions.size(), parallelPositions.size());
+    for (std::size_t i = 0; i < parallelPositions.size(); ++i)
+    {
+        EXPECT_EQ(sequentialPositions[i], parallelPositions[i]);
+    }
+
+    // the chunks are summed in another order than the sequential accumulation
+    const Rigid3Types::VecDeriv parallelForces = computeForces();
+    ASSERT_EQ(sequentialForces.size(), parallelForces.size());
+    for (std::size_t i = 0; i < sequentialForces.size(); ++i)
+    {
+        const type::Vec3 linear = getVCenter(sequentialForces[i]);
+        const type::Vec3 angular = getVOrientation(sequentialForces[i]);
+        EXPECT_GT(angular.norm(), 1.0);
+        EXPECT_LT((type::Vec3(getVCenter(parallelForces[i])) - linear).norm(), 1e-10 * linear.norm()) << "frame " << i;
+        EXPECT_LT((type::Vec3(getVOrientation(parallelForces[i])) - angular).norm(), 1e-10 * angular.norm()) << "frame " << i;
+    }
+}
+
+TEST_F(SkinningMapping_test, dualQuaternionTwist)
+{
+    // points on a circle around the axis, halfway between the frames
+    Vec3Types::VecCoord positions;
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        const SReal angle = 2 * M_PI * i / 8;
+        positions.emplace_back(1.0, 0.2 * std::cos(angle), 0.2 * std::sin(angle));
+    }
+
+    const type::Quat<SReal> twist(type::Vec3(1, 0, 0), 0.5 * M_PI);
+    for (const bool useDualQuaternion : { false, true })
+    {
+        createScene(useDualQuaternion, false, positions);
+        frames->writePositions()[1].getOrientation() = twist;
+        const Vec3Types::VecCoord mapped = applyMapping();
+
+        for (std::size_t i = 0; i < mapped.size(); ++i)
+        {
+            ASSERT_FALSE(std::isnan(mapped[i].norm()));
+            EXPECT_NEAR(mapped[i][0], 1.0, 1e-10);
+
+            // the dual quaternions blend the rotations: the points turn by half the twist and stay on the circle,
+            // whereas the linear blending shrinks the section (candy-wrapper artifact)
+            const SReal radius = std::sqrt(mapped[i][1] * mapped[i][1] + mapped[i][2] * mapped[i][2]);
+            if (useDualQuaternion)
+            {
+                EXPECT_NEAR(radius, 0.2, 1e-10) << "point " << i;
+                const type::Vec3 expected = type::Quat<SReal>(type::Vec3(1, 0, 0), 0.25 * M_PI).rotate(positions[i] - type::Vec3(1, 0, 0)) + type::Vec3(1, 0, 0);
+                EXPECT_LT((mapped[i] - expected).norm(), 1e-10) << "point " << i;
+            }
+            else
+            {
+                EXPECT_NEAR(radius, 0.2 * std::cos(0.25 * M_PI), 1e-10) << "point " << i;
+            }
+        }
+
+        sofa::simulation::node::unload(root);
+        root.reset();
+    }
+}
+
+TEST_F(SkinningMapping_test, dualQuaternionWithoutInfluence)
+{
+    Vec3Types::VecCoord linearPositions, expected;
+    createScene(false, false);
+    // the first child has no positive weight
+    removeInfluences(0);
+    mapping->reinit();
+    applyRigidMotion(linearPositions, expected);
+    sofa::simulation::node::unload(root);
+
+    Vec3Types::VecCoord dualQuaternionPositions;
+    createScene(true, false);
+    removeInfluences(0);
+    mapping->reinit();
+    applyRigidMotion(dualQuaternionPositions, expected);
+
+    // the child without influence gets the linear blending result instead of a non normalizable blend
+    ASSERT_EQ(linearPositions.size(), dualQuaternionPositions.size());
+    EXPECT_FALSE(std::isnan(dualQuaternionPositions[0].norm()));
+    EXPECT_EQ(dualQuaternionPositions[0], linearPositions[0]);
+    for (std::size_t i = 1; i < dualQuaternionPositions.size(); ++i)
+    {
+        EXPECT_LT((dualQuaternionPositions[i] - expected[i]).norm(), 1e-10) << "point " << i;
+    }
+}
+
+} // namespace sofa
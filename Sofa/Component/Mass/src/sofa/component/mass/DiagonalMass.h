@@ -33,6 +33,7 @@
 
 #include <sofa/component/mass/VecMassType.h>
 #include <sofa/component/mass/RigidMassType.h>
+#include <sofa/component/mass/SparseMassMatrix.h>
 
 #include <type_traits>
 
@@ -110,6 +111,9 @@ public:
     Data< float > d_showAxisSize; ///< Factor length of the axis displayed (only used for rigids)
     core::objectmodel::DataFileName d_fileMass; ///< an Xsp3.0 file to specify the mass parameters
 
+    /// if the mass and its inverse should be applied in parallel
+    Data< bool > d_parallelApply;
+
     /// value defining the initialization process of the mass (0 : totalMass, 1 : massDensity, 2 : vertexMass)
     int m_initializationProcess;
 
@@ -133,6 +137,13 @@ protected:
     /// The type of topology to build the mass from the topology
     sofa::geometry::ElementType m_massTopologyType;
 
+    /// Rebuild m_massMatrix if d_vertexMass changed since its last update (scalar masses only)
+    void updateMassMatrix();
+
+    /// Vertex masses and their inverses, used by addMDx and accFromF when the masses are scalars
+    SparseMassMatrix<Real> m_massMatrix;
+    int m_massMatrixCounter { -1 };
+
 protected:
     DiagonalMass();
 
@@ -50,6 +50,7 @@ DiagonalMass<DataTypes, GeometricalTypes>::DiagonalMass()
     , d_showCenterOfGravity( initData(&d_showCenterOfGravity, false, "showGravityCenter", "Display the center of gravity of the system" ) )
     , d_showAxisSize( initData(&d_showAxisSize, 1.0f, "showAxisSizeFactor", "Factor length of the axis displayed (only used for rigids)" ) )
     , d_fileMass( initData(&d_fileMass,  "filename", "Xsp3.0 file to specify the mass parameters" ) )
+    , d_parallelApply( initData(&d_parallelApply, false, "parallelApply", "Apply the mass (addMDx) and its inverse (accFromF) in parallel" ) )
     , l_topology(initLink("topology", "link to the topology container"))
     , l_geometryState(initLink("geometryState", "link to the MechanicalObject associated with the geometry"))
     , m_massTopologyType(sofa::geometry::ElementType::UNKNOWN)
@@ -533,9 +534,33 @@ void DiagonalMass<DataTypes, GeometricalTypes>::resize(int vsize)
 }
 
 // -- Mass interface
+template <class DataTypes, class GeometricalTypes>
+void DiagonalMass<DataTypes, GeometricalTypes>::updateMassMatrix()
+{
+    if constexpr (std::is_same_v<MassType, Real>)
+    {
+        const MassVector &masses= d_vertexMass.getValue();
+        if (m_massMatrixCounter == d_vertexMass.getCounter())
+        {
+            return;
+        }
+        m_massMatrixCounter = d_vertexMass.getCounter();
+        m_massMatrix.setLumpedMasses(masses, Real(1));
+    }
+}
+
 template <class DataTypes, class GeometricalTypes>
 void DiagonalMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalParams* /*mparams*/, DataVecDeriv& res, const DataVecDeriv& dx, SReal factor)
 {
+    if constexpr (std::is_same_v<MassType, Real>)
+    {
+        updateMassMatrix();
+        helper::WriteOnlyAccessor< DataVecDeriv > _res = res;
+        helper::ReadAccessor< DataVecDeriv > _dx = dx;
+        m_massMatrix.addMultiplyLumped(_res.wref(), _dx.ref(), Real(factor), d_parallelApply.getValue());
+        return;
+    }
+
     const MassVector &masses= d_vertexMass.getValue();
     helper::WriteOnlyAccessor< DataVecDeriv > _res = res;
     helper::ReadAccessor< DataVecDeriv > _dx = dx;
@@ -564,6 +589,14 @@ void DiagonalMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalPar
 template <class DataTypes, class GeometricalTypes>
 void DiagonalMass<DataTypes, GeometricalTypes>::accFromF(const core::MechanicalParams* /*mparams*/, DataVecDeriv& a, const DataVecDeriv& f)
 {
+    if constexpr (std::is_same_v<MassType, Real>)
+    {
+        // multiply by the inverses of the masses, computed once when the masses change
+        updateMassMatrix();
+        helper::WriteOnlyAccessor< DataVecDeriv > _a = a;
+        m_massMatrix.multiplyInverseLumped(_a.wref(), f.getValue(), d_parallelApply.getValue());
+        return;
+    }
 
     const MassVector &masses= d_vertexMass.getValue();
     helper::WriteOnlyAccessor< DataVecDeriv > _a = a;
@@ -32,6 +32,7 @@
 
 #include <sofa/component/mass/VecMassType.h>
 #include <sofa/component/mass/RigidMassType.h>
+#include <sofa/component/mass/SparseMassMatrix.h>
 
 //VERY IMPORTANT FOR GRAPHS
 #include <sofa/helper/map.h>
@@ -107,6 +108,8 @@ public:
     Data< bool >         d_lumping;
     /// if specific mass information should be outputed
     Data< bool >         d_printMass; ///< Boolean to print the mass
+    /// if the mass matrix and its lumped inverse should be applied in parallel
+    Data< bool >         d_parallelApply;
     Data< std::map < std::string, sofa::type::vector<double> > > f_graph; ///< Graph of the controlled potential
 
     /// Link to be set to the topology container in the component graph.
@@ -127,6 +130,16 @@ protected:
     void initTopologyHandlers(sofa::geometry::ElementType topologyType);
     void massInitialization();
 
+    /// Rebuild m_massMatrix if the vertex or edge masses changed since its last update
+    void updateMassMatrix();
+
+    /// Compressed copy of the mass matrix built from d_vertexMass and d_edgeMass, used by addMDx and accFromF
+    SparseMassMatrix<Real> m_massMatrix;
+    int m_massMatrixVertexMassCounter { -1 };
+    int m_massMatrixEdgeMassCounter { -1 };
+    Real m_massMatrixLumpingCoeff { 0 };
+    bool m_massMatrixLumped { false };
+
     /// Internal data required for Cuda computation (copy of vertex mass for deviceRead)
     MeshMatrixMassInternalData<DataTypes, MassType, GeometricalTypes> data;
     friend class MeshMatrixMassInternalData<DataTypes, MassType, GeometricalTypes>;
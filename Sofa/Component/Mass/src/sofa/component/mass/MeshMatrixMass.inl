@@ -53,6 +53,7 @@ MeshMatrixMass<DataTypes, GeometricalTypes>::MeshMatrixMass()
     , d_showAxisSize( initData(&d_showAxisSize, Real(1.0), "showAxisSizeFactor", "factor length of the axis displayed (only used for rigids)" ) )
     , d_lumping( initData(&d_lumping, false, "lumping","If true, the mass matrix is lumped, meaning the mass matrix becomes diagonal (summing all mass values of a line on the diagonal)") )
     , d_printMass( initData(&d_printMass, false, "printMass","boolean if you want to check the mass conservation") )
+    , d_parallelApply( initData(&d_parallelApply, false, "parallelApply","Apply the mass matrix (addMDx) and the inverse of the lumped mass matrix (accFromF) in parallel") )
     , f_graph( initData(&f_graph,"graph","Graph of the controlled potential") )
     , l_topology(initLink("topology", "link to the topology container"))
     , l_geometryState(initLink("geometryState", "link to the MechanicalObject associated with the geometry"))
@@ -1996,12 +1997,43 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::clear()
 }
 
 
+template <class DataTypes, class GeometricalTypes>
+void MeshMatrixMass<DataTypes, GeometricalTypes>::updateMassMatrix()
+{
+    const auto& vertexMass = d_vertexMass.getValue();
+    const auto& edgeMass = d_edgeMass.getValue();
+
+    if (m_massMatrixVertexMassCounter == d_vertexMass.getCounter()
+        && m_massMatrixEdgeMassCounter == d_edgeMass.getCounter()
+        && m_massMatrixLumpingCoeff == m_massLumpingCoeff
+        && m_massMatrixLumped == isLumped()
+        && m_massMatrix.rows() == vertexMass.size())
+    {
+        return;
+    }
+    m_massMatrixVertexMassCounter = d_vertexMass.getCounter();
+    m_massMatrixEdgeMassCounter = d_edgeMass.getCounter();
+    m_massMatrixLumpingCoeff = m_massLumpingCoeff;
+    m_massMatrixLumped = isLumped();
+
+    // the off-diagonal terms are not needed by a lumped mass
+    if (isLumped() || !l_topology)
+    {
+        m_massMatrix.build(vertexMass, sofa::type::vector<core::topology::BaseMeshTopology::Edge>(), edgeMass);
+    }
+    else
+    {
+        m_massMatrix.build(vertexMass, l_topology->getEdges(), edgeMass);
+    }
+    m_massMatrix.setLumpedMasses(vertexMass, m_massLumpingCoeff);
+}
+
+
 // -- Mass interface
 template <class DataTypes, class GeometricalTypes>
 void MeshMatrixMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalParams*, DataVecDeriv& vres, const DataVecDeriv& vdx, SReal factor)
 {
-    const auto &vertexMass= d_vertexMass.getValue();
-    const auto &edgeMass= d_edgeMass.getValue();
+    updateMassMatrix();
 
     helper::WriteAccessor< DataVecDeriv > res = vres;
     helper::ReadAccessor< DataVecDeriv > dx = vdx;
@@ -2011,38 +2043,14 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalP
     //using a lumped matrix (default)-----
     if(isLumped())
     {
-        for (size_t i=0; i<dx.size(); i++)
-        {
-            res[i] += dx[i] * vertexMass[i] * m_massLumpingCoeff * Real(factor);
-            massTotal += vertexMass[i]*m_massLumpingCoeff * Real(factor);
-        }
-
+        m_massMatrix.addMultiplyLumped(res.wref(), dx.ref(), Real(factor), d_parallelApply.getValue());
+        massTotal = m_massMatrix.lumpedSum() * Real(factor);
     }
     //using a sparse matrix---------------
     else
     {
-        const size_t nbEdges=l_topology->getNbEdges();
-        const auto& edges = l_topology->getEdges();
-
-        for (unsigned int i=0; i<dx.size(); i++)
-        {
-            res[i] += dx[i] * vertexMass[i] * Real(factor);
-            massTotal += vertexMass[i] * Real(factor);
-        }
-
-        Real tempMass=0.0;
-
-        for (unsigned int j=0; j<nbEdges; ++j)
-        {
-            const auto& e = edges[j];
-
-            tempMass = edgeMass[j] * Real(factor);
-
-            res[e[0]] += dx[e[1]] * tempMass;
-            res[e[1]] += dx[e[0]] * tempMass;
-
-            massTotal += 2 * tempMass;
-        }
+        m_massMatrix.addMultiply(res.wref(), dx.ref(), Real(factor), d_parallelApply.getValue());
+        massTotal = m_massMatrix.sum() * Real(factor);
     }
 
     if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
@@ -2072,14 +2080,12 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::accFromF(const core::Mechanica
         return;
     }
 
+    updateMassMatrix();
+
     helper::WriteAccessor< DataVecDeriv > _a = a;
     const VecDeriv& _f = f.getValue();
-    const auto &vertexMass= d_vertexMass.getValue();
 
-    for (unsigned int i=0; i<vertexMass.size(); i++)
-    {
-        _a[i] = _f[i] / ( vertexMass[i] * m_massLumpingCoeff);
-    }
+    m_massMatrix.multiplyInverseLumped(_a.wref(), _f, d_parallelApply.getValue());
 }
 
 
@@ -0,0 +1,204 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mass/config.h>
+
+#include <sofa/type/vector.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <algorithm>
+
+namespace sofa::component::mass
+{
+
+/**
+ * Symmetric mass matrix of scalar coefficients stored in compressed rows (CSR), along
+ * with a lumped diagonal and its inverse.
+ *
+ * Each coefficient m_ij stands for the block m_ij * Id of the matrix on the degrees of
+ * freedom, so the same storage applies to any vector type (Vec1, Vec2, Vec3...).
+ * The matrix is built once from the vertex and edge masses and only rebuilt when they
+ * change (e.g. after a topological change). Its products only read contiguous arrays and
+ * can be computed in parallel since each thread writes its own rows.
+ */
+template<class TReal>
+class SparseMassMatrix
+{
+public:
+    using Real = TReal;
+    using Index = sofa::Index;
+
+    void clear()
+    {
+        m_rowBegin.assign(1, 0);
+        m_colIndices.clear();
+        m_values.clear();
+        m_lumpedMasses.clear();
+        m_invLumpedMasses.clear();
+        m_sum = 0;
+        m_lumpedSum = 0;
+    }
+
+    /// Build the matrix from its diagonal (the vertex masses) and its off-diagonal terms,
+    /// one per edge (the edge masses). Each row stores its diagonal term first.
+    template<class Edges>
+    void build(const type::vector<Real>& vertexMass, const Edges& edges, const type::vector<Real>& edgeMass)
+    {
+        const std::size_t nbRows = vertexMass.size();
+        const std::size_t nbEdges = std::min(std::size_t(edges.size()), std::size_t(edgeMass.size()));
+
+        m_rowBegin.assign(nbRows + 1, 0);
+        for (std::size_t r = 0; r < nbRows; ++r)
+            m_rowBegin[r + 1] = 1;
+        for (std::size_t e = 0; e < nbEdges; ++e)
+        {
+            ++m_rowBegin[edges[e][0] + 1];
+            ++m_rowBegin[edges[e][1] + 1];
+        }
+        for (std::size_t r = 0; r < nbRows; ++r)
+            m_rowBegin[r + 1] += m_rowBegin[r];
+
+        m_colIndices.resize(m_rowBegin.back());
+        m_values.resize(m_rowBegin.back());
+        type::vector<Index> fill(m_rowBegin.begin(), m_rowBegin.end() - 1);
+
+        m_sum = 0;
+        for (std::size_t r = 0; r < nbRows; ++r)
+        {
+            const Index pos = fill[r]++;
+            m_colIndices[pos] = Index(r);
+            m_values[pos] = vertexMass[r];
+            m_sum += vertexMass[r];
+        }
+        for (std::size_t e = 0; e < nbEdges; ++e)
+        {
+            const Index a = edges[e][0];
+            const Index b = edges[e][1];
+            const Index posA = fill[a]++;
+            m_colIndices[posA] = b;
+            m_values[posA] = edgeMass[e];
+            const Index posB = fill[b]++;
+            m_colIndices[posB] = a;
+            m_values[posB] = edgeMass[e];
+            m_sum += 2 * edgeMass[e];
+        }
+    }
+
+    /// Set the lumped diagonal used by addMultiplyLumped and multiplyInverseLumped.
+    /// As with a division by the mass, a null mass gives an infinite (or NaN) inverse.
+    void setLumpedMasses(const type::vector<Real>& vertexMass, Real lumpingCoefficient)
+    {
+        m_lumpedMasses.resize(vertexMass.size());
+        m_invLumpedMasses.resize(vertexMass.size());
+        m_lumpedSum = 0;
+        for (std::size_t i = 0; i < vertexMass.size(); ++i)
+        {
+            m_lumpedMasses[i] = vertexMass[i] * lumpingCoefficient;
+            m_invLumpedMasses[i] = Real(1) / m_lumpedMasses[i];
+            m_lumpedSum += m_lumpedMasses[i];
+        }
+    }
+
+    std::size_t rows() const { return m_rowBegin.empty() ? 0 : m_rowBegin.size() - 1; }
+    std::size_t nbEntries() const { return m_values.size(); }
+
+    /// Sum of all the coefficients of the matrix (i.e. the total mass)
+    Real sum() const { return m_sum; }
+    /// Sum of the lumped diagonal
+    Real lumpedSum() const { return m_lumpedSum; }
+
+    /// out += factor * M.in
+    template<class VecType>
+    void addMultiply(VecType& out, const VecType& in, Real factor, bool parallel = false) const
+    {
+        using Value = typename VecType::value_type;
+        const std::size_t n = std::min({ rows(), std::size_t(out.size()), std::size_t(in.size()) });
+        forEachRange(n, parallel, [this, &out, &in, factor](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t r = begin; r < end; ++r)
+            {
+                Value value;
+                for (Index k = m_rowBegin[r]; k < m_rowBegin[r + 1]; ++k)
+                    value += in[m_colIndices[k]] * m_values[k];
+                out[r] += value * factor;
+            }
+        });
+    }
+
+    /// out += factor * M_lumped.in
+    template<class VecType>
+    void addMultiplyLumped(VecType& out, const VecType& in, Real factor, bool parallel = false) const
+    {
+        const std::size_t n = std::min({ m_lumpedMasses.size(), std::size_t(out.size()), std::size_t(in.size()) });
+        forEachRange(n, parallel, [this, &out, &in, factor](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                out[i] += in[i] * (m_lumpedMasses[i] * factor);
+        });
+    }
+
+    /// out = M_lumped^-1.in
+    template<class VecType>
+    void multiplyInverseLumped(VecType& out, const VecType& in, bool parallel = false) const
+    {
+        const std::size_t n = std::min({ m_invLumpedMasses.size(), std::size_t(out.size()), std::size_t(in.size()) });
+        forEachRange(n, parallel, [this, &out, &in](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                out[i] = in[i] * m_invLumpedMasses[i];
+        });
+    }
+
+protected:
+    template<class F>
+    static void forEachRange(std::size_t size, bool parallel, const F& f)
+    {
+        if (parallel)
+        {
+            simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            assert(taskScheduler);
+            if (taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+            }
+            simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size,
+                [&f](const simulation::Range<std::size_t>& range) { f(range.start, range.end); });
+        }
+        else
+        {
+            f(0, size);
+        }
+    }
+
+    type::vector<Index> m_rowBegin { 0 };     ///< offsets of each row in m_colIndices and m_values
+    type::vector<Index> m_colIndices;
+    type::vector<Real> m_values;
+
+    type::vector<Real> m_lumpedMasses;
+    type::vector<Real> m_invLumpedMasses;
+
+    Real m_sum { 0 };
+    Real m_lumpedSum { 0 };
+};
+
+} // namespace sofa::component::mass
@@ -40,7 +40,9 @@ using sofa::core::ExecParams ;
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetGeometryAlgorithms.h>
 
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/Node.h>
+#include <sofa/simulation/TaskScheduler.h>
 using sofa::simulation::Node ;
 
 #include <sofa/simulation/Simulation.h>
@@ -85,6 +87,8 @@ public:
     typedef TMassType MassType;
     typedef typename DataTypes::Coord Coord;
     typedef typename DataTypes::VecCoord VecCoord;
+    typedef typename DataTypes::Deriv Deriv;
+    typedef typename DataTypes::VecDeriv VecDeriv;
 
     typedef typename DataTypes::Real Real;
     typedef typename type::vector<MassType> VecMass;
@@ -984,6 +988,89 @@ public:
         EXPECT_EQ(vMasses.size(), 0);
         EXPECT_NEAR(mass->getTotalMass(), 0, 1e-4);
     }
+
+    void checkAddMDxAccFromF_Tetra(bool parallel)
+    {
+        const string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>                                       "
+                "    <DefaultAnimationLoop />                                                                       "
+                "    <RegularGridTopology name='grid' n='3 3 3' min='0 0 0' max='2 2 2' p0='0 0 0' />               "
+                "    <Node name='Tetra' >                                                                           "
+                "            <MechanicalObject position='@../grid.position' />                                      "
+                "            <TetrahedronSetTopologyContainer name='Container' />                                   "
+                "            <TetrahedronSetTopologyModifier name='Modifier' />                                     "
+                "            <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                  "
+                "            <Hexa2TetraTopologicalMapping input='@../grid' output='@Container' />                  "
+                "            <DiagonalMass name='m_mass' massDensity='1.0'/>                                        "
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+
+        const Node::SPtr root = SceneLoaderXML::loadFromMemory("loadWithNoParam", scene.c_str());
+        ASSERT_NE(root.get(), nullptr);
+        sofa::simulation::node::initRoot(root.get());
+
+        TheDiagonalMass* mass = root->getTreeObject<TheDiagonalMass>();
+        ASSERT_NE(mass, nullptr);
+        mass->d_parallelApply.setValue(parallel);
+        if (parallel)
+        {
+            // several threads, even on a single core machine
+            sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+        }
+
+        TetrahedronSetTopologyModifier* modifier = root->getTreeObject<TetrahedronSetTopologyModifier>();
+        ASSERT_NE(modifier, nullptr);
+
+        // addMDx and accFromF must use the current masses, i.e. the cached inverses follow the changes of d_vertexMass
+        const auto checkProducts = [mass]()
+        {
+            const VecMass& vMasses = mass->d_vertexMass.getValue();
+            const Real factor = 0.5;
+
+            VecDeriv dx(vMasses.size());
+            for (std::size_t i = 0; i < dx.size(); ++i)
+                dx[i] = Deriv(Real(i), Real(1), -Real(2 * i));
+
+            Data<VecDeriv> res(VecDeriv(dx.size(), Deriv(Real(1), Real(0), Real(0)))), dataDx(dx);
+            mass->addMDx(core::mechanicalparams::defaultInstance(), res, dataDx, factor);
+
+            Data<VecDeriv> acc(VecDeriv(dx.size()));
+            mass->accFromF(core::mechanicalparams::defaultInstance(), acc, dataDx);
+
+            const VecDeriv& result = res.getValue();
+            const VecDeriv& accResult = acc.getValue();
+            ASSERT_EQ(result.size(), dx.size());
+            ASSERT_EQ(accResult.size(), dx.size());
+            for (std::size_t i = 0; i < dx.size(); ++i)
+            {
+                ASSERT_GT(vMasses[i], 0);
+                const Deriv expected = Deriv(Real(1), Real(0), Real(0)) + dx[i] * vMasses[i] * factor;
+                const Deriv expectedAcc = dx[i] / vMasses[i];
+                for (std::size_t j = 0; j < Deriv::total_size; ++j)
+                {
+                    EXPECT_NEAR(result[i][j], expected[j], 1e-10);
+                    EXPECT_NEAR(accResult[i][j], expectedAcc[j], 1e-10 * std::abs(expectedAcc[j]) + 1e-12);
+                }
+            }
+        };
+
+        checkProducts();
+
+        // the masses change with the topology
+        sofa::type::vector<sofa::Index> elemIds = { 0 };
+        modifier->removeTetrahedra(elemIds);
+        checkProducts();
+
+        // or when they are directly edited
+        {
+            helper::WriteAccessor<Data<VecMass> > vMasses = mass->d_vertexMass;
+            for (std::size_t i = 0; i < vMasses.size(); ++i)
+                vMasses[i] *= Real(1 + i);
+        }
+        checkProducts();
+    }
 };
 
 
@@ -1193,6 +1280,16 @@ TEST_F(DiagonalMass3_test, checkTopologicalChanges_Edge) {
 }
 
 
+TEST_F(DiagonalMass3_test, checkAddMDxAccFromF_Tetra) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDxAccFromF_Tetra(false);
+}
+
+TEST_F(DiagonalMass3_test, checkAddMDxAccFromF_Tetra_parallel) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDxAccFromF_Tetra(true);
+}
+
 /// Rigid file are not handled only xs3....
 TEST_F(DiagonalMass3_test, checkAttributeLoadFromXpsRigid){
     checkAttributeLoadFromFile("BehaviorModels/card.rigid", 0, 0, true);
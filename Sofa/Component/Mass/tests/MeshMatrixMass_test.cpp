@@ -44,7 +44,9 @@ using sofa::testing::BaseSimulationTest;
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetGeometryAlgorithms.h>
 
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/Node.h>
+#include <sofa/simulation/TaskScheduler.h>
 using sofa::simulation::Node ;
 
 #include <sofa/simulation/Simulation.h>
@@ -89,6 +91,8 @@ public:
     typedef TMassType MassType;
     typedef typename DataTypes::Coord Coord;
     typedef typename DataTypes::VecCoord VecCoord;
+    typedef typename DataTypes::Deriv Deriv;
+    typedef typename DataTypes::VecDeriv VecDeriv;
     typedef typename DataTypes::Real Real;
     typedef typename type::vector<MassType> VecMass;
     typedef MeshMatrixMass<TDataTypes> TheMeshMatrixMass ;
@@ -1919,6 +1923,81 @@ public:
         EXPECT_EQ(eMasses.size(), 0);
         EXPECT_NEAR(mass->getTotalMass(), 0, 1e-4);
     }
+
+    void checkAddMDx_Tetra(bool parallel)
+    {
+        const string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>                                       "
+                "    <DefaultAnimationLoop />                                                                       "
+                "    <RegularGridTopology name='grid' n='2 2 2' min='0 0 0' max='2 2 2' p0='0 0 0' />               "
+                "    <Node name='Tetra' >                                                                           "
+                "            <MechanicalObject position='@../grid.position' />                                      "
+                "            <TetrahedronSetTopologyContainer name='Container' />                                   "
+                "            <TetrahedronSetTopologyModifier name='Modifier' />                                     "
+                "            <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                  "
+                "            <Hexa2TetraTopologicalMapping input='@../grid' output='@Container' />                  "
+                "            <MeshMatrixMass name='m_mass' massDensity='1.0'/>                                      "
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+
+        Node::SPtr root = SceneLoaderXML::loadFromMemory("loadWithNoParam", scene.c_str());
+        ASSERT_NE(root.get(), nullptr);
+        sofa::simulation::node::initRoot(root.get());
+
+        TheMeshMatrixMass* mass = root->getTreeObject<TheMeshMatrixMass>();
+        ASSERT_NE(mass, nullptr);
+        mass->d_parallelApply.setValue(parallel);
+        if (parallel)
+        {
+            // several threads, even on a single core machine
+            sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+        }
+
+        TetrahedronSetTopologyContainer* container = root->getTreeObject<TetrahedronSetTopologyContainer>();
+        ASSERT_NE(container, nullptr);
+        TetrahedronSetTopologyModifier* modifier = root->getTreeObject<TetrahedronSetTopologyModifier>();
+        ASSERT_NE(modifier, nullptr);
+
+        const auto checkProduct = [mass, container]()
+        {
+            const VecMass& vMasses = mass->d_vertexMass.getValue();
+            const VecMass& eMasses = mass->d_edgeMass.getValue();
+            const Real factor = 0.5;
+
+            VecDeriv dx(vMasses.size());
+            for (std::size_t i = 0; i < dx.size(); ++i)
+                dx[i] = Deriv(Real(i), Real(1), -Real(2 * i));
+
+            // expected product, computed from the vertex and edge masses
+            VecDeriv expected(dx.size());
+            for (std::size_t i = 0; i < dx.size(); ++i)
+                expected[i] += dx[i] * vMasses[i] * factor;
+            const auto& edges = container->getEdges();
+            for (std::size_t e = 0; e < edges.size(); ++e)
+            {
+                expected[edges[e][0]] += dx[edges[e][1]] * eMasses[e] * factor;
+                expected[edges[e][1]] += dx[edges[e][0]] * eMasses[e] * factor;
+            }
+
+            Data<VecDeriv> res(VecDeriv(dx.size())), dataDx(dx);
+            mass->addMDx(core::mechanicalparams::defaultInstance(), res, dataDx, factor);
+
+            const VecDeriv& result = res.getValue();
+            ASSERT_EQ(result.size(), expected.size());
+            for (std::size_t i = 0; i < result.size(); ++i)
+                for (std::size_t j = 0; j < Deriv::total_size; ++j)
+                    EXPECT_NEAR(result[i][j], expected[i][j], 1e-10);
+        };
+
+        checkProduct();
+
+        // the compressed mass matrix must follow the topological changes
+        sofa::type::vector<sofa::Index> elemIds = { 0 };
+        modifier->removeTetrahedra(elemIds);
+        checkProduct();
+    }
 };
 
 
@@ -2209,5 +2288,15 @@ TEST_F(MeshMatrixMass3_test, checkTopologicalChanges_Edge_lumped) {
     checkTopologicalChanges_Edge(true);
 }
 
+TEST_F(MeshMatrixMass3_test, checkAddMDx_Tetra) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDx_Tetra(false);
+}
+
+TEST_F(MeshMatrixMass3_test, checkAddMDx_Tetra_parallel) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDx_Tetra(true);
+}
+
 
 } // namespace sofa
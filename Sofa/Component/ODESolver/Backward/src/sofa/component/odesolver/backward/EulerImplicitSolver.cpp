@@ -189,6 +189,7 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
         l_linearSolver->setSystemRHVector(b);
         l_linearSolver->solveSystem();
     }
+    sofa::helper::AdvancedTimer::valSet("nb_linear_iterations", l_linearSolver->getNbIterationsOfLastSolve());
 #ifdef SOFA_DUMP_VISITOR_INFO
     simulation::Visitor::printCloseNode("SystemSolution");
 #endif
@@ -31,6 +31,7 @@
 #include <iomanip>
 #include <chrono>
 #include <memory>
+#include <numeric>
 
 using sofa::simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor;
 
@@ -68,6 +69,24 @@ StaticSolver::StaticSolver()
             false,
             "should_diverge_when_residual_is_growing",
             "Boolean stopping Netwon iterations when the residual is greater than the one from the previous iteration"))
+    , d_eisenstat_walker( initData(&d_eisenstat_walker,
+            false,
+            "eisenstat_walker",
+            "Inexact Newton: adapt the tolerance of the iterative linear solver to the decrease of the residual (Eisenstat-Walker). "
+            "Requires a linear solver supporting an adaptive tolerance, such as CGLinearSolver or ShewchukPCGLinearSolver"))
+    , d_initial_forcing_term( initData(&d_initial_forcing_term,
+            0.5_sreal,
+            "initial_forcing_term",
+            "Inexact Newton: relative tolerance |r|/|b| of the linear solver at the first Newton iteration"))
+    , d_maximum_forcing_term( initData(&d_maximum_forcing_term,
+            0.9_sreal,
+            "maximum_forcing_term",
+            "Inexact Newton: upper bound of the relative tolerance |r|/|b| of the linear solver"))
+    , d_line_search_iterations( initData(&d_line_search_iterations,
+            (unsigned) 0,
+            "line_search_iterations",
+            "Maximum number of backtracking steps of the line search on the residual norm. "
+            "0 disables the line search. The line search requires more than one Newton iteration"))
 {}
 
 void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
@@ -119,6 +138,8 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     const auto & absolute_residual_tolerance_threshold = d_absolute_residual_tolerance_threshold.getValue();
     const auto & max_number_of_newton_iterations = d_newton_iterations.getValue();
     const auto & should_diverge_when_residual_is_growing = d_should_diverge_when_residual_is_growing.getValue();
+    const auto & maximum_forcing_term = d_maximum_forcing_term.getValue();
+    const auto & max_number_of_line_search_iterations = d_line_search_iterations.getValue();
     const auto & print_log = f_printLog.getValue();
     auto info = MessageDispatcher::info(Message::Runtime, std::make_shared<ComponentInfo>(this->getClassName()), SOFA_FILE_INFO);
 
@@ -140,6 +161,23 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     p_squared_increment_norms.clear();
     p_squared_increment_norms.reserve(max_number_of_newton_iterations);
 
+    // Reset the list of linear iterations for this time step
+    p_linear_iterations.clear();
+    p_linear_iterations.reserve(max_number_of_newton_iterations);
+    p_forcing_terms.clear();
+    p_forcing_terms.reserve(max_number_of_newton_iterations);
+    p_line_search_steps.clear();
+    p_line_search_steps.reserve(max_number_of_newton_iterations);
+
+    // Inexact Newton: relative tolerance of the linear solver (forcing term)
+    SReal forcing_term = d_initial_forcing_term.getValue();
+    const bool use_eisenstat_walker = d_eisenstat_walker.getValue() && l_linearSolver->setRelativeTolerance(forcing_term);
+    if (d_eisenstat_walker.getValue() && !use_eisenstat_walker)
+    {
+        msg_warning() << "The linear solver " << l_linearSolver->getPathName() << " does not support an adaptive tolerance: "
+                      << "the linear systems are solved with the tolerance of the linear solver.";
+    }
+
     if (print_log)
     {
         info << "======= Starting static ODE solver =======\n";
@@ -203,6 +241,9 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
         SCOPED_TIMER_VARNAME(step_timer, "NewtonStep");
         t = steady_clock::now();
 
+        // Residual norm at the beginning of the iteration
+        const double R_start_squared_norm = R_squared_norm;
+
         // Part I. Assemble the system matrix.
         {
             SCOPED_TIMER("MBKBuild");
@@ -220,9 +261,16 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             SCOPED_TIMER("MBKSolve");
             // for CG: calls iteratively addDForce, mapped:  [applyJ, addDForce, applyJt(vec)]+
             // for Direct: solves the system, everything's already assembled
+            if (use_eisenstat_walker)
+            {
+                l_linearSolver->setRelativeTolerance(forcing_term);
+                p_forcing_terms.emplace_back(forcing_term);
+            }
             l_linearSolver->setSystemLHVector(dx);
             l_linearSolver->setSystemRHVector(force);
             l_linearSolver->solveSystem();
+
+            p_linear_iterations.emplace_back(l_linearSolver->getNbIterationsOfLastSolve());
         }
 
         // Part III. Propagate the solution increment and update geometry.
@@ -262,6 +310,48 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             mop.projectResponse(force);
         }
 
+        // Part IV bis. Backtracking line search: the step is halved until the residual decreases sufficiently
+        // |R(x + l dx)| <= (1 - t l (1 - eta)) |R(x)|
+        SReal step_length = 1;
+        if (max_number_of_line_search_iterations > 0)
+        {
+            SCOPED_TIMER("LineSearch");
+
+            static constexpr SReal sufficient_decrease = 1e-4;
+            const SReal eta = use_eisenstat_walker ? forcing_term : 0;
+
+            unsigned n_ls = 0;
+            double R_trial_squared_norm = force.dot(force);
+            auto acceptable_squared_norm = [&]()
+            {
+                const SReal ratio = 1 - sufficient_decrease * step_length * (1 - eta);
+                return ratio * ratio * R_start_squared_norm;
+            };
+
+            while (R_trial_squared_norm > acceptable_squared_norm() && n_ls < max_number_of_line_search_iterations)
+            {
+                const SReal new_step_length = step_length / 2;
+                x.peq(dx, new_step_length - step_length); // x := x - (l - l/2) dx
+                mop.solveConstraint(x, sofa::core::ConstraintOrder::POS);
+                MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(context);
+
+                mop.computeForce(force);
+                mop.projectResponse(force);
+                R_trial_squared_norm = force.dot(force);
+
+                step_length = new_step_length;
+                ++n_ls;
+            }
+
+            if (step_length < 1)
+            {
+                // dx is now the increment actually applied
+                dx.teq(step_length);
+            }
+
+            p_line_search_steps.emplace_back(n_ls);
+        }
+
         // Part V. Compute the updated norms.
         {
             SCOPED_TIMER("ComputeNorms");
@@ -285,6 +375,22 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             p_squared_increment_norms.emplace_back(dx_squared_norm);
         }
 
+        // Part V bis. Update the forcing term of the inexact Newton method (Eisenstat-Walker, choice 2 with gamma=0.9 and alpha=2)
+        const SReal previous_forcing_term = forcing_term;
+        if (use_eisenstat_walker && R_start_squared_norm > epsilon*epsilon)
+        {
+            static constexpr SReal gamma = 0.9;
+            forcing_term = gamma * R_squared_norm / R_start_squared_norm;
+
+            // safeguard preventing the forcing term to decrease too fast
+            const SReal safeguard = gamma * previous_forcing_term * previous_forcing_term;
+            if (safeguard > 0.1)
+            {
+                forcing_term = std::max(forcing_term, safeguard);
+            }
+            forcing_term = std::min(forcing_term, maximum_forcing_term);
+        }
+
         // Part VI. Stop timers and print step information.
         {
             auto iteration_time = duration_cast<nanoseconds>(steady_clock::now() - t).count();
@@ -298,6 +404,15 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
                      << "  |du| = "       << std::setw(12) << std::sqrt(dx_squared_norm)
                      << "  |du| / |U| = " << std::setw(12) << (U_squared_norm < epsilon*epsilon  ? 0 : std::sqrt(dx_squared_norm / U_squared_norm))
                      << std::defaultfloat;
+                info << "  Linear iterations = " << p_linear_iterations.back();
+                if (use_eisenstat_walker)
+                {
+                    info << "  eta = " << previous_forcing_term;
+                }
+                if (step_length < 1)
+                {
+                    info << "  Step length = " << step_length;
+                }
                 info << "  Time = " << iteration_time / 1000 / 1000 << " ms";
                 info << "\n";
             }
@@ -393,7 +508,14 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
         }
     }
 
+    if (use_eisenstat_walker)
+    {
+        // restore the tolerance defined in the linear solver
+        l_linearSolver->setRelativeTolerance(-1);
+    }
+
     sofa::helper::AdvancedTimer::valSet("nb_iterations", n_it+1);
+    sofa::helper::AdvancedTimer::valSet("nb_linear_iterations", std::accumulate(p_linear_iterations.begin(), p_linear_iterations.end(), 0u));
     sofa::helper::AdvancedTimer::valSet("residual", std::sqrt(R_squared_norm));
     sofa::helper::AdvancedTimer::valSet("correction", std::sqrt(dx_squared_norm));
 }
@@ -56,6 +56,18 @@ using sofa::core::objectmodel::Data;
  *     \mat{K}(\vec{x}_{n+1}^i) \left [ \Delta \vec{x}_{n+1}^{i+1} \right ] &= - \vec{F}(\vec{x}_{n+1}^i) \\
  *     \vec{x}_{n+1}^{i+1} &= \vec{x}_{n+1}^{i} + \Delta \vec{x}_{n+1}^{i+1}
  * \f}
+ *
+ * With an iterative linear solver, the linear systems can be solved inexactly: following Eisenstat and Walker
+ * (Choosing the forcing terms in an inexact Newton method, SIAM J. Sci. Comput., 1996), the relative tolerance
+ * \f$\eta_i\f$ of the linear solver is adapted to the decrease of the residual, so that the early Newton iterates
+ * are not over-solved:
+ *
+ * \f{align*}{
+ *     \left| \mat{K}(\vec{x}_{n+1}^i) \Delta \vec{x}_{n+1}^{i+1} + \vec{F}(\vec{x}_{n+1}^i) \right| &\leq \eta_i \left| \vec{F}(\vec{x}_{n+1}^i) \right| \\
+ *     \eta_{i} &= 0.9 \frac{ |\vec{F}(\vec{x}_{n+1}^{i})|^2 }{ |\vec{F}(\vec{x}_{n+1}^{i-1})|^2 }
+ * \f}
+ *
+ * A backtracking line search can also be enabled to guarantee a sufficient decrease of the residual at each iteration.
  */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API StaticSolver
     : public sofa::core::behavior::OdeSolver
@@ -74,6 +86,15 @@ public:
     /** The list of squared correction increment norms (dx.dot(dx) = ||dx||^2) of every newton iterations of the last solve call. */
     auto squared_increment_norms() const -> const std::vector<SReal> & { return p_squared_increment_norms; }
 
+    /** The list of the number of linear solver iterations of every newton iterations of the last solve call (0 for direct solvers). */
+    auto linear_iterations() const -> const std::vector<unsigned> & { return p_linear_iterations; }
+
+    /** The list of the relative tolerances |r|/|b| given to the linear solver at every newton iterations of the last solve call (empty if eisenstat_walker is disabled). */
+    auto forcing_terms() const -> const std::vector<SReal> & { return p_forcing_terms; }
+
+    /** The list of the number of backtracking steps of the line search at every newton iterations of the last solve call. */
+    auto line_search_steps() const -> const std::vector<unsigned> & { return p_line_search_steps; }
+
     /// Given a displacement as computed by the linear system inversion, how much will it affect the velocity
     ///
     /// This method is used to compute the compliance for contact corrections
@@ -155,6 +176,10 @@ protected:
     Data<SReal> d_absolute_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the norm of the residual |R| is smaller than this threshold. Use a negative value to disable this criterion.
     Data<SReal> d_relative_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the ratio |R|/|R0| is smaller than this threshold. Use a negative value to disable this criterion.
     Data<bool> d_should_diverge_when_residual_is_growing; ///< Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration.
+    Data<bool> d_eisenstat_walker; ///< Inexact Newton: adapt the tolerance of the iterative linear solver to the decrease of the residual (Eisenstat-Walker).
+    Data<SReal> d_initial_forcing_term; ///< Inexact Newton: relative tolerance of the linear solver at the first Newton iteration.
+    Data<SReal> d_maximum_forcing_term; ///< Inexact Newton: upper bound of the relative tolerance of the linear solver.
+    Data<unsigned> d_line_search_iterations; ///< Maximum number of backtracking steps of the line search on the residual norm. 0 disables the line search.
 
 private:
     /// Sum of displacement increments since the beginning of the time step
@@ -165,6 +190,15 @@ private:
 
     /// List of squared correction increment norms (dx.dot(dx) = ||dx||^2) of every newton iterations of the last solve call.
     std::vector<SReal> p_squared_increment_norms;
+
+    /// List of the number of linear solver iterations of every newton iterations of the last solve call.
+    std::vector<unsigned> p_linear_iterations;
+
+    /// List of the relative tolerances given to the linear solver at every newton iterations of the last solve call.
+    std::vector<SReal> p_forcing_terms;
+
+    /// List of the number of backtracking steps of the line search at every newton iterations of the last solve call.
+    std::vector<unsigned> p_line_search_steps;
 };
 
 } // namespace sofa::component::odesolver::backward
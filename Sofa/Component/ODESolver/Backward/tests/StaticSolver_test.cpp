@@ -59,7 +59,7 @@ public:
         createObject(root, "DefaultAnimationLoop");
         createObject(root, "RegularGridTopology", {{"name", "grid"}, {"min", "-7.5 -7.5 0"}, {"max", "7.5 7.5 80"}, {"n", "3 3 9"}});
         const auto s = createObject(root, "StaticSolver", {{"newton_iterations", "10"}});
-        createObject(root, "SparseLDLSolver", {{"template", "CompressedRowSparseMatrixd"}});
+        createObject(root, "SparseLDLSolver", {{"name", "linear_solver"}, {"template", "CompressedRowSparseMatrixd"}});
         createObject(root, "MechanicalObject", {{"name", "mo"}, {"src", "@grid"}});
         createObject(root, "TetrahedronSetTopologyContainer", {{"name", "mechanical_topology"}});
         createObject(root, "TetrahedronSetTopologyModifier");
@@ -78,7 +78,7 @@ public:
         createObject(root, "FixedProjectiveConstraint", {{"indices", "@top_roi.indices"}});
 
         createObject(root, "BoxROI", {{"name", "base_roi"}, {"box", "-7.5 -7.5 79.9 7.5 7.5 80.1"}, {"triangles", "@mechanical_topology.triangles"}});
-        createObject(root, "SurfacePressureForceField", {{"pressure", "100"}, {"mainDirection", "0 -1 0"}, {"triangleIndices", "@base_roi.trianglesInROI"}});
+        createObject(root, "SurfacePressureForceField", {{"name", "pressure"}, {"pressure", "100"}, {"mainDirection", "0 -1 0"}, {"triangleIndices", "@base_roi.trianglesInROI"}});
 
         solver = dynamic_cast<StaticSolver *> (s.get());
     }
@@ -239,3 +239,72 @@ TEST_F(StaticSolverTest, AbsoluteIncrements) {
     << "The static ODE solver is supposed to converge after 8 Newton steps when using a relative correction threshold of 1e-5.\n"
     << actual_increment_norms;
 }
+
+TEST_F(StaticSolverTest, EisenstatWalker) {
+    using namespace sofa::core::objectmodel;
+    // The forcing terms require an iterative linear solver
+    root->removeObject(root->getObject("linear_solver"));
+    createObject(root, "CGLinearSolver", {{"iterations", "1000"}, {"tolerance", "1e-20"}, {"threshold", "1e-20"}});
+
+    // Disable all convergence criteria BUT the relative residual, and enable the inexact Newton method
+    dynamic_cast< Data<unsigned> * > ( this->solver->findData("newton_iterations") )->setValue(20);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_correction_tolerance_threshold") )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_correction_tolerance_threshold") )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_residual_tolerance_threshold")   )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_residual_tolerance_threshold")   )->setValue(1e-5);
+    dynamic_cast< Data<bool> *     > ( this->solver->findData("should_diverge_when_residual_is_growing") )->setValue(false);
+    dynamic_cast< Data<bool> *     > ( this->solver->findData("eisenstat_walker") )->setValue(true);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("initial_forcing_term") )->setValue(0.5);
+
+    const sofa::type::vector<SReal> actual_force_residual_norms = this->execute().first;
+    ASSERT_GT(actual_force_residual_norms.size(), 2);
+    EXPECT_LT(actual_force_residual_norms.size(), 20)
+    << "The static ODE solver is supposed to converge with inexact linear solves.\n"
+    << actual_force_residual_norms;
+
+    // One tolerance is given to the linear solver per Newton iteration, starting from the initial forcing term,
+    // and it is tightened as the residual decreases
+    const auto & forcing_terms = this->solver->forcing_terms();
+    ASSERT_EQ(forcing_terms.size(), actual_force_residual_norms.size());
+    EXPECT_EQ(forcing_terms.front(), 0.5);
+    EXPECT_NE(forcing_terms[1], forcing_terms[0]);
+    EXPECT_LT(forcing_terms.back(), forcing_terms.front());
+
+    // The linear solves of the early iterations are inexact, so they need less CG iterations than the last ones
+    const auto & linear_iterations = this->solver->linear_iterations();
+    ASSERT_EQ(linear_iterations.size(), actual_force_residual_norms.size());
+    EXPECT_LT(linear_iterations.front(), linear_iterations.back());
+}
+
+TEST_F(StaticSolverTest, LineSearch) {
+    using namespace sofa::core::objectmodel;
+    // With a higher pressure, the full Newton steps overshoot and the residual oscillates
+    dynamic_cast< Data<SReal> *   > ( root->getObject("pressure")->findData("pressure") )->setValue(500);
+
+    // Disable all convergence criteria, and enable the backtracking line search
+    constexpr unsigned max_line_search_iterations = 10;
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_correction_tolerance_threshold") )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_correction_tolerance_threshold") )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_residual_tolerance_threshold")   )->setValue(-1);
+    dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_residual_tolerance_threshold")   )->setValue(-1);
+    dynamic_cast< Data<bool> *     > ( this->solver->findData("should_diverge_when_residual_is_growing") )->setValue(false);
+    dynamic_cast< Data<unsigned> * > ( this->solver->findData("line_search_iterations") )->setValue(max_line_search_iterations);
+
+    const sofa::type::vector<SReal> actual_force_residual_norms = this->execute().first;
+    ASSERT_EQ(actual_force_residual_norms.size(), 10);
+
+    // One number of backtracking steps per Newton iteration, the first full step is too long
+    const auto & line_search_steps = this->solver->line_search_steps();
+    ASSERT_EQ(line_search_steps.size(), actual_force_residual_norms.size());
+    EXPECT_GT(line_search_steps.front(), 0u);
+
+    // When the line search stops before its maximum number of steps, the residual has decreased
+    for (std::size_t i = 1; i < line_search_steps.size(); ++i)
+    {
+        if (line_search_steps[i] < max_line_search_iterations)
+        {
+            EXPECT_LT(actual_force_residual_norms[i], actual_force_residual_norms[i-1])
+            << "Newton iteration " << i << "\n" << actual_force_residual_norms;
+        }
+    }
+}
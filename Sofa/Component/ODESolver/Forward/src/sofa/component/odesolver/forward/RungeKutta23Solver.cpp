@@ -0,0 +1,306 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/forward/RungeKutta23Solver.h>
+#include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/VectorOperations.h>
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/core/ObjectFactory.h>
+#include <algorithm>
+#include <cmath>
+
+
+namespace sofa::component::odesolver::forward
+{
+
+using core::VecId;
+using namespace core::behavior;
+using namespace sofa::defaulttype;
+
+void registerRungeKutta23Solver(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("An explicit time integrator with adaptive sub-steps controlled by an embedded error estimate.")
+        .add< RungeKutta23Solver >());
+}
+
+namespace
+{
+
+using VMultiOp = core::behavior::BaseMechanicalState::VMultiOp;
+
+/// Add the operation result = a + sum_i f_i b_i to ops
+void addLinearCombination(VMultiOp& ops, core::MultiVecId result, core::ConstMultiVecId a,
+                          std::initializer_list<std::pair<core::ConstMultiVecId, SReal> > terms)
+{
+    ops.emplace_back(result);
+    auto& op = ops.back().second;
+    if (!a.isNull())
+    {
+        op.push_back(std::make_pair(a, 1.0_sreal));
+    }
+    for (const auto& term : terms)
+    {
+        op.push_back(term);
+    }
+}
+
+}
+
+RungeKutta23Solver::RungeKutta23Solver()
+    : d_absoluteTolerance(initData(&d_absoluteTolerance, (SReal)1e-4, "absoluteTolerance", "Absolute tolerance on the local error of a sub-step"))
+    , d_relativeTolerance(initData(&d_relativeTolerance, (SReal)1e-3, "relativeTolerance", "Relative tolerance on the local error of a sub-step"))
+    , d_minSubStep(initData(&d_minSubStep, (SReal)1e-6, "minSubStep", "Minimum size of a sub-step. A sub-step of this size is always accepted"))
+    , d_maxSubStep(initData(&d_maxSubStep, (SReal)0, "maxSubStep", "Maximum size of a sub-step. 0 means the time step of the simulation"))
+    , d_safetyFactor(initData(&d_safetyFactor, (SReal)0.9, "safetyFactor", "Safety factor applied to the optimal sub-step size"))
+    , d_maxNbSubSteps(initData(&d_maxNbSubSteps, 1000u, "maxNbSubSteps", "Maximum number of sub-steps (accepted or rejected) in a time step. The last one integrates the remaining time without error control"))
+    , d_nbAcceptedSubSteps(initData(&d_nbAcceptedSubSteps, 0u, "nbAcceptedSubSteps", "Output: number of accepted sub-steps during the last time step"))
+    , d_nbRejectedSubSteps(initData(&d_nbRejectedSubSteps, 0u, "nbRejectedSubSteps", "Output: number of rejected sub-steps during the last time step"))
+    , d_subStep(initData(&d_subStep, (SReal)0, "subStep", "Output: size of the last accepted sub-step"))
+    , d_error(initData(&d_error, (SReal)0, "error", "Output: largest normalized error of the accepted sub-steps during the last time step"))
+{
+    d_nbAcceptedSubSteps.setReadOnly(true);
+    d_nbRejectedSubSteps.setReadOnly(true);
+    d_subStep.setReadOnly(true);
+    d_error.setReadOnly(true);
+}
+
+void RungeKutta23Solver::init()
+{
+    Inherit1::init();
+
+    if (d_absoluteTolerance.getValue() <= 0 && d_relativeTolerance.getValue() <= 0)
+    {
+        msg_warning() << "Both tolerances are not positive: all the sub-steps will have the minimum size " << d_minSubStep.getValue();
+    }
+    if (d_maxNbSubSteps.getValue() == 0)
+    {
+        msg_warning() << "The maximum number of sub-steps must be positive. Set to 1.";
+        d_maxNbSubSteps.setValue(1);
+    }
+
+    reset();
+}
+
+void RungeKutta23Solver::reset()
+{
+    m_nextSubStep = 0;
+}
+
+/**
+ * Bogacki-Shampine tableau, applied to the first order system (x' = v, v' = a(x,v)):
+ *
+ *   c = (0, 1/2, 3/4, 1)
+ *   third order solution:  b  = (2/9, 1/3, 4/9, 0)
+ *   second order solution: b* = (7/24, 1/4, 1/3, 1/8)
+ *
+ * The fourth stage is evaluated at the third order solution, so that it is reused as the
+ * first stage of the next sub-step (First Same As Last).
+ */
+void RungeKutta23Solver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+    mop->setImplicit(false); // this solver is explicit only
+
+    // Get the Ids of the state vectors
+    MultiVecCoord pos(&vop, core::VecCoordId::position() );
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
+    MultiVecCoord pos2(&vop, xResult );
+    MultiVecDeriv vel2(&vop, vResult );
+
+    // Allocate auxiliary vectors
+    MultiVecCoord x(&vop);
+    MultiVecDeriv v(&vop);
+    MultiVecDeriv k1a(&vop);
+    MultiVecDeriv k2a(&vop);
+    MultiVecDeriv k3a(&vop);
+    MultiVecDeriv k4a(&vop);
+    MultiVecDeriv& k1v = v;
+    MultiVecDeriv k2v(&vop);
+    MultiVecDeriv k3v(&vop);
+    MultiVecCoord stageX(&vop);
+    MultiVecCoord newX(&vop);
+    MultiVecDeriv newV(&vop);
+    MultiVecDeriv errorX(&vop);
+    MultiVecDeriv errorV(&vop);
+
+    const SReal startTime = this->getTime();
+
+    const SReal absoluteTolerance = d_absoluteTolerance.getValue();
+    const SReal relativeTolerance = d_relativeTolerance.getValue();
+    const SReal safetyFactor = d_safetyFactor.getValue();
+    const unsigned int maxNbSubSteps = std::max(d_maxNbSubSteps.getValue(), 1u);
+    const SReal maxSubStep = (d_maxSubStep.getValue() > 0) ? std::min(d_maxSubStep.getValue(), dt) : dt;
+    const SReal minSubStep = std::min(d_minSubStep.getValue(), maxSubStep);
+
+    // bounds of the change of the sub-step size between two sub-steps
+    static constexpr SReal minScale = 0.2;
+    static constexpr SReal maxScale = 5;
+
+    mop.addSeparateGravity(dt);	// v += dt*g . Used if mass wants to added G separately from the other forces to v.
+
+    x.eq(pos);
+    v.eq(vel);
+
+    SReal h = (m_nextSubStep > 0) ? m_nextSubStep : dt;
+    h = std::clamp(h, minSubStep, maxSubStep);
+
+    SReal t = 0;
+    bool isFirstStageComputed = false;
+    unsigned int nbAccepted = 0;
+    unsigned int nbRejected = 0;
+    SReal lastAcceptedSubStep = 0;
+    SReal maxAcceptedError = 0;
+
+    while (t < dt)
+    {
+        SCOPED_TIMER_VARNAME(subStepTimer, "RK23SubStep");
+
+        const bool isLastAllowedSubStep = nbAccepted + nbRejected + 1 >= maxNbSubSteps;
+        const SReal remaining = dt - t;
+        const SReal proposedSubStep = h;
+
+        // do not overshoot the end of the time step, and do not leave a tiny remainder
+        const bool isTruncated = isLastAllowedSubStep || h >= remaining * (1 - 1e-6);
+        if (isTruncated)
+        {
+            h = remaining;
+        }
+
+        if (!isFirstStageComputed)
+        {
+            mop.computeAcc(startTime + t, k1a, x, v);
+            isFirstStageComputed = true;
+        }
+
+        {
+            VMultiOp ops;
+            addLinearCombination(ops, stageX, x, {{k1v, h / 2}});
+            addLinearCombination(ops, k2v, v, {{k1a, h / 2}});
+            vop.v_multiop(ops);
+        }
+        mop.computeAcc(startTime + t + h / 2, k2a, stageX, k2v);
+
+        {
+            VMultiOp ops;
+            addLinearCombination(ops, stageX, x, {{k2v, 3 * h / 4}});
+            addLinearCombination(ops, k3v, v, {{k2a, 3 * h / 4}});
+            vop.v_multiop(ops);
+        }
+        mop.computeAcc(startTime + t + 3 * h / 4, k3a, stageX, k3v);
+
+        {
+            VMultiOp ops;
+            addLinearCombination(ops, newX, x, {{k1v, 2 * h / 9}, {k2v, h / 3}, {k3v, 4 * h / 9}});
+            addLinearCombination(ops, newV, v, {{k1a, 2 * h / 9}, {k2a, h / 3}, {k3a, 4 * h / 9}});
+            vop.v_multiop(ops);
+        }
+        mop.computeAcc(startTime + t + h, k4a, newX, newV);
+
+        // difference between the third and the second order solutions: h * (b - b*) . k
+        {
+            VMultiOp ops;
+            addLinearCombination(ops, errorX, core::ConstMultiVecId::null(),
+                {{k1v, -5 * h / 72}, {k2v, h / 12}, {k3v, h / 9}, {newV, -h / 8}});
+            addLinearCombination(ops, errorV, core::ConstMultiVecId::null(),
+                {{k1a, -5 * h / 72}, {k2a, h / 12}, {k3a, h / 9}, {k4a, -h / 8}});
+            vop.v_multiop(ops);
+        }
+
+        const SReal scaleX = absoluteTolerance + relativeTolerance * std::max(x.norm(0), newX.norm(0));
+        const SReal scaleV = absoluteTolerance + relativeTolerance * std::max(v.norm(0), newV.norm(0));
+        const SReal errorNormX = errorX.norm(0);
+        const SReal errorNormV = errorV.norm(0);
+        const SReal error = std::max(
+            scaleX > 0 ? errorNormX / scaleX : (errorNormX > 0 ? std::numeric_limits<SReal>::max() : 0),
+            scaleV > 0 ? errorNormV / scaleV : (errorNormV > 0 ? std::numeric_limits<SReal>::max() : 0));
+
+        const bool isAccepted = error <= 1 || h <= minSubStep || isLastAllowedSubStep;
+
+        // optimal size for a method of order 2 (error in h^3), bounded
+        SReal scale = maxScale;
+        if (error > 0)
+        {
+            scale = std::clamp(safetyFactor * std::pow(error, -1_sreal / 3), minScale, maxScale);
+        }
+
+        if (isAccepted)
+        {
+            if (error > 1)
+            {
+                if (!m_isToleranceExceeded)
+                {
+                    msg_warning() << "Sub-steps are accepted with an error above the tolerance because the minimum sub-step "
+                                  << "size or the maximum number of sub-steps is reached. The error of each time step is given by '"
+                                  << d_error.getName() << "'.";
+                    m_isToleranceExceeded = true;
+                }
+                msg_info() << "Sub-step of size " << h << " accepted at time " << startTime + t
+                           << " with an error " << error << " above the tolerance ("
+                           << (isLastAllowedSubStep ? "maximum number of sub-steps reached" : "minimum sub-step size reached") << ")";
+            }
+
+            x.eq(newX);
+            v.eq(newV);
+            k1a.eq(k4a); // First Same As Last
+
+            t += h;
+            ++nbAccepted;
+            lastAcceptedSubStep = h;
+            maxAcceptedError = std::max(maxAcceptedError, error);
+
+            h = std::clamp(h * scale, minSubStep, maxSubStep);
+            if (isTruncated)
+            {
+                // the truncation does not reflect the dynamics: do not let it shrink the next sub-steps
+                h = std::max(h, std::min(proposedSubStep, maxSubStep));
+            }
+        }
+        else
+        {
+            ++nbRejected;
+            h = std::clamp(h * std::min(scale, 1_sreal), minSubStep, maxSubStep);
+
+            dmsg_info() << "Sub-step rejected at time " << startTime + t << " (error " << error << "), new size " << h;
+        }
+    }
+
+    m_nextSubStep = h;
+
+    pos2.eq(x);
+    vel2.eq(v);
+    mop.solveConstraint(pos2, core::ConstraintOrder::POS);
+    mop.solveConstraint(vel2, core::ConstraintOrder::VEL);
+
+    d_nbAcceptedSubSteps.setValue(nbAccepted);
+    d_nbRejectedSubSteps.setValue(nbRejected);
+    d_subStep.setValue(lastAcceptedSubStep);
+    d_error.setValue(maxAcceptedError);
+
+    sofa::helper::AdvancedTimer::valSet("nb_accepted_substeps", nbAccepted);
+    sofa::helper::AdvancedTimer::valSet("nb_rejected_substeps", nbRejected);
+
+    msg_info() << "Time step " << startTime << ": " << nbAccepted << " accepted and " << nbRejected
+               << " rejected sub-steps, next sub-step " << m_nextSubStep;
+}
+
+} // namespace sofa::component::odesolver::forward
@@ -0,0 +1,106 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/forward/config.h>
+
+#include <sofa/core/behavior/OdeSolver.h>
+
+namespace sofa::component::odesolver::forward
+{
+
+/** Explicit time integrator with adaptive sub-stepping, based on the embedded
+ * Runge-Kutta pair of Bogacki and Shampine (third order with an embedded second order estimate).
+ *
+ * The time step of the simulation is divided into sub-steps whose size is controlled by
+ * the local truncation error, estimated as the difference between the two solutions of the pair.
+ * A sub-step whose error exceeds the tolerance is rejected and redone with a smaller size.
+ * The sub-step size is kept from one time step to the next, so that quiescent phases are
+ * integrated with large steps and impacts with small ones.
+ *
+ * The error of a sub-step is measured in infinity norm, on positions and velocities:
+ * err = max( |e_x| / (atol + rtol |x|), |e_v| / (atol + rtol |v|) ), and the sub-step is accepted if err <= 1.
+ *
+ * @see P. Bogacki and L.F. Shampine, A 3(2) pair of Runge-Kutta formulas, Appl. Math. Letters, 1989
+ */
+class SOFA_COMPONENT_ODESOLVER_FORWARD_API RungeKutta23Solver : public sofa::core::behavior::OdeSolver
+{
+public:
+    SOFA_CLASS(RungeKutta23Solver, sofa::core::behavior::OdeSolver);
+protected:
+    RungeKutta23Solver();
+public:
+    void init() override;
+    void reset() override;
+
+    void solve (const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult) override;
+
+    Data<SReal> d_absoluteTolerance; ///< Absolute tolerance on the local error of a sub-step
+    Data<SReal> d_relativeTolerance; ///< Relative tolerance on the local error of a sub-step
+    Data<SReal> d_minSubStep; ///< Minimum size of a sub-step. A sub-step of this size is always accepted
+    Data<SReal> d_maxSubStep; ///< Maximum size of a sub-step. 0 means the time step of the simulation
+    Data<SReal> d_safetyFactor; ///< Safety factor applied to the optimal sub-step size
+    Data<unsigned int> d_maxNbSubSteps; ///< Maximum number of sub-steps (accepted or rejected) in a time step
+
+    Data<unsigned int> d_nbAcceptedSubSteps; ///< Output: number of accepted sub-steps during the last time step
+    Data<unsigned int> d_nbRejectedSubSteps; ///< Output: number of rejected sub-steps during the last time step
+    Data<SReal> d_subStep; ///< Output: size of the last accepted sub-step
+    Data<SReal> d_error; ///< Output: largest normalized error of the accepted sub-steps during the last time step
+
+    /// Given an input derivative order (0 for position, 1 for velocity, 2 for acceleration),
+    /// how much will it affect the output derivative of the given order.
+    SReal getIntegrationFactor(int inputDerivative, int outputDerivative) const override
+    {
+        const SReal dt = getContext()->getDt();
+        const SReal matrix[3][3] =
+        {
+            { 1, dt/2, 0},
+            { 0, 1, dt/2},
+            { 0, 0, 0}
+        };
+        if (inputDerivative >= 3 || outputDerivative >= 3)
+            return 0;
+        else
+            return matrix[outputDerivative][inputDerivative];
+    }
+
+    /// Given a solution of the linear system,
+    /// how much will it affect the output derivative of the given order.
+    SReal getSolutionIntegrationFactor(int outputDerivative) const override
+    {
+        const SReal dt = getContext()->getDt();
+        const SReal vect[3] = { 0.0, dt/2, 1};
+        if (outputDerivative >= 3)
+            return 0;
+        else
+            return vect[outputDerivative];
+    }
+
+protected:
+
+    /// Size of the next sub-step, kept between time steps. Non-positive if unknown.
+    SReal m_nextSubStep { 0 };
+
+    /// True once a sub-step has been accepted with an error above the tolerance, to warn only once
+    bool m_isToleranceExceeded { false };
+};
+
+} // namespace sofa::component::odesolver::forward
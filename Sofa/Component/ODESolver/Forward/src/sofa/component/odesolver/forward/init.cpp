@@ -31,6 +31,7 @@ extern void registerDampVelocitySolver(sofa::core::ObjectFactory* factory);
 extern void registerEulerExplicitSolver(sofa::core::ObjectFactory* factory);
 extern void registerRungeKutta2Solver(sofa::core::ObjectFactory* factory);
 extern void registerRungeKutta4Solver(sofa::core::ObjectFactory* factory);
+extern void registerRungeKutta23Solver(sofa::core::ObjectFactory* factory);
 
 extern "C" {
     SOFA_EXPORT_DYNAMIC_LIBRARY void initExternalModule();
@@ -61,6 +62,7 @@ void registerObjects(sofa::core::ObjectFactory* factory)
     registerEulerExplicitSolver(factory);
     registerRungeKutta2Solver(factory);
     registerRungeKutta4Solver(factory);
+    registerRungeKutta23Solver(factory);
 }
 
 void init()
@@ -0,0 +1,145 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/testing/ODESolverSpringTest.h>
+#include <sofa/component/odesolver/forward/RungeKutta23Solver.h>
+
+#include <sofa/simulation/Node.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/helper/logging/MessageDispatcher.h>
+#include <sofa/helper/logging/MessageHandler.h>
+
+namespace sofa {
+
+using namespace component;
+using namespace defaulttype;
+using namespace simulation;
+
+using MechanicalObject3 = statecontainer::MechanicalObject<Vec3Types>;
+
+/**  Dynamic solver test.
+Test the adaptive sub-stepping of the RungeKutta23Solver on a mass-spring system under gravity, initialized with the
+spring at rest length. The mass oscillates around its equilibrium position:
+y(t) = y0 - (m g / K) (1 - cos(wt)) with w = sqrt(K/M).
+The simulated positions are compared to the analytical solution, the error being controlled by the solver tolerances
+even if the time step of the simulation is large.
+*/
+struct RungeKutta23ExplicitSolverDynamic_test : public component::odesolver::testing::ODESolverSpringTest
+{
+    odesolver::forward::RungeKutta23Solver* solver { nullptr };
+
+    void createScene(double K, double m, double l0, double tolerance)
+    {
+        this->prepareScene(K, m, l0);
+        const auto object = simpleapi::createObject(m_si.root, "RungeKutta23Solver", {
+            { "absoluteTolerance", simpleapi::str(tolerance) },
+            { "relativeTolerance", simpleapi::str(tolerance) }
+        });
+        solver = dynamic_cast<odesolver::forward::RungeKutta23Solver*>(object.get());
+        ASSERT_NE(solver, nullptr);
+    }
+
+    /// Compare the simulated positions to the analytical solution, and return the total number of sub-steps
+    unsigned int compareSimulatedToAnalyticalPositions(double K, double m, double h, double tolerance)
+    {
+        constexpr double g = 10;
+        constexpr double y0 = 1;
+        const double w = std::sqrt(K / m);
+
+        m_si.initScene();
+
+        const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+        const MechanicalObject3::SPtr dofs = massNode->get<MechanicalObject3>(m_si.root->SearchDown);
+
+        unsigned int nbSubSteps = 0;
+        double time = m_si.root->getTime();
+        while (time < 2)
+        {
+            m_si.simulate(h);
+            time = m_si.root->getTime();
+            nbSubSteps += solver->d_nbAcceptedSubSteps.getValue();
+
+            const double expected = y0 - m * g / K * (1 - std::cos(w * time));
+            const double actual = dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0][1];
+            EXPECT_NEAR(actual, expected, tolerance) << "Position of mass at time " << time << " is wrong";
+        }
+        return nbSubSteps;
+    }
+};
+
+TEST_F(RungeKutta23ExplicitSolverDynamic_test, largeTimeStep)
+{
+    this->createScene(1000, 10, 1, 1e-7); // k,m,l0,tolerance
+    const unsigned int nbSubSteps = this->compareSimulatedToAnalyticalPositions(1000, 10, 0.1, 1e-4);
+
+    // w*h = 1: the time step must have been divided to reach the tolerance
+    EXPECT_GT(nbSubSteps, 20u);
+}
+
+TEST_F(RungeKutta23ExplicitSolverDynamic_test, subStepIsKeptBetweenTimeSteps)
+{
+    this->createScene(100, 10, 1, 1e-5); // k,m,l0,tolerance
+    this->compareSimulatedToAnalyticalPositions(100, 10, 0.1, 1e-2);
+
+    // once the sub-step size is adapted, a time step does not need rejected sub-steps in general
+    EXPECT_LE(solver->d_nbRejectedSubSteps.getValue(), 1u);
+    EXPECT_GT(solver->d_subStep.getValue(), 0);
+    EXPECT_LE(solver->d_subStep.getValue(), 0.1);
+}
+
+namespace
+{
+/// Count the warnings emitted while it is registered
+class WarningCounter : public helper::logging::MessageHandler
+{
+public:
+    void process(helper::logging::Message& m) override
+    {
+        if (m.type() == helper::logging::Message::Warning)
+        {
+            ++nbWarnings;
+        }
+    }
+
+    unsigned int nbWarnings { 0 };
+};
+}
+
+TEST_F(RungeKutta23ExplicitSolverDynamic_test, toleranceExceededIsWarnedOnce)
+{
+    this->createScene(1000, 10, 1, 1e-9); // k,m,l0,tolerance
+    solver->d_maxNbSubSteps.setValue(1); // every sub-step is accepted, whatever its error
+    m_si.initScene();
+
+    WarningCounter counter;
+    helper::logging::MessageDispatcher::addHandler(&counter);
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        m_si.simulate(0.1);
+        EXPECT_GT(solver->d_error.getValue(), 1);
+    }
+    helper::logging::MessageDispatcher::rmHandler(&counter);
+
+    EXPECT_EQ(counter.nbWarnings, 1u);
+}
+
+} // namespace sofa
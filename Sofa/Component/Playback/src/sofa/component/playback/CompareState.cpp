@@ -132,6 +132,16 @@ void CompareState::processCompareState()
     SReal time = getContext()->getTime() + d_shift.getValue();
     time += getContext()->getDt() * 0.001;
     //lastTime = time+0.00001;
+    if (m_stateRecord)
+    {
+        // binary records are compared directly, without formatting the state as text
+        StateRecordFrame frame;
+        last_time = getContext()->getTime();
+        if (!this->readNextFrame(time, frame)) return;
+        compareStateRecordFrame(frame);
+        msg_info() << "totalError_X = " << totalError_X << ", totalError_V = " << totalError_V;
+        return;
+    }
     std::vector<std::string> validLines;
     if (!nextValidLines.empty() && last_time == getContext()->getTime())
         validLines.swap(nextValidLines);
@@ -174,6 +184,43 @@ void CompareState::processCompareState()
     msg_info() << "totalError_X = " << totalError_X << ", totalError_V = " << totalError_V;
 }
 
+SReal CompareState::compareRecordedVector(const type::vector<SReal>& values, core::ConstVecId id, Size dimension)
+{
+    // same measure as BaseMechanicalState::compareVec: mean absolute difference of the scalars
+    m_currentValues.resize(mmodel->getSize() * dimension);
+    mmodel->copyToBuffer(m_currentValues.data(), id, static_cast<unsigned int>(m_currentValues.size()));
+
+    const std::size_t count = std::min(values.size(), m_currentValues.size());
+    if (count == 0) return 0;
+
+    SReal error = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        error += std::abs(values[i] - m_currentValues[i]);
+    }
+    return error / count;
+}
+
+void CompareState::compareStateRecordFrame(const StateRecordFrame& frame)
+{
+    const double dsize = (double)this->mmodel->getSize();
+    if (const auto* x = frame.getValues(StateRecordVector::POSITION))
+    {
+        m_lastRecordedX = *x;
+        const double currentError = compareRecordedVector(*x, core::VecId::position(), mmodel->getCoordDimension());
+        totalError_X += currentError;
+        if (dsize != 0.0)
+            dofError_X += currentError/dsize;
+    }
+    if (const auto* v = frame.getValues(StateRecordVector::VELOCITY))
+    {
+        const double currentError = compareRecordedVector(*v, core::VecId::velocity(), mmodel->getDerivDimension());
+        totalError_V += currentError;
+        if (dsize != 0.0)
+            dofError_V += currentError/dsize;
+    }
+}
+
 //-------------------------------- processCompareState------------------------------------
 void CompareState::draw(const core::visual::VisualParams* vparams)
 {
@@ -182,6 +229,30 @@ void CompareState::draw(const core::visual::VisualParams* vparams)
     SReal time = getContext()->getTime() + d_shift.getValue();
     time += getContext()->getDt() * 0.001;
     //lastTime = time+0.00001;
+    if (m_stateRecord)
+    {
+        // the reference positions of binary records are the ones of the last comparison
+        if (mmodel && !m_lastRecordedX.empty())
+        {
+            const Size dimension = mmodel->getCoordDimension();
+            m_currentValues.resize(mmodel->getSize() * dimension);
+            mmodel->copyToBuffer(m_currentValues.data(), core::VecId::position(), static_cast<unsigned int>(m_currentValues.size()));
+
+            const std::size_t nbp = dimension ? std::min(m_currentValues.size(), m_lastRecordedX.size()) / dimension : 0;
+            const Size nc = std::min<Size>(3, dimension);
+            std::vector< Vec3 > points(nbp * 2);
+            for (std::size_t p = 0; p < nbp; ++p)
+            {
+                for (Size c = 0; c < nc; ++c)
+                {
+                    points[2*p+0][c] = m_currentValues[p*dimension+c];
+                    points[2*p+1][c] = m_lastRecordedX[p*dimension+c];
+                }
+            }
+            vparams->drawTool()->drawLines(points, 1, sofa::type::RGBAColor(1.0f,0.0f,0.5f,1.0f));
+        }
+        return;
+    }
     if (nextValidLines.empty() && last_time != getContext()->getTime())
     {
         last_time = getContext()->getTime();
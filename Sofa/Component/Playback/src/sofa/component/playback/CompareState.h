@@ -68,6 +68,12 @@ public:
     void draw(const core::visual::VisualParams* vparams) override;
 
 protected :
+    /// Binary state records (.sst) only: compare the recorded vectors to the current ones
+    void compareStateRecordFrame(const StateRecordFrame& frame);
+
+    /// Mean absolute difference between the recorded values and the values of a vector of the state
+    SReal compareRecordedVector(const type::vector<SReal>& values, core::ConstVecId id, Size dimension);
+
     /// total error for positions
     double totalError_X;
     double dofError_X;
@@ -78,6 +84,7 @@ protected :
     double last_time;
     std::string last_X, last_V;
     std::vector<std::string> nextValidLines;
+    type::vector<SReal> m_lastRecordedX, m_currentValues;
 };
 
 /// Create CompareState component in the graph each time needed
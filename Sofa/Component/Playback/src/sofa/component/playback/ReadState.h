@@ -23,16 +23,19 @@
 #include <sofa/component/playback/config.h>
 
 #include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/VecId.h>
 #include <sofa/simulation/AnimateBeginEvent.h>
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/simulation/Visitor.h>
 #include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/component/playback/StateRecord.h>
 
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
 #include <zlib.h>
 #endif
 
 #include <fstream>
+#include <memory>
 
 namespace sofa::component::playback
 {
@@ -58,6 +61,8 @@ protected:
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
     gzFile gzfile;
 #endif
+    std::unique_ptr<StateRecordReader> m_stateRecord;
+    std::size_t m_stateRecordFrame;
     double nextTime;
     double lastTime;
     double loopTime;
@@ -82,6 +87,13 @@ public:
     /// Read the next values in the file corresponding to the last timestep before the given time
     bool readNext(double time, std::vector<std::string>& lines);
 
+    /// Binary state records (.sst) only: read the last frame recorded before the given time.
+    /// The frame is left empty if it was already read.
+    bool readNextFrame(double time, StateRecordFrame& frame);
+
+    /// Copy the values of a recorded vector into a vector of the mechanical state, resizing it if needed
+    bool copyRecordedVector(const type::vector<SReal>& values, core::VecId id, Size dimension);
+
     /// Pre-construction check method called by ObjectFactory.
     /// Check that DataTypes matches the MechanicalState.
     template<class T>
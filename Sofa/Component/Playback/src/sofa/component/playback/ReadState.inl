@@ -31,6 +31,7 @@ using sofa::simulation::mechanicalvisitor::MechanicalProjectPositionAndVelocityV
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor;
 
+#include <cmath>
 #include <cstring>
 #include <sstream>
 
@@ -52,6 +53,7 @@ ReadState::ReadState()
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
     , gzfile(nullptr)
 #endif
+    , m_stateRecordFrame(StateRecordReader::InvalidFrame)
     , nextTime(0)
     , lastTime(0)
     , loopTime(0)
@@ -98,12 +100,23 @@ void ReadState::reset()
         gzfile = nullptr;
     }
 #endif
+    m_stateRecord.reset();
+    m_stateRecordFrame = StateRecordReader::InvalidFrame;
 
     const std::string& filename = d_filename.getFullPath();
     if (filename.empty())
     {
         msg_error() << "ERROR: empty filename";
     }
+    else if (StateRecordReader::isStateRecordFile(filename))
+    {
+        m_stateRecord = std::make_unique<StateRecordReader>();
+        if (!m_stateRecord->open(filename))
+        {
+            msg_error() << "Error opening state record file " << filename;
+            m_stateRecord.reset();
+        }
+    }
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
     else if (filename.size() >= 3 && filename.substr(filename.size()-3)==".gz")
     {
@@ -230,17 +243,78 @@ bool ReadState::readNext(double time, std::vector<std::string>& validLines)
     return true;
 }
 
+bool ReadState::readNextFrame(double time, StateRecordFrame& frame)
+{
+    frame.blocks.clear();
+    if (!mmodel || !m_stateRecord) return false;
+    lastTime = time;
+
+    const std::size_t nbFrames = m_stateRecord->getNbFrames();
+    if (nbFrames == 0) return true;
+
+    // the frames are indexed: the frame at the given time is found directly, without reading the previous ones
+    const double duration = m_stateRecord->getTime(nbFrames - 1);
+    if (d_loop.getValue() && duration > 0 && time > duration)
+        time = std::fmod(time, duration);
+
+    const std::size_t i = m_stateRecord->findFrame(time);
+    if (i == StateRecordReader::InvalidFrame || i == m_stateRecordFrame)
+        return true;
+
+    m_stateRecordFrame = i;
+    if (!m_stateRecord->readFrame(i, frame))
+    {
+        msg_error() << "Error reading frame " << i << " of " << d_filename.getFullPath();
+        frame.blocks.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ReadState::copyRecordedVector(const type::vector<SReal>& values, core::VecId id, Size dimension)
+{
+    if (dimension == 0 || values.size() % dimension != 0)
+    {
+        msg_error() << "The recorded vector does not match the type of " << mmodel->getName();
+        return false;
+    }
+    if (values.size() / dimension != mmodel->getSize())
+        mmodel->resize(static_cast<Size>(values.size() / dimension));
+    mmodel->copyFromBuffer(id, values.data(), static_cast<unsigned int>(values.size()));
+    return true;
+}
+
 void ReadState::processReadState()
 {
     double time = getContext()->getTime() + d_shift.getValue();
-    std::vector<std::string> validLines;
-    if (!readNext(time, validLines)) return;
     bool updated = false;
 
     const double scale = d_scalePos.getValue();
     const Vec3& rotation = d_rotation.getValue();
     const Vec3& translation = d_translation.getValue();
 
+    std::vector<std::string> validLines;
+    if (m_stateRecord)
+    {
+        StateRecordFrame frame;
+        if (!readNextFrame(time, frame)) return;
+        if (const auto* x = frame.getValues(StateRecordVector::POSITION))
+        {
+            if (copyRecordedVector(*x, core::VecId::position(), mmodel->getCoordDimension()))
+            {
+                mmodel->applyScale(scale,scale,scale);
+                mmodel->applyRotation(rotation[0],rotation[1],rotation[2]);
+                mmodel->applyTranslation(translation[0],translation[1],translation[2]);
+                updated = true;
+            }
+        }
+        if (const auto* v = frame.getValues(StateRecordVector::VELOCITY))
+        {
+            updated |= copyRecordedVector(*v, core::VecId::velocity(), mmodel->getDerivDimension());
+        }
+    }
+    else if (!readNext(time, validLines)) return;
+
     for (std::vector<std::string>::iterator it=validLines.begin(); it!=validLines.end(); ++it)
     {
         std::istringstream str(*it);
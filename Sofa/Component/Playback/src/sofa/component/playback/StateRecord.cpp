@@ -0,0 +1,504 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/playback/StateRecord.h>
+
+#if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace sofa::component::playback
+{
+
+namespace
+{
+
+constexpr char FileMagic[8] = { 'S', 'O', 'F', 'A', 'S', 'S', 'T', '1' };
+constexpr char IndexMagic[8] = { 'S', 'S', 'T', 'I', 'N', 'D', 'E', 'X' };
+constexpr std::uint32_t FileVersion = 1;
+constexpr std::size_t NbVectors = 4;
+
+constexpr std::uint32_t FLAG_QUANTIZED = 1;
+constexpr std::uint8_t BLOCK_DELTA = 1;
+constexpr std::uint8_t BLOCK_DEFLATE = 2;
+
+template<class T>
+void writeValue(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+bool readValue(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/// Group the i-th bytes of all the values together, so that the exponents and the high-order
+/// bytes, which change slowly, form long runs
+void shuffleBytes(const std::vector<unsigned char>& in, std::vector<unsigned char>& out, std::size_t width)
+{
+    const std::size_t n = in.size() / width;
+    out.resize(in.size());
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t b = 0; b < width; ++b)
+            out[b * n + i] = in[i * width + b];
+}
+
+void unshuffleBytes(const std::vector<unsigned char>& in, std::vector<unsigned char>& out, std::size_t width)
+{
+    const std::size_t n = in.size() / width;
+    out.resize(in.size());
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t b = 0; b < width; ++b)
+            out[i * width + b] = in[b * n + i];
+}
+
+std::size_t getValueWidth(std::uint32_t flags)
+{
+    return (flags & FLAG_QUANTIZED) ? sizeof(float) : sizeof(double);
+}
+
+} // anonymous namespace
+
+const type::vector<SReal>* StateRecordFrame::getValues(StateRecordVector vector) const
+{
+    for (const auto& block : blocks)
+    {
+        if (block.vector == vector)
+            return &block.values;
+    }
+    return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// StateRecordWriter
+
+StateRecordWriter::~StateRecordWriter()
+{
+    close();
+}
+
+bool StateRecordWriter::open(const std::string& filename, const Options& options)
+{
+    close();
+
+    m_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+        return false;
+
+    m_options = options;
+    m_flags = options.quantize ? FLAG_QUANTIZED : 0;
+    m_file.write(FileMagic, sizeof(FileMagic));
+    writeValue(m_file, FileVersion);
+    writeValue(m_file, m_flags);
+    writeValue(m_file, std::uint32_t(options.keyframeInterval));
+
+    m_index.clear();
+    m_previous.assign(NbVectors, {});
+    m_stop = false;
+    if (m_options.async)
+    {
+        m_thread = std::thread(&StateRecordWriter::run, this);
+    }
+    return static_cast<bool>(m_file);
+}
+
+void StateRecordWriter::write(StateRecordFrame frame)
+{
+    if (!isOpen())
+        return;
+
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(frame));
+        }
+        m_condition.notify_one();
+    }
+    else
+    {
+        writeFrame(frame);
+    }
+}
+
+void StateRecordWriter::run()
+{
+    while (true)
+    {
+        StateRecordFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+                return;
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        writeFrame(frame);
+    }
+}
+
+void StateRecordWriter::close()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_one();
+        m_thread.join();
+    }
+
+    if (!m_file.is_open())
+        return;
+
+    const std::uint64_t indexOffset = m_file.tellp();
+    writeValue(m_file, std::uint64_t(m_index.size()));
+    for (const auto& entry : m_index)
+    {
+        writeValue(m_file, entry.time);
+        writeValue(m_file, entry.offset);
+        writeValue(m_file, entry.keyframe);
+    }
+    writeValue(m_file, indexOffset);
+    m_file.write(IndexMagic, sizeof(IndexMagic));
+    m_file.close();
+    m_index.clear();
+}
+
+void StateRecordWriter::writeFrame(const StateRecordFrame& frame)
+{
+    const std::size_t width = getValueWidth(m_flags);
+    const bool keyframe = m_options.keyframeInterval <= 1 || m_index.size() % m_options.keyframeInterval == 0;
+
+    if (keyframe)
+    {
+        // the frames following a keyframe only depend on it
+        for (auto& previous : m_previous)
+            previous.clear();
+    }
+
+    m_index.push_back({ frame.time, std::uint64_t(m_file.tellp()), std::uint8_t(keyframe) });
+    writeValue(m_file, frame.time);
+    writeValue(m_file, std::uint8_t(keyframe));
+    writeValue(m_file, std::uint32_t(frame.blocks.size()));
+
+    for (const auto& block : frame.blocks)
+    {
+        const std::size_t n = block.values.size();
+        m_buffer.resize(n * width);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (width == sizeof(float))
+            {
+                const float v = static_cast<float>(block.values[i]);
+                std::memcpy(&m_buffer[i * width], &v, width);
+            }
+            else
+            {
+                const double v = static_cast<double>(block.values[i]);
+                std::memcpy(&m_buffer[i * width], &v, width);
+            }
+        }
+
+        std::uint8_t encoding = 0;
+        auto& previous = m_previous[std::size_t(block.vector) % NbVectors];
+        if (!keyframe && previous.size() == m_buffer.size())
+        {
+            encoding |= BLOCK_DELTA;
+            for (std::size_t i = 0; i < m_buffer.size(); ++i)
+            {
+                const unsigned char value = m_buffer[i];
+                m_buffer[i] ^= previous[i];
+                previous[i] = value;
+            }
+        }
+        else
+        {
+            previous = m_buffer;
+        }
+
+        shuffleBytes(m_buffer, m_shuffled, width);
+        const std::vector<unsigned char>* stored = &m_shuffled;
+#if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
+        if (m_options.compress && !m_shuffled.empty())
+        {
+            uLongf compressedSize = compressBound(uLong(m_shuffled.size()));
+            m_compressed.resize(compressedSize);
+            if (compress2(m_compressed.data(), &compressedSize, m_shuffled.data(), uLong(m_shuffled.size()), Z_BEST_SPEED) == Z_OK
+                && compressedSize < m_shuffled.size())
+            {
+                m_compressed.resize(compressedSize);
+                stored = &m_compressed;
+                encoding |= BLOCK_DEFLATE;
+            }
+        }
+#endif
+
+        writeValue(m_file, std::uint8_t(block.vector));
+        writeValue(m_file, encoding);
+        writeValue(m_file, std::uint64_t(n));
+        writeValue(m_file, std::uint64_t(stored->size()));
+        m_file.write(reinterpret_cast<const char*>(stored->data()), std::streamsize(stored->size()));
+    }
+    m_file.flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// StateRecordReader
+
+bool StateRecordReader::isStateRecordFile(const std::string& filename)
+{
+    return filename.size() >= 4 && filename.substr(filename.size() - 4) == ".sst";
+}
+
+bool StateRecordReader::open(const std::string& filename)
+{
+    close();
+
+    m_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!m_file.is_open())
+        return false;
+
+    char magic[sizeof(FileMagic)];
+    std::uint32_t version = 0, keyframeInterval = 0;
+    if (!m_file.read(magic, sizeof(magic)) || std::memcmp(magic, FileMagic, sizeof(magic)) != 0
+        || !readValue(m_file, version) || version != FileVersion
+        || !readValue(m_file, m_flags) || !readValue(m_file, keyframeInterval))
+    {
+        close();
+        return false;
+    }
+    m_dataBegin = m_file.tellg();
+
+    // a record which was not closed has no index: rebuild it from the frame headers
+    if (!readIndex() && !scanFrames())
+    {
+        close();
+        return false;
+    }
+    m_previous.assign(NbVectors, {});
+    return true;
+}
+
+void StateRecordReader::close()
+{
+    if (m_file.is_open())
+        m_file.close();
+    m_file.clear();
+    m_index.clear();
+    m_lastDecodedFrame = InvalidFrame;
+}
+
+bool StateRecordReader::readIndex()
+{
+    m_file.clear();
+    m_file.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = m_file.tellg();
+    if (fileSize < m_dataBegin + sizeof(std::uint64_t) * 2 + sizeof(IndexMagic))
+        return false;
+
+    m_file.seekg(std::streamoff(fileSize - sizeof(std::uint64_t) - sizeof(IndexMagic)));
+    std::uint64_t indexOffset = 0;
+    char magic[sizeof(IndexMagic)];
+    if (!readValue(m_file, indexOffset) || !m_file.read(magic, sizeof(magic))
+        || std::memcmp(magic, IndexMagic, sizeof(magic)) != 0 || indexOffset < m_dataBegin || indexOffset >= fileSize)
+        return false;
+
+    m_file.seekg(std::streamoff(indexOffset));
+    std::uint64_t nbFrames = 0;
+    if (!readValue(m_file, nbFrames))
+        return false;
+    m_index.resize(nbFrames);
+    for (auto& entry : m_index)
+    {
+        if (!readValue(m_file, entry.time) || !readValue(m_file, entry.offset) || !readValue(m_file, entry.keyframe))
+        {
+            m_index.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StateRecordReader::scanFrames()
+{
+    m_file.clear();
+    m_file.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = m_file.tellg();
+    m_file.seekg(std::streamoff(m_dataBegin));
+    m_index.clear();
+
+    while (true)
+    {
+        IndexEntry entry;
+        entry.offset = m_file.tellg();
+        std::uint32_t nbBlocks = 0;
+        if (!readValue(m_file, entry.time) || !readValue(m_file, entry.keyframe) || !readValue(m_file, nbBlocks))
+            break;
+
+        bool complete = true;
+        for (std::uint32_t b = 0; b < nbBlocks && complete; ++b)
+        {
+            std::uint8_t vector, encoding;
+            std::uint64_t nbValues, nbBytes;
+            complete = readValue(m_file, vector) && readValue(m_file, encoding)
+                && readValue(m_file, nbValues) && readValue(m_file, nbBytes)
+                && std::uint64_t(m_file.tellg()) + nbBytes <= fileSize;
+            if (complete)
+                m_file.seekg(std::streamoff(nbBytes), std::ios::cur);
+        }
+        if (!complete)
+            break;
+        m_index.push_back(entry);
+    }
+    m_file.clear();
+    return true;
+}
+
+std::size_t StateRecordReader::findFrame(double time) const
+{
+    const auto it = std::upper_bound(m_index.begin(), m_index.end(), time,
+        [](double t, const IndexEntry& entry) { return t < entry.time; });
+    if (it == m_index.begin())
+        return InvalidFrame;
+    return std::size_t(it - m_index.begin()) - 1;
+}
+
+bool StateRecordReader::readFrame(std::size_t frame, StateRecordFrame& result)
+{
+    if (!isOpen() || frame >= m_index.size())
+        return false;
+
+    std::size_t start = frame;
+    while (start > 0 && !m_index[start].keyframe)
+        --start;
+    if (m_lastDecodedFrame != InvalidFrame && m_lastDecodedFrame >= start && m_lastDecodedFrame < frame)
+        start = m_lastDecodedFrame + 1;
+
+    for (std::size_t f = start; f < frame; ++f)
+    {
+        if (!decodeFrame(f, nullptr))
+            return false;
+    }
+    return decodeFrame(frame, &result);
+}
+
+bool StateRecordReader::decodeFrame(std::size_t frame, StateRecordFrame* result)
+{
+    m_lastDecodedFrame = InvalidFrame;
+    m_file.clear();
+    m_file.seekg(std::streamoff(m_index[frame].offset));
+
+    const std::size_t width = getValueWidth(m_flags);
+    double time = 0;
+    std::uint8_t keyframe = 0;
+    std::uint32_t nbBlocks = 0;
+    if (!readValue(m_file, time) || !readValue(m_file, keyframe) || !readValue(m_file, nbBlocks))
+        return false;
+
+    if (keyframe)
+    {
+        for (auto& previous : m_previous)
+            previous.clear();
+    }
+
+    if (result)
+    {
+        result->time = time;
+        result->blocks.resize(nbBlocks);
+    }
+
+    for (std::uint32_t b = 0; b < nbBlocks; ++b)
+    {
+        std::uint8_t vector, encoding;
+        std::uint64_t nbValues, nbBytes;
+        if (!readValue(m_file, vector) || !readValue(m_file, encoding)
+            || !readValue(m_file, nbValues) || !readValue(m_file, nbBytes))
+            return false;
+
+        m_stored.resize(nbBytes);
+        if (!m_file.read(reinterpret_cast<char*>(m_stored.data()), std::streamsize(nbBytes)))
+            return false;
+
+        if (encoding & BLOCK_DEFLATE)
+        {
+#if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
+            uLongf size = uLongf(nbValues * width);
+            m_shuffled.resize(size);
+            if (uncompress(m_shuffled.data(), &size, m_stored.data(), uLong(nbBytes)) != Z_OK || size != nbValues * width)
+                return false;
+            m_stored.swap(m_shuffled);
+#else
+            return false;
+#endif
+        }
+        if (m_stored.size() != nbValues * width)
+            return false;
+        unshuffleBytes(m_stored, m_shuffled, width);
+
+        auto& previous = m_previous[vector % NbVectors];
+        if (encoding & BLOCK_DELTA)
+        {
+            if (previous.size() != m_shuffled.size())
+                return false;
+            for (std::size_t i = 0; i < previous.size(); ++i)
+                previous[i] ^= m_shuffled[i];
+        }
+        else
+        {
+            previous.swap(m_shuffled);
+        }
+
+        if (result)
+        {
+            auto& block = result->blocks[b];
+            block.vector = static_cast<StateRecordVector>(vector);
+            block.values.resize(nbValues);
+            for (std::size_t i = 0; i < nbValues; ++i)
+            {
+                if (width == sizeof(float))
+                {
+                    float v;
+                    std::memcpy(&v, &previous[i * width], width);
+                    block.values[i] = static_cast<SReal>(v);
+                }
+                else
+                {
+                    double v;
+                    std::memcpy(&v, &previous[i * width], width);
+                    block.values[i] = static_cast<SReal>(v);
+                }
+            }
+        }
+    }
+
+    m_lastDecodedFrame = frame;
+    return true;
+}
+
+} // namespace sofa::component::playback
@@ -0,0 +1,165 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/playback/config.h>
+
+#include <sofa/type/vector.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace sofa::component::playback
+{
+
+/// State vectors which can be stored in a state record
+enum class StateRecordVector : std::uint8_t
+{
+    POSITION = 0,
+    REST_POSITION,
+    VELOCITY,
+    FORCE
+};
+
+/// Values of the recorded state vectors at a given time.
+/// Each vector is stored as a flat array of scalars, as in BaseMechanicalState::copyToBuffer.
+struct SOFA_COMPONENT_PLAYBACK_API StateRecordFrame
+{
+    struct Block
+    {
+        StateRecordVector vector;
+        type::vector<SReal> values;
+    };
+
+    double time { 0 };
+    type::vector<Block> blocks;
+
+    /// Return the values of the given vector, or nullptr if it is not part of the frame
+    const type::vector<SReal>* getValues(StateRecordVector vector) const;
+};
+
+/** Binary state record (.sst files), written by WriteState and read by ReadState and CompareState.
+ *
+ * The file is a sequence of frames, followed by an index of the frames written when the record is
+ * closed. Every keyframeInterval frames, a keyframe stores the absolute values of the vectors, and
+ * the other frames store the bitwise difference (xor) with the previous frame, which compresses
+ * well. A frame is then found by a binary search in the index and decoded from the previous
+ * keyframe, instead of parsing the file from the beginning.
+ */
+class SOFA_COMPONENT_PLAYBACK_API StateRecordWriter
+{
+public:
+    struct Options
+    {
+        bool quantize { false };          ///< store the values as 32-bit floats
+        bool compress { true };           ///< compress the frames with zlib
+        unsigned int keyframeInterval { 25 }; ///< number of frames between two keyframes (1: no delta encoding)
+        bool async { true };              ///< encode and write the frames in a background thread
+    };
+
+    StateRecordWriter() = default;
+    StateRecordWriter(const StateRecordWriter&) = delete;
+    StateRecordWriter& operator=(const StateRecordWriter&) = delete;
+    ~StateRecordWriter();
+
+    bool open(const std::string& filename, const Options& options);
+    bool isOpen() const { return m_file.is_open(); }
+
+    /// Write a frame. In asynchronous mode, the frame is only queued and written later.
+    void write(StateRecordFrame frame);
+
+    /// Wait for the queued frames to be written, and write the index of the frames
+    void close();
+
+protected:
+    void writeFrame(const StateRecordFrame& frame);
+    void run();
+
+    std::ofstream m_file;
+    Options m_options;
+    std::uint32_t m_flags { 0 };
+
+    struct IndexEntry
+    {
+        double time;
+        std::uint64_t offset;
+        std::uint8_t keyframe;
+    };
+    std::vector<IndexEntry> m_index;
+    std::vector<std::vector<unsigned char> > m_previous; ///< encoded values of the previous frame, per vector
+    std::vector<unsigned char> m_buffer, m_shuffled, m_compressed;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<StateRecordFrame> m_queue;
+    bool m_stop { false };
+};
+
+/// Random access reader of a binary state record (see StateRecordWriter)
+class SOFA_COMPONENT_PLAYBACK_API StateRecordReader
+{
+public:
+    static constexpr std::size_t InvalidFrame = std::size_t(-1);
+
+    bool open(const std::string& filename);
+    bool isOpen() const { return m_file.is_open(); }
+    void close();
+
+    std::size_t getNbFrames() const { return m_index.size(); }
+    double getTime(std::size_t frame) const { return m_index[frame].time; }
+
+    /// Return the last frame recorded before or at the given time, or InvalidFrame
+    std::size_t findFrame(double time) const;
+
+    /// Decode the given frame. Reading the frames in order only decodes each frame once.
+    bool readFrame(std::size_t frame, StateRecordFrame& result);
+
+    /// Return true if the file names a binary state record
+    static bool isStateRecordFile(const std::string& filename);
+
+protected:
+    bool readIndex();
+    bool scanFrames();
+    bool decodeFrame(std::size_t frame, StateRecordFrame* result);
+
+    std::ifstream m_file;
+    std::uint32_t m_flags { 0 };
+    std::uint64_t m_dataBegin { 0 };
+
+    struct IndexEntry
+    {
+        double time;
+        std::uint64_t offset;
+        std::uint8_t keyframe;
+    };
+    std::vector<IndexEntry> m_index;
+    std::size_t m_lastDecodedFrame { InvalidFrame };
+    std::vector<std::vector<unsigned char> > m_previous;
+    std::vector<unsigned char> m_stored, m_shuffled;
+};
+
+} // namespace sofa::component::playback
@@ -31,12 +31,14 @@
 #include <sofa/defaulttype/DataTypeInfo.h>
 #include <sofa/simulation/Visitor.h>
 #include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/component/playback/StateRecord.h>
 
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
 #include <zlib.h>
 #endif
 
 #include <fstream>
+#include <memory>
 
 namespace sofa::component::playback
 {
@@ -63,6 +65,10 @@ public:
     Data < type::vector<unsigned int> > d_DOFsV; ///< set the velocity DOFs to write
     Data < double > d_stopAt; ///< stop the simulation when the given threshold is reached
     Data < double > d_keperiod; ///< set the period to measure the kinetic energy increase
+    Data < bool > d_quantize; ///< binary files (.sst) only: store the values as 32-bit floats
+    Data < bool > d_compress; ///< binary files (.sst) only: compress the recorded frames
+    Data < unsigned int > d_keyframeInterval; ///< binary files (.sst) only: number of frames between two keyframes
+    Data < bool > d_asyncWrite; ///< binary files (.sst) only: write the recorded frames in a background thread
 
 protected:
     core::behavior::BaseMechanicalState* mmodel;
@@ -70,6 +76,7 @@ protected:
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
     gzFile gzfile;
 #endif
+    std::unique_ptr<StateRecordWriter> m_stateRecord;
     unsigned int nextIteration;
     double lastTime;
     bool kineticEnergyThresholdReached;
@@ -90,6 +97,8 @@ public:
 
     void reset() override;
 
+    void cleanup() override;
+
     void handleEvent(sofa::core::objectmodel::Event* event) override;
 
 
@@ -44,6 +44,10 @@ WriteState::WriteState()
     , d_DOFsV( initData(&d_DOFsV, type::vector<unsigned int>(0), "DOFsV", "set the velocity DOFs to write"))
     , d_stopAt( initData(&d_stopAt, 0.0, "stopAt", "stop the simulation when the given threshold is reached"))
     , d_keperiod( initData(&d_keperiod, 0.0, "keperiod", "set the period to measure the kinetic energy increase"))
+    , d_quantize( initData(&d_quantize, false, "quantize", "binary files (.sst) only: store the values as 32-bit floats"))
+    , d_compress( initData(&d_compress, true, "compress", "binary files (.sst) only: compress the recorded frames"))
+    , d_keyframeInterval( initData(&d_keyframeInterval, 25u, "keyframeInterval", "binary files (.sst) only: number of frames between two keyframes, the other frames store the difference with the previous one (1: no difference encoding)"))
+    , d_asyncWrite( initData(&d_asyncWrite, true, "asyncWrite", "binary files (.sst) only: write the recorded frames in a background thread"))
     , mmodel(nullptr)
     , outfile(nullptr)
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
@@ -86,6 +90,22 @@ void WriteState::init()
     const std::string& filename = d_filename.getFullPath();
     if (!filename.empty())
     {
+        if (StateRecordReader::isStateRecordFile(filename))
+        {
+            StateRecordWriter::Options options;
+            options.quantize = d_quantize.getValue();
+            options.compress = d_compress.getValue();
+            options.keyframeInterval = d_keyframeInterval.getValue();
+            options.async = d_asyncWrite.getValue();
+
+            m_stateRecord = std::make_unique<StateRecordWriter>();
+            if (!m_stateRecord->open(filename, options))
+            {
+                msg_error() << "Error creating file " << filename;
+                m_stateRecord.reset();
+            }
+        }
+        else
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
         if (filename.size() >= 3 && filename.substr(filename.size()-3)==".gz")
         {
@@ -226,8 +246,15 @@ if (outfile)
 if (gzfile)
     gzclose(gzfile);
 #endif
+m_stateRecord.reset();
 init();
 }
+
+void WriteState::cleanup()
+{
+    // wait for the pending frames and write the index of the binary record
+    m_stateRecord.reset();
+}
 void WriteState::reset()
 {
     nextIteration = 0;
@@ -246,7 +273,7 @@ void WriteState::handleEvent(sofa::core::objectmodel::Event* event)
     if (simulation::AnimateBeginEvent::checkEventType(event))
     {
         if (!mmodel) return;
-        if (!outfile
+        if (!outfile && !m_stateRecord
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
             && !gzfile
 #endif
@@ -318,6 +345,29 @@ void WriteState::handleEvent(sofa::core::objectmodel::Event* event)
         }
         if (writeCurrent)
         {
+            if (m_stateRecord)
+            {
+                // only copy the vectors here, they are encoded and written by the StateRecordWriter
+                StateRecordFrame frame;
+                frame.time = time;
+                const auto addBlock = [&frame, this](StateRecordVector vector, core::ConstVecId id, Size dimension)
+                {
+                    auto& block = frame.blocks.emplace_back();
+                    block.vector = vector;
+                    block.values.resize(mmodel->getSize() * dimension);
+                    mmodel->copyToBuffer(block.values.data(), id, static_cast<unsigned int>(block.values.size()));
+                };
+                if (d_writeX.getValue())
+                    addBlock(StateRecordVector::POSITION, core::VecId::position(), mmodel->getCoordDimension());
+                if (d_writeX0.getValue())
+                    addBlock(StateRecordVector::REST_POSITION, core::VecId::restPosition(), mmodel->getCoordDimension());
+                if (d_writeV.getValue())
+                    addBlock(StateRecordVector::VELOCITY, core::VecId::velocity(), mmodel->getDerivDimension());
+                if (d_writeF.getValue())
+                    addBlock(StateRecordVector::FORCE, core::VecId::force(), mmodel->getDerivDimension());
+                m_stateRecord->write(std::move(frame));
+            }
+            else
 #if SOFA_COMPONENT_PLAYBACK_HAVE_ZLIB
             if (gzfile)
             {
@@ -28,6 +28,14 @@ using sofa::simulation::Node;
 #include <sofa/type/Vec.h>
 using sofa::type::Vec3;
 
+#include <sofa/component/playback/CompareState.h>
+using sofa::component::playback::CompareState;
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 class ReadState_test : public BaseSimulationTest
 {
 public:
@@ -63,6 +71,116 @@ public:
         return true;
     }
 
+    const std::string m_stateRecordFilename = std::string(SOFA_COMPONENT_PLAYBACK_TEST_BUILD_DIR) + "particlesGravity.sst";
+    static constexpr int nbRecordedSteps = 10;
+
+    /// Three falling particles, with an additional component reading or writing their state
+    Node::SPtr createFallingParticles(const std::string& stateComponent, const std::map<std::string, std::string>& params,
+                                      const Vec3& gravity = Vec3(0.0, 0.0, -9.81))
+    {
+        const auto simulation = sofa::simpleapi::createSimulation();
+        const Node::SPtr root = sofa::simpleapi::createRootNode(simulation, "root");
+        for (const auto& plugin : { "Sofa.Component.Playback", "Sofa.Component.StateContainer", "Sofa.Component.ODESolver.Backward",
+                                    "Sofa.Component.LinearSolver.Iterative", "Sofa.Component.Mass" })
+        {
+            sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name", plugin } });
+        }
+        root->setGravity(gravity);
+        root->setDt(0.01);
+
+        sofa::simpleapi::createObject(root, "EulerImplicitSolver", {});
+        sofa::simpleapi::createObject(root, "CGLinearSolver", {{"iterations", "25"}, {"tolerance", "1e-5"}, {"threshold", "1e-5"}});
+        sofa::simpleapi::createObject(root, "MechanicalObject", {{"name", "particles"}, {"position", "0 0 0  1 0 0  0 1 0"}});
+        sofa::simpleapi::createObject(root, "UniformMass", {{"totalMass", "1"}});
+        sofa::simpleapi::createObject(root, stateComponent, params);
+        sofa::simulation::node::initRoot(root.get());
+        return root;
+    }
+
+    /// Record the falling particles with WriteState in a binary state record, and return the recorded positions
+    std::vector<std::string> writeStateRecord()
+    {
+        std::vector<std::string> positions;
+        const Node::SPtr root = createFallingParticles("WriteState", {{"filename", m_stateRecordFilename},
+            {"writeX", "1"}, {"writeV", "1"}, {"period", "0.01"}, {"keyframeInterval", "4"}});
+        const auto* particles = root->getObject("particles");
+        for (int i = 0; i < nbRecordedSteps; ++i)
+        {
+            // the state is recorded at the beginning of the time step
+            positions.push_back(particles->findData("position")->getValueString());
+            sofa::simulation::node::animate(root.get(), 0.01);
+        }
+
+        // the index of the frames is written when the record is closed
+        sofa::simulation::node::unload(root);
+        return positions;
+    }
+
+    /// Read a binary state record written by WriteState, into a MechanicalObject of another size
+    bool testStateRecord()
+    {
+        const std::vector<std::string> recordedPositions = writeStateRecord();
+
+        const auto simulation = sofa::simpleapi::createSimulation();
+        const Node::SPtr root = sofa::simpleapi::createRootNode(simulation, "root");
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name","Sofa.Component.Playback" } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name","Sofa.Component.StateContainer" } });
+        root->setGravity(Vec3(0.0,0.0,0.0));
+        root->setDt(0.01);
+
+        const auto meca = sofa::simpleapi::createObject(root, "MechanicalObject", {{"size", "1"}});
+        sofa::simpleapi::createObject(root, "ReadState", {{"filename", m_stateRecordFilename}, {"loop", "1"}});
+        sofa::simulation::node::initRoot(root.get());
+
+        // the MechanicalObject is resized to the recorded state
+        EXPECT_EQ(meca->findData("size")->getValueString(), "3");
+        EXPECT_EQ(meca->findData("position")->getValueString(), recordedPositions[0]);
+
+        for (int i = 1; i < nbRecordedSteps; ++i)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+            EXPECT_EQ(meca->findData("position")->getValueString(), recordedPositions[i - 1]) << "step " << i;
+        }
+
+        // after the last recorded frame, the record is read again from the beginning
+        for (int i = 0; i < 4; ++i)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+        }
+        const auto frame = std::find(recordedPositions.begin(), recordedPositions.end(), meca->findData("position")->getValueString());
+        EXPECT_NE(frame, recordedPositions.end());
+        EXPECT_LT(frame - recordedPositions.begin(), nbRecordedSteps / 2);
+
+        sofa::simulation::node::unload(root);
+        return true;
+    }
+
+    /// Compare the falling particles to a binary state record written by WriteState
+    bool testCompareStateRecord()
+    {
+        writeStateRecord();
+
+        // CompareState starts from the recorded state (see ReadState::bwdInit): the simulations differ by their gravity
+        const auto compare = [this](const Vec3& gravity)
+        {
+            const Node::SPtr root = createFallingParticles("CompareState", {{"filename", m_stateRecordFilename}}, gravity);
+            for (int i = 0; i < nbRecordedSteps; ++i)
+            {
+                sofa::simulation::node::animate(root.get(), 0.01);
+            }
+            auto* compareState = root->getTreeObject<CompareState>();
+            const double error = compareState ? compareState->getTotalError() : -1.;
+            sofa::simulation::node::unload(root);
+            return error;
+        };
+
+        // same simulation: no difference
+        EXPECT_NEAR(compare(Vec3(0.0, 0.0, -9.81)), 0., 1e-12);
+        // the simulation differs from the record
+        EXPECT_GT(compare(Vec3(0.0, 0.0, 0.0)), 0.5);
+        return true;
+    }
+
     /// Run seven steps of simulation then check results
     bool testLoadFailure()
     {
@@ -96,3 +214,15 @@ TEST_F(ReadState_test , test_loadFailure)
 {
     ASSERT_TRUE( this->testLoadFailure() );
 }
+
+/// Test : write a binary state record and read it back
+TEST_F(ReadState_test , test_stateRecord)
+{
+    ASSERT_TRUE( this->testStateRecord() );
+}
+
+/// Test : compare a simulation to a binary state record
+TEST_F(ReadState_test , test_compareStateRecord)
+{
+    ASSERT_TRUE( this->testCompareStateRecord() );
+}
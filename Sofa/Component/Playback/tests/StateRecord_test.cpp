@@ -0,0 +1,174 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/component/playback/StateRecord.h>
+using namespace sofa::component::playback;
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+
+class StateRecord_test : public BaseTest
+{
+public:
+    const std::string filename = std::string(SOFA_COMPONENT_PLAYBACK_TEST_BUILD_DIR) + "stateRecord.sst";
+    static constexpr int nbFrames = 60;
+    static constexpr int nbValues = 30;
+
+    static SReal value(int frame, int i)
+    {
+        return std::sin(0.1 * frame + i) * (i + 1);
+    }
+
+    void writeRecord(const StateRecordWriter::Options& options)
+    {
+        StateRecordWriter writer;
+        ASSERT_TRUE(writer.open(filename, options));
+        for (int f = 0; f < nbFrames; ++f)
+        {
+            StateRecordFrame frame;
+            frame.time = 0.01 * f;
+            frame.blocks.resize(2);
+            frame.blocks[0].vector = StateRecordVector::POSITION;
+            frame.blocks[1].vector = StateRecordVector::VELOCITY;
+            for (int i = 0; i < nbValues; ++i)
+            {
+                frame.blocks[0].values.push_back(value(f, i));
+                frame.blocks[1].values.push_back(-value(f, i));
+            }
+            writer.write(std::move(frame));
+        }
+    }
+
+    /// Read the frames in an arbitrary order and compare them to the written values
+    void checkRecord(SReal tolerance)
+    {
+        StateRecordReader reader;
+        ASSERT_TRUE(reader.open(filename));
+        ASSERT_EQ(reader.getNbFrames(), std::size_t(nbFrames));
+
+        EXPECT_EQ(reader.findFrame(-1.), StateRecordReader::InvalidFrame);
+        EXPECT_EQ(reader.findFrame(0.255), 25u);
+        EXPECT_EQ(reader.findFrame(100.), std::size_t(nbFrames - 1));
+
+        StateRecordFrame frame;
+        for (const int f : { 37, 0, 1, 2, 59, 24, 25, 26, 12 })
+        {
+            ASSERT_TRUE(reader.readFrame(f, frame));
+            EXPECT_DOUBLE_EQ(frame.time, 0.01 * f);
+
+            const auto* x = frame.getValues(StateRecordVector::POSITION);
+            const auto* v = frame.getValues(StateRecordVector::VELOCITY);
+            ASSERT_NE(x, nullptr);
+            ASSERT_NE(v, nullptr);
+            EXPECT_EQ(frame.getValues(StateRecordVector::FORCE), nullptr);
+            ASSERT_EQ(x->size(), std::size_t(nbValues));
+            for (int i = 0; i < nbValues; ++i)
+            {
+                EXPECT_NEAR((*x)[i], value(f, i), tolerance);
+                EXPECT_NEAR((*v)[i], -value(f, i), tolerance);
+            }
+        }
+    }
+};
+
+TEST_F(StateRecord_test, lossless)
+{
+    StateRecordWriter::Options options;
+    options.keyframeInterval = 10;
+    writeRecord(options);
+    checkRecord(0);
+}
+
+TEST_F(StateRecord_test, synchronousWithoutDelta)
+{
+    StateRecordWriter::Options options;
+    options.keyframeInterval = 1;
+    options.async = false;
+    options.compress = false;
+    writeRecord(options);
+    checkRecord(0);
+}
+
+TEST_F(StateRecord_test, quantized)
+{
+    StateRecordWriter::Options options;
+    options.quantize = true;
+    writeRecord(options);
+    checkRecord(1e-5);
+}
+
+TEST_F(StateRecord_test, unclosedRecord)
+{
+    StateRecordWriter::Options options;
+    options.keyframeInterval = 10;
+    writeRecord(options);
+
+    // the record ends with the offset of the index of the frames, followed by an 8-byte marker
+    const auto fileSize = std::filesystem::file_size(filename);
+    std::uint64_t indexOffset = 0;
+    {
+        std::ifstream file(filename, std::ios::binary);
+        file.seekg(std::streamoff(fileSize - sizeof(std::uint64_t) - 8));
+        file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+        ASSERT_TRUE(file.good());
+    }
+    ASSERT_GT(indexOffset, 0u);
+    ASSERT_LT(indexOffset, fileSize);
+
+    // without its index, as if the record was not closed, the frames are found from their headers
+    std::filesystem::resize_file(filename, indexOffset);
+    checkRecord(0);
+
+    // the last frame was not completely written: it is ignored
+    std::filesystem::resize_file(filename, indexOffset - 3);
+    StateRecordReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_EQ(reader.getNbFrames(), std::size_t(nbFrames - 1));
+    EXPECT_EQ(reader.findFrame(100.), std::size_t(nbFrames - 2));
+
+    StateRecordFrame frame;
+    ASSERT_TRUE(reader.readFrame(nbFrames - 2, frame));
+    const auto* x = frame.getValues(StateRecordVector::POSITION);
+    ASSERT_NE(x, nullptr);
+    ASSERT_EQ(x->size(), std::size_t(nbValues));
+    for (int i = 0; i < nbValues; ++i)
+    {
+        EXPECT_EQ((*x)[i], value(nbFrames - 2, i));
+    }
+}
+
+TEST_F(StateRecord_test, invalidFile)
+{
+    StateRecordReader reader;
+    EXPECT_FALSE(reader.open(std::string(SOFA_COMPONENT_PLAYBACK_TEST_FILES_DIR) + "particleGravityX.data"));
+    EXPECT_TRUE(StateRecordReader::isStateRecordFile(filename));
+    EXPECT_FALSE(StateRecordReader::isStateRecordFile("particleGravityX.data"));
+}
+
+}
@@ -147,6 +147,7 @@ public:
     Data< sofa::helper::OptionsGroup > d_gatherBsize; ///< number of dof accumulated per threads during the gather operation (Only use in GPU version)
     Data<bool> d_drawing; ///< draw the forcefield if true
     Data<Real> d_drawPercentageOffset; ///< size of the hexa
+    Data<bool> d_shareStiffnessMatrices; ///< Elements with the same rest shape and material share a single stiffness matrix
     bool needUpdateTopology;
 
     using Inherit1::l_topology;
@@ -234,6 +235,39 @@ protected:
 
     static void computeForce( Displacement &F, const Displacement &Depl, const ElementStiffness &K );
 
+    /// Index of the stiffness matrix of an element in d_elementStiffnesses (different from the element index if the matrices are shared)
+    sofa::Index getElementStiffnessId(sofa::Index elementId) const
+    {
+        return m_elementStiffnessIds.empty() ? elementId : m_elementStiffnessIds[elementId];
+    }
+
+    /// Factor to apply to the stiffness matrix of an element (the sparse grid stiffness coefficient if the matrices are shared)
+    Real getElementStiffnessFactor(sofa::Index elementId) const
+    {
+        return m_elementStiffnessFactors.empty() ? static_cast<Real>(1) : m_elementStiffnessFactors[elementId];
+    }
+
+    /// True if the stiffness matrices are recomputed from the deformed elements in addForce
+    bool isUpdatingStiffnessMatrices() const
+    {
+        return d_updateStiffnessMatrix.getValue() && m_elementStiffnessIds.empty();
+    }
+
+    /// Compute the stiffness matrix of an element from its rest shape, or reuse the one of an identical element
+    void initElementStiffness(sofa::Index i);
+
+    /// Compute the forces of an element, expressed in the world frame, and add its contribution to the potential energy.
+    /// Only the rotation of the element (and its stiffness matrix, if provided) is written: elements can be processed concurrently.
+    void computeElementForce(const VecCoord& p, sofa::Index i, const Element& elem,
+                             type::Vec<8, Deriv>& f, SReal& potentialEnergy, ElementStiffness* updatedStiffness);
+    void accumulateElementForce(WDataRefVecDeriv& f, RDataRefVecCoord& p, sofa::Index i, const Element& elem);
+
+    /// If not empty, the stiffness matrix of each element is d_elementStiffnesses[m_elementStiffnessIds[i]] * m_elementStiffnessFactors[i]
+    type::vector<sofa::Index> m_elementStiffnessIds;
+    type::vector<Real> m_elementStiffnessFactors;
+    /// Element used as a reference for each shared stiffness matrix
+    type::vector<sofa::Index> m_sharedStiffnessElements;
+
 
     ////////////// large displacements method
     type::vector<type::fixed_array<Coord,8> > _rotatedInitialElements;   ///< The initials positions in its frame
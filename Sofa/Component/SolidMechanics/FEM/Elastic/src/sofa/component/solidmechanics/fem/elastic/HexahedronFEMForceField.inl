@@ -56,6 +56,9 @@ HexahedronFEMForceField<DataTypes>::HexahedronFEMForceField()
     , d_gatherBsize(initData(&d_gatherBsize, "gatherBsize", "number of dof accumulated per threads during the gather operation (Only use in GPU version)"))
     , d_drawing(initData(&d_drawing, true, "drawing", "draw the forcefield if true"))
     , d_drawPercentageOffset(initData(&d_drawPercentageOffset, (Real)0.15, "drawPercentageOffset", "size of the hexa"))
+    , d_shareStiffnessMatrices(initData(&d_shareStiffnessMatrices, false, "shareStiffnessMatrices", "Elements with the same rest shape and material share a single stiffness matrix, "
+                                                                                                  "scaled by the stiffness coefficient of the sparse grid cells. It reduces the memory and the "
+                                                                                                  "initialization time on regular and sparse grids. Ignored if updateStiffnessMatrix is true."))
     , needUpdateTopology(false)
     , d_elementStiffnesses(initData(&d_elementStiffnesses, "stiffnessMatrices", "Stiffness matrices per element (K_i)"))
     , _sparseGrid(nullptr)
@@ -154,6 +157,16 @@ void HexahedronFEMForceField<DataTypes>::reinit()
     else if (d_method.getValue() == "small")
         this->setMethod(SMALL);
 
+    m_elementStiffnessIds.clear();
+    m_elementStiffnessFactors.clear();
+    m_sharedStiffnessElements.clear();
+    if (d_shareStiffnessMatrices.getValue() && !d_updateStiffnessMatrix.getValue())
+    {
+        sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses).clear();
+        m_elementStiffnessIds.resize(this->getIndexedElements()->size());
+        m_elementStiffnessFactors.resize(this->getIndexedElements()->size());
+    }
+
     switch(method)
     {
     case LARGE :
@@ -269,6 +282,7 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
     typename VecElement::const_iterator it;
 
     const auto* indexedElements = this->getIndexedElements();
+    const auto& stiffnesses = d_elementStiffnesses.getValue();
 
     for(it = indexedElements->begin() ; it != indexedElements->end() ; ++it, ++i)
     {
@@ -288,11 +302,12 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
         }
 
         Displacement F;
-        computeForce(F, X, d_elementStiffnesses.getValue()[i] );
+        computeForce(F, X, stiffnesses[getElementStiffnessId(i)] );
 
+        const Real factor = kFactor * getElementStiffnessFactor(i);
         for(int w=0; w<8; ++w)
         {
-            _df[(*it)[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * kFactor;
+            _df[(*it)[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * factor;
         }
     }
 }
@@ -726,42 +741,93 @@ void HexahedronFEMForceField<DataTypes>::computeForce( Displacement &F, const Di
     F = K*Depl;
 }
 
-
-/////////////////////////////////////////////////
-/////////////////////////////////////////////////
-/////////////////////////////////////////////////
-////////////// small displacements method
-
 template<class DataTypes>
-void HexahedronFEMForceField<DataTypes>::initSmall(sofa::Index i, const Element &elem)
+void HexahedronFEMForceField<DataTypes>::initElementStiffness(sofa::Index i)
 {
-    // Rotation matrix identity
-    Transformation t; t.identity();
-    _rotations[i] = t;
+    const double stiffnessFactor = _sparseGrid ? _sparseGrid->getStiffnessCoef(i) : 1.0;
+    auto stiffnesses = sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
 
-    for(int w=0; w<8; ++w)
-        _rotatedInitialElements[i][w] = _rotations[i] * d_initialPoints.getValue()[elem[w]];
+    if (m_elementStiffnessIds.empty())
+    {
+        if( stiffnesses.size() <= i )
+        {
+            stiffnesses.resize( i + 1 );
+        }
+
+        computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, stiffnessFactor );
+        return;
+    }
+
+    // The stiffness matrix only depends on the material and on the rest shape of the element in its frame, up to a translation.
+    // Regular and sparse grids have very few different cells: they are looked for among the most recently shared matrices.
+    static constexpr std::size_t maxNbCandidates = 16;
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
+    const auto& nodes = _rotatedInitialElements[i];
+    const Real tolerance = std::max(static_cast<Real>(1e-10), 100 * std::numeric_limits<Real>::epsilon())
+                           * (nodes[0].norm() + (nodes[6] - nodes[0]).norm());
+
+    m_elementStiffnessFactors[i] = static_cast<Real>(stiffnessFactor);
+
+    const std::size_t nbShared = m_sharedStiffnessElements.size();
+    for (std::size_t c = nbShared; c > 0 && c + maxNbCandidates > nbShared; --c)
     {
-        stiffnesses.resize( i + 1 );
+        const sofa::Index reference = m_sharedStiffnessElements[c - 1];
+        if (_materialsStiffnesses[reference] != _materialsStiffnesses[i])
+        {
+            continue;
+        }
+
+        const auto& referenceNodes = _rotatedInitialElements[reference];
+        bool isSameShape = true;
+        for (int w = 1; w < 8 && isSameShape; ++w)
+        {
+            isSameShape = ((nodes[w] - nodes[0]) - (referenceNodes[w] - referenceNodes[0])).norm() <= tolerance;
+        }
+
+        if (isSameShape)
+        {
+            m_elementStiffnessIds[i] = static_cast<sofa::Index>(c - 1);
+            return;
+        }
     }
 
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    m_elementStiffnessIds[i] = static_cast<sofa::Index>(nbShared);
+    m_sharedStiffnessElements.push_back(i);
+    stiffnesses.wref().emplace_back();
+    computeElementStiffness( stiffnesses.wref().back(), _materialsStiffnesses[i], nodes, i, 1.0 );
 }
 
 template<class DataTypes>
-void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv &f, RDataRefVecCoord &p, sofa::Index i, const Element&elem )
+void HexahedronFEMForceField<DataTypes>::computeElementForce(const VecCoord& p, sofa::Index i, const Element& elem,
+                                                             type::Vec<8, Deriv>& f, SReal& potentialEnergy, ElementStiffness* updatedStiffness)
 {
-    Vec<8,Coord> nodes;
+    type::Vec<8,Coord> nodes;
     for(int w=0; w<8; ++w)
         nodes[w] = p[elem[w]];
 
-    // positions of the deformed and displaced Tetrahedron in its frame
-    sofa::type::fixed_array<Coord, 8> deformed;
+    // Rotation matrix (deformed and displaced element/world). It stays the identity for small displacements
+    Transformation& rotation = _rotations[i];
+    switch(method)
+    {
+    case LARGE :
+    {
+        Coord horizontal = (nodes[1]-nodes[0] + nodes[2]-nodes[3] + nodes[5]-nodes[4] + nodes[6]-nodes[7])*.25;
+        Coord vertical = (nodes[3]-nodes[0] + nodes[2]-nodes[1] + nodes[7]-nodes[4] + nodes[6]-nodes[5])*.25;
+        computeRotationLarge(rotation, horizontal, vertical);
+        break;
+    }
+    case POLAR :
+        computeRotationPolar(rotation, nodes);
+        break;
+    default:
+        break;
+    }
+    const bool isRotated = (method != SMALL);
+
+    // positions of the deformed and displaced element in its frame
+    type::Vec<8,Coord> deformed;
     for(int w=0; w<8; ++w)
-        deformed[w] = nodes[w];
+        deformed[w] = isRotated ? rotation * nodes[w] : nodes[w];
 
     // displacement
     Displacement D;
@@ -769,27 +835,70 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv
     {
         const int index = k*3;
         for(int j=0 ; j<3 ; ++j )
-            D[index+j] = _rotatedInitialElements[i][k][j] - nodes[k][j];
+            D[index+j] = _rotatedInitialElements[i][k][j] - deformed[k][j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if(d_updateStiffnessMatrix.getValue())
-        computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    if (updatedStiffness)
+        computeElementStiffness( *updatedStiffness, _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
 
     Displacement F; //forces
-    computeForce( F, D, stiffnesses[i] ); // compute force on element
+    computeForce(F, D, d_elementStiffnesses.getValue()[getElementStiffnessId(i)] ); // compute force on element
+
+    const Real stiffnessFactor = getElementStiffnessFactor(i);
+    if (stiffnessFactor != static_cast<Real>(1))
+        F *= stiffnessFactor;
+
+    for(int w=0; w<8; ++w)
+    {
+        const Deriv force( F[w*3],  F[w*3+1],   F[w*3+2]  );
+        f[w] = isRotated ? rotation.multTranspose(force) : force;
+    }
+
+    for(int w=0; w<8; ++w)
+        potentialEnergy += dot(Deriv( F[w*3], F[w*3+1], F[w*3+2] ), -Deriv( D[w*3], D[w*3+1], D[w*3+2] ));
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::accumulateElementForce(WDataRefVecDeriv& f, RDataRefVecCoord& p, sofa::Index i, const Element& elem)
+{
+    type::Vec<8, Deriv> force;
+    if (isUpdatingStiffnessMatrices())
+    {
+        auto stiffnesses = sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
+        computeElementForce(p.ref(), i, elem, force, m_potentialEnergy, &stiffnesses[i]);
+    }
+    else
+    {
+        computeElementForce(p.ref(), i, elem, force, m_potentialEnergy, nullptr);
+    }
 
     for(int w=0; w<8; ++w)
-        f[elem[w]] += Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) ;
-
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+        f[elem[w]] += force[w];
+}
+
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+////////////// small displacements method
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::initSmall(sofa::Index i, const Element &elem)
+{
+    // Rotation matrix identity
+    Transformation t; t.identity();
+    _rotations[i] = t;
+
+    for(int w=0; w<8; ++w)
+        _rotatedInitialElements[i][w] = _rotations[i] * d_initialPoints.getValue()[elem[w]];
+
+    initElementStiffness(i);
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv &f, RDataRefVecCoord &p, sofa::Index i, const Element&elem )
+{
+    accumulateElementForce(f, p, i, elem);
 }
 
 
@@ -816,13 +925,7 @@ void HexahedronFEMForceField<DataTypes>::initLarge(sofa::Index i, const Element
     for(int w=0; w<8; ++w)
         _rotatedInitialElements[i][w] = _rotations[i] * d_initialPoints.getValue()[elem[w]];
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
-    {
-        stiffnesses.resize( i + 1 );
-    }
-
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    initElementStiffness(i);
 }
 
 template<class DataTypes>
@@ -848,51 +951,7 @@ void HexahedronFEMForceField<DataTypes>::computeRotationLarge( Transformation &r
 template<class DataTypes>
 void HexahedronFEMForceField<DataTypes>::accumulateForceLarge( WDataRefVecDeriv &f, RDataRefVecCoord &p, sofa::Index i, const Element&elem )
 {
-    type::Vec<8,Coord> nodes;
-    for(int w=0; w<8; ++w)
-        nodes[w] = p[elem[w]];
-
-    Coord horizontal;
-    horizontal = (nodes[1]-nodes[0] + nodes[2]-nodes[3] + nodes[5]-nodes[4] + nodes[6]-nodes[7])*.25;
-    Coord vertical;
-    vertical = (nodes[3]-nodes[0] + nodes[2]-nodes[1] + nodes[7]-nodes[4] + nodes[6]-nodes[5])*.25;
-
-    // 	Transformation R_0_2; // Rotation matrix (deformed and displaced Tetrahedron/world)
-    computeRotationLarge( _rotations[i], horizontal,vertical);
-
-    // positions of the deformed and displaced Tetrahedron in its frame
-    sofa::type::fixed_array<Coord, 8> deformed;
-    for(int w=0; w<8; ++w)
-        deformed[w] = _rotations[i] * nodes[w];
-
-
-    // displacement
-    Displacement D;
-    for(int k=0 ; k<8 ; ++k )
-    {
-        const int index = k*3;
-        for(int j=0 ; j<3 ; ++j )
-            D[index+j] = _rotatedInitialElements[i][k][j] - deformed[k][j];
-    }
-
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if(d_updateStiffnessMatrix.getValue())
-        computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
-
-    Displacement F; //forces
-    computeForce(F, D, d_elementStiffnesses.getValue()[i] ); // compute force on element
-
-    for(int w=0; w<8; ++w)
-        f[elem[w]] += _rotations[i].multTranspose( Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) );
-
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    accumulateElementForce(f, p, i, elem);
 }
 
 
@@ -916,13 +975,7 @@ void HexahedronFEMForceField<DataTypes>::initPolar(sofa::Index i, const Element&
         _rotatedInitialElements[i][j] =  _rotations[i] * nodes[j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
-    {
-        stiffnesses.resize( i + 1 );
-    }
-
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0);
+    initElementStiffness(i);
 }
 
 
@@ -1047,52 +1100,7 @@ void HexahedronFEMForceField<DataTypes>::getRotations(linearalgebra::BaseMatrix
 template<class DataTypes>
 void HexahedronFEMForceField<DataTypes>::accumulateForcePolar( WDataRefVecDeriv &f, RDataRefVecCoord &p, sofa::Index i, const Element&elem )
 {
-    type::Vec<8,Coord> nodes;
-    for(int j=0; j<8; ++j)
-        nodes[j] = p[elem[j]];
-
-    // 	Transformation R_0_2; // Rotation matrix (deformed and displaced Tetrahedron/world)
-    computeRotationPolar( _rotations[i], nodes );
-
-    // positions of the deformed and displaced Tetrahedre in its frame
-    sofa::type::fixed_array<Coord, 8> deformed;
-    for(int j=0; j<8; ++j)
-        deformed[j] = _rotations[i] * nodes[j];
-
-
-
-    // displacement
-    Displacement D;
-    for(int k=0 ; k<8 ; ++k )
-    {
-        const int index = k*3;
-        for(int j=0 ; j<3 ; ++j )
-            D[index+j] = _rotatedInitialElements[i][k][j] - deformed[k][j];
-    }
-
-    //forces
-    Displacement F;
-
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if(d_updateStiffnessMatrix.getValue())
-        computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0);
-
-
-    // compute force on element
-    computeForce(F, D, d_elementStiffnesses.getValue()[i] );
-
-
-    for(int j=0; j<8; ++j)
-            f[elem[j]] += _rotations[i].multTranspose( Deriv( F[j*3],  F[j*3+1],   F[j*3+2]  ) );
-
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    accumulateElementForce(f, p, i, elem);
 }
 
 template<class DataTypes>
@@ -1139,8 +1147,9 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalPara
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        const ElementStiffness &Ke = stiffnesses[getElementStiffnessId(e)];
         const Transformation Rot = getElementRotation(e);
+        const Real factor = kFactor * getElementStiffnessFactor(e);
         e++;
 
         // find index of node 1
@@ -1157,7 +1166,7 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalPara
                         Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
                         Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
 
-                r.matrix->add( r.offset + 3 * node1, r.offset + 3 * node2, tmp * (-kFactor));
+                r.matrix->add( r.offset + 3 * node1, r.offset + 3 * node2, tmp * (-factor));
             }
         }
     }
@@ -1176,8 +1185,9 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        const ElementStiffness &Ke = stiffnesses[getElementStiffnessId(e)];
         const Transformation& Rot = getElementRotation(e);
+        const Real factor = getElementStiffnessFactor(e);
         e++;
 
         for (Element::size_type n1 = 0; n1 < Element::size(); n1++)
@@ -1192,7 +1202,7 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
                         Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
                         Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
 
-                dfdx(3 * node1, 3 * node2) += - tmp;
+                dfdx(3 * node1, 3 * node2) += - tmp * factor;
             }
         }
     }
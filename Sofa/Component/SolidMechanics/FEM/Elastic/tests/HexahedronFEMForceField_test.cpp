@@ -22,6 +22,7 @@
 #include <sofa/component/solidmechanics/fem/elastic/HexahedronFEMForceField.h>
 
 #include <sofa/component/solidmechanics/testing/ForceFieldTestCreation.h>
+#include <sofa/simpleapi/SimpleApi.h>
 
 namespace sofa 
 {
@@ -149,4 +150,78 @@ TYPED_TEST( HexahedronFEMForceField_test, test_computeBBox )
     ASSERT_NO_THROW(this->test_computeBBox()) ;
 }
 
+/// The cells of a regular grid share a single stiffness matrix, and the forces are the same as without sharing
+TEST(HexahedronFEMForceField, shareStiffnessMatrices)
+{
+    using ForceField = component::solidmechanics::fem::elastic::HexahedronFEMForceField<defaulttype::Vec3Types>;
+    using VecElementStiffness = type::vector<type::Mat<24, 24, SReal> >;
+
+    sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+    sofa::simpleapi::importPlugin("Sofa.Component.Topology.Container.Grid");
+    sofa::simpleapi::importPlugin("Sofa.Component.SolidMechanics.FEM.Elastic");
+
+    const auto root = sofa::simpleapi::createRootNode(sofa::simulation::getSimulation(), "root");
+
+    sofa::type::fixed_array<ForceField*, 2> forceFields;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        const auto node = sofa::simpleapi::createChild(root, "grid" + std::to_string(i));
+        sofa::simpleapi::createObject(node, "RegularGridTopology", {{"n", "4 4 4"}, {"min", "0 0 0"}, {"max", "1.5 1.5 3"}});
+        sofa::simpleapi::createObject(node, "MechanicalObject", {{"template", "Vec3"}});
+        sofa::simpleapi::createObject(node, "HexahedronFEMForceField", {{"youngModulus", "1000"}, {"poissonRatio", "0.3"},
+                                                                         {"shareStiffnessMatrices", i == 0 ? "true" : "false"}});
+        forceFields[i] = node->get<ForceField>();
+        ASSERT_NE(forceFields[i], nullptr);
+    }
+
+    sofa::simulation::node::initRoot(root.get());
+
+    const auto nbStiffnesses = [](ForceField* forceField)
+    {
+        const auto* data = dynamic_cast<const Data<VecElementStiffness>*>(forceField->findData("stiffnessMatrices"));
+        return data ? data->getValue().size() : 0;
+    };
+    EXPECT_EQ(nbStiffnesses(forceFields[0]), 1);
+    EXPECT_EQ(nbStiffnesses(forceFields[1]), 27);
+
+    // deformed positions
+    const auto& restPositions = forceFields[0]->getMState()->read(core::ConstVecCoordId::restPosition())->getValue();
+    Data<ForceField::VecCoord> x(restPositions);
+    Data<ForceField::VecDeriv> v(ForceField::VecDeriv(restPositions.size()));
+    Data<ForceField::VecDeriv> dx(ForceField::VecDeriv(restPositions.size()));
+    {
+        auto positions = sofa::helper::getWriteAccessor(x);
+        auto displacements = sofa::helper::getWriteAccessor(dx);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            positions[i] += defaulttype::Vec3Types::Deriv(0.01 * std::sin(i), 0.02 * std::cos(3. * i), 0.05 * std::sin(2. * i));
+            displacements[i] = defaulttype::Vec3Types::Deriv(std::cos(i), std::sin(5. * i), 0.1);
+        }
+    }
+
+    core::MechanicalParams mparams;
+    mparams.setKFactor(1.0);
+
+    sofa::type::fixed_array<ForceField::VecDeriv, 2> forces, dforces;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        Data<ForceField::VecDeriv> f, df;
+        forceFields[i]->addForce(&mparams, f, x, v);
+        forceFields[i]->addDForce(&mparams, df, dx);
+        forces[i] = f.getValue();
+        dforces[i] = df.getValue();
+    }
+
+    ASSERT_EQ(forces[0].size(), restPositions.size());
+    ASSERT_EQ(dforces[0].size(), restPositions.size());
+    for (std::size_t i = 0; i < restPositions.size(); ++i)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(forces[0][i][c], forces[1][i][c], 1e-8);
+            EXPECT_NEAR(dforces[0][i][c], dforces[1][i][c], 1e-8);
+        }
+    }
+}
+
 } // namespace sofa
@@ -138,6 +138,7 @@ public:
     Data<sofa::helper::OptionsGroup> d_materialName; ///< the name of the material to be used. Possible options are: 'ArrudaBoyce', 'Costa', 'MooneyRivlin', 'NeoHookean', 'Ogden', 'StVenantKirchhoff', 'VerondaWestman', 'StableNeoHookean'
     Data<SetParameterArray> d_parameterSet; ///< The global parameters specifying the material
     Data<SetAnisotropyDirectionArray> d_anisotropySet; ///< The global directions of anisotropy of the material: vector containing anisotropic directions. The vector size is 0 if the material is isotropic, 1 if it is transversely isotropic and 2 for orthotropic materials
+    Data<bool> d_parallelComputation; ///< Compute the forces and the tangent matrix of the elements in parallel
 
     TetrahedronData<sofa::type::vector<TetrahedronRestInformation> > m_tetrahedronInfo; ///< Internal tetrahedron data
     EdgeData<sofa::type::vector<EdgeInformation> > m_edgeInfo; ///< Internal edge data
@@ -193,6 +194,30 @@ protected:
     void updateTangentMatrix();
 
     void instantiateMaterial();
+
+    /// Call f(begin, end) on ranges of [0, size), in parallel if d_parallelComputation is set
+    template<class F>
+    void forEachRange(std::size_t size, const F& f) const;
+
+    /// Call f with the material. The materials having a compiled kernel (NeoHookean, StableNeoHookean, MooneyRivlin,
+    /// StVenantKirchhoff, Ogden) are given with their exact type, so that their methods are inlined in the loops on
+    /// the elements. The other materials are called through the virtual methods of HyperelasticMaterial.
+    template<class F>
+    void dispatchMaterial(const F& f);
+
+    /// Compute the deformation, the stress and the forces of each element in m_elementForces
+    template<class Material>
+    void computeElementForces(Material& material, const VecCoord& x);
+
+    /// Compute the stiffness of the edges of each element in m_elementEdgeStiffness
+    template<class Material>
+    void computeElementEdgeStiffness(Material& material);
+
+    /// forces of the 4 vertices of each element, accumulated in the force vector after the loop on the elements
+    type::vector<type::fixed_array<Deriv, 4> > m_elementForces;
+
+    /// stiffness of the 6 edges of each element, accumulated in m_edgeInfo after the loop on the elements
+    type::vector<type::fixed_array<Matrix3, 6> > m_elementEdgeStiffness;
 };
 
 #if !defined(SOFA_COMPONENT_FORCEFIELD_TETRAHEDRONHYPERELASTICITYFEMFORCEFIELD_CPP)
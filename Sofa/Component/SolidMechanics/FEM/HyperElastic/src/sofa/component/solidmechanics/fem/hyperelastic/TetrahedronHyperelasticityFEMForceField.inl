@@ -37,6 +37,9 @@
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/behavior/ForceField.inl>
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <typeinfo>
 
 namespace sofa::component::solidmechanics::fem::hyperelastic
 {
@@ -65,6 +68,7 @@ template <class DataTypes> TetrahedronHyperelasticityFEMForceField<DataTypes>::T
     , d_materialName(initData(&d_materialName, materialOptions<DataTypes>, "materialName","the name of the material to be used. Possible options are: 'ArrudaBoyce', 'Costa', 'MooneyRivlin', 'NeoHookean', 'Ogden', 'StVenantKirchhoff', 'VerondaWestman', 'StableNeoHookean'"))
     , d_parameterSet(initData(&d_parameterSet,"ParameterSet","The global parameters specifying the material"))
     , d_anisotropySet(initData(&d_anisotropySet,"AnisotropyDirections","The global directions of anisotropy of the material: vector containing anisotropic directions. The vector size is 0 if the material is isotropic, 1 if it is transversely isotropic and 2 for orthotropic materials"))
+    , d_parallelComputation(initData(&d_parallelComputation, false, "parallelComputation", "Compute the forces and the tangent matrix of the elements in parallel"))
     , m_tetrahedronInfo(initData(&m_tetrahedronInfo, "tetrahedronInfo", "Internal tetrahedron data"))
     , m_edgeInfo(initData(&m_edgeInfo, "edgeInfo", "Internal edge data"))
     , l_topology(initLink("topology", "link to the topology container"))
@@ -280,178 +284,287 @@ void TetrahedronHyperelasticityFEMForceField<DataTypes>::createTetrahedronRestIn
 }
 
 template <class DataTypes>
-void TetrahedronHyperelasticityFEMForceField<DataTypes>::addForce(const core::MechanicalParams* /* mparams */ /* PARAMS FIRST */, DataVecDeriv& d_f, const DataVecCoord& d_x, const DataVecDeriv& /* d_v */)
+template <class F>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::forEachRange(std::size_t size, const F& f) const
 {
-    auto f = sofa::helper::getWriteAccessor(d_f);
-    const VecCoord& x = d_x.getValue();
+    if (d_parallelComputation.getValue())
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, std::size_t(0), size,
+            [&f](const simulation::Range<std::size_t>& range) { f(range.start, range.end); });
+    }
+    else
+    {
+        f(0, size);
+    }
+}
 
-    unsigned int j = 0, k = 0, l = 0;
-    const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
+template <class DataTypes>
+template <class F>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::dispatchMaterial(const F& f)
+{
+    HyperelasticMaterial<DataTypes>& material = *m_myMaterial;
 
-    auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
+    // the exact type is compared: a class deriving from one of the materials keeps the virtual calls
+    const std::type_info& type = typeid(material);
+    if (type == typeid(NeoHookean<DataTypes>))
+    {
+        f(static_cast<NeoHookean<DataTypes>&>(material));
+    }
+    else if (type == typeid(StableNeoHookean<DataTypes>))
+    {
+        f(static_cast<StableNeoHookean<DataTypes>&>(material));
+    }
+    else if (type == typeid(MooneyRivlin<DataTypes>))
+    {
+        f(static_cast<MooneyRivlin<DataTypes>&>(material));
+    }
+    else if (type == typeid(STVenantKirchhoff<DataTypes>))
+    {
+        f(static_cast<STVenantKirchhoff<DataTypes>&>(material));
+    }
+    else if (type == typeid(Ogden<DataTypes>))
+    {
+        f(static_cast<Ogden<DataTypes>&>(material));
+    }
+    else
+    {
+        f(material);
+    }
+}
 
-    assert(this->mstate);
+template <class DataTypes>
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeElementForces(Material& material, const VecCoord& x)
+{
+    auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
+    type::vector<TetrahedronRestInformation>& tetrahedronInfo = tetrahedronInf.wref();
+    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
 
-    Coord dp[3], x0, sv;
+    m_elementForces.resize(tetrahedronArray.size());
 
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
+    forEachRange(tetrahedronArray.size(), [&](std::size_t begin, std::size_t end)
     {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        const Tetrahedron& ta = m_topology->getTetrahedron(i);
-
-        x0 = x[ta[0]];
-
-        // compute the deformation gradient
-        // deformation gradient = sum of tensor product between vertex position and shape vector
-        // optimize by using displacement with first vertex
-        dp[0] = x[ta[1]] - x0;
-        sv = tetInfo->m_shapeVector[1];
-        for (k = 0; k < 3; ++k)
+        for (std::size_t i = begin; i < end; ++i)
         {
-            for (l = 0; l < 3; ++l)
+            TetrahedronRestInformation* tetInfo = &tetrahedronInfo[i];
+            const Tetrahedron& ta = tetrahedronArray[i];
+            Matrix3& deformationGradient = tetInfo->m_deformationGradient;
+
+            // compute the deformation gradient
+            // deformation gradient = sum of tensor product between vertex position and shape vector
+            // optimize by using displacement with first vertex
+            const Coord x0 = x[ta[0]];
+            const Coord dp[3] = { x[ta[1]] - x0, x[ta[2]] - x0, x[ta[3]] - x0 };
+            for (unsigned int k = 0; k < 3; ++k)
             {
-                tetInfo->m_deformationGradient[k][l] = dp[0][k] * sv[l];
+                for (unsigned int l = 0; l < 3; ++l)
+                {
+                    deformationGradient[k][l] = dp[0][k] * tetInfo->m_shapeVector[1][l]
+                        + dp[1][k] * tetInfo->m_shapeVector[2][l]
+                        + dp[2][k] * tetInfo->m_shapeVector[3][l];
+                }
             }
-        }
-        for (j = 1; j < 3; ++j)
-        {
-            dp[j] = x[ta[j + 1]] - x0;
-            sv = tetInfo->m_shapeVector[j + 1];
-            for (k = 0; k < 3; ++k)
+
+            /// compute the right Cauchy-Green deformation matrix
+            for (unsigned int k = 0; k < 3; ++k)
             {
-                for (l = 0; l < 3; ++l)
+                for (unsigned int l = k; l < 3; ++l)
                 {
-                    tetInfo->m_deformationGradient[k][l] += dp[j][k] * sv[l];
+                    tetInfo->deformationTensor(k, l) =
+                        deformationGradient(0, k) * deformationGradient(0, l) +
+                        deformationGradient(1, k) * deformationGradient(1, l) +
+                        deformationGradient(2, k) * deformationGradient(2, l);
                 }
             }
-        }
 
-        /// compute the right Cauchy-Green deformation matrix
-        for (k = 0; k < 3; ++k)
-        {
-            for (l = k; l < 3; ++l)
+            if (globalParameters.anisotropyDirection.size() > 0)
             {
-                tetInfo->deformationTensor(k, l) =
-                    tetInfo->m_deformationGradient(0, k) * tetInfo->m_deformationGradient(0, l) +
-                    tetInfo->m_deformationGradient(1, k) * tetInfo->m_deformationGradient(1, l) +
-                    tetInfo->m_deformationGradient(2, k) * tetInfo->m_deformationGradient(2, l);
+                tetInfo->m_fiberDirection = globalParameters.anisotropyDirection[0];
+                Coord vectCa = tetInfo->deformationTensor * tetInfo->m_fiberDirection;
+                Real aDotCDota = dot(tetInfo->m_fiberDirection, vectCa);
+                tetInfo->lambda = (Real)sqrt(aDotCDota);
             }
-        }
+            const Coord areaVec = cross( dp[1], dp[2] );
 
-        if (globalParameters.anisotropyDirection.size() > 0)
-        {
-            tetInfo->m_fiberDirection = globalParameters.anisotropyDirection[0];
-            Coord vectCa = tetInfo->deformationTensor * tetInfo->m_fiberDirection;
-            Real aDotCDota = dot(tetInfo->m_fiberDirection, vectCa);
-            tetInfo->lambda = (Real)sqrt(aDotCDota);
+            tetInfo->J = dot(areaVec, dp[0]) * tetInfo->m_volScale;
+            tetInfo->trC = (Real)(tetInfo->deformationTensor(0, 0) + tetInfo->deformationTensor(1, 1) +
+                                  tetInfo->deformationTensor(2, 2));
+            tetInfo->m_SPKTensorGeneral.clear();
+            if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+            {
+                material.deriveSPKTensor(tetInfo, globalParameters, tetInfo->m_SPKTensorGeneral);
+            }
+            else
+            {
+                material.Material::deriveSPKTensor(tetInfo, globalParameters, tetInfo->m_SPKTensorGeneral);
+            }
+
+            for (unsigned int l = 0; l < 4; ++l)
+            {
+                m_elementForces[i][l] = -(deformationGradient * (
+                    tetInfo->m_SPKTensorGeneral * tetInfo->m_shapeVector[l]) * tetInfo->m_restVolume);
+            }
         }
-        const Coord areaVec = cross( dp[1], dp[2] );
-
-        tetInfo->J = dot(areaVec, dp[0]) * tetInfo->m_volScale;
-        tetInfo->trC = (Real)(tetInfo->deformationTensor(0, 0) + tetInfo->deformationTensor(1, 1) +
-                              tetInfo->deformationTensor(2, 2));
-        tetInfo->m_SPKTensorGeneral.clear();
-        m_myMaterial->deriveSPKTensor(tetInfo, globalParameters, tetInfo->m_SPKTensorGeneral);
-        for (l = 0; l < 4; ++l)
+    });
+}
+
+template <class DataTypes>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::addForce(const core::MechanicalParams* /* mparams */ /* PARAMS FIRST */, DataVecDeriv& d_f, const DataVecCoord& d_x, const DataVecDeriv& /* d_v */)
+{
+    auto f = sofa::helper::getWriteAccessor(d_f);
+    const VecCoord& x = d_x.getValue();
+
+    assert(this->mstate);
+
+    dispatchMaterial([this, &x](auto& material)
+    {
+        computeElementForces(material, x);
+    });
+
+    // the elements share their vertices: the forces are accumulated sequentially
+    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
+    for (std::size_t i = 0; i < tetrahedronArray.size(); ++i)
+    {
+        const Tetrahedron& ta = tetrahedronArray[i];
+        for (unsigned int l = 0; l < 4; ++l)
         {
-            f[ta[l]] -= tetInfo->m_deformationGradient * (
-                tetInfo->m_SPKTensorGeneral * tetInfo->m_shapeVector[l]) * tetInfo->m_restVolume;
+            f[ta[l]] += m_elementForces[i][l];
         }
     }
 
-
     /// indicates that the next call to addDForce will need to update the stiffness matrix
     m_updateMatrix = true;
 }
 
 template <class DataTypes>
-void TetrahedronHyperelasticityFEMForceField<DataTypes>::updateTangentMatrix()
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeElementEdgeStiffness(Material& material)
 {
-    unsigned int k = 0, l;
-    const unsigned int nbEdges = m_topology->getNbEdges();
     const type::vector<Edge>& edgeArray = m_topology->getEdges();
+    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
 
-    auto edgeInf = sofa::helper::getWriteAccessor(m_edgeInfo);
     auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
+    type::vector<TetrahedronRestInformation>& tetrahedronInfo = tetrahedronInf.wref();
 
-    const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
-    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
+    m_elementEdgeStiffness.resize(tetrahedronArray.size());
 
-    for (l = 0; l < nbEdges; l++)
+    Edge localEdges[6];
+    for (unsigned int j = 0; j < 6; ++j)
     {
-        edgeInf[l].DfDx.clear();
+        localEdges[j] = m_topology->getLocalEdgesInTetrahedron(j);
     }
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
+    // make sure the topological array is built before being accessed in parallel
+    if (!tetrahedronArray.empty())
     {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        Matrix3& df = tetInfo->m_deformationGradient;
-//			Matrix3 Tdf=df.transposed();
-        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+        m_topology->getEdgesInTetrahedron(0);
+    }
 
-        /// describe the jth vertex index of triangle no i
-        const Tetrahedron& ta = tetrahedronArray[i];
-        for (unsigned int j = 0; j < 6; j++)
+    forEachRange(tetrahedronArray.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
         {
-            EdgeInformation* einfo = &edgeInf[te[j]];
-            Edge e = m_topology->getLocalEdgesInTetrahedron(j);
-
-            k = e[0];
-            l = e[1];
-            if (edgeArray[te[j]][0] != ta[k])
+            TetrahedronRestInformation* tetInfo = &tetrahedronInfo[i];
+            const Matrix3& df = tetInfo->m_deformationGradient;
+            const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+            const Tetrahedron& ta = tetrahedronArray[i];
+
+            // The elasticity tensor is linear: it is applied once on each tensor of the basis of the symmetric
+            // matrices, and its application on the tensors of the edges is a combination of the results
+            MatrixSym elasticityOfBasis[6];
+            for (unsigned int b = 0; b < 6; ++b)
             {
-                k = e[1];
-                l = e[0];
+                MatrixSym basisTensor;
+                basisTensor.clear();
+                basisTensor[b] = 1;
+                if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+                {
+                    material.applyElasticityTensor(tetInfo, globalParameters, basisTensor, elasticityOfBasis[b]);
+                }
+                else
+                {
+                    material.Material::applyElasticityTensor(tetInfo, globalParameters, basisTensor, elasticityOfBasis[b]);
+                }
             }
-            Matrix3 &edgeDfDx = einfo->DfDx;
 
-
-            const Coord& svl = tetInfo->m_shapeVector[l];
-            const Coord& svk = tetInfo->m_shapeVector[k];
-
-            Matrix3  M, N;
-            MatrixSym outputTensor;
-            N.clear();
-            type::vector<MatrixSym> inputTensor;
-            inputTensor.resize(3);
-            //	MatrixSym input1,input2,input3,outputTensor;
-            for (int m = 0; m < 3; m++)
+            for (unsigned int j = 0; j < 6; j++)
             {
-                for (int n = m; n < 3; n++)
+                unsigned int k = localEdges[j][0];
+                unsigned int l = localEdges[j][1];
+                if (edgeArray[te[j]][0] != ta[k])
                 {
-                    inputTensor[0](m, n) = svl[m] * df[0][n] + df[0][m] * svl[n];
-                    inputTensor[1](m, n) = svl[m] * df[1][n] + df[1][m] * svl[n];
-                    inputTensor[2](m, n) = svl[m] * df[2][n] + df[2][m] * svl[n];
+                    k = localEdges[j][1];
+                    l = localEdges[j][0];
                 }
-            }
 
-            for (int m = 0; m < 3; m++)
-            {
-                m_myMaterial->applyElasticityTensor(tetInfo, globalParameters, inputTensor[m],
-                                                    outputTensor);
-                Coord vectortemp = df * (outputTensor * svk);
-                Matrix3 Nv;
-                //Nv.clear();
-                for (int u = 0; u < 3; u++)
+                const Coord& svl = tetInfo->m_shapeVector[l];
+                const Coord& svk = tetInfo->m_shapeVector[k];
+
+                Matrix3 N;
+                for (int m = 0; m < 3; m++)
                 {
-                    Nv[u][m] = vectortemp[u];
+                    MatrixSym inputTensor;
+                    for (int p = 0; p < 3; p++)
+                    {
+                        for (int q = p; q < 3; q++)
+                        {
+                            inputTensor(p, q) = svl[p] * df[m][q] + df[m][p] * svl[q];
+                        }
+                    }
+
+                    MatrixSym outputTensor;
+                    outputTensor.clear();
+                    for (unsigned int b = 0; b < 6; ++b)
+                    {
+                        outputTensor += elasticityOfBasis[b] * inputTensor[b];
+                    }
+
+                    N[m] = df * (outputTensor * svk);
                 }
-                N += Nv.transposed();
-            }
 
+                //Now M
+                const Real productSD = dot(tetInfo->m_SPKTensorGeneral * svk, svl);
+                for (int m = 0; m < 3; m++)
+                {
+                    N[m][m] += productSD;
+                }
 
-            //Now M
-            Real productSD = 0;
+                m_elementEdgeStiffness[i][j] = N * tetInfo->m_restVolume;
+            }
+        }
+    });
+}
 
-            const Coord vectSD = tetInfo->m_SPKTensorGeneral * svk;
-            productSD = dot(vectSD, svl);
-            M[0][1] = M[0][2] = M[1][0] = M[1][2] = M[2][0] = M[2][1] = 0;
-            M[0][0] = M[1][1] = M[2][2] = (Real)productSD;
+template <class DataTypes>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::updateTangentMatrix()
+{
+    auto edgeInf = sofa::helper::getWriteAccessor(m_edgeInfo);
 
-            edgeDfDx += (M+N)*tetInfo->m_restVolume;
+    for (auto& edgeInfo : edgeInf)
+    {
+        edgeInfo.DfDx.clear();
+    }
 
+    dispatchMaterial([this](auto& material)
+    {
+        computeElementEdgeStiffness(material);
+    });
 
-        }// end of for j
-    }//end of for i
+    // the elements share their edges: the stiffnesses are accumulated sequentially
+    const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
+    for (unsigned int i = 0; i < nbTetrahedra; i++)
+    {
+        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+        for (unsigned int j = 0; j < 6; j++)
+        {
+            edgeInf[te[j]].DfDx += m_elementEdgeStiffness[i][j];
+        }
+    }
     m_updateMatrix=false;
 }
 
@@ -0,0 +1,163 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/solidmechanics/fem/hyperelastic/TetrahedronHyperelasticityFEMForceField.h>
+#include <sofa/core/MechanicalParams.h>
+
+#include <cmath>
+
+namespace sofa {
+
+/** @brief Comparison of the forces and force differentials computed sequentially and in parallel, for several materials
+ */
+struct TetrahedronHyperelasticityFEMForceField_parallel_test : public BaseSimulationTest
+{
+    using DataTypes = defaulttype::Vec3Types;
+    using VecCoord = DataTypes::VecCoord;
+    using VecDeriv = DataTypes::VecDeriv;
+    using DOF = component::statecontainer::MechanicalObject<DataTypes>;
+    using ForceField = component::solidmechanics::fem::hyperelastic::TetrahedronHyperelasticityFEMForceField<DataTypes>;
+
+    struct Result
+    {
+        VecDeriv force;
+        VecDeriv dforce;
+    };
+
+    void SetUp() override
+    {
+        // several threads, even on a single core machine
+        sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+    }
+
+    static Result computeForces(const std::string& materialName, const type::vector<SReal>& parameters, bool parallel)
+    {
+        const std::string sceneFilename = std::string(SOFA_COMPONENT_SOLIDMECHANICS_FEM_HYPERELASTIC_TEST_SCENES_DIR) + "/TetrahedronHyperelasticityFEMForceField_base.scn";
+        const simulation::Node::SPtr root = sofa::simulation::node::load(sceneFilename.c_str());
+        Result result;
+        if (!root)
+        {
+            ADD_FAILURE() << "Cannot load " << sceneFilename;
+            return result;
+        }
+        simulation::Node* node = root->getChild("Hyperelastic-Liver");
+        if (!node)
+        {
+            ADD_FAILURE() << "Node Hyperelastic-Liver not found in " << sceneFilename;
+            return result;
+        }
+
+        const ForceField::SPtr forceField = sofa::core::objectmodel::New<ForceField>();
+        node->addObject(forceField);
+        forceField->setMaterialName(materialName);
+        forceField->setparameter(parameters);
+        forceField->d_parallelComputation.setValue(parallel);
+
+        sofa::simulation::node::initRoot(root.get());
+
+        const DOF* dof = node->get<DOF>();
+        if (!dof)
+        {
+            ADD_FAILURE() << "No MechanicalObject in " << sceneFilename;
+            return result;
+        }
+
+        // deterministic deformation of the rest shape
+        const VecCoord& restPositions = dof->read(core::ConstVecCoordId::restPosition())->getValue();
+        VecCoord x(restPositions.size());
+        VecDeriv dx(restPositions.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const DataTypes::Coord& p = restPositions[i];
+            x[i] = p + DataTypes::Coord(0.05 * std::sin(p[1]), 0.03 * std::cos(p[2]), 0.04 * std::sin(p[0] + p[2]));
+            dx[i] = DataTypes::Deriv(std::sin(1.0 * i), std::cos(2.0 * i), std::sin(3.0 * i));
+        }
+
+        Data<VecCoord> xData;
+        xData.setValue(x);
+        Data<VecDeriv> vData;
+        vData.setValue(VecDeriv(x.size()));
+        Data<VecDeriv> dxData;
+        dxData.setValue(dx);
+        Data<VecDeriv> fData;
+        fData.setValue(VecDeriv(x.size()));
+        Data<VecDeriv> dfData;
+        dfData.setValue(VecDeriv(x.size()));
+
+        core::MechanicalParams mparams;
+        mparams.setKFactor(1.0);
+        forceField->addForce(&mparams, fData, xData, vData);
+        forceField->addDForce(&mparams, dfData, dxData);
+
+        result.force = fData.getValue();
+        result.dforce = dfData.getValue();
+
+        sofa::simulation::node::unload(root);
+        return result;
+    }
+
+    static void compareSequentialAndParallel(const std::string& materialName, const type::vector<SReal>& parameters)
+    {
+        const Result sequential = computeForces(materialName, parameters, false);
+        const Result parallel = computeForces(materialName, parameters, true);
+
+        ASSERT_FALSE(sequential.force.empty());
+        ASSERT_EQ(sequential.force.size(), parallel.force.size());
+        ASSERT_EQ(sequential.dforce.size(), parallel.dforce.size());
+
+        SReal forceNorm = 0;
+        for (std::size_t i = 0; i < sequential.force.size(); ++i)
+        {
+            forceNorm += sequential.force[i].norm2();
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+                // the element contributions are accumulated in the same order: the results are identical
+                EXPECT_DOUBLE_EQ(sequential.force[i][c], parallel.force[i][c]) << materialName << ", vertex " << i;
+                EXPECT_DOUBLE_EQ(sequential.dforce[i][c], parallel.dforce[i][c]) << materialName << ", vertex " << i;
+            }
+        }
+        EXPECT_GT(forceNorm, 0) << materialName;
+    }
+};
+
+TEST_F(TetrahedronHyperelasticityFEMForceField_parallel_test, MooneyRivlin)
+{
+    compareSequentialAndParallel("MooneyRivlin", {151065.460, 101709.668, 1e07});
+}
+
+TEST_F(TetrahedronHyperelasticityFEMForceField_parallel_test, NeoHookean)
+{
+    compareSequentialAndParallel("NeoHookean", {1e5, 1e6});
+}
+
+TEST_F(TetrahedronHyperelasticityFEMForceField_parallel_test, StVenantKirchhoff)
+{
+    compareSequentialAndParallel("StVenantKirchhoff", {1e5, 1e6});
+}
+
+} // namespace sofa
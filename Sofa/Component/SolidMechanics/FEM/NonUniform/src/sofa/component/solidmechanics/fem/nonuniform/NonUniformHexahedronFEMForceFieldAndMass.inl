@@ -43,6 +43,12 @@ void NonUniformHexahedronFEMForceFieldAndMass<DataTypes>::init()
     if(this->_alreadyInit)return;
     else this->_alreadyInit=true;
 
+    // the condensed stiffness matrices (also in HexahedronCompositeFEMForceFieldAndMass) are computed per element
+    if (this->d_shareStiffnessMatrices.getValue())
+    {
+        msg_warning() << "shareStiffnessMatrices is not supported by this component, the stiffness matrices are not shared.";
+        this->d_shareStiffnessMatrices.setValue(false);
+    }
 
     elastic::BaseLinearElasticityFEMForceField<DataTypes>::init();
 
@@ -46,6 +46,8 @@ public:
     using Inherit1::mstate2;
     using Inherit1::d_springs;
 
+    bool useSpringArrays() const override { return typeid(*this) == typeid(MeshSpringForceField<DataTypes>); }
+
 protected:
     Data< Real >  d_linesStiffness; ///< Stiffness for the Lines
     Data< Real >  d_linesDamping; ///< Damping for the Lines
@@ -46,6 +46,8 @@ public:
     typedef typename DataTypes::VecCoord VecCoord;
     typedef core::behavior::MechanicalState<DataTypes> MechanicalState;
 
+    bool useSpringArrays() const override { return typeid(*this) == typeid(QuadBendingSprings<DataTypes>); }
+
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_SOLIDMECHANICS_SPRING()
     sofa::core::objectmodel::RenamedData<type::Vec<2,int>> localRange;
 
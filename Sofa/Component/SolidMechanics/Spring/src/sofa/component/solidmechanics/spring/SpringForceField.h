@@ -34,6 +34,8 @@
 
 #include <sofa/core/topology/TopologySubsetIndices.h>
 
+#include <typeinfo>
+
 namespace sofa::component::solidmechanics::spring
 {
 
@@ -122,6 +124,11 @@ public:
     /// export kinetic and potential energy state at "time" to a gnuplot file
     void exportGnuplot(SReal time) override;
 
+    /// True if addForce and addDForce process the springs as arrays with the default spring force (computeSpringForceFromArrays).
+    /// Otherwise they call the virtual addSpringForce (thus computeSpringForce) for each spring, so that a component
+    /// overriding them keeps its own spring force. The components keeping the default spring force override this method.
+    virtual bool useSpringArrays() const { return typeid(*this) == typeid(SpringForceField<DataTypes>); }
+
 protected:
 
     class Loader;
@@ -135,7 +142,22 @@ protected:
         type::MatNoInit<N, N, Real> dForce_dX;
     };
 
+    /// Copy of d_springs as a structure of arrays, so that the force and force derivative loops only
+    /// stream the values they need. It is rebuilt by updateSpringArrays() when d_springs changes.
+    struct SpringArrays
+    {
+        enum Flags : unsigned char { Enabled = 1, ElongationOnly = 2 };
+
+        sofa::type::vector<sofa::Index> m1, m2;
+        sofa::type::vector<Real> ks, kd, initpos;
+        sofa::type::vector<unsigned char> flags;
+
+        std::size_t size() const { return m1.size(); }
+    };
+
     sofa::type::vector<Mat>  dfdx;
+    SpringArrays m_springArrays;
+    int m_springArraysCounter { -1 };
     core::objectmodel::DataFileName fileSprings;
     core::objectmodel::DataCallback c_springCallBack;
     bool areSpringIndicesDirty { true };
@@ -156,7 +178,18 @@ protected:
     template<class Matrix>
     static void addToMatrix(Matrix* globalMatrix, const unsigned int offsetRow, const unsigned int offsetCol, const Mat& localMatrix);
 
+    /// Force of a single spring, used by the components computing their springs one by one (e.g. RegularGridSpringForceField),
+    /// and by addForce when useSpringArrays() is false.
     virtual std::unique_ptr<SpringForce> computeSpringForce(const VecCoord& p1, const VecDeriv& v1, const VecCoord& p2, const VecDeriv& v2, const Spring& spring);
+
+    /// Rebuild m_springArrays if d_springs changed since the last call
+    void updateSpringArrays();
+
+    /// Compute the force applied by the spring i of m_springArrays on its first extremity (the opposite force is applied on the
+    /// second one), its potential energy and the derivative of the force. Returns false if the spring does not apply any force.
+    /// It does not allocate nor write any member, so that springs can be processed concurrently.
+    bool computeSpringForceFromArrays(sofa::Index i, const VecCoord& p1, const VecDeriv& v1, const VecCoord& p2, const VecDeriv& v2,
+                                      typename DataTypes::DPos& force, Real& energy, Mat& dForce_dX) const;
     virtual void addSpringForce(Real& potentialEnergy, VecDeriv& f1, const VecCoord& p1, const VecDeriv& v1, VecDeriv& f2, const VecCoord& p2, const VecDeriv& v2, sofa::Index /*i*/, const Spring& spring);
     void initializeTopologyHandler(sofa::core::topology::TopologySubsetIndices& indices, core::topology::BaseMeshTopology* topology, sofa::Index mstateId);
     void updateTopologyIndicesFromSprings();
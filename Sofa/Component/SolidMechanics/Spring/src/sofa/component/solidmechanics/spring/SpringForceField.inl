@@ -558,15 +558,86 @@ auto SpringForceField<DataTypes>::computeSpringForce(
     return {};
 }
 
+template <class DataTypes>
+void SpringForceField<DataTypes>::updateSpringArrays()
+{
+    const type::vector<Spring>& springs = this->d_springs.getValue();
+    if (m_springArraysCounter == this->d_springs.getCounter() && m_springArrays.size() == springs.size())
+    {
+        return;
+    }
+    m_springArraysCounter = this->d_springs.getCounter();
+
+    const auto nbSprings = springs.size();
+    m_springArrays.m1.resize(nbSprings);
+    m_springArrays.m2.resize(nbSprings);
+    m_springArrays.ks.resize(nbSprings);
+    m_springArrays.kd.resize(nbSprings);
+    m_springArrays.initpos.resize(nbSprings);
+    m_springArrays.flags.resize(nbSprings);
+
+    for (std::size_t i = 0; i < nbSprings; ++i)
+    {
+        const Spring& spring = springs[i];
+        m_springArrays.m1[i] = spring.m1;
+        m_springArrays.m2[i] = spring.m2;
+        m_springArrays.ks[i] = spring.ks;
+        m_springArrays.kd[i] = spring.kd;
+        m_springArrays.initpos[i] = spring.initpos;
+        m_springArrays.flags[i] = (spring.enabled ? SpringArrays::Enabled : 0) | (spring.elongationOnly ? SpringArrays::ElongationOnly : 0);
+    }
+}
+
+template <class DataTypes>
+bool SpringForceField<DataTypes>::computeSpringForceFromArrays(
+    sofa::Index i,
+    const VecCoord& p1, const VecDeriv& v1,
+    const VecCoord& p2, const VecDeriv& v2,
+    typename DataTypes::DPos& force, Real& energy, Mat& dForce_dX) const
+{
+    const sofa::Index a = m_springArrays.m1[i];
+    const sofa::Index b = m_springArrays.m2[i];
+    const Real ks = m_springArrays.ks[i];
+    const Real initpos = m_springArrays.initpos[i];
+    const unsigned char flags = m_springArrays.flags[i];
+
+    /// Get the positional part out of the dofs.
+    typename DataTypes::CPos u = DataTypes::getCPos(p2[b])-DataTypes::getCPos(p1[a]);
+    const Real d = u.norm();
+    if (!((flags & SpringArrays::Enabled) && d > 1.0e-9 && (!(flags & SpringArrays::ElongationOnly) || d > initpos)))
+    {
+        return false;
+    }
+
+    // same computation as computeSpringForce
+    const Real inverseLength = 1.0f/d;
+    u *= inverseLength;
+    const Real elongation = (Real)(d - initpos);
+    energy = elongation * elongation * ks / 2;
+    const typename DataTypes::DPos relativeVelocity = DataTypes::getDPos(v2[b])-DataTypes::getDPos(v1[a]);
+    const Real elongationVelocity = dot(u,relativeVelocity);
+    const Real forceIntensity = (Real)(ks*elongation+m_springArrays.kd[i]*elongationVelocity);
+    force = u*forceIntensity;
+
+    const Real tgt = forceIntensity * inverseLength;
+    for(sofa::Index j=0; j<N; ++j )
+    {
+        for(sofa::Index k=0; k<N; ++k )
+        {
+            dForce_dX[j][k] = (ks-tgt) * u[j] * u[k];
+        }
+        dForce_dX[j][j] += tgt;
+    }
+
+    return true;
+}
+
 template<class DataTypes>
 void SpringForceField<DataTypes>::addForce(
     const core::MechanicalParams* /* mparams */, DataVecDeriv& data_f1, DataVecDeriv& data_f2,
     const DataVecCoord& data_x1, const DataVecCoord& data_x2,
     const DataVecDeriv& data_v1, const DataVecDeriv& data_v2)
 {
-    const type::vector<Spring>& _springs = this->d_springs.getValue();
-    this->dfdx.resize(_springs.size());
-
     const VecCoord& x1 = data_x1.getValue();
     const VecDeriv& v1 = data_v1.getValue();
 
@@ -579,9 +650,39 @@ void SpringForceField<DataTypes>::addForce(
     f1.resize(x1.size());
     f2.resize(x2.size());
     this->m_potentialEnergy = 0;
-    for (unsigned int i=0; i < _springs.size(); i++)
+
+    if (!useSpringArrays())
     {
-        this->addSpringForce(this->m_potentialEnergy,f1.wref(),x1,v1,f2.wref(),x2,v2, i, _springs[i]);
+        const type::vector<Spring>& _springs = this->d_springs.getValue();
+        this->dfdx.resize(_springs.size());
+        for (unsigned int i=0; i < _springs.size(); i++)
+        {
+            this->addSpringForce(this->m_potentialEnergy,f1.wref(),x1,v1,f2.wref(),x2,v2, i, _springs[i]);
+        }
+        return;
+    }
+
+    updateSpringArrays();
+    const auto nbSprings = m_springArrays.size();
+    this->dfdx.resize(nbSprings);
+
+    typename DataTypes::DPos force;
+    Real energy;
+    for (sofa::Index i = 0; i < nbSprings; ++i)
+    {
+        if (computeSpringForceFromArrays(i, x1, v1, x2, v2, force, energy, this->dfdx[i]))
+        {
+            const sofa::Index a = m_springArrays.m1[i];
+            const sofa::Index b = m_springArrays.m2[i];
+            DataTypes::setDPos( f1[a], DataTypes::getDPos(f1[a]) + force ) ;
+            DataTypes::setDPos( f2[b], DataTypes::getDPos(f2[b]) - force ) ;
+            this->m_potentialEnergy += energy;
+        }
+        else
+        {
+            // set derivative to 0
+            this->dfdx[i].clear();
+        }
     }
 }
 
@@ -617,13 +718,31 @@ void SpringForceField<DataTypes>::addDForce(const core::MechanicalParams* mparam
     Real kFactor       =  (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams,this->rayleighStiffness.getValue());
     Real bFactor       =  (Real)sofa::core::mechanicalparams::bFactor(mparams);
 
-    const type::vector<Spring>& springs = this->d_springs.getValue();
     df1.resize(dx1.size());
     df2.resize(dx2.size());
 
-    for (sofa::Index i=0; i<springs.size(); i++)
+    if (!useSpringArrays())
     {
-        this->addSpringDForce(df1.wref(), dx1,df2.wref(),dx2, i, springs[i], kFactor, bFactor);
+        const type::vector<Spring>& springs = this->d_springs.getValue();
+        for (sofa::Index i=0; i<springs.size(); i++)
+        {
+            this->addSpringDForce(df1.wref(), dx1,df2.wref(),dx2, i, springs[i], kFactor, bFactor);
+        }
+        return;
+    }
+
+    updateSpringArrays();
+
+    const auto nbSprings = std::min(m_springArrays.size(), this->dfdx.size());
+    for (sofa::Index i = 0; i < nbSprings; ++i)
+    {
+        const sofa::Index a = m_springArrays.m1[i];
+        const sofa::Index b = m_springArrays.m2[i];
+        const typename DataTypes::CPos d = DataTypes::getDPos(dx2[b]) - DataTypes::getDPos(dx1[a]);
+        const typename DataTypes::DPos dforce = this->dfdx[i] * d * kFactor;
+
+        DataTypes::setDPos( df1[a], DataTypes::getDPos(df1[a]) + dforce ) ;
+        DataTypes::setDPos( df2[b], DataTypes::getDPos(df2[b]) - dforce ) ;
     }
 }
 
@@ -44,6 +44,9 @@ public:
 
     typedef typename DataTypes::Real Real;
     typedef typename DataTypes::VecCoord VecCoord;
+
+    bool useSpringArrays() const override { return typeid(*this) == typeid(TriangleBendingSprings<DataTypes>); }
+
 protected:
     TriangleBendingSprings();
 
@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/topology/container/dynamic/HexahedronSetTopologyContainer.h>
+#include <sofa/component/topology/container/dynamic/TopologyAdjacency.h>
 #include <sofa/core/topology/Topology.h>
 #include <sofa/core/topology/TopologyHandler.h>
 
@@ -414,16 +415,9 @@ void HexahedronSetTopologyContainer::createHexahedraAroundVertexArray()
     if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(Size(d_initPoints.getValue().size()));
 
-    m_hexahedraAroundVertex.resize( getNbPoints() );
     const helper::ReadAccessor< Data< sofa::type::vector<Hexahedron> > > m_hexahedron = d_hexahedron;
 
-    for(size_t i=0; i<m_hexahedron.size(); ++i)
-    {
-        HexahedronID hexaID = (HexahedronID)i;
-        // adding vertex i in the vertex shell
-        for(unsigned int j=0; j<8; ++j)
-            m_hexahedraAroundVertex[ m_hexahedron[i][j]  ].push_back(hexaID);
-    }
+    createElementsAroundEntityArray(m_hexahedron.ref(), getNbPoints(), m_hexahedraAroundVertex);
 }
 
 void HexahedronSetTopologyContainer::createHexahedraAroundEdgeArray ()
@@ -433,16 +427,7 @@ void HexahedronSetTopologyContainer::createHexahedraAroundEdgeArray ()
     if(!hasEdgesInHexahedron())
         createEdgesInHexahedronArray();
 
-    m_hexahedraAroundEdge.resize(getNumberOfEdges());
-    for(size_t i=0; i<getNumberOfHexahedra(); ++i)
-    {
-        HexahedronID hexaID = (HexahedronID)i;
-        // adding edge i in the edge shell
-        for(unsigned int j=0; j<12; ++j)
-        {
-            m_hexahedraAroundEdge[ m_edgesInHexahedron[i][j] ].push_back(hexaID);
-        }
-    }
+    createElementsAroundEntityArray(m_edgesInHexahedron, getNumberOfEdges(), m_hexahedraAroundEdge);
 }
 
 void HexahedronSetTopologyContainer::createHexahedraAroundQuadArray()
@@ -452,16 +437,7 @@ void HexahedronSetTopologyContainer::createHexahedraAroundQuadArray()
     if(!hasQuadsInHexahedron())
         createQuadsInHexahedronArray();
 
-    m_hexahedraAroundQuad.resize( getNumberOfQuads());
-    for(size_t i=0; i<getNumberOfHexahedra(); ++i)
-    {
-        HexahedronID hexaID = (HexahedronID)i;
-        // adding quad i in the edge shell of both points
-        for(unsigned int j=0; j<6; ++j)
-        {
-            m_hexahedraAroundQuad[ m_quadsInHexahedron[i][j] ].push_back(hexaID);
-        }
-    }
+    createElementsAroundEntityArray(m_quadsInHexahedron, getNumberOfQuads(), m_hexahedraAroundQuad);
 }
 
 const sofa::type::vector<HexahedronSetTopologyContainer::Hexahedron> &HexahedronSetTopologyContainer::getHexahedronArray()
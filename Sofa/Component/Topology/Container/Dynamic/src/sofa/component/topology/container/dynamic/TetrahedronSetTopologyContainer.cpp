@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyContainer.h>
+#include <sofa/component/topology/container/dynamic/TopologyAdjacency.h>
 #include <sofa/core/topology/TopologyHandler.h>
 
 #include <sofa/core/ObjectFactory.h>
@@ -41,6 +42,7 @@ TetrahedronSetTopologyContainer::TetrahedronSetTopologyContainer()
     : TriangleSetTopologyContainer()
 	, d_createTriangleArray(initData(&d_createTriangleArray, bool(false),"createTriangleArray", "Force the creation of a set of triangles associated with each tetrahedron"))
     , d_tetrahedron(initData(&d_tetrahedron, "tetrahedra", "List of tetrahedron indices"))
+    , d_parallelAdjacencyCreation(initData(&d_parallelAdjacencyCreation, false, "parallelAdjacencyCreation", "If true, the lists of tetrahedra around vertices, edges and triangles are created in parallel"))
 {
     addAlias(&d_tetrahedron, "tetras");
 }
@@ -341,17 +343,9 @@ void TetrahedronSetTopologyContainer::createTetrahedraAroundVertexArray()
     if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(sofa::Size(d_initPoints.getValue().size()));
 
-    m_tetrahedraAroundVertex.resize( getNbPoints() );
     const helper::ReadAccessor< Data< sofa::type::vector<Tetrahedron> > > m_tetrahedron = d_tetrahedron;
 
-    for (size_t i = 0; i < getNumberOfTetrahedra(); ++i)
-    {
-        // adding edge i in the edge shell of both points
-        for (PointID j=0; j<4; ++j)
-        {
-            m_tetrahedraAroundVertex[ m_tetrahedron[i][j]  ].push_back( (TetrahedronID)i );
-        }
-    }
+    createElementsAroundEntityArray(m_tetrahedron.ref(), getNbPoints(), m_tetrahedraAroundVertex, d_parallelAdjacencyCreation.getValue());
 }
 
 void TetrahedronSetTopologyContainer::createTetrahedraAroundEdgeArray ()
@@ -362,15 +356,7 @@ void TetrahedronSetTopologyContainer::createTetrahedraAroundEdgeArray ()
     if(!hasEdgesInTetrahedron())
         createEdgesInTetrahedronArray();
 
-    m_tetrahedraAroundEdge.resize(getNumberOfEdges());
-    for (size_t i=0; i< getNumberOfTetrahedra(); ++i)
-    {
-        // adding edge i in the edge shell of both points
-        for (EdgeID j=0; j<6; ++j)
-        {
-            m_tetrahedraAroundEdge[ m_edgesInTetrahedron[i][j] ].push_back( (TetrahedronID)i );
-        }
-    }
+    createElementsAroundEntityArray(m_edgesInTetrahedron, getNumberOfEdges(), m_tetrahedraAroundEdge, d_parallelAdjacencyCreation.getValue());
 }
 
 void TetrahedronSetTopologyContainer::createTetrahedraAroundTriangleArray ()
@@ -411,16 +397,7 @@ void TetrahedronSetTopologyContainer::createTetrahedraAroundTriangleArray ()
         return;
     }
 
-    m_tetrahedraAroundTriangle.resize(numTriangles);
-
-    for (size_t i=0; i<numTetra; ++i)
-    {
-        // adding tetrahedron i in the shell of all neighbors triangles
-        for (TriangleID j=0; j<4; ++j)
-        {
-            m_tetrahedraAroundTriangle[ m_trianglesInTetrahedron[i][j] ].push_back( (TetrahedronID)i );
-        }
-    }
+    createElementsAroundEntityArray(m_trianglesInTetrahedron, sofa::Size(numTriangles), m_tetrahedraAroundTriangle, d_parallelAdjacencyCreation.getValue());
 }
 
 const sofa::type::vector<TetrahedronSetTopologyContainer::Tetrahedron> &TetrahedronSetTopologyContainer::getTetrahedronArray()
@@ -408,6 +408,9 @@ public:
 
     /// provides the set of tetrahedra.
     Data< sofa::type::vector<Tetrahedron> > d_tetrahedron;
+
+    /// create the lists of tetrahedra around vertices, edges and triangles in parallel
+    Data<bool> d_parallelAdjacencyCreation;
 protected:
     /// provides the set of edges for each tetrahedron.
     sofa::type::vector<EdgesInTetrahedron> m_edgesInTetrahedron;
@@ -63,6 +63,14 @@ void TetrahedronSetTopologyModifier::reinit()
 
 void TetrahedronSetTopologyModifier::addTetrahedra(const sofa::type::vector<Tetrahedron> &tetrahedra)
 {
+    if (isInChangeBatch())
+    {
+        m_changeBatch.addedTetrahedra.insert(m_changeBatch.addedTetrahedra.end(), tetrahedra.begin(), tetrahedra.end());
+        m_changeBatch.ancestors.resize(m_changeBatch.addedTetrahedra.size());
+        m_changeBatch.baryCoefs.resize(m_changeBatch.addedTetrahedra.size());
+        return;
+    }
+
     const size_t ntetra = m_container->getNbTetrahedra();
 
     /// effectively add triangles in the topology container
@@ -86,6 +94,23 @@ void TetrahedronSetTopologyModifier::addTetrahedra(const sofa::type::vector<Tetr
         const sofa::type::vector<sofa::type::vector<TetrahedronID> > &ancestors,
         const sofa::type::vector<sofa::type::vector<SReal> > &baryCoefs)
 {
+    if (isInChangeBatch())
+    {
+        const auto offset = m_changeBatch.addedTetrahedra.size();
+        m_changeBatch.addedTetrahedra.insert(m_changeBatch.addedTetrahedra.end(), tetrahedra.begin(), tetrahedra.end());
+        m_changeBatch.ancestors.resize(m_changeBatch.addedTetrahedra.size());
+        m_changeBatch.baryCoefs.resize(m_changeBatch.addedTetrahedra.size());
+        for (std::size_t i = 0; i < tetrahedra.size(); ++i)
+        {
+            if (i < ancestors.size())
+                m_changeBatch.ancestors[offset + i] = ancestors[i];
+            if (i < baryCoefs.size())
+                m_changeBatch.baryCoefs[offset + i] = baryCoefs[i];
+        }
+        m_changeBatch.hasAncestors = true;
+        return;
+    }
+
     const size_t ntetra = m_container->getNbTetrahedra();
 
     /// effectively add triangles in the topology container
@@ -605,6 +630,14 @@ void TetrahedronSetTopologyModifier::renumberPointsProcess( const sofa::type::ve
 
 void TetrahedronSetTopologyModifier::removeTetrahedra(const sofa::type::vector<TetrahedronID> &tetrahedraIds, const bool removeIsolatedItems)
 {
+    if (isInChangeBatch())
+    {
+        m_changeBatch.removedTetrahedra.insert(m_changeBatch.removedTetrahedra.end(), tetrahedraIds.begin(), tetrahedraIds.end());
+        // isolated items are removed only if all the removals of the batch request it
+        m_changeBatch.removeIsolatedItems = m_changeBatch.removeIsolatedItems && removeIsolatedItems;
+        return;
+    }
+
     sofa::type::vector<TetrahedronID> tetrahedraIds_filtered;
     for (size_t i = 0; i < tetrahedraIds.size(); i++)
     {
@@ -642,6 +675,106 @@ void TetrahedronSetTopologyModifier::removeItems(const sofa::type::vector< Tetra
     removeTetrahedra(items);
 }
 
+void TetrahedronSetTopologyModifier::beginChangeBatch()
+{
+    ++m_changeBatchDepth;
+}
+
+void TetrahedronSetTopologyModifier::endChangeBatch()
+{
+    if (m_changeBatchDepth == 0)
+    {
+        msg_error() << "endChangeBatch called without a matching beginChangeBatch.";
+        return;
+    }
+
+    if (--m_changeBatchDepth > 0)
+        return;
+
+    ChangeBatch batch;
+    std::swap(batch, m_changeBatch);
+
+    SCOPED_TIMER("applyChangeBatch");
+
+    // a tetrahedron can be selected several times in a batch (e.g. by overlapping cuts)
+    std::sort(batch.removedTetrahedra.begin(), batch.removedTetrahedra.end());
+    batch.removedTetrahedra.erase(std::unique(batch.removedTetrahedra.begin(), batch.removedTetrahedra.end()), batch.removedTetrahedra.end());
+
+    compactChangeBatch(batch);
+
+    // additions first: the new tetrahedra are appended, so that the indices given for the removals stay valid
+    if (!batch.addedTetrahedra.empty())
+    {
+        if (batch.hasAncestors)
+            addTetrahedra(batch.addedTetrahedra, batch.ancestors, batch.baryCoefs);
+        else
+            addTetrahedra(batch.addedTetrahedra);
+    }
+
+    if (!batch.removedTetrahedra.empty())
+    {
+        removeTetrahedra(batch.removedTetrahedra, batch.removeIsolatedItems);
+    }
+
+    if (batch.endingEvent)
+    {
+        notifyEndingEvent();
+    }
+}
+
+void TetrahedronSetTopologyModifier::compactChangeBatch(ChangeBatch& batch) const
+{
+    // the tetrahedra added in the batch are numbered after the existing ones
+    const auto nbTetrahedra = m_container->getNumberOfTetrahedra();
+    const auto nbAdded = batch.addedTetrahedra.size();
+
+    const auto firstAddedRemoval = std::lower_bound(batch.removedTetrahedra.begin(), batch.removedTetrahedra.end(), nbTetrahedra);
+    if (firstAddedRemoval == batch.removedTetrahedra.end())
+    {
+        return;
+    }
+
+    // a tetrahedron added then removed in the same batch is never created
+    sofa::type::vector<bool> isCancelled(nbAdded, false);
+    for (auto it = firstAddedRemoval; it != batch.removedTetrahedra.end(); ++it)
+    {
+        if (*it - nbTetrahedra < nbAdded)
+        {
+            isCancelled[*it - nbTetrahedra] = true;
+        }
+        else
+        {
+            dmsg_warning() << "Tetrahedra: " << *it << " is out of bound and won't be removed.";
+        }
+    }
+    batch.removedTetrahedra.erase(firstAddedRemoval, batch.removedTetrahedra.end());
+
+    std::size_t nbKept = 0;
+    for (std::size_t i = 0; i < nbAdded; ++i)
+    {
+        if (isCancelled[i])
+            continue;
+        batch.addedTetrahedra[nbKept] = batch.addedTetrahedra[i];
+        batch.ancestors[nbKept] = batch.ancestors[i];
+        batch.baryCoefs[nbKept] = batch.baryCoefs[i];
+        ++nbKept;
+    }
+    batch.addedTetrahedra.resize(nbKept);
+    batch.ancestors.resize(nbKept);
+    batch.baryCoefs.resize(nbKept);
+}
+
+void TetrahedronSetTopologyModifier::notifyEndingEvent()
+{
+    if (isInChangeBatch())
+    {
+        m_changeBatch.endingEvent = true;
+        return;
+    }
+
+    TriangleSetTopologyModifier::notifyEndingEvent();
+}
+
 void TetrahedronSetTopologyModifier::propagateTopologicalEngineChanges()
 {
     if (m_container->beginChange() == m_container->endChange()) return; // nothing to do if no event is stored
@@ -101,7 +101,54 @@ public:
     */
     void RemoveTetraBall(TetrahedronID ind_ta, TetrahedronID ind_tb);
 
+    /** \brief Starts a batch of topological changes (e.g. several cuts during a time step).
+    *
+    * Until endChangeBatch() is called, the tetrahedra given to addTetrahedra and removeTetrahedra are only recorded.
+    * All the indices (removed tetrahedra, ancestors) refer to the numbering of the tetrahedra at the beginning of the batch.
+    * Batches can be nested: the changes are applied when the outermost batch ends.
+    */
+    void beginChangeBatch();
+
+    /** \brief Applies the changes recorded since beginChangeBatch(): all the additions at once, then all the removals at once.
+    *
+    * The changes are compacted first: the duplicated removals are merged, and a tetrahedron added then removed in
+    * the batch is neither added nor removed.
+    * The additions and the removals produce each a single set of topological changes, propagated once to the
+    * topology handlers and mappings.
+    */
+    void endChangeBatch();
+
+    /// Returns true if the changes are currently recorded in a batch
+    bool isInChangeBatch() const { return m_changeBatchDepth > 0; }
+
+    /** \brief Adds an EndingEvent to the topological changes and propagates them.
+    *
+    * During a batch, the event is sent when the batch is applied, after the recorded changes.
+    */
+    void notifyEndingEvent() override;
+
 protected:
+    /// Changes recorded in the current batch
+    struct ChangeBatch
+    {
+        sofa::type::vector< Tetrahedron > addedTetrahedra;
+        sofa::type::vector< sofa::type::vector< TetrahedronID > > ancestors;
+        sofa::type::vector< sofa::type::vector< SReal > > baryCoefs;
+        bool hasAncestors { false };
+
+        sofa::type::vector< TetrahedronID > removedTetrahedra;
+        bool removeIsolatedItems { true };
+
+        bool endingEvent { false };
+    };
+
+    /// Removes from a batch the tetrahedra both added and removed in it. The removals must be sorted and unique.
+    void compactChangeBatch(ChangeBatch& batch) const;
+
+    /// Number of nested calls to beginChangeBatch not yet closed by endChangeBatch
+    unsigned int m_changeBatchDepth { 0 };
+    ChangeBatch m_changeBatch;
+
     /** \brief Sends a message to warn that some tetrahedra were added in this topology.
     *
     * \sa addTetrahedraProcess
@@ -0,0 +1,138 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/topology/container/dynamic/config.h>
+
+#include <sofa/type/vector.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+namespace sofa::component::topology::container::dynamic
+{
+
+/// Elements ignored by createElementsAroundEntityArray because they refer to entities out of range
+struct InvalidElements
+{
+    sofa::Size count { 0 };
+    sofa::Index first { sofa::InvalidID }; ///< index of the first ignored element
+};
+
+/**
+ * Create, for each entity (vertex, edge, triangle...), the list of the elements containing it, given the
+ * list of the entities of each element. For instance, the tetrahedra around each vertex are created from
+ * the vertices of each tetrahedron. In each list, the elements are sorted by increasing index.
+ *
+ * The number of elements around each entity is counted first, so that each list is allocated once with its
+ * exact size and is not reallocated while it is filled. The lists are then filled by scanning the
+ * elements. In parallel, each task fills the lists of a range of entities, scanning all the elements.
+ *
+ * An element having an entity out of [0, nbEntities) is skipped entirely: it does not appear around any
+ * of its entities.
+ * @return the number of skipped elements and the first of them
+ */
+template<class ElementID, class EntitiesInElementArray>
+InvalidElements createElementsAroundEntityArray(const EntitiesInElementArray& entitiesInElement,
+                                                sofa::Size nbEntities,
+                                                sofa::type::vector< sofa::type::vector<ElementID> >& elementsAroundEntity,
+                                                bool parallel = false)
+{
+    const auto nbElements = entitiesInElement.size();
+    InvalidElements invalidElements;
+
+    const auto isValid = [&entitiesInElement, nbEntities](std::size_t i)
+    {
+        for (const auto entity : entitiesInElement[i])
+        {
+            if (static_cast<sofa::Size>(entity) >= nbEntities)
+                return false;
+        }
+        return true;
+    };
+
+    // number of elements around each entity
+    sofa::type::vector<sofa::Size> valences(nbEntities, 0);
+    sofa::type::vector<bool> validElements(nbElements, true);
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        if (!isValid(i))
+        {
+            validElements[i] = false;
+            if (invalidElements.count++ == 0)
+                invalidElements.first = static_cast<sofa::Index>(i);
+            continue;
+        }
+        for (const auto entity : entitiesInElement[i])
+        {
+            ++valences[entity];
+        }
+    }
+
+    elementsAroundEntity.clear();
+    elementsAroundEntity.resize(nbEntities);
+
+    // the element indices are added in increasing order
+    const auto fill = [&elementsAroundEntity, &valences, &validElements, &entitiesInElement, nbElements](const auto& range)
+    {
+        for (auto e = range.start; e != range.end; ++e)
+        {
+            elementsAroundEntity[e].reserve(valences[e]);
+        }
+        for (std::size_t i = 0; i < nbElements; ++i)
+        {
+            if (!validElements[i])
+                continue;
+            for (const auto entity : entitiesInElement[i])
+            {
+                const auto e = static_cast<sofa::Size>(entity);
+                if (e >= range.start && e < range.end)
+                {
+                    elementsAroundEntity[e].push_back(static_cast<ElementID>(i));
+                }
+            }
+        }
+    };
+
+    simulation::TaskScheduler* taskScheduler = nullptr;
+    if (parallel)
+    {
+        taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+    }
+
+    // the default number of threads is 0 on a single core machine
+    if (taskScheduler && taskScheduler->getThreadCount() > 0)
+    {
+        simulation::forEachRange(simulation::ForEachExecutionPolicy::PARALLEL, *taskScheduler, sofa::Size(0), nbEntities, fill);
+    }
+    else
+    {
+        fill(simulation::Range<sofa::Size>(0, nbEntities));
+    }
+
+    return invalidElements;
+}
+
+} //namespace sofa::component::topology::container::dynamic
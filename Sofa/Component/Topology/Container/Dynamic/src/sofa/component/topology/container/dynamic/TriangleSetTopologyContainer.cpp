@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/topology/container/dynamic/TriangleSetTopologyContainer.h>
+#include <sofa/component/topology/container/dynamic/TopologyAdjacency.h>
 #include <sofa/core/topology/TopologyHandler.h>
 
 #include <sofa/core/ObjectFactory.h>
@@ -122,19 +123,12 @@ void TriangleSetTopologyContainer::createTrianglesAroundVertexArray()
     if (nbPoints == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(sofa::Size(d_initPoints.getValue().size()));
 
-    m_trianglesAroundVertex.resize(getNbPoints());
-    for (size_t i = 0; i < m_triangle.size(); ++i)
+    const InvalidElements invalidTriangles = createElementsAroundEntityArray(m_triangle.ref(), getNbPoints(), m_trianglesAroundVertex);
+    if (invalidTriangles.count > 0)
     {
-        if (m_triangle[i][0] >= getNbPoints() || m_triangle[i][1] >= getNbPoints() || m_triangle[i][2] >= getNbPoints())
-        {
-            msg_warning() << "trianglesAroundVertex creation failed, Triangle buffer is not consistent with number of points, Triangle: " << m_triangle[i] << " for: " << getNbPoints() << " points.";
-            continue;
-        }
-
-
-        // adding edge i in the edge shell of both points
-        for (unsigned int j=0; j<3; ++j)
-            m_trianglesAroundVertex[ m_triangle[i][j]  ].push_back( (TriangleID)i );
+        msg_warning() << "trianglesAroundVertex creation failed, Triangle buffer is not consistent with number of points, Triangle: "
+                      << m_triangle[invalidTriangles.first] << " for: " << getNbPoints() << " points. "
+                      << invalidTriangles.count << " triangle(s) skipped.";
     }
 }
 
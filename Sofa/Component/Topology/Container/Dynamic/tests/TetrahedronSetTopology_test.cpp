@@ -24,7 +24,10 @@
 #include <sofa/testing/BaseTest.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyContainer.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetGeometryAlgorithms.h>
+#include <sofa/component/topology/container/dynamic/TopologyAdjacency.h>
+#include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 #include <sofa/helper/system/FileRepository.h>
+#include <sofa/core/topology/TopologyData.inl>
 
 using namespace sofa::component::topology::container::dynamic;
 using namespace sofa::testing;
@@ -38,6 +41,9 @@ public:
     bool testTriangleBuffers();
     bool testEdgeBuffers();
     bool testVertexBuffers();
+    bool testParallelAdjacencyCreation();
+    bool testChangeBatch();
+    bool testChangeBatchCompaction();
     bool checkTopology();
     bool testTetrahedronGeometry();
 
@@ -387,6 +393,175 @@ bool TetrahedronSetTopology_test::testVertexBuffers()
 
 
 
+bool TetrahedronSetTopology_test::testParallelAdjacencyCreation()
+{
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+
+    if (topoCon == nullptr)
+    {
+        if (scene != nullptr)
+            delete scene;
+        return false;
+    }
+
+    const auto& tetrahedraAroundVertex = topoCon->getTetrahedraAroundVertexArray();
+    const auto& tetrahedraAroundEdge = topoCon->getTetrahedraAroundEdgeArray();
+
+    // the lists created in parallel must be identical to the ones of the container, including the order
+    // several threads, even on a single core machine
+    sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+    sofa::type::vector< TetrahedronSetTopologyContainer::TetrahedraAroundVertex > parallelTetrahedraAroundVertex;
+    createElementsAroundEntityArray(topoCon->getTetrahedronArray(), topoCon->getNbPoints(), parallelTetrahedraAroundVertex, true);
+    EXPECT_EQ(parallelTetrahedraAroundVertex, tetrahedraAroundVertex);
+
+    sofa::type::vector< TetrahedronSetTopologyContainer::TetrahedraAroundEdge > parallelTetrahedraAroundEdge;
+    createElementsAroundEntityArray(topoCon->getEdgesInTetrahedronArray(), topoCon->getNumberOfEdges(), parallelTetrahedraAroundEdge, true);
+    EXPECT_EQ(parallelTetrahedraAroundEdge, tetrahedraAroundEdge);
+
+    // the lists have no spare capacity
+    for (const auto& tetrahedra : tetrahedraAroundVertex)
+    {
+        EXPECT_EQ(tetrahedra.capacity(), tetrahedra.size());
+    }
+
+    // elements having an entity out of range are skipped entirely
+    sofa::type::vector< TetrahedronSetTopologyContainer::TetrahedraAroundVertex > truncated;
+    const InvalidElements invalidTetrahedra = createElementsAroundEntityArray(topoCon->getTetrahedronArray(), 1, truncated);
+    EXPECT_EQ(truncated.size(), 1);
+    EXPECT_TRUE(truncated[0].empty());
+    EXPECT_EQ(invalidTetrahedra.count, topoCon->getNbTetrahedra());
+    EXPECT_EQ(invalidTetrahedra.first, 0);
+
+    const sofa::type::vector<sofa::topology::Triangle> triangles { {0, 1, 2}, {1, 2, 5}, {2, 3, 0}, {7, 1, 3} };
+    sofa::type::vector< sofa::type::vector<sofa::Index> > trianglesAroundVertex;
+    const InvalidElements invalidTriangles = createElementsAroundEntityArray(triangles, 4, trianglesAroundVertex);
+    EXPECT_EQ(invalidTriangles.count, 2);
+    EXPECT_EQ(invalidTriangles.first, 1);
+    const sofa::type::vector< sofa::type::vector<sofa::Index> > expectedTrianglesAroundVertex { {0, 2}, {0}, {0, 2}, {2} };
+    EXPECT_EQ(trianglesAroundVertex, expectedTrianglesAroundVertex);
+
+    delete scene;
+    return true;
+}
+
+
+bool TetrahedronSetTopology_test::testChangeBatch()
+{
+    // reference: all the tetrahedra removed at once
+    fake_TopologyScene* refScene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* refTopoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(refScene->getNode().get()->getMeshTopology());
+    const auto refModifier = refScene->getNode()->get<TetrahedronSetTopologyModifier>(sofa::core::objectmodel::BaseContext::SearchDown);
+
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+    const auto modifier = scene->getNode()->get<TetrahedronSetTopologyModifier>(sofa::core::objectmodel::BaseContext::SearchDown);
+
+    if (refTopoCon == nullptr || topoCon == nullptr || refModifier == nullptr || modifier == nullptr)
+    {
+        delete refScene;
+        delete scene;
+        return false;
+    }
+
+    refModifier->removeTetrahedra({ 2, 5, 17, 30, 43 });
+
+    // same removals in several calls, with a duplicate, using the numbering of the beginning of the batch
+    modifier->beginChangeBatch();
+    modifier->removeTetrahedra({ 30, 2 });
+    modifier->beginChangeBatch();
+    modifier->removeTetrahedra({ 43, 17 });
+    modifier->endChangeBatch();
+    modifier->removeTetrahedra({ 5, 30 });
+
+    // nothing is applied before the end of the outermost batch
+    EXPECT_TRUE(modifier->isInChangeBatch());
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron);
+    modifier->endChangeBatch();
+    EXPECT_FALSE(modifier->isInChangeBatch());
+
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron - 5);
+    EXPECT_EQ(topoCon->getNbPoints(), refTopoCon->getNbPoints());
+    const auto& tetrahedra = topoCon->getTetrahedronArray();
+    const auto& refTetrahedra = refTopoCon->getTetrahedronArray();
+    for (std::size_t i = 0; i < tetrahedra.size(); ++i)
+    {
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(tetrahedra[i][j], refTetrahedra[i][j]);
+        }
+    }
+
+    delete refScene;
+    delete scene;
+    return true;
+}
+
+
+bool TetrahedronSetTopology_test::testChangeBatchCompaction()
+{
+    // reference: only the changes remaining after the compaction of the batch
+    fake_TopologyScene* refScene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* refTopoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(refScene->getNode().get()->getMeshTopology());
+    const auto refModifier = refScene->getNode()->get<TetrahedronSetTopologyModifier>(sofa::core::objectmodel::BaseContext::SearchDown);
+
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+    const auto modifier = scene->getNode()->get<TetrahedronSetTopologyModifier>(sofa::core::objectmodel::BaseContext::SearchDown);
+
+    if (refTopoCon == nullptr || topoCon == nullptr || refModifier == nullptr || modifier == nullptr)
+    {
+        delete refScene;
+        delete scene;
+        return false;
+    }
+
+    // tetrahedra 2 and 5 are replaced by new ones, but the replacement of 5 is removed in the same batch
+    const auto replacement2 = topoCon->getTetrahedron(2);
+    const auto replacement5 = topoCon->getTetrahedron(5);
+
+    // the mass of the scene requires the ancestors of the added tetrahedra
+    refModifier->addTetrahedra({ replacement2 }, { { 2 } }, { { 1 } });
+    refModifier->removeTetrahedra({ 2, 5 });
+
+    // number of tetrahedra added in the changes propagated to the topology data
+    auto tetrahedronData = std::make_unique< sofa::core::topology::TetrahedronData< sofa::type::vector<sofa::Index> > >(sofa::core::objectmodel::BaseData::BaseInitData());
+    tetrahedronData->setOwner(topoCon);
+    tetrahedronData->setValue(sofa::type::vector<sofa::Index>(nbrTetrahedron, 0));
+    tetrahedronData->createTopologyHandler(topoCon);
+    std::size_t nbPropagatedAdditions = 0;
+    tetrahedronData->addTopologyEventCallBack(sofa::core::topology::TopologyChangeType::TETRAHEDRAADDED,
+        [&nbPropagatedAdditions](const sofa::core::topology::TopologyChange* change)
+        {
+            nbPropagatedAdditions += static_cast<const sofa::core::topology::TetrahedraAdded*>(change)->getNbAddedTetrahedra();
+        });
+
+    modifier->beginChangeBatch();
+    modifier->addTetrahedra({ replacement2, replacement5 }, { { 2 }, { 5 } }, { { 1 }, { 1 } });
+    modifier->removeTetrahedra({ 5, sofa::Index(nbrTetrahedron + 1), 2 });
+    modifier->endChangeBatch();
+
+    EXPECT_EQ(nbPropagatedAdditions, 1u);
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron - 1);
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), refTopoCon->getNumberOfTetrahedra());
+    const auto& tetrahedra = topoCon->getTetrahedronArray();
+    const auto& refTetrahedra = refTopoCon->getTetrahedronArray();
+    for (std::size_t i = 0; i < std::min(tetrahedra.size(), refTetrahedra.size()); ++i)
+    {
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(tetrahedra[i][j], refTetrahedra[i][j]);
+        }
+    }
+
+    // the data is removed from the topology before it is destroyed
+    tetrahedronData.reset();
+    delete refScene;
+    delete scene;
+    return true;
+}
+
+
 bool TetrahedronSetTopology_test::checkTopology()
 {
     fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
@@ -465,6 +640,21 @@ TEST_F(TetrahedronSetTopology_test, testVertexBuffers)
     ASSERT_TRUE(testVertexBuffers());
 }
 
+TEST_F(TetrahedronSetTopology_test, testParallelAdjacencyCreation)
+{
+    ASSERT_TRUE(testParallelAdjacencyCreation());
+}
+
+TEST_F(TetrahedronSetTopology_test, testChangeBatch)
+{
+    ASSERT_TRUE(testChangeBatch());
+}
+
+TEST_F(TetrahedronSetTopology_test, testChangeBatchCompaction)
+{
+    ASSERT_TRUE(testChangeBatchCompaction());
+}
+
 TEST_F(TetrahedronSetTopology_test, checkTopology)
 {
     ASSERT_TRUE(checkTopology());
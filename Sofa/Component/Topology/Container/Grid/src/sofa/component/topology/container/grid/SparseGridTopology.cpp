@@ -29,7 +29,9 @@
 #include <sofa/component/topology/container/grid/polygon_cube_intersection/polygon_cube_intersection.h>
 #include <sofa/core/loader/VoxelLoader.h>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <string>
 #include <cmath>
 
@@ -1305,25 +1307,96 @@ SparseGridTopology::Index SparseGridTopology::findNearestCube(const type::Vec3&
     float lgmin = 99999999.0f;
 
     const auto& points = d_seqPoints.getValue();
-    for(unsigned w=0; w<hexahedra.size(); ++w)
+    const auto checkCube = [&](Index w)
     {
-        if(!_usingMC && _types[w]!=BOUNDARY )continue;
+        if(!_usingMC && _types[w]!=BOUNDARY ) return;
 
         const Hexa& c = getHexahedron( w );
-        const Index c0 = c[0];
-        const Index c7 = c[6];
-
-        const auto& p0 = points[c0];
-        const auto& p7 = points[c7];
+        const auto& p0 = points[c[0]];
+        const auto& p7 = points[c[6]];
 
         type::Vec3 barycenter = (p0+p7) * .5;
 
+        // the cube with the lowest index is kept among the cubes at the same distance
         const float lg = (float)((pos-barycenter).norm());
-        if( lg < lgmin )
+        if( lg < lgmin || (lg == lgmin && w < indice) )
         {
             lgmin = lg;
             indice = w;
         }
+    };
+
+    // The cubes are visited by rings of increasing size in the regular grid, around the regular cube nearest to
+    // pos, until the unexplored cubes are further than the nearest cube found so far.
+    const Vec3i n(getNx() - 1, getNy() - 1, getNz() - 1); // number of cubes in each direction
+    const type::Vec3 axes[3] = { _regularGrid->getDx(), _regularGrid->getDy(), _regularGrid->getDz() };
+    const type::Vec3 p = pos - _regularGrid->getP0();
+    type::Vec3 gridPos; // position in the regular grid, in number of cubes
+    type::Vec3 cubeSize;
+    Vec3i center;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const SReal axisNorm2 = axes[i].norm2();
+        gridPos[i] = axisNorm2 > 0 ? (p * axes[i]) / axisNorm2 : 0;
+        cubeSize[i] = std::sqrt(axisNorm2);
+        center[i] = std::clamp(int(std::floor(gridPos[i])), 0, std::max(n[i] - 1, 0));
+    }
+
+    const int maxRing = std::max({n[0], n[1], n[2]});
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        Vec3i lo, hi;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            lo[i] = std::max(center[i] - ring, 0);
+            hi[i] = std::min(center[i] + ring, n[i] - 1);
+        }
+
+        const auto checkRegularCube = [&](int x, int y, int z)
+        {
+            const Index w = _indicesOfRegularCubeInSparseGrid[_regularGrid->cube(x, y, z)];
+            if (w != InvalidID)
+                checkCube(w);
+        };
+
+        for (int z = lo[2]; z <= hi[2]; ++z)
+        {
+            for (int y = lo[1]; y <= hi[1]; ++y)
+            {
+                if (std::abs(z - center[2]) == ring || std::abs(y - center[1]) == ring)
+                {
+                    for (int x = lo[0]; x <= hi[0]; ++x)
+                        checkRegularCube(x, y, z);
+                }
+                else
+                {
+                    // only the ends of the row are on the ring
+                    if (center[0] - ring >= 0)
+                        checkRegularCube(center[0] - ring, y, z);
+                    if (center[0] + ring <= n[0] - 1)
+                        checkRegularCube(center[0] + ring, y, z);
+                }
+            }
+        }
+
+        // distance from pos to the closest unexplored cube
+        SReal bound = std::numeric_limits<SReal>::max();
+        bool remaining = false;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            if (lo[i] > 0)
+            {
+                remaining = true;
+                bound = std::min(bound, (gridPos[i] - lo[i]) * cubeSize[i]);
+            }
+            if (hi[i] < n[i] - 1)
+            {
+                remaining = true;
+                bound = std::min(bound, (hi[i] + 1 - gridPos[i]) * cubeSize[i]);
+            }
+        }
+        if (!remaining || (float)bound > lgmin)
+            break;
     }
 
     const Hexa& c = getHexahedron( indice );
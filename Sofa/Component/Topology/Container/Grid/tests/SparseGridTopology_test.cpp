@@ -47,6 +47,7 @@ struct SparseGridTopology_test : public BaseTest
 
     bool buildFromMeshFile();
     bool buildFromMeshParams();
+    bool findNearestCube();
 };
 
 
@@ -124,8 +125,63 @@ bool SparseGridTopology_test::buildFromMeshParams()
     return true;
 }
 
-TEST_F(SparseGridTopology_test, buildFromMeshFile) { ASSERT_TRUE(buildFromMeshFile()); }
-TEST_F(SparseGridTopology_test, buildFromMeshParams) { ASSERT_TRUE(buildFromMeshParams()); }
+bool SparseGridTopology_test::findNearestCube()
+{
+    const SparseGridTopology::SPtr sparseGrid = New<SparseGridTopology>();
+    EXPECT_NE(sparseGrid, nullptr);
+
+    //Pyramid centered on 0 0 0
+    sparseGrid->d_seqPoints.setValue({{0, 0, 1}, {-1, 0, -1}, {0, 1, -1}, {1, 0, -1}, {0, -1, -1} });
+    sparseGrid->d_seqTriangles.setValue({{0, 1, 2}, {0, 2, 3}, {0, 3, 4}, {0, 4, 1}, {1, 2, 3}, {3, 4, 1} });
+    sparseGrid->setN({ 10,10,10 });
+    sparseGrid->init();
+
+    // exhaustive search: the boundary cube with the nearest center, the first one in case of equality
+    const auto point = [&sparseGrid](sofa::Index i)
+    {
+        return Vec3(sparseGrid->getPX(i), sparseGrid->getPY(i), sparseGrid->getPZ(i));
+    };
+    const auto exhaustiveSearch = [&sparseGrid, &point](const Vec3& pos)
+    {
+        sofa::Index nearest = 0;
+        float minDistance = 99999999.0f;
+        for (sofa::Index w = 0; w < sparseGrid->getNbHexahedra(); ++w)
+        {
+            if (sparseGrid->getType(w) != SparseGridTopology::BOUNDARY)
+                continue;
+            const auto& hexa = sparseGrid->getHexahedron(w);
+            const Vec3 center = (point(hexa[0]) + point(hexa[6])) * 0.5;
+            const float distance = (float)((pos - center).norm());
+            if (distance < minDistance)
+            {
+                minDistance = distance;
+                nearest = w;
+            }
+        }
+        return nearest;
+    };
+
+    // the grid points are at the same distance of several cubes
+    sofa::type::vector<Vec3> positions;
+    for (sofa::Index i = 0; i < sparseGrid->getNbPoints(); ++i)
+    {
+        positions.push_back(point(i));
+    }
+    for (unsigned int i = 0; i < 300; ++i)
+    {
+        positions.push_back(Vec3(3 * std::sin(0.37 * i), 3 * std::cos(0.53 * i), 3 * std::sin(0.71 * i + 1)));
+    }
+    positions.push_back(Vec3(50, -20, 10));
 
+    for (const auto& pos : positions)
+    {
+        SReal fx, fy, fz;
+        EXPECT_EQ(sparseGrid->findNearestCube(pos, fx, fy, fz), exhaustiveSearch(pos)) << "position " << pos;
+    }
 
+    return true;
+}
 
+TEST_F(SparseGridTopology_test, buildFromMeshFile) { ASSERT_TRUE(buildFromMeshFile()); }
+TEST_F(SparseGridTopology_test, buildFromMeshParams) { ASSERT_TRUE(buildFromMeshParams()); }
+TEST_F(SparseGridTopology_test, findNearestCube) { ASSERT_TRUE(findNearestCube()); }
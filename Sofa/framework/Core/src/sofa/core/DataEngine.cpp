@@ -21,11 +21,18 @@
 ******************************************************************************/
 
 #include <sofa/core/DataEngine.h>
+#include <atomic>
 
 namespace sofa::core
 {
 
+namespace
+{
+std::atomic<std::uint64_t> nbEvaluations { 0 };
+}
+
 DataEngine::DataEngine()
+    : d_asyncUpdate(initData(&d_asyncUpdate, false, "asyncUpdate", "If true, the engine is updated on a worker thread as soon as it is dirty at the end of a time step, until the next time step. Its inputs must not be modified between two time steps."))
 {
 }
 
@@ -66,7 +73,88 @@ void DataEngine::update()
 {
     updateAllInputs();
     DDGNode::cleanDirty();
+    nbEvaluations.fetch_add(1, std::memory_order_relaxed);
     doUpdate();
     m_dataTracker.clean();
 }
+
+namespace
+{
+/// Update exclusively the dirty engines upstream of node, starting with the farthest ones
+void updateUpstreamEnginesExclusively(objectmodel::DDGNode* node)
+{
+    for (objectmodel::DDGNode* input : node->getInputs())
+    {
+        if (!input->isDirty())
+        {
+            continue;
+        }
+        if (auto* engine = dynamic_cast<DataEngine*>(input))
+        {
+            engine->updateExclusively();
+        }
+        else
+        {
+            updateUpstreamEnginesExclusively(input);
+        }
+    }
+}
+}
+
+bool DataEngine::updateExclusively()
+{
+    if (!isDirty())
+    {
+        return false;
+    }
+
+    // The upstream engines are updated the same way first, so that their outputs are reserved as well while
+    // they are computed. Otherwise, update() would update them through updateIfDirty, reserving only the
+    // output it reads.
+    updateUpstreamEnginesExclusively(this);
+
+    if (!tryLockUpdate())
+    {
+        return false;
+    }
+
+    // the outputs are reserved as well: they may be cleaned during doUpdate, before their final value is set
+    std::vector<DDGNode*> lockedOutputs;
+    lockedOutputs.reserve(getOutputs().size());
+    bool isLocked = true;
+    for (DDGNode* output : getOutputs())
+    {
+        if (!output->tryLockUpdate())
+        {
+            // an output is being read by another thread, which will update the engine itself
+            isLocked = false;
+            break;
+        }
+        lockedOutputs.push_back(output);
+    }
+
+    const bool isUpdated = isLocked && isDirty();
+    if (isUpdated)
+    {
+        update();
+    }
+
+    for (DDGNode* output : lockedOutputs)
+    {
+        // the outputs are cleaned as if they had been read
+        if (isUpdated)
+        {
+            output->updateIfDirty();
+        }
+        output->unlockUpdate();
+    }
+    unlockUpdate();
+
+    return isUpdated;
+}
+
+std::uint64_t DataEngine::getNbEvaluations()
+{
+    return nbEvaluations.load(std::memory_order_relaxed);
+}
 } // namespace sofa::core
@@ -90,5 +90,19 @@ public:
 
     /// Add a new output to this engine
     void addOutput(objectmodel::BaseData* n);
+
+    /// Number of evaluations of all the engines since the start of the program
+    static std::uint64_t getNbEvaluations();
+
+    /// Update the engine if it is dirty, while it and its outputs are reserved to the current thread (see
+    /// DDGNode::tryLockUpdate): the other threads reading the outputs wait for the end of the update.
+    /// The dirty engines upstream of this one are updated the same way beforehand.
+    /// Returns false if the engine was not updated, because it is clean or already being updated.
+    bool updateExclusively();
+
+    /// If true, the animation loop updates the engine on a worker thread as soon as it is dirty at the
+    /// end of a time step, instead of when one of its outputs is read. Its inputs must not be modified
+    /// until the beginning of the next time step.
+    Data<bool> d_asyncUpdate;
 };
 } // namespace sofa
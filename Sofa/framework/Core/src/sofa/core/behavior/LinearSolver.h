@@ -85,6 +85,20 @@ public:
     /// Invert the system, this method is optional because it's called when solveSystem() is called for the first time
     virtual void invertSystem() {}
 
+    /// Override the tolerance on the relative residual |r|/|b| of an iterative solver for the next calls to solveSystem.
+    /// It is used by nonlinear solvers to adapt the accuracy of the linear solves (inexact Newton methods).
+    /// A negative value restores the tolerance defined by the solver.
+    ///
+    /// @return false if the solver does not support this operation (e.g. direct solvers)
+    virtual bool setRelativeTolerance(SReal tolerance)
+    {
+        SOFA_UNUSED(tolerance);
+        return false;
+    }
+
+    /// Number of iterations performed during the last call to solveSystem, or 0 if the solver is not iterative
+    virtual unsigned getNbIterationsOfLastSolve() const { return 0; }
+
     /// Multiply the inverse of the system matrix by the transpose of the given matrix J
     ///
     /// @param result the variable where the result will be added
@@ -24,6 +24,8 @@
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/helper/accessor.h>
 #include <fstream>
+#include <filesystem>
+#include <type_traits>
 
 #include <cstdlib>
 
@@ -67,6 +69,7 @@ MeshLoader::MeshLoader() : BaseLoader()
   , d_rotation(initData(&d_rotation, Vec3(), "rotation", "Rotation of the DOFs"))
   , d_scale(initData(&d_scale, Vec3(1.0, 1.0, 1.0), "scale3d", "Scale of the DOFs in 3 dimensions"))
   , d_transformation(initData(&d_transformation, type::Matrix4::Identity(), "transformation", "4x4 Homogeneous matrix to transform the DOFs (when present replace any)"))
+  , d_binaryCache(initData(&d_binaryCache, false, "binaryCache", "Store the loaded buffers in a binary file next to the loaded file, and read it instead of parsing the file the next times"))
   , d_previousTransformation(type::Matrix4::Identity() )
 {
     addAlias(&d_tetrahedra, "tetras");
@@ -81,6 +84,7 @@ MeshLoader::MeshLoader() : BaseLoader()
     d_rotation.setAutoLink(false);
     d_scale.setAutoLink(false);
     d_transformation.setAutoLink(false);
+    d_binaryCache.setAutoLink(false);
     d_transformation.setDirtyValue();
 
     d_positions.setGroup("Vectors");
@@ -241,19 +245,351 @@ void MeshLoader::reinit()
     updateMesh();
 }
 
+namespace
+{
+
+constexpr char binaryMeshMagic[8] = {'S', 'O', 'F', 'A', 'M', 'E', 'S', 'H'};
+constexpr std::uint32_t binaryMeshVersion = 1;
+constexpr std::uint32_t binaryMeshEndianness = 0x01020304;
+
+/// FNV-1a hash
+std::uint64_t hashBytes(const char* bytes, std::size_t nbBytes, std::uint64_t hash = 14695981039346656037ull)
+{
+    for (std::size_t i = 0; i < nbBytes; ++i)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hashFile(const std::string& filename, std::uint64_t& hash)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(1 << 16);
+    while (file)
+    {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = hashBytes(buffer.data(), static_cast<std::size_t>(file.gcount()), hash);
+    }
+    return file.eof();
+}
+
+template<class T>
+void writeValue(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+bool readValue(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/// Check that the stream still contains size values of valueSize bytes, before allocating them from a size read in
+/// the file
+bool hasRemainingValues(std::istream& in, std::uint64_t size, std::size_t valueSize)
+{
+    const std::istream::pos_type position = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(position);
+    if (position < 0 || end < position || size > static_cast<std::uint64_t>(end - position) / valueSize)
+    {
+        msg_error("MeshLoader") << "Corrupted binary mesh: " << size << " values of " << valueSize
+            << " bytes are expected, but the file is shorter";
+        return false;
+    }
+    return true;
+}
+
+template<class T>
+void writeArray(std::ostream& out, const type::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    writeValue<std::uint64_t>(out, values.size());
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+/// The array is read at once in its buffer, without any parsing
+template<class T>
+bool readArray(std::istream& in, type::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::uint64_t size = 0;
+    if (!readValue(in, size) || !hasRemainingValues(in, size, sizeof(T)))
+    {
+        return false;
+    }
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+template<class T>
+bool readArray(std::istream& in, objectmodel::Data<type::vector<T>>& data)
+{
+    auto values = helper::getWriteOnlyAccessor(data);
+    return readArray(in, values.wref());
+}
+
+/// Nested arrays are flattened: the sizes of the arrays, then their concatenated values
+template<class T>
+void writeNestedArray(std::ostream& out, const type::vector<type::vector<T>>& values)
+{
+    type::vector<std::uint64_t> sizes;
+    type::vector<T> flat;
+    sizes.reserve(values.size());
+    for (const auto& v : values)
+    {
+        sizes.push_back(v.size());
+        flat.insert(flat.end(), v.begin(), v.end());
+    }
+    writeArray(out, sizes);
+    writeArray(out, flat);
+}
+
+template<class T>
+bool readNestedArray(std::istream& in, objectmodel::Data<type::vector<type::vector<T>>>& data)
+{
+    type::vector<std::uint64_t> sizes;
+    type::vector<T> flat;
+    if (!readArray(in, sizes) || !readArray(in, flat))
+    {
+        return false;
+    }
+
+    auto values = helper::getWriteOnlyAccessor(data);
+    values.resize(sizes.size());
+    auto it = flat.begin();
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        if (static_cast<std::uint64_t>(std::distance(it, flat.end())) < sizes[i])
+        {
+            msg_error("MeshLoader") << "Corrupted binary mesh: the nested arrays are longer than their values";
+            return false;
+        }
+        values[i].assign(it, it + sizes[i]);
+        it += sizes[i];
+    }
+    return true;
+}
+
+void writeString(std::ostream& out, const std::string& s)
+{
+    writeValue<std::uint64_t>(out, s.size());
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+bool readString(std::istream& in, std::string& s)
+{
+    std::uint64_t size = 0;
+    if (!readValue(in, size) || !hasRemainingValues(in, size, sizeof(char)))
+    {
+        return false;
+    }
+    s.resize(size);
+    return static_cast<bool>(in.read(s.data(), static_cast<std::streamsize>(size)));
+}
+
+void writeGroups(std::ostream& out, const type::vector<PrimitiveGroup>& groups)
+{
+    writeValue<std::uint64_t>(out, groups.size());
+    for (const auto& group : groups)
+    {
+        writeValue(out, group.p0);
+        writeValue(out, group.nbp);
+        writeValue(out, group.materialId);
+        writeString(out, group.materialName);
+        writeString(out, group.groupName);
+    }
+}
+
+bool readGroups(std::istream& in, objectmodel::Data<type::vector<PrimitiveGroup>>& data)
+{
+    // each group is written with at least its indices, its material id and the sizes of its names
+    constexpr std::size_t minimalGroupSize = sizeof(PrimitiveGroup::p0) + sizeof(PrimitiveGroup::nbp)
+        + sizeof(PrimitiveGroup::materialId) + 2 * sizeof(std::uint64_t);
+    std::uint64_t size = 0;
+    if (!readValue(in, size) || !hasRemainingValues(in, size, minimalGroupSize))
+    {
+        return false;
+    }
+    auto groups = helper::getWriteOnlyAccessor(data);
+    groups.resize(size);
+    for (auto& group : groups)
+    {
+        if (!readValue(in, group.p0) || !readValue(in, group.nbp) || !readValue(in, group.materialId)
+            || !readString(in, group.materialName) || !readString(in, group.groupName))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The buffers are accessed with getBuffer, which allows to read them without updating them while loading
+template<class Loader, class GetBuffer>
+bool writeBinaryMeshFile(const std::string& filename, std::uint64_t key, Loader& loader, GetBuffer getBuffer)
+{
+    // Written in a temporary file, then renamed, so that concurrent loads never read a partial file
+    const std::string temporaryFilename = filename + ".tmp";
+    {
+        std::ofstream out(temporaryFilename, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        out.write(binaryMeshMagic, sizeof(binaryMeshMagic));
+        writeValue(out, binaryMeshVersion);
+        writeValue(out, binaryMeshEndianness);
+        writeValue<std::uint32_t>(out, sizeof(SReal));
+        writeValue<std::uint32_t>(out, sizeof(MeshLoader::PointID));
+        writeValue(out, key);
+
+        writeArray(out, getBuffer(loader.d_positions));
+        writeArray(out, getBuffer(loader.d_normals));
+        writeNestedArray(out, getBuffer(loader.d_polylines));
+        writeArray(out, getBuffer(loader.d_edges));
+        writeArray(out, getBuffer(loader.d_triangles));
+        writeArray(out, getBuffer(loader.d_quads));
+        writeNestedArray(out, getBuffer(loader.d_polygons));
+        writeArray(out, getBuffer(loader.d_tetrahedra));
+        writeArray(out, getBuffer(loader.d_hexahedra));
+        writeArray(out, getBuffer(loader.d_pentahedra));
+        writeArray(out, getBuffer(loader.d_pyramids));
+        writeArray(out, getBuffer(loader.d_highOrderEdgePositions));
+        writeArray(out, getBuffer(loader.d_highOrderTrianglePositions));
+        writeArray(out, getBuffer(loader.d_highOrderQuadPositions));
+        writeArray(out, getBuffer(loader.d_highOrderTetrahedronPositions));
+        writeArray(out, getBuffer(loader.d_highOrderHexahedronPositions));
+        writeGroups(out, getBuffer(loader.d_edgesGroups));
+        writeGroups(out, getBuffer(loader.d_trianglesGroups));
+        writeGroups(out, getBuffer(loader.d_quadsGroups));
+        writeGroups(out, getBuffer(loader.d_polygonsGroups));
+        writeGroups(out, getBuffer(loader.d_tetrahedraGroups));
+        writeGroups(out, getBuffer(loader.d_hexahedraGroups));
+        writeGroups(out, getBuffer(loader.d_pentahedraGroups));
+        writeGroups(out, getBuffer(loader.d_pyramidsGroups));
+
+        if (!out)
+        {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryFilename, filename, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryFilename, error);
+        return false;
+    }
+    return true;
+}
+
+}
+
 bool MeshLoader::load()
 {
     // Clear previously loaded buffers
     clearBuffers();
+    m_loadedFromBinaryCache = false;
+
+    // The binary cache is keyed by the loader, its parameters and the content of the loaded file
+    std::string cacheFilename;
+    std::uint64_t cacheKey = 0;
+    const std::string cacheParameters = d_binaryCache.getValue() ? getBinaryCacheParameters() : std::string();
+    if (!cacheParameters.empty() && hashFile(d_filename.getFullPath(), cacheKey))
+    {
+        cacheKey = hashBytes(cacheParameters.data(), cacheParameters.size(), cacheKey);
+        cacheFilename = d_filename.getFullPath() + ".sofamesh";
+        if (readBinaryMesh(cacheFilename, &cacheKey))
+        {
+            msg_info() << "Buffers read from the binary cache " << cacheFilename;
+            m_loadedFromBinaryCache = true;
+            return true;
+        }
+        clearBuffers();
+    }
+    else if (d_binaryCache.getValue() && cacheParameters.empty())
+    {
+        msg_warning() << "The binary cache is not supported by this loader";
+    }
 
     const bool loaded = doLoad();
 
     // Clear (potentially) partially filled buffers
     if (!loaded)
         clearBuffers();
+    else if (!cacheFilename.empty())
+    {
+        // Reading the buffers with getValue would update them, i.e. load them again
+        const auto getLoadedBuffer = [](auto& data) -> const auto& { return helper::getWriteOnlyAccessor(data).ref(); };
+        if (!writeBinaryMeshFile(cacheFilename, cacheKey, *this, getLoadedBuffer))
+            msg_warning() << "Cannot write the binary cache " << cacheFilename;
+    }
     return loaded;
 }
 
+bool MeshLoader::writeBinaryMesh(const std::string& filename, std::uint64_t key) const
+{
+    return writeBinaryMeshFile(filename, key, *this, [](const auto& data) -> const auto& { return data.getValue(); });
+}
+
+bool MeshLoader::readBinaryMesh(const std::string& filename, const std::uint64_t* key)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    char magic[sizeof(binaryMeshMagic)] {};
+    std::uint32_t version = 0, endianness = 0, realSize = 0, indexSize = 0;
+    std::uint64_t fileKey = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(binaryMeshMagic))
+        || !readValue(in, version) || version != binaryMeshVersion
+        || !readValue(in, endianness) || endianness != binaryMeshEndianness
+        || !readValue(in, realSize) || realSize != sizeof(SReal)
+        || !readValue(in, indexSize) || indexSize != sizeof(PointID)
+        || !readValue(in, fileKey) || (key && *key != fileKey))
+    {
+        return false;
+    }
+
+    return readArray(in, d_positions)
+        && readArray(in, d_normals)
+        && readNestedArray(in, d_polylines)
+        && readArray(in, d_edges)
+        && readArray(in, d_triangles)
+        && readArray(in, d_quads)
+        && readNestedArray(in, d_polygons)
+        && readArray(in, d_tetrahedra)
+        && readArray(in, d_hexahedra)
+        && readArray(in, d_pentahedra)
+        && readArray(in, d_pyramids)
+        && readArray(in, d_highOrderEdgePositions)
+        && readArray(in, d_highOrderTrianglePositions)
+        && readArray(in, d_highOrderQuadPositions)
+        && readArray(in, d_highOrderTetrahedronPositions)
+        && readArray(in, d_highOrderHexahedronPositions)
+        && readGroups(in, d_edgesGroups)
+        && readGroups(in, d_trianglesGroups)
+        && readGroups(in, d_quadsGroups)
+        && readGroups(in, d_polygonsGroups)
+        && readGroups(in, d_tetrahedraGroups)
+        && readGroups(in, d_hexahedraGroups)
+        && readGroups(in, d_pentahedraGroups)
+        && readGroups(in, d_pyramidsGroups);
+}
+
 
 
 bool MeshLoader::canLoad()
@@ -26,6 +26,7 @@
 #include <sofa/core/loader/BaseLoader.h>
 #include <sofa/type/PrimitiveGroup.h>
 #include <sofa/core/topology/Topology.h>
+#include <cstdint>
 
 
 namespace sofa::helper::io {
@@ -95,6 +96,13 @@ public:
 
     virtual bool load() final;
 
+    /// Write the loaded buffers in the binary mesh format, which can be read by MeshBinaryLoader.
+    /// The key identifies the source and the parameters of the buffers, it is checked when reading a cache.
+    bool writeBinaryMesh(const std::string& filename, std::uint64_t key = 0) const;
+
+    /// True if the buffers of the last load were read from the binary cache instead of being parsed
+    bool isLoadedFromBinaryCache() const { return m_loadedFromBinaryCache; }
+
     /// Apply Homogeneous transformation to the positions
     virtual void applyTransformation (sofa::type::Matrix4 const& T);
 
@@ -183,6 +191,8 @@ public:
     Data< Vec3 > d_scale; ///< Scale of the DOFs in 3 dimensions
     Data< type::Matrix4 > d_transformation; ///< 4x4 Homogeneous matrix to transform the DOFs (when present replace any)
 
+    Data< bool > d_binaryCache; ///< Store the loaded buffers in a binary file next to the loaded file, and read it instead of parsing the file the next times
+
 
     virtual void updateMesh();
     virtual void updateElements();
@@ -228,6 +238,16 @@ protected:
     void addPyramid(type::vector< Pyramid>& pPyramids,
                     Topology::ElemID p0, Topology::ElemID p1, Topology::ElemID p2, Topology::ElemID p3, Topology::ElemID p4);
 
+    /// Read buffers written by writeBinaryMesh. If a key is given, a file written with another key is rejected.
+    bool readBinaryMesh(const std::string& filename, const std::uint64_t* key = nullptr);
+
+    /// Loader parameters changing the loaded buffers, used with the content of the file to key the binary cache.
+    /// An empty string (default) disables the cache: the loaders filling other Data than the buffers of the
+    /// MeshLoader must not be cached.
+    virtual std::string getBinaryCacheParameters() const { return {}; }
+
+    bool m_loadedFromBinaryCache { false };
+
     /// Temporary method that will copy all buffers from a io::Mesh into the corresponding Data. Will be removed as soon as work on unifying meshloader is finished
     void copyMeshToData(helper::io::Mesh& _mesh);
 };
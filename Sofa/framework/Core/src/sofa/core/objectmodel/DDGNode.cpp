@@ -27,6 +27,12 @@
 namespace sofa::core::objectmodel
 {
 
+namespace
+{
+std::atomic<std::uint64_t> nbDirtyPropagations { 0 };
+std::atomic<std::uint64_t> nbUpdates { 0 };
+}
+
 /// Constructor
 DDGNode::DDGNode()
 {
@@ -46,33 +52,33 @@ DDGNode::~DDGNode()
 
 void DDGNode::setDirtyValue()
 {
-    bool& dirtyValue = dirtyFlags.dirtyValue;
-    if (!dirtyValue)
+    if (!dirtyFlags.dirtyValue.exchange(true, std::memory_order_acq_rel))
     {
-        dirtyValue = true;
+        nbDirtyPropagations.fetch_add(1, std::memory_order_relaxed);
         setDirtyOutputs();
     }
 }
 
 void DDGNode::setDirtyOutputs()
 {
-    bool& dirtyOutputs = dirtyFlags.dirtyOutputs;
-    if (!dirtyOutputs)
+    if (!dirtyFlags.dirtyOutputs.exchange(true, std::memory_order_acq_rel))
     {
-        dirtyOutputs = true;
         for(DDGLinkIterator it=outputs.begin(), itend=outputs.end(); it != itend; ++it)
         {
-            (*it)->setDirtyValue();
+            // An output already dirty has already propagated its dirtiness: skip it without the virtual call.
+            // An input is only flagged as having dirty outputs until one of them is cleaned, so this case is frequent.
+            if (!(*it)->isDirty())
+            {
+                (*it)->setDirtyValue();
+            }
         }
     }
 }
 
 void DDGNode::cleanDirty()
 {
-    bool& dirtyValue = dirtyFlags.dirtyValue;
-    if (dirtyValue)
+    if (dirtyFlags.dirtyValue.exchange(false, std::memory_order_acq_rel))
     {
-        dirtyValue = false;
         cleanDirtyOutputsOfInputs();
     }
 }
@@ -86,7 +92,7 @@ void DDGNode::notifyEndEdit()
 void DDGNode::cleanDirtyOutputsOfInputs()
 {
     for(const auto it : inputs)
-        it->dirtyFlags.dirtyOutputs = false;
+        it->dirtyFlags.dirtyOutputs.store(false, std::memory_order_release);
 }
 
 void DDGNode::addInput(DDGNode* n)
@@ -144,10 +150,68 @@ const DDGNode::DDGLinkContainer& DDGNode::getOutputs()
 
 void DDGNode::updateIfDirty() const
 {
-    if (isDirty())
+    const std::thread::id thisThread = std::this_thread::get_id();
+    if (!isDirty())
+    {
+        // The update cleans the node before computing its value (BaseData::update, DataEngine::update), and a
+        // node reserved by tryLockUpdate may be clean too: while another thread updates the node, wait for it.
+        const std::thread::id updatingThread = m_updatingThread.load(std::memory_order_acquire);
+        if (updatingThread != std::thread::id{} && updatingThread != thisThread)
+        {
+            while (m_updatingThread.load(std::memory_order_acquire) != std::thread::id{})
+            {
+                std::this_thread::yield();
+            }
+        }
+        return;
+    }
+
+    std::thread::id noThread {};
+    if (m_updatingThread.compare_exchange_strong(noThread, thisThread, std::memory_order_acq_rel))
+    {
+        // double check: another thread may have updated the node in the meantime
+        if (isDirty())
+        {
+            nbUpdates.fetch_add(1, std::memory_order_relaxed);
+            const_cast <DDGNode*> (this)->update();
+        }
+        m_updatingThread.store(std::thread::id{}, std::memory_order_release);
+    }
+    else if (noThread == thisThread)
     {
+        // re-entrant call from the update of this node
+        nbUpdates.fetch_add(1, std::memory_order_relaxed);
         const_cast <DDGNode*> (this)->update();
     }
+    else
+    {
+        // the graph is acyclic: the thread updating this node never waits for the current thread
+        while (m_updatingThread.load(std::memory_order_acquire) != std::thread::id{})
+        {
+            std::this_thread::yield();
+        }
+        // a reservation by tryLockUpdate does not necessarily clean the node
+        updateIfDirty();
+    }
+}
+
+bool DDGNode::tryLockUpdate()
+{
+    std::thread::id noThread {};
+    return m_updatingThread.compare_exchange_strong(noThread, std::this_thread::get_id(), std::memory_order_acq_rel);
+}
+
+void DDGNode::unlockUpdate()
+{
+    m_updatingThread.store(std::thread::id{}, std::memory_order_release);
+}
+
+DDGNode::Statistics DDGNode::getStatistics()
+{
+    Statistics statistics;
+    statistics.nbDirtyPropagations = nbDirtyPropagations.load(std::memory_order_relaxed);
+    statistics.nbUpdates = nbUpdates.load(std::memory_order_relaxed);
+    return statistics;
 }
 
 void DDGNode::doAddInput(DDGNode* n)
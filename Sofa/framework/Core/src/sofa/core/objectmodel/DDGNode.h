@@ -23,6 +23,9 @@
 
 #include <sofa/core/config.h>
 #include <sofa/core/fwd.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 #include <vector>
 
 namespace sofa::core::objectmodel
@@ -70,7 +73,7 @@ public:
     virtual void update() = 0;
 
     /// Returns true if the DDGNode needs to be updated
-    bool isDirty() const { return dirtyFlags.dirtyValue; }
+    bool isDirty() const { return dirtyFlags.dirtyValue.load(std::memory_order_acquire); }
 
     /// Indicate the value needs to be updated
     virtual void setDirtyValue();
@@ -85,8 +88,29 @@ public:
     virtual void notifyEndEdit();
 
     /// Utility method to call update if necessary. This method should be called before reading of writing the value of this node.
+    /// It can be called concurrently from several threads: only one of them updates the node, the others wait for the
+    /// end of the update, even if the node has already been cleaned by this update.
     void updateIfDirty() const;
 
+    /// Reserve the update of this node to the current thread until unlockUpdate(). Meanwhile, the other threads
+    /// reading the node wait for unlockUpdate(), even if the node is not dirty, so that they never read a value
+    /// being computed. Returns false if another thread is already updating the node.
+    bool tryLockUpdate();
+
+    /// Release the reservation made by tryLockUpdate()
+    void unlockUpdate();
+
+    /// Counters of the work done in the data dependency graph, accumulated over all the nodes since the start of the program
+    struct Statistics
+    {
+        /// Number of nodes reached by the propagation of the dirty flags
+        std::uint64_t nbDirtyPropagations {};
+        /// Number of calls to update
+        std::uint64_t nbUpdates {};
+    };
+
+    static Statistics getStatistics();
+
 protected:
     DDGLinkContainer inputs;
     DDGLinkContainer outputs;
@@ -103,10 +127,13 @@ private:
 
     struct DirtyFlags
     {
-        bool dirtyValue {false};
-        bool dirtyOutputs {false};
+        std::atomic<bool> dirtyValue {false};
+        std::atomic<bool> dirtyOutputs {false};
     };
     DirtyFlags dirtyFlags;
+
+    /// Thread currently updating this node or holding its reservation, if any
+    mutable std::atomic<std::thread::id> m_updatingThread {};
 };
 
 } // namespace sofa::core::objectmodel
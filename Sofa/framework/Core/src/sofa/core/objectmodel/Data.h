@@ -178,7 +178,11 @@ public:
     /// @warning writeOnly (the Data is not updated before being set)
     void setValue(const T& value)
     {
-        *beginWriteOnly()=value;
+        m_counter++;
+        m_isSet=true;
+        BaseData::setDirtyOutputs();
+        // a shared value is replaced, not copied before being overwritten
+        m_value.setValue(value);
         endEdit();
     }
 
@@ -188,6 +192,15 @@ public:
         return m_value.getValue();
     }
 
+    /// Read-only buffer of the value, which can be kept without copying the value. The buffer is never modified:
+    /// if the Data is modified later, it makes its own copy of the value. Pointers to the value taken before this call
+    /// are not valid anymore after this modification. Types without copy-on-write (scalars) are copied.
+    std::shared_ptr<const T> getSharedValue() const
+    {
+        updateIfDirty();
+        return m_value.getSharedValue();
+    }
+
     /// @}
 
     /// Get info about the value type of the associated variable
@@ -212,6 +225,11 @@ public:
 
     bool copyValueFrom(const Data<T>* data);
 
+    /// Share the buffer of data until one of the two Data is modified, instead of copying it as copyValueFrom does.
+    /// @warning the first modification of data moves it to its own buffer: pointers and accessors to the value of data
+    /// taken before this call must not be used after it.
+    bool shareValueFrom(const Data<T>* data);
+
     static constexpr bool isCopyOnWrite(){ return !std::is_scalar_v<T>; }
 
     Data(const Data& ) = delete;
@@ -329,6 +347,19 @@ bool Data<T>::copyValueFrom(const Data<T>* data)
     return true;
 }
 
+template <class T>
+bool Data<T>::shareValueFrom(const Data<T>* data)
+{
+    data->updateIfDirty();
+    m_counter++;
+    m_isSet = true;
+    BaseData::setDirtyOutputs();
+    // with copy-on-write, both Data share the same buffer until one of them is modified
+    m_value = data->m_value;
+    endEdit();
+    return true;
+}
+
 template <class T>
 bool Data<T>::doCopyValueFrom(const BaseData* data)
 {
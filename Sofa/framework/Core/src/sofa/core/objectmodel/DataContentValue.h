@@ -63,6 +63,7 @@ public:
     T* beginEdit() { return &data; }
     void endEdit() {}
     const T& getValue() const { return data; }
+    std::shared_ptr<const T> getSharedValue() const { return std::make_shared<const T>(data); }
     void setValue(const T& value)
     {
         data = value;
@@ -127,9 +128,15 @@ public:
         return *ptr;
     }
 
+    /// The returned buffer is never modified: a Data modifying its value while the buffer is shared makes its own copy
+    std::shared_ptr<const T> getSharedValue() const
+    {
+        return ptr;
+    }
+
     void setValue(const T& value)
     {
-        if(!ptr.unique())
+        if(ptr.use_count() != 1)
         {
             ptr.reset(new T(value)); // the Data is modified -> copy
         }
@@ -116,4 +116,24 @@ TEST_F(DataEngine_test, testDataEngine )
     this->testTrackedData<TestEngine>(this->engine);
 }
 
+TEST_F(DataEngine_test, updateExclusively )
+{
+    engine.update();
+    EXPECT_FALSE(engine.isDirty());
+
+    // a clean engine is not updated
+    EXPECT_FALSE(engine.updateExclusively());
+
+    engine.input.setValue(true);
+    EXPECT_TRUE(engine.isDirty());
+    EXPECT_TRUE(engine.updateExclusively());
+    EXPECT_FALSE(engine.isDirty());
+    EXPECT_FALSE(engine.output.isDirty());
+    EXPECT_EQ(engine.output.getValue(), TestEngine::CHANGED);
+
+    // the engine is not reserved by a thread, an update can be reserved again
+    EXPECT_TRUE(engine.tryLockUpdate());
+    engine.unlockUpdate();
+}
+
 }// namespace sofa
@@ -26,6 +26,10 @@ using sofa::testing::BaseTest ;
 #include <sofa/core/objectmodel/DDGNode.h>
 using sofa::core::objectmodel::DDGNode;
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 class DDGNodeTestClass : public DDGNode
 {
 public:
@@ -183,3 +187,74 @@ TEST_F(DDGNode_test, propagationScenario3)
     EXPECT_EQ(m_ddgnode1.m_cpt, 1);
     EXPECT_EQ(m_ddgnode2.m_cpt, 1);
 }
+
+/// A node which takes some time to update, and cleans itself before computing its value as a Data does
+class DDGNodeSlowUpdate : public DDGNode
+{
+public:
+    std::atomic<int> m_cpt {0};
+    std::atomic<bool> m_upToDate {false};
+
+    void update() override
+    {
+        cleanDirty();
+        m_cpt++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        m_upToDate = true;
+    }
+};
+
+TEST_F(DDGNode_test, concurrentUpdateIfDirty)
+{
+    DDGNodeSlowUpdate input;
+    DDGNodeSlowUpdate output;
+    output.addInput(&input);
+
+    output.setDirtyValue();
+    ASSERT_TRUE(output.isDirty());
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&output]()
+        {
+            output.updateIfDirty();
+            // the value must be computed when updateIfDirty returns, even if another thread
+            // has already cleaned the node and is still computing it
+            EXPECT_FALSE(output.isDirty());
+            EXPECT_TRUE(output.m_upToDate);
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(output.m_cpt, 1);
+}
+
+TEST_F(DDGNode_test, statistics)
+{
+    DDGNodeTestClass ddgnode4;
+    m_ddgnode1.addInput(&m_ddgnode2);
+    m_ddgnode2.addInput(&m_ddgnode3);
+    ddgnode4.addInput(&m_ddgnode3);
+    m_ddgnode1.cleanDirty();
+    m_ddgnode2.cleanDirty();
+    ddgnode4.cleanDirty();
+
+    const DDGNode::Statistics before = DDGNode::getStatistics();
+    m_ddgnode3.setDirtyOutputs();
+    const DDGNode::Statistics afterPropagation = DDGNode::getStatistics();
+    EXPECT_EQ(afterPropagation.nbDirtyPropagations - before.nbDirtyPropagations, 3);
+
+    // cleaning one output allows a new propagation from the input, which skips the outputs already dirty
+    ddgnode4.cleanDirty();
+    m_ddgnode3.setDirtyOutputs();
+    EXPECT_TRUE(ddgnode4.isDirty());
+    EXPECT_EQ(DDGNode::getStatistics().nbDirtyPropagations - afterPropagation.nbDirtyPropagations, 1);
+
+    const DDGNode::Statistics beforeUpdate = DDGNode::getStatistics();
+    m_ddgnode1.updateIfDirty();
+    EXPECT_EQ(DDGNode::getStatistics().nbUpdates - beforeUpdate.nbUpdates, 1);
+}
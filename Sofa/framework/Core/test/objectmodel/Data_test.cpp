@@ -162,4 +162,57 @@ TEST_F(Data_test, getNameWithValueTypeInfo)
         EXPECT_EQ(dataVectorVec3.getValueTypeInfo()->name(), "vector<Vec3f>");
     }
 }
+
+TEST_F(Data_test, copyValueFromKeepsBuffers)
+{
+    Data<sofa::type::vector<int>> source;
+    Data<sofa::type::vector<int>> copy;
+    source.setValue({1, 2, 3});
+    const int* sourceBuffer = source.getValue().data();
+
+    copy.copyValueFrom(&source);
+    EXPECT_EQ(copy.getValue(), source.getValue());
+    EXPECT_NE(copy.getValue().data(), sourceBuffer);
+
+    // the source keeps its buffer: pointers taken before the copy are still valid
+    EXPECT_EQ(source.beginEdit()->data(), sourceBuffer);
+    source.endEdit();
+    EXPECT_EQ(source.getValue().data(), sourceBuffer);
+}
+
+TEST_F(Data_test, shareValueFrom)
+{
+    Data<sofa::type::vector<int>> source;
+    Data<sofa::type::vector<int>> copy;
+    source.setValue({1, 2, 3});
+
+    copy.shareValueFrom(&source);
+    EXPECT_EQ(copy.getValue(), source.getValue());
+    EXPECT_EQ(copy.getValue().data(), source.getValue().data());
+
+    // modifying one of the Data does not modify the other one
+    copy.beginEdit()->push_back(4);
+    copy.endEdit();
+    EXPECT_EQ(source.getValue().size(), 3);
+    EXPECT_EQ(copy.getValue().size(), 4);
+}
+
+TEST_F(Data_test, getSharedValue)
+{
+    Data<sofa::type::vector<int>> data;
+    data.setValue({1, 2, 3});
+
+    const auto shared = data.getSharedValue();
+    EXPECT_EQ(shared->data(), data.getValue().data());
+
+    // the shared buffer is not modified with the Data
+    data.beginEdit()->front() = 10;
+    data.endEdit();
+    EXPECT_EQ(shared->front(), 1);
+    EXPECT_EQ(data.getValue().front(), 10);
+
+    data.setValue({5});
+    EXPECT_EQ(shared->size(), 3);
+}
+
 }// namespace sofa
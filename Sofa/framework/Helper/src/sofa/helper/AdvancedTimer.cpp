@@ -23,6 +23,7 @@
 
 #include <sofa/helper/logging/Messaging.h>
 #include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/TraceRecorder.h>
 #include <sofa/type/vector.h>
 #include <json.h>
 
@@ -138,6 +139,49 @@ void setCurRecords(type::vector<Record>* ptr)
     else if (!ptr && prev) --activeTimers;
 }
 
+/// @return the TraceRecorder id of a step or object id. The ids of the IdFactory are specific
+/// to each thread, so is the cache.
+template<class Base>
+TraceRecorder::TraceId getTraceId(const AdvancedTimer::Id<Base>& id)
+{
+    thread_local std::vector<TraceRecorder::TraceId> traceIds;
+    const unsigned int i = id;
+    if (i >= traceIds.size())
+    {
+        traceIds.resize(i + 1, 0);
+    }
+    if (!traceIds[i])
+    {
+        traceIds[i] = TraceRecorder::intern(static_cast<std::string>(id));
+    }
+    return traceIds[i];
+}
+
+void traceStep(TraceRecorder::Phase phase, AdvancedTimer::IdStep id)
+{
+    if (!TraceRecorder::isEnabled()) return;
+    const TraceRecorder::TraceId traceId = getTraceId(id);
+    switch (phase)
+    {
+        case TraceRecorder::Phase::Begin: TraceRecorder::begin(traceId); break;
+        case TraceRecorder::Phase::End: TraceRecorder::end(traceId); break;
+        case TraceRecorder::Phase::Instant: TraceRecorder::instant(traceId); break;
+    }
+}
+
+void traceStep(TraceRecorder::Phase phase, AdvancedTimer::IdStep id, AdvancedTimer::IdObj obj)
+{
+    if (!TraceRecorder::isEnabled()) return;
+    const TraceRecorder::TraceId traceId = getTraceId(id);
+    const TraceRecorder::TraceId traceObj = getTraceId(obj);
+    switch (phase)
+    {
+        case TraceRecorder::Phase::Begin: TraceRecorder::begin(traceId, traceObj); break;
+        case TraceRecorder::Phase::End: TraceRecorder::end(traceId, traceObj); break;
+        case TraceRecorder::Phase::Instant: TraceRecorder::instant(traceId, traceObj); break;
+    }
+}
+
 AdvancedTimer::SyncCallBack syncCallBack = nullptr;
 void* syncCallBackData = nullptr;
 
@@ -356,6 +400,7 @@ bool AdvancedTimer::isActive()
 
 void AdvancedTimer::stepBegin(IdStep id)
 {
+    traceStep(TraceRecorder::Phase::Begin, id);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     Record r;
@@ -367,6 +412,7 @@ void AdvancedTimer::stepBegin(IdStep id)
 
 void AdvancedTimer::stepBegin(IdStep id, IdObj obj)
 {
+    traceStep(TraceRecorder::Phase::Begin, id, obj);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     Record r;
@@ -379,6 +425,7 @@ void AdvancedTimer::stepBegin(IdStep id, IdObj obj)
 
 void AdvancedTimer::stepEnd  (IdStep id)
 {
+    traceStep(TraceRecorder::Phase::End, id);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     if (syncCallBack) (*syncCallBack)(syncCallBackData);
@@ -391,6 +438,7 @@ void AdvancedTimer::stepEnd  (IdStep id)
 
 void AdvancedTimer::stepEnd  (IdStep id, IdObj obj)
 {
+    traceStep(TraceRecorder::Phase::End, id, obj);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     Record r;
@@ -403,6 +451,8 @@ void AdvancedTimer::stepEnd  (IdStep id, IdObj obj)
 
 void AdvancedTimer::stepNext (IdStep prevId, IdStep nextId)
 {
+    traceStep(TraceRecorder::Phase::End, prevId);
+    traceStep(TraceRecorder::Phase::Begin, nextId);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     Record r;
@@ -418,6 +468,7 @@ void AdvancedTimer::stepNext (IdStep prevId, IdStep nextId)
 
 void AdvancedTimer::step     (IdStep id)
 {
+    traceStep(TraceRecorder::Phase::Instant, id);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     if (syncCallBack) (*syncCallBack)(syncCallBackData);
@@ -430,6 +481,7 @@ void AdvancedTimer::step     (IdStep id)
 
 void AdvancedTimer::step     (IdStep id, IdObj obj)
 {
+    traceStep(TraceRecorder::Phase::Instant, id, obj);
     type::vector<Record>* curRecords = getCurRecords();
     if (!curRecords) return;
     if (syncCallBack) (*syncCallBack)(syncCallBackData);
@@ -480,70 +532,70 @@ void AdvancedTimer::end(const char* idStr)
 void AdvancedTimer::stepBegin(const char* idStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepBegin(IdStep(idStr));
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const char* objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepBegin(IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const std::string& objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepBegin(IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepEnd  (IdStep(idStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const char* objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepEnd  (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const std::string& objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepEnd  (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepNext (const char* prevIdStr, const char* nextIdStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     stepNext (IdStep(prevIdStr), IdStep(nextIdStr));
 }
 
 void AdvancedTimer::step     (const char* idStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     step     (IdStep(idStr));
 }
 
 void AdvancedTimer::step     (const char* idStr, const char* objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     step     (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::step     (const char* idStr, const std::string& objStr)
 {
     const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!curRecords && !TraceRecorder::isEnabled()) return;
     step     (IdStep(idStr), IdObj(objStr));
 }
 
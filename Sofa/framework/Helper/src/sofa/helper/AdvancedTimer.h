@@ -81,6 +81,9 @@ namespace sofa::helper
   * When reloading/reseting the simulation:
     AdvancedTimer::clear();
 
+  * To get a timeline of the steps of each thread instead of statistics, see TraceRecorder:
+    TraceRecorder::start();
+
 
   The produced stats will looks like:
 
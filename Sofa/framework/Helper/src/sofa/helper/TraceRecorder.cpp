@@ -0,0 +1,420 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/TraceRecorder.h>
+#include <sofa/helper/NameDecoder.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace sofa::helper
+{
+
+std::atomic<bool> TraceRecorder::s_enabled { false };
+
+namespace
+{
+
+/// Ring buffer of the events of one thread. Only the owner thread writes in it.
+struct ThreadBuffer
+{
+    ThreadBuffer(std::size_t capacity, std::uint64_t generation, std::uint32_t threadIndex)
+        : events(capacity), mask(capacity - 1), generation(generation), threadIndex(threadIndex)
+    {
+    }
+
+    std::vector<TraceRecorder::Event> events;
+    const std::size_t mask;
+    std::atomic<std::uint64_t> nbRecorded { 0 }; ///< total number of events, including the overwritten ones
+    std::atomic<bool> writing { false }; ///< an event is being written, see TraceRecorder::stop()
+    const std::uint64_t generation;
+    const std::uint32_t threadIndex;
+    std::string threadName;
+};
+
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::string> names { std::string() };
+    std::unordered_map<std::string, TraceRecorder::TraceId> ids { { std::string(), 0 } };
+    std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    std::size_t capacity { TraceRecorder::DefaultCapacity };
+
+    /// incremented when the buffers are discarded, so that each thread allocates a new one
+    std::atomic<std::uint64_t> generation { 1 };
+    std::atomic<std::int64_t> origin { 0 };
+    std::atomic<std::uint32_t> nbThreads { 0 };
+};
+
+TraceRegistry& getRegistry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+std::int64_t getClockTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ThreadState
+{
+    std::shared_ptr<ThreadBuffer> buffer;
+    std::string name;
+    std::uint32_t index { 0 };
+};
+
+thread_local ThreadState threadState;
+
+ThreadBuffer& getThreadBuffer(ThreadState& state, TraceRegistry& registry)
+{
+    if (!state.buffer || state.buffer->generation != registry.generation.load(std::memory_order_relaxed))
+    {
+        if (state.index == 0)
+        {
+            state.index = ++registry.nbThreads;
+        }
+        std::lock_guard lock(registry.mutex);
+        state.buffer = std::make_shared<ThreadBuffer>(registry.capacity, registry.generation.load(), state.index);
+        state.buffer->threadName = state.name;
+        registry.buffers.push_back(state.buffer);
+    }
+    return *state.buffer;
+}
+
+void writeString(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (const char c : str)
+    {
+        switch (c)
+        {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                    out << buffer;
+                }
+                else
+                {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+/// Chrome trace timestamps are in microseconds
+void writeMicroseconds(std::ostream& out, std::uint64_t nanoseconds)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%llu.%03u",
+                  static_cast<unsigned long long>(nanoseconds / 1000),
+                  static_cast<unsigned int>(nanoseconds % 1000));
+    out << buffer;
+}
+
+/// Records the whole execution when SOFA_TRACE_FILE is set, and exports the trace on exit
+struct TraceFileFromEnvironment
+{
+    std::string filename;
+
+    TraceFileFromEnvironment()
+    {
+        const char* val = getenv("SOFA_TRACE_FILE");
+        if (val && *val)
+        {
+            filename = val;
+            TraceRecorder::start();
+        }
+    }
+
+    ~TraceFileFromEnvironment()
+    {
+        if (!filename.empty())
+        {
+            TraceRecorder::stop();
+            std::ofstream out(filename);
+            if (out)
+            {
+                TraceRecorder::exportChromeTrace(out);
+            }
+        }
+    }
+} traceFileFromEnvironment;
+
+} // namespace
+
+void TraceRecorder::start(std::size_t capacityPerThread)
+{
+    TraceRegistry& registry = getRegistry();
+    {
+        std::lock_guard lock(registry.mutex);
+        std::size_t capacity = 16;
+        while (capacity < capacityPerThread)
+        {
+            capacity *= 2;
+        }
+        registry.capacity = capacity;
+        registry.buffers.clear();
+        ++registry.generation;
+        registry.origin.store(getClockTime(), std::memory_order_relaxed);
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop()
+{
+    s_enabled.store(false);
+
+    // wait for the events being written: a thread which read isEnabled() before the store above
+    // may still be writing in its buffer. After that, the events recorded (the end of the scopes
+    // still open) never overwrite an event, so the buffers can be exported while they are written.
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (const auto& buffer : registry.buffers)
+    {
+        while (buffer->writing.load())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TraceRecorder::clear()
+{
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.buffers.clear();
+    ++registry.generation;
+}
+
+TraceRecorder::TraceId TraceRecorder::intern(const std::string& name)
+{
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    const auto it = registry.ids.find(name);
+    if (it != registry.ids.end())
+    {
+        return it->second;
+    }
+    const auto id = static_cast<TraceId>(registry.names.size());
+    registry.names.push_back(name);
+    registry.ids.emplace(name, id);
+    return id;
+}
+
+TraceRecorder::TraceId TraceRecorder::intern(const std::type_info& type)
+{
+    thread_local std::unordered_map<std::type_index, TraceId> typeIds;
+    const auto it = typeIds.find(type);
+    if (it != typeIds.end())
+    {
+        return it->second;
+    }
+    const TraceId id = intern(NameDecoder::decodeClassName(type));
+    typeIds.emplace(type, id);
+    return id;
+}
+
+std::string TraceRecorder::getName(TraceId id)
+{
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    return id < registry.names.size() ? registry.names[id] : std::string();
+}
+
+void TraceRecorder::record(TraceId id, TraceId obj, Phase phase)
+{
+    TraceRegistry& registry = getRegistry();
+    const std::int64_t time = getClockTime() - registry.origin.load(std::memory_order_relaxed);
+    ThreadBuffer& buffer = getThreadBuffer(threadState, registry);
+    const std::uint64_t n = buffer.nbRecorded.load(std::memory_order_relaxed);
+
+    // paired with stop(): either stop() waits for this event, or the event sees the recording stopped
+    buffer.writing.store(true);
+    if (n > buffer.mask && !s_enabled.load())
+    {
+        // the recording is stopped: the oldest event is kept, it may be being exported
+        buffer.writing.store(false, std::memory_order_release);
+        return;
+    }
+
+    Event& event = buffer.events[n & buffer.mask];
+    event.time = static_cast<std::uint64_t>(std::max<std::int64_t>(time, 0));
+    event.id = id;
+    event.obj = obj;
+    event.phase = phase;
+    buffer.nbRecorded.store(n + 1, std::memory_order_release);
+    buffer.writing.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::setThreadName(const std::string& name)
+{
+    ThreadState& state = threadState;
+    state.name = name;
+    if (state.buffer)
+    {
+        std::lock_guard lock(getRegistry().mutex);
+        state.buffer->threadName = name;
+    }
+}
+
+std::size_t TraceRecorder::getNbEvents()
+{
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    std::size_t nbEvents = 0;
+    for (const auto& buffer : registry.buffers)
+    {
+        nbEvents += static_cast<std::size_t>(std::min<std::uint64_t>(
+            buffer->nbRecorded.load(std::memory_order_acquire), buffer->events.size()));
+    }
+    return nbEvents;
+}
+
+void TraceRecorder::exportChromeTrace(std::ostream& out)
+{
+    TraceRegistry& registry = getRegistry();
+    std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    std::vector<std::string> names;
+    std::vector<std::string> threadNames;
+    {
+        std::lock_guard lock(registry.mutex);
+        buffers = registry.buffers;
+        names = registry.names;
+        for (const auto& buffer : buffers)
+        {
+            threadNames.push_back(buffer->threadName.empty()
+                ? "Thread " + std::to_string(buffer->threadIndex) : buffer->threadName);
+        }
+    }
+
+    const auto writeEvent = [&out, &names](const Event& event, const char* phase, std::uint32_t tid)
+    {
+        out << ",\n{\"name\":";
+        writeString(out, names[event.id]);
+        out << ",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+        writeMicroseconds(out, event.time);
+        if (event.obj)
+        {
+            out << ",\"args\":{\"object\":";
+            writeString(out, names[event.obj]);
+            out << '}';
+        }
+    };
+
+    const bool recording = isEnabled();
+    if (recording)
+    {
+        msg_warning("TraceRecorder") << "The recording is not stopped: the oldest half of the full buffers is not exported";
+    }
+
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SOFA\"}}";
+
+    std::vector<const Event*> stack;
+    for (std::size_t b = 0; b < buffers.size(); ++b)
+    {
+        const ThreadBuffer& buffer = *buffers[b];
+        const std::uint32_t tid = buffer.threadIndex;
+
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+        writeString(out, threadNames[b]);
+        out << "}}";
+
+        const std::uint64_t nbRecorded = buffer.nbRecorded.load(std::memory_order_acquire);
+        std::uint64_t first = nbRecorded - std::min<std::uint64_t>(nbRecorded, buffer.events.size());
+        if (recording && nbRecorded > buffer.mask)
+        {
+            // the oldest events are overwritten first by the thread still recording
+            first += (buffer.mask + 1) / 2;
+        }
+
+        // the begin and end are merged into complete events, which halves the size of the file
+        stack.clear();
+        for (std::uint64_t i = first; i < nbRecorded; ++i)
+        {
+            const Event& event = buffer.events[i & buffer.mask];
+            switch (event.phase)
+            {
+                case Phase::Begin:
+                    stack.push_back(&event);
+                    break;
+                case Phase::End:
+                    // without begin, it has been overwritten in the ring buffer
+                    if (!stack.empty())
+                    {
+                        const Event& begin = *stack.back();
+                        stack.pop_back();
+                        writeEvent(begin, "X", tid);
+                        out << ",\"dur\":";
+                        writeMicroseconds(out, event.time - std::min(event.time, begin.time));
+                        out << '}';
+                    }
+                    break;
+                case Phase::Instant:
+                    writeEvent(event, "i", tid);
+                    out << ",\"s\":\"t\"}";
+                    break;
+            }
+        }
+
+        // scopes still open at the end of the recording
+        for (const Event* begin : stack)
+        {
+            writeEvent(*begin, "B", tid);
+            out << '}';
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool TraceRecorder::exportChromeTrace(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if (!out)
+    {
+        msg_error("TraceRecorder") << "Cannot open file " << filename << " to export the trace";
+        return false;
+    }
+    exportChromeTrace(out);
+    return true;
+}
+
+} // namespace sofa::helper
@@ -0,0 +1,172 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/helper/config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+namespace sofa::helper
+{
+
+/**
+  Timeline recorder of the begin and end of the scopes executed by each thread, meant to be
+  visualized in chrome://tracing or https://ui.perfetto.dev.
+
+  Contrary to the statistics of AdvancedTimer, the events are not aggregated: each thread appends
+  them to its own ring buffer, without lock, with a nanosecond timestamp and an id interned once
+  for all the threads. When the buffer of a thread is full, its oldest events are overwritten.
+
+  When the recording is not started, the cost of an event is a single relaxed atomic load.
+
+  The steps of AdvancedTimer (and therefore SCOPED_TIMER), the tasks run by the task scheduler
+  and the visitor traversals are recorded. The recording can also be started at the launch of
+  the application by setting the environment variable SOFA_TRACE_FILE to the name of the file
+  where the trace is exported on exit.
+
+  Usage example :
+
+    TraceRecorder::start();
+    ...
+    {
+        static const TraceRecorder::TraceId id = TraceRecorder::intern("Solve");
+        TraceRecorder::ScopedEvent event(id);
+        ...
+    }
+    ...
+    TraceRecorder::stop();
+    TraceRecorder::exportChromeTrace("trace.json");
+ */
+class SOFA_HELPER_API TraceRecorder
+{
+public:
+    /// Index of an interned name. 0 is the empty name.
+    using TraceId = std::uint32_t;
+
+    enum class Phase : std::uint8_t
+    {
+        Begin,
+        End,
+        Instant
+    };
+
+    struct Event
+    {
+        std::uint64_t time { 0 }; ///< nanoseconds since the last call to start()
+        TraceId id { 0 };
+        TraceId obj { 0 };        ///< optional name of the object being processed
+        Phase phase { Phase::Instant };
+    };
+
+    /// Default number of events kept by each thread
+    static constexpr std::size_t DefaultCapacity = 1 << 16;
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Start a new recording, discarding the previous events. The capacity of the buffer of
+    /// each thread is rounded up to a power of 2.
+    static void start(std::size_t capacityPerThread = DefaultCapacity);
+
+    /// Stop the recording. The recorded events are kept until the next call to start() or clear().
+    /// It waits for the events being written by the other threads. The end of the scopes still open
+    /// is recorded afterwards only if it does not overwrite an event.
+    static void stop();
+
+    /// Discard the recorded events
+    static void clear();
+
+    /// @return the id of the given name, registering it if needed. It involves a lock: the id
+    /// should be computed once and stored (in a static variable for instance).
+    static TraceId intern(const std::string& name);
+
+    /// @return the id of the decoded name of the given type. The id is cached for each thread.
+    static TraceId intern(const std::type_info& type);
+
+    static std::string getName(TraceId id);
+
+    static void begin(TraceId id, TraceId obj = 0)
+    {
+        if (isEnabled()) record(id, obj, Phase::Begin);
+    }
+
+    static void end(TraceId id, TraceId obj = 0)
+    {
+        if (isEnabled()) record(id, obj, Phase::End);
+    }
+
+    static void instant(TraceId id, TraceId obj = 0)
+    {
+        if (isEnabled()) record(id, obj, Phase::Instant);
+    }
+
+    /// Name given to the current thread in the exported trace
+    static void setThreadName(const std::string& name);
+
+    /// @return the number of events currently stored in the buffers of all the threads
+    static std::size_t getNbEvents();
+
+    /// Write the recorded events in the Chrome trace event format (JSON), also read by Perfetto.
+    /// The recording should be stopped before. Otherwise, the oldest half of the full buffers is
+    /// skipped, as it may be overwritten by the threads while it is exported.
+    static void exportChromeTrace(std::ostream& out);
+    static bool exportChromeTrace(const std::string& filename);
+
+    /// Scoped (RAII) event
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(TraceId id, TraceId obj = 0)
+            : m_id(id), m_obj(obj), m_recorded(isEnabled())
+        {
+            if (m_recorded) record(m_id, m_obj, Phase::Begin);
+        }
+
+        ~ScopedEvent()
+        {
+            // the end is recorded even if the recording was stopped in the scope, to keep the
+            // begin and end balanced
+            if (m_recorded) record(m_id, m_obj, Phase::End);
+        }
+
+        ScopedEvent(const ScopedEvent&) = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    private:
+        TraceId m_id;
+        TraceId m_obj;
+        bool m_recorded;
+    };
+
+protected:
+    static void record(TraceId id, TraceId obj, Phase phase);
+
+    static std::atomic<bool> s_enabled;
+};
+
+} // namespace sofa::helper
@@ -37,6 +37,8 @@ namespace sofa::helper
 *  - the tree is rebuild from points by calling build(p)
 *  - N nearest points from point x (in terms of euclidean distance) are retrieved with getNClosest(distance/index_List , x , N)
 *  - Caching may be used to speed up retrieval: if dx< (d(n)-d(0))/2, then the closest point is in the n-1 cached points (updateCachedDistances is used to update the n-1 distances)
+*  - all the points closer to x than a radius are retrieved with getInRadius(distance/index_List , x , radius)
+*  - the queries do not modify the tree: they can be run concurrently once the tree is built
 *  see for instance: [zhang92] report and [simon96] thesis for more details
 *
 *  @author Benjamin Gilles
@@ -67,8 +69,9 @@ public:
     void build(const VecCoord& positions);       ///< update tree (to be used whenever positions have changed)
     void build(const VecCoord& positions, const type::vector<unsigned int> &ROI);       ///< update tree based on positions subset (to be used whenever points p have changed)
     void getNClosest(distanceSet &cl, const Coord &x, const VecCoord& positions, const unsigned int n) const;  ///< get an ordered set of n distance/index pairs between positions and x
-    unsigned int getClosest(const Coord &x, const VecCoord& positions) const; ///< get the index of the closest point between positions and x
+    unsigned int getClosest(const Coord &x, const VecCoord& positions) const; ///< get the index of the closest point between positions and x (the lowest index among equidistant points)
     bool getNClosestCached(distanceSet &cl, distanceToPoint &cacheThresh_max, distanceToPoint &cacheThresh_min, Coord &previous_x, const Coord &x, const VecCoord& positions, const unsigned int n) const;  ///< use distance caching to accelerate closest point computation when positions are fixed (see simon96 thesis)
+    void getInRadius(type::vector<distanceToPoint> &cl, const Coord &x, const VecCoord& positions, const Real radius) const; ///< get the (unordered) distance/index pairs of the points of positions strictly closer to x than radius
 
 
     /// @name To be Data-zable
@@ -82,9 +85,10 @@ protected :
 
     type::vector< TREENODE > tree; unsigned int firstNode;
 
-    unsigned int build(UIlist &list, unsigned char direction, const VecCoord& positions); // recursive function to build the kdtree
+    unsigned int build(unsigned int* begin, unsigned int* end, unsigned char direction, const VecCoord& positions); // recursive function to build the kdtree
     void closest(distanceSet &cl, const Coord &x, const unsigned int &currentnode, const VecCoord& positions, unsigned N) const;     // recursive function to get closest points
     void closest(distanceToPoint &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions) const;  // recursive function to get closest point
+    void inRadius(type::vector<distanceToPoint> &cl, const Coord &x, const unsigned int &currentnode, const VecCoord& positions, const Real radius) const;  // recursive function to get the points in a ball
 };
 
 
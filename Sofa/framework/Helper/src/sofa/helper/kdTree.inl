@@ -25,6 +25,7 @@
 
 #include <sofa/helper/logging/Messaging.h>
 
+#include <algorithm>
 #include <map>
 #include <limits>
 #include <iterator>
@@ -37,20 +38,18 @@ template<class Coord>
 void kdTree<Coord>::build(const VecCoord& positions)
 {
     const auto nbp = positions.size();
-    UIlist list;   for(unsigned int i=0; i<nbp; i++) list.push_back(i);
+    type::vector<unsigned int> list(nbp);
+    for(unsigned int i=0; i<nbp; i++) list[i]=i;
     tree.resize(nbp);
-    firstNode=build(list,(unsigned char)0, positions);
+    firstNode = nbp ? build(list.data(), list.data() + nbp, (unsigned char)0, positions) : 0;
 }
 
 template<class Coord>
 void kdTree<Coord>::build(const VecCoord& positions, const type::vector<unsigned int> &ROI)
 {
-    const size_t nbp = ROI.size();
-    UIlist list;
-    for(size_t i=0; i<nbp; i++)
-        list.push_back(ROI[i]);
-    tree.resize(positions.size());
-    firstNode=build(list,(unsigned char)0, positions);
+    type::vector<unsigned int> list(ROI);
+    tree.resize(list.empty() ? 0 : positions.size());
+    firstNode = list.empty() ? 0 : build(list.data(), list.data() + list.size(), (unsigned char)0, positions);
 }
 
 template<class Coord>
@@ -62,33 +61,30 @@ void kdTree<Coord>::print(const unsigned int index)
 }
 
 template<class Coord>
-unsigned int kdTree<Coord>::build(UIlist &list, unsigned char direction, const VecCoord& positions)
+unsigned int kdTree<Coord>::build(unsigned int* begin, unsigned int* end, unsigned char direction, const VecCoord& positions)
 {
     // detect leaf
-    if(list.size()==(unsigned int)1)
+    if(end - begin == 1)
     {
-        unsigned int index=list.front(); list.pop_front();
+        const unsigned int index = *begin;
         tree[index].left=tree[index].right=index;
         tree[index].splitdir=direction;
         return index;
     }
-    // ordered list of 1D coord
-    distanceSet q;
-    UIlist::iterator it;
-    for(it=list.begin(); it!=list.end(); it++) q.insert( distanceToPoint(positions[*it][direction],*it));
-    it=list.begin();    for(distanceSetIt sit=q.begin(); sit!=q.end(); sit++) {*it=sit->second; it++;}
-    // split list in 2
-    it=list.begin(); advance (it,list.size()/2);
-    UIlist newlist;
-    newlist.splice(newlist.begin(),list,list.begin(),it);
+    // partition around the median along the split direction (ties broken by index)
+    unsigned int* median = begin + (end - begin) / 2;
+    std::nth_element(begin, median, end, [&positions, direction](const unsigned int a, const unsigned int b)
+    {
+        return distanceToPoint(positions[a][direction], a) < distanceToPoint(positions[b][direction], b);
+    });
     // add node
-    unsigned int index=list.front(); list.pop_front();
+    const unsigned int index = *median;
     tree[index].splitdir=direction;
     tree[index].left=tree[index].right=index;
     // split children recursively
     unsigned char newdirection=direction+1; if(newdirection==dim) newdirection=0;
-    if(newlist.size()!=0) tree[index].left=build(newlist,newdirection,positions);
-    if(list.size()!=0) tree[index].right=build(list,newdirection,positions);
+    if(median != begin) tree[index].left=build(begin,median,newdirection,positions);
+    if(median + 1 != end) tree[index].right=build(median+1,end,newdirection,positions);
     // return child index to parent
     return index;
 }
@@ -120,25 +116,42 @@ void kdTree<Coord>::closest(distanceSet &cl,const Coord &x, const unsigned int &
 
 
 // slightly improved version of the above, for one point
+// The squared distances are compared, and equidistant points are resolved by the lowest index, as a linear search
+// would do: the subtrees are pruned only if all their points are strictly farther than the closest point found.
 template<class Coord>
 void kdTree<Coord>::closest(distanceToPoint &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions) const
 {
-    Real Dmax=cl.first;
-    unsigned int splitdir=tree[currentnode].splitdir;
-    Coord pos=positions[currentnode];
-    Real c1=x[splitdir],c2=pos[splitdir];
-    if(std::abs(c1-c2)<=Dmax)
+    const unsigned int splitdir=tree[currentnode].splitdir;
+    const Coord& pos=positions[currentnode];
+    const Real c1=x[splitdir],c2=pos[splitdir];
+    const Real splitDistance2=(c1-c2)*(c1-c2);
+    if(splitDistance2<=cl.first)
     {
-        Real d=(x-pos).norm();
-        if(d<Dmax)
+        const Real d2=(x-pos).norm2();
+        if(d2<cl.first || (d2==cl.first && currentnode<cl.second))
         {
-            Dmax=d;
-            cl.first=d;
+            cl.first=d2;
             cl.second=currentnode;
         }
     }
-    if(tree[currentnode].left!=currentnode)     if(c1-Dmax<c2)  closest(cl,x,tree[currentnode].left,positions);
-    if(tree[currentnode].right!=currentnode)    if(c2-Dmax<c1)  closest(cl,x,tree[currentnode].right,positions);
+    if(tree[currentnode].left!=currentnode)     if(c1<=c2 || splitDistance2<=cl.first)  closest(cl,x,tree[currentnode].left,positions);
+    if(tree[currentnode].right!=currentnode)    if(c2<=c1 || splitDistance2<=cl.first)  closest(cl,x,tree[currentnode].right,positions);
+}
+
+
+template<class Coord>
+void kdTree<Coord>::inRadius(type::vector<distanceToPoint> &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions, const Real radius) const
+{
+    const unsigned int splitdir=tree[currentnode].splitdir;
+    const Coord& pos=positions[currentnode];
+    const Real c1=x[splitdir],c2=pos[splitdir];
+    if(std::abs(c1-c2)<radius)
+    {
+        const Real d=(x-pos).norm();
+        if(d<radius) cl.emplace_back(d,currentnode);
+    }
+    if(tree[currentnode].left!=currentnode)     if(c1-radius<c2)  inRadius(cl,x,tree[currentnode].left,positions,radius);
+    if(tree[currentnode].right!=currentnode)    if(c2-radius<c1)  inRadius(cl,x,tree[currentnode].right,positions,radius);
 }
 
 
@@ -157,6 +170,14 @@ unsigned int kdTree<Coord>::getClosest(const Coord &x, const VecCoord& positions
     return cl.second;
 }
 
+template<class Coord>
+void kdTree<Coord>::getInRadius(type::vector<distanceToPoint> &cl, const Coord &x, const VecCoord& positions, const Real radius) const
+{
+    cl.clear();
+    if(isEmpty()) return;
+    inRadius(cl,x,firstNode,positions,radius);
+}
+
 template<class Coord>
 bool kdTree<Coord>::getNClosestCached(distanceSet &cl,  distanceToPoint &cacheThresh_max, distanceToPoint &cacheThresh_min, Coord &previous_x, const Coord &x, const VecCoord& positions, const unsigned int n) const
 {
@@ -109,6 +109,27 @@ struct KdTreeTest: public BaseTest
         }
     }
 
+    /// test if kdtree finds all the points of target closer than radius to the source points
+    void testPointRadiusCorrespondences(const unsigned int nbp_source, const unsigned int nbp_target,const Real range, const Real radius)
+    {
+        VecCoord sourceposition;
+        generateRandomPoint(sourceposition,nbp_source,range);
+        VecCoord targetposition;
+        generateRandomPoint(targetposition,nbp_target,range);
+
+        kdT KDT;
+        KDT.build(targetposition);
+
+        for(unsigned int i=0;i<nbp_source;i++)
+        {
+            type::vector<distanceToPoint> inRadius_kdt; KDT.getInRadius(inRadius_kdt, sourceposition[i],targetposition,radius);
+            std::set<unsigned int> kdt, brute;
+            for(const auto& p : inRadius_kdt) kdt.insert(p.second);
+            for(unsigned int j=0;j<targetposition.size();j++) if((sourceposition[i]-targetposition[j]).norm()<radius) brute.insert(j);
+            ASSERT_EQ( brute , kdt);
+        }
+    }
+
     /// move a source point nb times and test if distance caching works to find the right closest point to target
     void testCachedPointPointCorrespondences(const unsigned int nb, const unsigned int nbp_target,const Real range, const Real dprange, const unsigned int N)
     {
@@ -140,6 +161,7 @@ struct KdTreeTest: public BaseTest
 
 TEST_F(KdTreeTest, point_point ) {    testPointPointCorrespondences(100,100,10); }
 TEST_F(KdTreeTest, point_Npoints ) {   testPointNPointsCorrespondences(100,100,10,10); }
+TEST_F(KdTreeTest, point_radius ) {   testPointRadiusCorrespondences(100,100,10,3); }
 TEST_F(KdTreeTest, cached_point_point ) {   testCachedPointPointCorrespondences(100,100,10,0.5,5); }
 
 
@@ -0,0 +1,205 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/helper/TraceRecorder.h>
+#include <sofa/helper/AdvancedTimer.h>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+using sofa::helper::TraceRecorder;
+using sofa::helper::AdvancedTimer;
+
+namespace
+{
+
+std::size_t countOccurrences(const std::string& str, const std::string& pattern)
+{
+    std::size_t count = 0;
+    for (auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+std::string exportTrace()
+{
+    std::stringstream out;
+    TraceRecorder::exportChromeTrace(out);
+    return out.str();
+}
+
+}
+
+TEST(TraceRecorder_test, intern)
+{
+    const auto id = TraceRecorder::intern("TraceRecorder_test::intern");
+    EXPECT_NE(id, 0u);
+    EXPECT_EQ(TraceRecorder::intern("TraceRecorder_test::intern"), id);
+    EXPECT_EQ(TraceRecorder::getName(id), "TraceRecorder_test::intern");
+    EXPECT_EQ(TraceRecorder::intern(""), 0u);
+}
+
+TEST(TraceRecorder_test, disabled)
+{
+    TraceRecorder::start();
+    TraceRecorder::stop();
+
+    {
+        TraceRecorder::ScopedEvent event(TraceRecorder::intern("disabled"));
+    }
+    AdvancedTimer::stepBegin("disabledStep");
+    AdvancedTimer::stepEnd("disabledStep");
+
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 0u);
+}
+
+TEST(TraceRecorder_test, nestedEvents)
+{
+    const auto outer = TraceRecorder::intern("outer");
+    const auto inner = TraceRecorder::intern("inner");
+    const auto obj = TraceRecorder::intern("my\"object");
+
+    TraceRecorder::start();
+    {
+        TraceRecorder::ScopedEvent outerEvent(outer);
+        for (int i = 0; i < 3; ++i)
+        {
+            TraceRecorder::ScopedEvent innerEvent(inner, obj);
+        }
+        TraceRecorder::instant(outer);
+    }
+    TraceRecorder::stop();
+
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 9u);
+
+    // the begin and end are merged in complete events
+    const std::string trace = exportTrace();
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"outer\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"outer\",\"ph\":\"i\""), 1u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"inner\",\"ph\":\"X\""), 3u);
+    EXPECT_EQ(countOccurrences(trace, "\"args\":{\"object\":\"my\\\"object\"}"), 3u);
+    EXPECT_EQ(countOccurrences(trace, "\"dur\":"), 4u);
+}
+
+TEST(TraceRecorder_test, ringBuffer)
+{
+    const auto outer = TraceRecorder::intern("ringOuter");
+    const auto inner = TraceRecorder::intern("ringInner");
+
+    TraceRecorder::start(16);
+    {
+        TraceRecorder::ScopedEvent outerEvent(outer);
+        for (int i = 0; i < 100; ++i)
+        {
+            TraceRecorder::ScopedEvent innerEvent(inner);
+        }
+    }
+    TraceRecorder::stop();
+
+    // only the last events are kept
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 16u);
+
+    // the end of the outer event lost its begin: it is not exported
+    const std::string trace = exportTrace();
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"ringInner\",\"ph\":\"X\""), 7u);
+    EXPECT_EQ(countOccurrences(trace, "ringOuter"), 0u);
+
+    TraceRecorder::clear();
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 0u);
+}
+
+TEST(TraceRecorder_test, threads)
+{
+    const auto id = TraceRecorder::intern("threadEvent");
+
+    TraceRecorder::start();
+    std::thread thread([id]
+    {
+        TraceRecorder::setThreadName("TraceRecorder_test thread");
+        TraceRecorder::ScopedEvent event(id);
+    });
+    thread.join();
+    {
+        TraceRecorder::ScopedEvent event(id);
+    }
+    TraceRecorder::stop();
+
+    // the events of a finished thread are kept
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 4u);
+
+    const std::string trace = exportTrace();
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"threadEvent\",\"ph\":\"X\""), 2u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"TraceRecorder_test thread\""), 1u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"thread_name\""), 2u);
+}
+
+TEST(TraceRecorder_test, stopWhileRecording)
+{
+    const auto outer = TraceRecorder::intern("stopOuter");
+    const auto inner = TraceRecorder::intern("stopInner");
+
+    TraceRecorder::start(16);
+    std::atomic<bool> stopped { false };
+    std::thread thread([&]
+    {
+        TraceRecorder::ScopedEvent outerEvent(outer);
+        while (!stopped)
+        {
+            TraceRecorder::ScopedEvent innerEvent(inner);
+        }
+        // the end of the outer event is recorded after the export
+    });
+
+    // wait for the buffer of the thread to be full
+    while (TraceRecorder::getNbEvents() < 16)
+    {
+        std::this_thread::yield();
+    }
+    TraceRecorder::stop();
+
+    // the events recorded after stop() do not overwrite the exported ones
+    const std::string trace = exportTrace();
+    stopped = true;
+    thread.join();
+    EXPECT_EQ(exportTrace(), trace);
+    EXPECT_EQ(TraceRecorder::getNbEvents(), 16u);
+
+    TraceRecorder::clear();
+}
+
+TEST(TraceRecorder_test, advancedTimerSteps)
+{
+    TraceRecorder::start();
+    AdvancedTimer::stepBegin("TraceRecorderStep");
+    AdvancedTimer::stepNext("TraceRecorderStep", "TraceRecorderNextStep");
+    AdvancedTimer::step("TraceRecorderMilestone");
+    AdvancedTimer::stepEnd("TraceRecorderNextStep");
+    TraceRecorder::stop();
+
+    const std::string trace = exportTrace();
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"TraceRecorderStep\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"TraceRecorderNextStep\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"TraceRecorderMilestone\",\"ph\":\"i\""), 1u);
+}
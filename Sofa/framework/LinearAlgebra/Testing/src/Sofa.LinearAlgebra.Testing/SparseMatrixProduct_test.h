@@ -114,6 +114,63 @@ struct TestSparseMatrixProduct : public sofa::testing::SparseMatrixTest<typename
 
         return true;
     }
+
+    bool checkSparsityPatternChange(typename LHSMatrix::Index nbRowsA, typename LHSMatrix::Index nbColsA, typename RHSMatrix::Index nbColsB, Real sparsity)
+    {
+        Eigen::SparseMatrix<Real, Eigen::RowMajor> eigen_a;
+        Eigen::SparseMatrix<Real, Eigen::ColMajor> eigen_b;
+
+        generateRandomSparseMatrix(eigen_a, nbRowsA, nbColsA, sparsity);
+        generateRandomSparseMatrix(eigen_b, nbColsA, nbColsB, sparsity);
+
+        LHSMatrix A;
+        RHSMatrix B;
+        copyFromEigen(A, eigen_a);
+        copyFromEigen(B, eigen_b);
+
+        T product(&A, &B);
+        SparseMatrixProductInit<T>::init(product);
+
+        EXPECT_FALSE(product.hasSameSparsityPattern()); // the intersection is not computed yet
+        product.computeProduct();
+        EXPECT_TRUE(product.hasSameSparsityPattern());
+
+        //modify the values of B, but not its pattern
+        for (int i = 0; i < eigen_b.nonZeros(); ++i)
+        {
+            eigen_b.valuePtr()[i] = static_cast<SReal>(sofa::helper::drand(1));
+        }
+        copyFromEigen(B, eigen_b);
+        EXPECT_TRUE(product.hasSameSparsityPattern());
+
+        //add a non-zero value in the first empty entry of B
+        bool hasAddedEntry = false;
+        for (Eigen::Index j = 0; j < eigen_b.cols() && !hasAddedEntry; ++j)
+        {
+            for (Eigen::Index i = 0; i < eigen_b.rows() && !hasAddedEntry; ++i)
+            {
+                if (eigen_b.coeff(i, j) == 0)
+                {
+                    eigen_b.coeffRef(i, j) = 1;
+                    hasAddedEntry = true;
+                }
+            }
+        }
+        eigen_b.makeCompressed();
+        EXPECT_TRUE(hasAddedEntry);
+        copyFromEigen(B, eigen_b);
+        EXPECT_FALSE(product.hasSameSparsityPattern());
+
+        product.computeProduct(!product.hasSameSparsityPattern());
+        EXPECT_TRUE(product.hasSameSparsityPattern());
+
+        const Eigen::SparseMatrix<Real, Eigen::RowMajor> eigen_c = eigen_a * eigen_b;
+        EXPECT_TRUE(compareSparseMatrix(eigen_c, product.getProductResult()));
+
+        SparseMatrixProductInit<T>::cleanup(product);
+
+        return true;
+    }
 };
 
 TYPED_TEST_SUITE_P(TestSparseMatrixProduct);
@@ -144,7 +201,14 @@ TYPED_TEST_P(TestSparseMatrixProduct, rectangularMatrix )
     EXPECT_TRUE( this->checkMatrix( 20, 30, 10, 1. ) );
 }
 
+TYPED_TEST_P(TestSparseMatrixProduct, sparsityPatternChange )
+{
+    EXPECT_TRUE( this->checkSparsityPatternChange( 5, 5, 5, 1. / 5. ) );
+    EXPECT_TRUE( this->checkSparsityPatternChange( 10, 5, 7, 3. / 5. ) );
+    EXPECT_TRUE( this->checkSparsityPatternChange( 100, 300, 200, 1. / 100. ) );
+}
+
 REGISTER_TYPED_TEST_SUITE_P(TestSparseMatrixProduct,
-                            squareMatrix,rectangularMatrix);
+                            squareMatrix,rectangularMatrix,sparsityPatternChange);
 
 }
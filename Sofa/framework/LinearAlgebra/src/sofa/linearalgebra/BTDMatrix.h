@@ -243,7 +243,7 @@ void BTDMatrix<N, T>::add(Index row, Index col,
         const Index bi = row / BSIZE;
         const Index bj = col / BSIZE;
         const Index bindex = bj - bi + 1;
-        if (bindex >= 3)
+        if (bindex < 0 || bindex >= 3)
         {
             return;
         }
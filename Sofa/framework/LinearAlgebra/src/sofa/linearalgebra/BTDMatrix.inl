@@ -107,7 +107,7 @@ SReal BTDMatrix<N, T>::element(Index i, Index j) const
     const Index bi = i / BSIZE; i = i % BSIZE;
     const Index bj = j / BSIZE; j = j % BSIZE;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return (SReal)0;
+    if (bindex < 0 || bindex >= 3) return (SReal)0;
     return data[bi*3+bindex][i][j];
 }
 
@@ -116,7 +116,7 @@ const typename BTDMatrix<N, T>::Block& BTDMatrix<N, T>::asub(Index bi, Index bj,
 {
     static Block b;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return b;
+    if (bindex < 0 || bindex >= 3) return b;
     return data[bi*3+bindex];
 }
 
@@ -131,7 +131,7 @@ typename BTDMatrix<N, T>::Block& BTDMatrix<N, T>::asub(Index bi, Index bj, Index
 {
     static Block b;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return b;
+    if (bindex < 0 || bindex >= 3) return b;
     return data[bi*3+bindex];
 }
 
@@ -175,7 +175,7 @@ void BTDMatrix<N, T>:: set(Index i, Index j, double v)
     const Index bi = i / BSIZE; i = i % BSIZE;
     const Index bj = j / BSIZE; j = j % BSIZE;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return;
+    if (bindex < 0 || bindex >= 3) return;
     data[bi*3+bindex][i][j] = (Real)v;
 }
 
@@ -185,7 +185,7 @@ void BTDMatrix<N, T>::add(Index i, Index j, double v)
     const Index bi = i / BSIZE; i = i % BSIZE;
     const Index bj = j / BSIZE; j = j % BSIZE;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return;
+    if (bindex < 0 || bindex >= 3) return;
     data[bi*3+bindex][i][j] += (Real)v;
 }
 
@@ -195,7 +195,7 @@ void BTDMatrix<N, T>::clear(Index i, Index j)
     const Index bi = i / BSIZE; i = i % BSIZE;
     const Index bj = j / BSIZE; j = j % BSIZE;
     const Index bindex = bj - bi + 1;
-    if (bindex >= 3) return;
+    if (bindex < 0 || bindex >= 3) return;
     data[bi*3+bindex][i][j] = (Real)0;
 }
 
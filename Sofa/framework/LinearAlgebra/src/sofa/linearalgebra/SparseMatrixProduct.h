@@ -39,6 +39,9 @@ namespace sofa::linearalgebra
  *
  * To compute the product, the method computeProduct must be called.
  *
+ * The sparsity patterns of the inputs are recorded when the intersection is computed. hasSameSparsityPattern compares
+ * them with the current inputs, so that the intersection is recomputed only when a pattern actually changed.
+ *
  * Based on:
  * Saupin, G., Duriez, C. and Grisoni, L., 2007, November. Embedded multigrid approach for real-time volumetric deformation. In International Symposium on Visual Computing (pp. 149-159). Springer, Berlin, Heidelberg.
  * and
@@ -74,6 +77,10 @@ public:
 
     void invalidateIntersection();
 
+    /// Return true if the sparsity patterns of both inputs are the ones used to compute the intersection, i.e. if the
+    /// intersection can be reused. The comparison is linear in the number of non-zeros of the inputs.
+    [[nodiscard]] bool hasSameSparsityPattern() const;
+
     SparseMatrixProduct(Lhs* lhs, Rhs* rhs) : m_lhs(lhs), m_rhs(rhs) {}
     SparseMatrixProduct() = default;
     virtual ~SparseMatrixProduct() = default;
@@ -100,6 +107,25 @@ protected:
 
     Intersection m_intersectionAB;
 
+    /// Sparsity pattern of a matrix in compressed storage
+    struct SparsityPattern
+    {
+        Index rows {};
+        Index cols {};
+        sofa::type::vector<Index> outerIndex;
+        sofa::type::vector<Index> innerIndex;
+
+        template<class Matrix>
+        void set(const Matrix& matrix);
+
+        template<class Matrix>
+        [[nodiscard]] bool isSameAs(const Matrix& matrix) const;
+    };
+
+    /// Sparsity patterns of the inputs when the intersection has been computed
+    SparsityPattern m_lhsPattern;
+    SparsityPattern m_rhsPattern;
+
 };
 
 
@@ -23,6 +23,7 @@
 #include <sofa/linearalgebra/SparseMatrixProduct.h>
 #include <Eigen/Sparse>
 #include <sofa/type/vector.h>
+#include <algorithm>
 
 
 namespace sofa::linearalgebra::sparsematrixproduct
@@ -280,6 +281,9 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
     }
 
     m_productResult = product.template cast<ResultScalar>();
+
+    m_lhsPattern.set(*m_lhs);
+    m_rhsPattern.set(*m_rhs);
 }
 
 template<class Lhs, class Rhs, class ResultType>
@@ -313,4 +317,33 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::invalidateIntersection()
     m_hasComputedIntersection = false;
 }
 
+template<class Lhs, class Rhs, class ResultType>
+bool SparseMatrixProduct<Lhs, Rhs, ResultType>::hasSameSparsityPattern() const
+{
+    return m_hasComputedIntersection
+        && m_lhsPattern.isSameAs(*m_lhs)
+        && m_rhsPattern.isSameAs(*m_rhs);
+}
+
+template<class Lhs, class Rhs, class ResultType>
+template<class Matrix>
+void SparseMatrixProduct<Lhs, Rhs, ResultType>::SparsityPattern::set(const Matrix& matrix)
+{
+    rows = matrix.rows();
+    cols = matrix.cols();
+    outerIndex.assign(matrix.outerIndexPtr(), matrix.outerIndexPtr() + matrix.outerSize() + 1);
+    innerIndex.assign(matrix.innerIndexPtr(), matrix.innerIndexPtr() + matrix.nonZeros());
+}
+
+template<class Lhs, class Rhs, class ResultType>
+template<class Matrix>
+bool SparseMatrixProduct<Lhs, Rhs, ResultType>::SparsityPattern::isSameAs(const Matrix& matrix) const
+{
+    return rows == matrix.rows() && cols == matrix.cols()
+        && outerIndex.size() == static_cast<std::size_t>(matrix.outerSize() + 1)
+        && innerIndex.size() == static_cast<std::size_t>(matrix.nonZeros())
+        && std::equal(outerIndex.begin(), outerIndex.end(), matrix.outerIndexPtr())
+        && std::equal(innerIndex.begin(), innerIndex.end(), matrix.innerIndexPtr());
+}
+
 }
@@ -0,0 +1,85 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/AsyncDataEngineUpdater.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/core/DataEngine.h>
+#include <sofa/helper/AdvancedTimer.h>
+
+namespace sofa::simulation
+{
+
+AsyncDataEngineUpdater::~AsyncDataEngineUpdater()
+{
+    wait();
+}
+
+std::size_t AsyncDataEngineUpdater::launch(Node* node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+
+    std::vector<core::DataEngine*> engines;
+    node->getTreeObjects<core::DataEngine>(&engines);
+
+    std::size_t nbLaunched = 0;
+    for (core::DataEngine* engine : engines)
+    {
+        if (!engine->d_asyncUpdate.getValue() || !engine->isDirty())
+        {
+            continue;
+        }
+
+        if (!m_taskScheduler)
+        {
+            m_taskScheduler = MainTaskSchedulerFactory::createInRegistry();
+            assert(m_taskScheduler != nullptr);
+            if (m_taskScheduler->getThreadCount() < 1)
+            {
+                m_taskScheduler->init(0);
+            }
+        }
+
+        m_taskScheduler->addTask(m_status.emplace_back(), [engine]() { engine->updateExclusively(); });
+        ++nbLaunched;
+    }
+
+    if (nbLaunched > 0)
+    {
+        helper::AdvancedTimer::valSet("AsyncEngineUpdates", static_cast<double>(nbLaunched));
+    }
+    return nbLaunched;
+}
+
+void AsyncDataEngineUpdater::wait()
+{
+    for (CpuTask::Status& status : m_status)
+    {
+        m_taskScheduler->workUntilDone(&status);
+    }
+    m_status.clear();
+}
+
+} // namespace sofa::simulation
@@ -0,0 +1,61 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/simulation/config.h>
+#include <sofa/simulation/fwd.h>
+#include <sofa/simulation/CpuTask.h>
+
+#include <deque>
+
+namespace sofa::simulation
+{
+
+class TaskScheduler;
+
+/**
+ * Updates on the task scheduler the dirty engines of a scene graph which enabled their Data asyncUpdate.
+ *
+ * The updates launched by launch() overlap the work done meanwhile by the calling thread. Reading an output of
+ * an engine being updated waits for the end of its update (see core::DataEngine::updateExclusively), and an
+ * engine not started yet when one of its outputs is read is updated by the reader, as usual.
+ * The updates read the inputs of the engines without synchronization: launch() must be called once the
+ * inputs are written (the animation loops launch the updates at the end of a time step), and wait() before
+ * they are written again (at the beginning of the next time step, or on reset and cleanup).
+ */
+class SOFA_SIMULATION_CORE_API AsyncDataEngineUpdater
+{
+public:
+    ~AsyncDataEngineUpdater();
+
+    /// Launch the update of the dirty engines of the graph under node which enabled asyncUpdate.
+    /// Returns the number of launched updates.
+    std::size_t launch(Node* node);
+
+    /// Wait for the end of all the launched updates
+    void wait();
+
+protected:
+    TaskScheduler* m_taskScheduler { nullptr };
+    std::deque<CpuTask::Status> m_status;
+};
+
+} // namespace sofa::simulation
@@ -42,11 +42,37 @@ BaseSimulationExporter::BaseSimulationExporter() :
   , d_exportAtEnd( initData(&d_exportAtEnd, false, "exportAtEnd",
                             "export file when the simulation is over and cleanup is called, i.e. just before deleting the simulation (default=false)"))
   , d_isEnabled( initData(&d_isEnabled, true, "enable", "Enable or disable the component. (default=true)"))
+  , d_asyncExport( initData(&d_asyncExport, false, "asyncExport",
+                            "write the exported files in a background thread, the simulation only waits if the previous exports are not written yet (default=false)"))
 {
     f_listening.setValue(false) ;
     d_filename.setPathType(sofa::core::objectmodel::PathType::BOTH);
 }
 
+BaseSimulationExporter::~BaseSimulationExporter()
+{
+    /// Write the pending files while the component still exists
+    m_exportQueue.reset();
+}
+
+ExportQueue* BaseSimulationExporter::getExportQueue()
+{
+    if (!d_asyncExport.getValue())
+        return nullptr;
+    if (!m_exportQueue)
+        m_exportQueue = std::make_unique<ExportQueue>();
+    reportExportErrors();
+    return m_exportQueue.get();
+}
+
+void BaseSimulationExporter::reportExportErrors()
+{
+    if (!m_exportQueue)
+        return;
+    for (const std::string& error : m_exportQueue->takeErrors())
+        msg_error() << error;
+}
+
 
 const std::string BaseSimulationExporter::getOrCreateTargetPath(const std::string& filename, bool autonumbering)
 {
@@ -133,6 +159,12 @@ void BaseSimulationExporter::cleanup()
 {
     if (d_isEnabled.getValue() && d_exportAtEnd.getValue())
         write();
+
+    if (m_exportQueue)
+    {
+        m_exportQueue->flush();
+        reportExportErrors();
+    }
 }
 
 
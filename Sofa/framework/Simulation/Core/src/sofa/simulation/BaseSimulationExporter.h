@@ -25,7 +25,9 @@
 #include <sofa/simulation/config.h>
 #include <sofa/core/objectmodel/BaseObject.h>
 #include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/simulation/ExportQueue.h>
 
+#include <memory>
 #include <string>
 
 
@@ -52,6 +54,7 @@ public:
     Data<bool>         d_exportAtBegin;
     Data<bool>         d_exportAtEnd;
     Data<bool>         d_isEnabled; ///< Enable or disable the component. (default=true)
+    Data<bool>         d_asyncExport; ///< Write the exported files in a background thread
 
     /// Don't override this function anymore. But you can do you init in the doInit.
     void init() final;
@@ -69,11 +72,19 @@ public:
 
 protected:
     BaseSimulationExporter() ;
-    ~BaseSimulationExporter() override { }
+    ~BaseSimulationExporter() override ;
 
     const std::string getOrCreateTargetPath(const std::string& filename, bool autonumbering);
     void updateFromDataField();
+
+    /// Queue in which the exported files are written, or nullptr if asyncExport is disabled.
+    /// Use it with an ExportFileStream to write the files.
+    ExportQueue* getExportQueue() ;
+    /// Report the errors of the files written in the background since the last call
+    void reportExportErrors() ;
+
     unsigned int m_stepCounter {0};
+    std::unique_ptr<ExportQueue> m_exportQueue;
 };
 
 }
@@ -0,0 +1,173 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/DataMemoryReport.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/defaulttype/AbstractTypeInfo.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+
+/// Address and size of the contiguous payload of a Data, if it has one
+bool getPayload(const core::objectmodel::BaseData* data, const void*& address, std::size_t& nbBytes)
+{
+    const defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+    if (!typeInfo || !typeInfo->ValidInfo() || !typeInfo->Container() || !typeInfo->SimpleLayout()
+        || !typeInfo->BaseType() || !typeInfo->BaseType()->FixedSize())
+    {
+        return false;
+    }
+
+    const void* value = data->getValueVoidPtr();
+    const std::size_t nbValues = typeInfo->size(value);
+    if (nbValues == 0)
+    {
+        return false;
+    }
+
+    address = typeInfo->getValuePtr(value);
+    nbBytes = nbValues * typeInfo->byteSize();
+    return address != nullptr;
+}
+
+}
+
+DataMemoryReport computeDataMemoryReport(Node* root, std::size_t minimumNbBytes)
+{
+    DataMemoryReport report;
+    if (!root)
+    {
+        return report;
+    }
+
+    std::vector<core::objectmodel::BaseObject*> objects;
+    root->getTreeObjects<core::objectmodel::BaseObject>(&objects);
+
+    // Data sharing a buffer have the same payload address
+    std::unordered_map<const void*, DataMemoryReport::Buffer> buffers;
+    for (const auto* object : objects)
+    {
+        for (const auto* data : object->getDataFields())
+        {
+            if (data->isDirty())
+            {
+                continue;
+            }
+
+            const void* address = nullptr;
+            std::size_t nbBytes = 0;
+            if (!getPayload(data, address, nbBytes) || nbBytes < minimumNbBytes)
+            {
+                continue;
+            }
+
+            auto& buffer = buffers[address];
+            buffer.nbBytes = std::max(buffer.nbBytes, nbBytes);
+            buffer.data.push_back(data);
+
+            ++report.nbData;
+            report.totalBytes += nbBytes;
+        }
+    }
+
+    // Distinct buffers are grouped by size and content hash, then compared byte per byte
+    std::map<std::pair<std::size_t, std::size_t>, std::vector<std::pair<const void*, DataMemoryReport::Buffer*>>> candidates;
+    for (auto& [address, buffer] : buffers)
+    {
+        report.allocatedBytes += buffer.nbBytes;
+        const std::size_t hash = std::hash<std::string_view>{}(std::string_view(static_cast<const char*>(address), buffer.nbBytes));
+        candidates[{buffer.nbBytes, hash}].emplace_back(address, &buffer);
+    }
+
+    for (auto& [key, group] : candidates)
+    {
+        std::vector<bool> isGrouped(group.size(), false);
+        for (std::size_t i = 0; i < group.size(); ++i)
+        {
+            if (isGrouped[i])
+            {
+                continue;
+            }
+
+            DataMemoryReport::Duplicates duplicates;
+            duplicates.nbBytes = key.first;
+            duplicates.buffers.push_back(*group[i].second);
+            for (std::size_t j = i + 1; j < group.size(); ++j)
+            {
+                if (!isGrouped[j] && std::memcmp(group[i].first, group[j].first, key.first) == 0)
+                {
+                    isGrouped[j] = true;
+                    duplicates.buffers.push_back(*group[j].second);
+                }
+            }
+
+            if (duplicates.buffers.size() > 1)
+            {
+                report.duplicatedBytes += (duplicates.buffers.size() - 1) * duplicates.nbBytes;
+                report.duplicates.push_back(std::move(duplicates));
+            }
+        }
+    }
+
+    std::sort(report.duplicates.begin(), report.duplicates.end(),
+        [](const DataMemoryReport::Duplicates& a, const DataMemoryReport::Duplicates& b)
+        {
+            return (a.buffers.size() - 1) * a.nbBytes > (b.buffers.size() - 1) * b.nbBytes;
+        });
+
+    return report;
+}
+
+std::ostream& operator<<(std::ostream& out, const DataMemoryReport& report)
+{
+    out << "Data payloads: " << report.nbData << " Data, "
+        << report.totalBytes << " bytes without sharing, "
+        << report.allocatedBytes << " bytes allocated, "
+        << report.duplicatedBytes << " bytes duplicated";
+
+    for (const auto& duplicates : report.duplicates)
+    {
+        out << "\n  " << duplicates.buffers.size() << " buffers of " << duplicates.nbBytes << " bytes with the same content:";
+        for (const auto& buffer : duplicates.buffers)
+        {
+            out << "\n   ";
+            for (const auto* data : buffer.data)
+            {
+                out << " " << data->getLinkPath();
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace sofa::simulation
@@ -0,0 +1,72 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/simulation/config.h>
+#include <sofa/simulation/fwd.h>
+#include <sofa/core/fwd.h>
+
+#include <iosfwd>
+#include <vector>
+
+namespace sofa::simulation
+{
+
+/**
+ * Memory used by the contiguous payloads of the Data of a scene graph, such as vectors of coordinates or of
+ * topological elements.
+ *
+ * The Data sharing the same buffer through copy-on-write (e.g. linked Data) are counted once. The distinct buffers
+ * holding the same bytes are reported as duplicated: they could have been shared.
+ */
+struct SOFA_SIMULATION_CORE_API DataMemoryReport
+{
+    /// Data sharing the same buffer
+    struct Buffer
+    {
+        std::size_t nbBytes {};
+        std::vector<const core::objectmodel::BaseData*> data;
+    };
+
+    /// Distinct buffers with the same content
+    struct Duplicates
+    {
+        std::size_t nbBytes {}; ///< Size of each buffer
+        std::vector<Buffer> buffers;
+    };
+
+    std::size_t nbData {}; ///< Number of Data with a payload in the report
+    std::size_t totalBytes {}; ///< Sum of the payloads of all the Data, as if nothing was shared
+    std::size_t allocatedBytes {}; ///< Sum of the payloads of the distinct buffers
+    std::size_t duplicatedBytes {}; ///< Bytes which could be saved by sharing the buffers with the same content
+    std::vector<Duplicates> duplicates; ///< Sorted by decreasing number of duplicated bytes
+};
+
+/**
+ * Compute the memory report of the Data of all the objects in the graph under the node.
+ * Payloads smaller than minimumNbBytes are ignored.
+ * Dirty Data are ignored, so that computing the report does not trigger any update of the graph.
+ */
+SOFA_SIMULATION_CORE_API DataMemoryReport computeDataMemoryReport(Node* root, std::size_t minimumNbBytes = 0);
+
+SOFA_SIMULATION_CORE_API std::ostream& operator<<(std::ostream& out, const DataMemoryReport& report);
+
+} // namespace sofa::simulation
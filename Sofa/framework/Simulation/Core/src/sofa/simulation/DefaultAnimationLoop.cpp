@@ -110,6 +110,18 @@ void DefaultAnimationLoop::init()
     }
 }
 
+void DefaultAnimationLoop::reset()
+{
+    waitAsyncEngineUpdates();
+    Inherit::reset();
+}
+
+void DefaultAnimationLoop::cleanup()
+{
+    waitAsyncEngineUpdates();
+    Inherit::cleanup();
+}
+
 void DefaultAnimationLoop::setNode(simulation::Node* n)
 {
     l_node.set(n);
@@ -291,6 +303,18 @@ void DefaultAnimationLoop::animate(const core::ExecParams* params, SReal dt) con
     endIntegration(params, dt);
 }
 
+void DefaultAnimationLoop::launchAsyncEngineUpdates()
+{
+    SCOPED_TIMER("LaunchAsyncEngineUpdates");
+    m_asyncEngineUpdater.launch(m_node);
+}
+
+void DefaultAnimationLoop::waitAsyncEngineUpdates()
+{
+    SCOPED_TIMER("WaitAsyncEngineUpdates");
+    m_asyncEngineUpdater.wait();
+}
+
 void DefaultAnimationLoop::step(const core::ExecParams* params, SReal dt)
 {
     if (this->d_componentState.getValue() != sofa::core::objectmodel::ComponentState::Valid)
@@ -310,6 +334,9 @@ void DefaultAnimationLoop::step(const core::ExecParams* params, SReal dt)
     simulation::Visitor::printNode("Step");
 #endif
 
+    // the asynchronous updates launched at the end of the previous step read the data modified by this step
+    waitAsyncEngineUpdates();
+
     propagateAnimateBeginEvent(params, dt);
     animate(params, dt);
     updateSimulationContext(params, dt, m_node->getTime());
@@ -318,6 +345,9 @@ void DefaultAnimationLoop::step(const core::ExecParams* params, SReal dt)
     updateMapping(params, dt);
     computeBoundingBox(params);
 
+    // the positions of the time step are final: the dirty asynchronous engines can be updated until the next step
+    launchAsyncEngineUpdates();
+
 #ifdef SOFA_DUMP_VISITOR_INFO
     simulation::Visitor::printCloseNode("Step");
 #endif
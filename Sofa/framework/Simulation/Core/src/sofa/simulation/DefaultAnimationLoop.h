@@ -25,6 +25,7 @@
 #include <sofa/core/behavior/BaseAnimationLoop.h>
 
 #include <sofa/simulation/fwd.h>
+#include <sofa/simulation/AsyncDataEngineUpdater.h>
 
 
 namespace sofa::core
@@ -57,6 +58,8 @@ public:
     Data<bool> d_parallelODESolving; ///< If true, solves all the ODEs in parallel
 
     void init() override;
+    void reset() override;
+    void cleanup() override;
 
     /// Set the simulation node this animation loop is controlling
     virtual void setNode(simulation::Node*);
@@ -67,6 +70,9 @@ public:
 protected :
     simulation::Node* m_node { nullptr };
 
+    /// Updates the engines with asyncUpdate between the end of a time step and the beginning of the next one
+    AsyncDataEngineUpdater m_asyncEngineUpdater;
+
     void behaviorUpdatePosition(const sofa::core::ExecParams* params, SReal dt) const;
     void updateInternalData(const sofa::core::ExecParams* params) const;
     void beginIntegration(const sofa::core::ExecParams* params, SReal dt) const;
@@ -86,6 +92,8 @@ protected :
     void updateMapping(const sofa::core::ExecParams* params, SReal dt) const;
     void computeBoundingBox(const sofa::core::ExecParams* params) const;
     void propagateAnimateBeginEvent(const sofa::core::ExecParams* params, SReal dt) const;
+    void launchAsyncEngineUpdates();
+    void waitAsyncEngineUpdates();
 
 };
 
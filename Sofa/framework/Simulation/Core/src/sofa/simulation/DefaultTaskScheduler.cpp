@@ -22,6 +22,7 @@
 #include <sofa/simulation/DefaultTaskScheduler.h>
 
 #include <sofa/helper/system/thread/thread_specific_ptr.h>
+#include <sofa/helper/TraceRecorder.h>
 #include <sofa/simulation/WorkerThread.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 
@@ -63,6 +64,7 @@ DefaultTaskScheduler::DefaultTaskScheduler()
     // init global static thread local var
     {
         _threads[std::this_thread::get_id()] = new WorkerThread(this, 0, "Main  ");// new WorkerThread(this, 0, "Main  ");
+        helper::TraceRecorder::setThreadName("Main");
     }
 }
 
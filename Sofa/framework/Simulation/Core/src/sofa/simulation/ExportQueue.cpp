@@ -0,0 +1,156 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/ExportQueue.h>
+
+#include <algorithm>
+
+namespace sofa::simulation
+{
+
+ExportQueue::ExportQueue(std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(capacity, 1))
+{
+}
+
+ExportQueue::~ExportQueue()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        m_thread.join();
+    }
+}
+
+void ExportQueue::push(std::function<void()> job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable())
+    {
+        m_thread = std::thread(&ExportQueue::run, this);
+    }
+
+    // backpressure: the running job counts as pending
+    m_condition.wait(lock, [this] { return m_jobs.size() + (m_running ? 1 : 0) < m_capacity; });
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+    m_condition.notify_all();
+}
+
+void ExportQueue::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_jobs.empty() && !m_running; });
+}
+
+void ExportQueue::addError(std::string error)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.push_back(std::move(error));
+}
+
+std::vector<std::string> ExportQueue::takeErrors()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> errors;
+    errors.swap(m_errors);
+    return errors;
+}
+
+void ExportQueue::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+            return;
+
+        std::function<void()> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_running = true;
+        lock.unlock();
+
+        job();
+
+        lock.lock();
+        m_running = false;
+        m_condition.notify_all();
+    }
+}
+
+ExportFileStream::ExportFileStream(ExportQueue* queue, const std::string& filename, std::ios::openmode mode)
+    : std::ostream(nullptr)
+    , m_queue(queue)
+    , m_filename(filename)
+    , m_file(std::make_shared<std::ofstream>(filename.c_str(), mode))
+{
+    if (m_queue && m_file->is_open())
+    {
+        m_buffer = std::make_shared<std::stringbuf>(std::ios::out | (mode & std::ios::binary));
+        rdbuf(m_buffer.get());
+    }
+    else
+    {
+        rdbuf(m_file->rdbuf());
+    }
+}
+
+ExportFileStream::~ExportFileStream()
+{
+    close();
+}
+
+bool ExportFileStream::is_open() const
+{
+    return m_file && m_file->is_open();
+}
+
+void ExportFileStream::close()
+{
+    if (!is_open())
+        return;
+
+    if (m_buffer)
+    {
+        rdbuf(nullptr);
+        m_queue->push([queue = m_queue, filename = m_filename, file = m_file, buffer = m_buffer]()
+        {
+            const std::string content = buffer->str();
+            file->write(content.data(), std::streamsize(content.size()));
+            file->close();
+            if (file->fail())
+                queue->addError("Error writing file '" + filename + "'");
+        });
+        m_buffer.reset();
+    }
+    else
+    {
+        m_file->close();
+    }
+    m_file.reset();
+}
+
+} // namespace sofa::simulation
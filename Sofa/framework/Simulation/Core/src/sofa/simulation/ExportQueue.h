@@ -0,0 +1,109 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/simulation/config.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sofa::simulation
+{
+
+/**
+ * Bounded queue of export jobs (formatting and writing files) run by a background thread.
+ *
+ * The exporters snapshot the data they need on the simulation thread, and push a job using only
+ * this snapshot. When capacity jobs are already pending, push() waits for the oldest one to
+ * finish: a simulation exporting faster than the disk can write is slowed down instead of
+ * accumulating snapshots in memory.
+ * A dedicated thread is used rather than the task scheduler, as the jobs mostly wait for the disk.
+ * The jobs cannot report their errors themselves: they add them to the queue, and the exporter
+ * reports them on the simulation thread (see takeErrors()).
+ */
+class SOFA_SIMULATION_CORE_API ExportQueue
+{
+public:
+    explicit ExportQueue(std::size_t capacity = 2);
+    ExportQueue(const ExportQueue&) = delete;
+    ExportQueue& operator=(const ExportQueue&) = delete;
+
+    /// Wait for the pending jobs
+    ~ExportQueue();
+
+    void push(std::function<void()> job);
+
+    /// Wait for the pending jobs
+    void flush();
+
+    std::size_t getCapacity() const { return m_capacity; }
+
+    /// Record an error of a job, e.g. a file which could not be written. Can be called by the jobs.
+    void addError(std::string error);
+
+    /// Return the errors recorded since the last call
+    std::vector<std::string> takeErrors();
+
+protected:
+    void run();
+
+    std::size_t m_capacity;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()> > m_jobs;
+    std::vector<std::string> m_errors;
+    bool m_running { false }; ///< a job was popped and is being run
+    bool m_stop { false };
+};
+
+/**
+ * Output stream of an exported file.
+ * Without an ExportQueue, it writes directly in the file. With an ExportQueue, the content is
+ * formatted in memory and written in the file by the queue when the stream is closed. In both
+ * cases, the file is created by the constructor so that errors are reported immediately. An error
+ * while writing the file in the background is added to the errors of the queue.
+ */
+class SOFA_SIMULATION_CORE_API ExportFileStream : public std::ostream
+{
+public:
+    ExportFileStream(ExportQueue* queue, const std::string& filename, std::ios::openmode mode = std::ios::out);
+    ~ExportFileStream() override;
+
+    bool is_open() const;
+    void close();
+
+protected:
+    ExportQueue* m_queue;
+    std::string m_filename;
+    std::shared_ptr<std::ofstream> m_file;
+    std::shared_ptr<std::stringbuf> m_buffer;
+};
+
+} // namespace sofa::simulation
@@ -62,6 +62,7 @@
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/helper/Factory.inl>
 #include <sofa/helper/cast.h>
+#include <sofa/helper/TraceRecorder.h>
 #include <iostream>
 
 /// If you want to activate/deactivate that please set them to true/false
@@ -891,7 +892,11 @@ void Node::executeVisitor(Visitor* action, bool precomputedOrder)
         ++level;
     }
 
-    doExecuteVisitor(action, precomputedOrder);
+    {
+        const helper::TraceRecorder::ScopedEvent traceEvent(
+            helper::TraceRecorder::isEnabled() ? helper::TraceRecorder::intern(typeid(*action)) : 0);
+        doExecuteVisitor(action, precomputedOrder);
+    }
 
     if(DEBUG_VISITOR)
     {
@@ -48,6 +48,7 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/ComponentNameHelper.h>
+#include <sofa/core/DataEngine.h>
 
 #include <sofa/simulation/SceneLoaderFactory.h>
 
@@ -218,7 +219,16 @@ void animate(Node* root, SReal dt)
 
     if (sofa::core::behavior::BaseAnimationLoop* aloop = root->getAnimationLoop())
     {
+        const auto ddgStatisticsBefore = sofa::core::objectmodel::DDGNode::getStatistics();
+        const auto nbEngineEvaluationsBefore = sofa::core::DataEngine::getNbEvaluations();
+
         aloop->step(params, dt);
+
+        // work done in the data dependency graph during the step
+        const auto ddgStatisticsAfter = sofa::core::objectmodel::DDGNode::getStatistics();
+        sofa::helper::AdvancedTimer::valSet("DDG dirty propagations", static_cast<double>(ddgStatisticsAfter.nbDirtyPropagations - ddgStatisticsBefore.nbDirtyPropagations));
+        sofa::helper::AdvancedTimer::valSet("DDG updates", static_cast<double>(ddgStatisticsAfter.nbUpdates - ddgStatisticsBefore.nbUpdates));
+        sofa::helper::AdvancedTimer::valSet("engine evaluations", static_cast<double>(sofa::core::DataEngine::getNbEvaluations() - nbEngineEvaluationsBefore));
     }
     else
     {
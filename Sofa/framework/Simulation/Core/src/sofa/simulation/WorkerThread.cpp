@@ -21,6 +21,7 @@
 ******************************************************************************/
 #include <sofa/simulation/WorkerThread.h>
 #include <sofa/simulation/DefaultTaskScheduler.h>
+#include <sofa/helper/TraceRecorder.h>
 
 #include <cassert>
 #include <mutex>
@@ -80,6 +81,7 @@ void WorkerThread::run(void)
         widestr.c_str()
         );
 #endif
+    helper::TraceRecorder::setThreadName(m_name);
 
     //workerThreadIndex = this;
     //TaskSchedulerDefault::_threads[std::this_thread::get_id()] = this;
@@ -153,6 +155,10 @@ void WorkerThread::runTask(Task *task)
     m_currentStatus = task->getStatus();
 
     {
+        // the name is read before the run, as the task may be deleted at its end
+        const helper::TraceRecorder::ScopedEvent traceEvent(
+            helper::TraceRecorder::isEnabled() ? helper::TraceRecorder::intern(typeid(*task)) : 0);
+
         if (task->run() & Task::MemoryAlloc::Dynamic)
         {
             // pooled memory: call destructor and free
@@ -0,0 +1,199 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+#include <sofa/core/DataEngine.h>
+#include <sofa/helper/accessor.h>
+#include <sofa/simulation/AsyncDataEngineUpdater.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace sofa
+{
+
+namespace
+{
+
+constexpr std::size_t nbValues = 2000;
+
+/// Engine filling its two outputs slowly, so that a concurrent reader would see them partially written
+class SlowCopyEngine : public core::DataEngine
+{
+public:
+    SOFA_CLASS(SlowCopyEngine, core::DataEngine);
+
+    Data<int> d_input;
+    Data<type::vector<int> > d_values;
+    Data<type::vector<int> > d_doubles;
+
+    void doUpdate() override
+    {
+        const int input = d_input.getValue();
+        {
+            helper::WriteOnlyAccessor<Data<type::vector<int> > > values = d_values;
+            values.resize(nbValues);
+            for (std::size_t i = 0; i < nbValues; ++i)
+            {
+                values[i] = input;
+                std::this_thread::yield();
+            }
+        }
+        {
+            helper::WriteOnlyAccessor<Data<type::vector<int> > > doubles = d_doubles;
+            doubles.resize(nbValues);
+            for (std::size_t i = 0; i < nbValues; ++i)
+            {
+                doubles[i] = 2 * input;
+                std::this_thread::yield();
+            }
+        }
+    }
+
+protected:
+    SlowCopyEngine()
+        : d_input(initData(&d_input, 0, "input", "input"))
+        , d_values(initData(&d_values, "values", "copies of the input"))
+        , d_doubles(initData(&d_doubles, "doubles", "copies of twice the input"))
+    {
+        addInput(&d_input);
+        addOutput(&d_values);
+        addOutput(&d_doubles);
+    }
+};
+
+class SumEngine : public core::DataEngine
+{
+public:
+    SOFA_CLASS(SumEngine, core::DataEngine);
+
+    Data<type::vector<int> > d_values;
+    Data<int> d_sum;
+
+    void doUpdate() override
+    {
+        int sum = 0;
+        for (const int value : d_values.getValue())
+        {
+            sum += value;
+        }
+        d_sum.setValue(sum);
+    }
+
+protected:
+    SumEngine()
+        : d_values(initData(&d_values, "values", "values to sum"))
+        , d_sum(initData(&d_sum, 0, "sum", "sum of the values"))
+    {
+        addInput(&d_values);
+        addOutput(&d_sum);
+    }
+};
+
+bool isFilledWith(const type::vector<int>& values, int value)
+{
+    return values.size() == nbValues && std::all_of(values.begin(), values.end(), [value](const int v) { return v == value; });
+}
+
+}
+
+TEST(AsyncDataEngineUpdater, launchOnlyAsyncDirtyEngines)
+{
+    const simulation::Node::SPtr root = simulation::getSimulation()->createNewGraph("root");
+    const auto copy = core::objectmodel::New<SlowCopyEngine>();
+    const auto sum = core::objectmodel::New<SumEngine>();
+    root->addObject(copy);
+    root->addObject(sum);
+    sum->d_values.setParent(&copy->d_values);
+
+    simulation::AsyncDataEngineUpdater updater;
+    EXPECT_EQ(updater.launch(root.get()), 0u);
+
+    sum->d_asyncUpdate.setValue(true);
+    copy->d_input.setValue(3);
+    EXPECT_EQ(updater.launch(root.get()), 1u);
+    updater.wait();
+
+    // the upstream engine has been updated along with the asynchronous one
+    EXPECT_FALSE(copy->isDirty());
+    EXPECT_FALSE(sum->isDirty());
+    EXPECT_EQ(sum->d_sum.getValue(), 3 * static_cast<int>(nbValues));
+    EXPECT_TRUE(isFilledWith(copy->d_doubles.getValue(), 6));
+
+    // nothing to do for a clean engine
+    EXPECT_EQ(updater.launch(root.get()), 0u);
+
+    sofa::simulation::node::unload(root);
+}
+
+/// The outputs of the asynchronous engine and of the engines upstream of it are read by another thread during
+/// the update: the reader must never see a value being computed.
+TEST(AsyncDataEngineUpdater, concurrentReader)
+{
+    const simulation::Node::SPtr root = simulation::getSimulation()->createNewGraph("root");
+    const auto copy = core::objectmodel::New<SlowCopyEngine>();
+    const auto sum = core::objectmodel::New<SumEngine>();
+    root->addObject(copy);
+    root->addObject(sum);
+    sum->d_values.setParent(&copy->d_values);
+    sum->d_asyncUpdate.setValue(true);
+
+    simulation::AsyncDataEngineUpdater updater;
+
+    for (int input = 1; input <= 50; ++input)
+    {
+        copy->d_input.setValue(input);
+        ASSERT_EQ(updater.launch(root.get()), 1u);
+
+        std::atomic<int> nbInconsistencies { 0 };
+        std::thread reader([&copy, &sum, &nbInconsistencies, input]()
+        {
+            // the second output of the upstream engine is not read by the asynchronous engine
+            if (!isFilledWith(copy->d_doubles.getValue(), 2 * input))
+            {
+                ++nbInconsistencies;
+            }
+            if (sum->d_sum.getValue() != input * static_cast<int>(nbValues))
+            {
+                ++nbInconsistencies;
+            }
+            if (!isFilledWith(copy->d_values.getValue(), input))
+            {
+                ++nbInconsistencies;
+            }
+        });
+
+        // the calling thread runs the launched update if there is no worker thread
+        updater.wait();
+        reader.join();
+
+        EXPECT_EQ(nbInconsistencies.load(), 0) << "input " << input;
+        EXPECT_EQ(sum->d_sum.getValue(), input * static_cast<int>(nbValues));
+    }
+
+    sofa::simulation::node::unload(root);
+}
+
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/simulation/DataMemoryReport.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+namespace sofa
+{
+
+namespace
+{
+
+class DataMemoryReportObject : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(DataMemoryReportObject, core::objectmodel::BaseObject);
+
+    Data<type::vector<double> > d_source;
+    Data<type::vector<double> > d_copy;
+
+protected:
+    DataMemoryReportObject()
+        : d_source(initData(&d_source, "source", "source buffer"))
+        , d_copy(initData(&d_copy, "copy", "copy of the source buffer"))
+    {}
+};
+
+constexpr std::size_t nbValues = 1000;
+constexpr std::size_t nbBytes = nbValues * sizeof(double);
+
+}
+
+TEST(DataMemoryReport, sharedBuffers)
+{
+    const simulation::Node::SPtr root = simulation::getSimulation()->createNewGraph("root");
+    const auto object = core::objectmodel::New<DataMemoryReportObject>();
+    root->addObject(object);
+
+    type::vector<double> values(nbValues);
+    for (std::size_t i = 0; i < nbValues; ++i)
+    {
+        values[i] = static_cast<double>(i);
+    }
+    object->d_source.setValue(values);
+
+    // the small Data of the object (name, tags...) are ignored
+    const auto computeReport = [&root]() { return simulation::computeDataMemoryReport(root.get(), 1024); };
+
+    // the copy shares the buffer of the source: it is counted once
+    object->d_copy.shareValueFrom(&object->d_source);
+    {
+        const simulation::DataMemoryReport report = computeReport();
+        EXPECT_EQ(report.nbData, 2u);
+        EXPECT_EQ(report.totalBytes, 2 * nbBytes);
+        EXPECT_EQ(report.allocatedBytes, nbBytes);
+        EXPECT_EQ(report.duplicatedBytes, 0u);
+        EXPECT_TRUE(report.duplicates.empty());
+    }
+
+    // a write detaches the copy: same content in two buffers
+    object->d_copy.beginEdit();
+    object->d_copy.endEdit();
+    {
+        const simulation::DataMemoryReport report = computeReport();
+        EXPECT_EQ(report.nbData, 2u);
+        EXPECT_EQ(report.allocatedBytes, 2 * nbBytes);
+        EXPECT_EQ(report.duplicatedBytes, nbBytes);
+        ASSERT_EQ(report.duplicates.size(), 1u);
+        EXPECT_EQ(report.duplicates[0].nbBytes, nbBytes);
+        EXPECT_EQ(report.duplicates[0].buffers.size(), 2u);
+    }
+
+    object->d_copy.beginEdit()->front() = -1.;
+    object->d_copy.endEdit();
+    {
+        const simulation::DataMemoryReport report = computeReport();
+        EXPECT_EQ(report.allocatedBytes, 2 * nbBytes);
+        EXPECT_EQ(report.duplicatedBytes, 0u);
+        EXPECT_TRUE(report.duplicates.empty());
+    }
+
+    // shared again, then detached by setValue without modifying the source
+    object->d_copy.shareValueFrom(&object->d_source);
+    EXPECT_EQ(computeReport().allocatedBytes, nbBytes);
+    object->d_copy.setValue(values);
+    {
+        const simulation::DataMemoryReport report = computeReport();
+        EXPECT_EQ(report.allocatedBytes, 2 * nbBytes);
+        EXPECT_EQ(report.duplicatedBytes, nbBytes);
+        EXPECT_EQ(object->d_source.getValue(), values);
+    }
+
+    simulation::node::unload(root);
+}
+
+}
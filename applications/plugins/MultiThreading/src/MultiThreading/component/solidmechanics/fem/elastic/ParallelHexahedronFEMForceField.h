@@ -32,18 +32,21 @@ namespace multithreading::component::forcefield::solidmechanics::fem::elastic
 /**
  * Parallel implementation of HexahedronFEMForceField
  *
- * This implementation is the most efficient when:
- * 1) the number of hexahedron is large (> 1000)
- * 2) the global system matrix is not assembled. It is usually the case with a CGLinearSolver templated with GraphScattered types.
- * 3) the method is 'large'. If the method is 'polar' or 'small', addForce is executed sequentially, but addDForce in parallel.
+ * This implementation is the most efficient when the number of hexahedron is large (> 1000).
  *
- * The following methods are executed in parallel:
- * - addForce for method 'large'.
+ * The following methods are executed in parallel, for all the methods ('large', 'polar' and 'small'):
+ * - addForce
  * - addDForce
+ * - buildStiffnessMatrix: the element matrices are rotated in parallel, but accumulated sequentially in the global matrix.
  *
- * The method addKToMatrix is not executed in parallel. This method is called with an assembled system, usually with
- * a direct solver or a CGLinearSolver templated with types different from GraphScattered. In this case, the most
- * time-consumming step is to invert the matrix. This is where efforts should be put to accelerate the simulation.
+ * In addForce and addDForce, the computation is done in 2 steps:
+ * 1) Elements are visited in parallel: a force (derivative) is computed inside each element
+ * 2) Vertices are visited in parallel: the force (derivative) in all adjacent hexahedra are
+ * accumulated in the vertices
+ *
+ * The method addKToMatrix is not executed in parallel.
+ * On regular and sparse grids, setting 'shareStiffnessMatrices' reduces the memory footprint and the
+ * initialization time.
  */
 template<class DataTypes>
 class SOFA_MULTITHREADING_PLUGIN_API ParallelHexahedronFEMForceField :
@@ -66,27 +69,22 @@ public:
     typedef sofa::core::topology::BaseMeshTopology::SeqHexahedra VecElement;
     typedef sofa::type::Mat<24, 24, Real> ElementStiffness;
     typedef sofa::helper::vector<ElementStiffness> VecElementStiffness;
+    typedef sofa::type::Mat<3, 3, Real> Mat33;
 
     void init() override;
 
     void addForce (const sofa::core::MechanicalParams* mparams, DataVecDeriv& f,
                    const DataVecCoord& x, const DataVecDeriv& v) override;
 
-    /**
-     * The computation is done in 2 steps:
-     * 1) Elements are visited in parallel: a force derivative is computed inside each element
-     * 2) Vertices are visited in parallel: the force derivative in all adjacent hexahedra are
-     * accumulated in the vertices
-     */
     void addDForce (const sofa::core::MechanicalParams* mparams, DataVecDeriv& df,
                     const DataVecDeriv& dx) override;
 
+    void buildStiffnessMatrix(sofa::core::behavior::StiffnessMatrix* matrix) override;
+
 protected:
 
-    // code duplicated from HexahedronFEMForceField::accumulateForceLarge but adapted to be thread-safe
-    void computeTaskForceLarge(RDataRefVecCoord& p, sofa::Index elementId, const Element& elem,
-                               const VecElementStiffness& elementStiffnesses, SReal& OutPotentialEnery,
-                               sofa::type::Vec<8, Deriv>& OutF);
+    /// Accumulate the contributions stored in m_elementsDf into the vertices, in parallel
+    void gatherElementContributions(WDataRefVecDeriv& f);
 
     /// Assuming a vertex has 8 adjacent hexahedra, the array stores where the vertex is referenced in each of the adjacent hexahedra
     using HexaAroundVerticesIndex = sofa::type::fixed_array<sofa::Size, 8>;
@@ -94,14 +92,14 @@ protected:
     /// Where all vertex ids are stored in their adjacent hexahedra
     sofa::type::vector<HexaAroundVerticesIndex> m_vertexIdInAdjacentHexahedra;
 
-    /// A list of DF corresponding to all elements. It is stored as a class member to avoid to reallocate it
+    /// A list of forces or force derivatives corresponding to all elements. It is stored as a class member to avoid to reallocate it
     sofa::type::vector<sofa::type::Vec<8, Deriv> > m_elementsDf;
 
     /// Cache the list of hexahedra around vertices
     sofa::type::vector<sofa::core::topology::BaseMeshTopology::HexahedraAroundVertex> m_around;
 
-private:
-    bool updateStiffnessMatrices; /// cache to avoid calling 'getValue' on d_updateStiffnessMatrix
+    /// Rotated blocks of the element stiffness matrices, computed in parallel before being accumulated in the global matrix
+    sofa::type::vector<Mat33> m_stiffnessBlocks;
 };
 
 #if  !defined(SOFA_MULTITHREADING_PARALLELHEXAHEDRONFEMFORCEFIELD_CPP)
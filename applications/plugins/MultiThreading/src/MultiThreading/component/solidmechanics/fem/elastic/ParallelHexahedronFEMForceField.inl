@@ -25,6 +25,8 @@
 #include <sofa/simulation/TaskScheduler.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
+#include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
+#include <mutex>
 
 namespace multithreading::component::forcefield::solidmechanics::fem::elastic
 {
@@ -68,15 +70,8 @@ template<class DataTypes>
 void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& f,
               const DataVecCoord& p, const DataVecDeriv& v)
 {
-    using namespace sofa::component::solidmechanics::fem::elastic;
-    if (this->method != HexahedronFEMForceField<DataTypes>::LARGE)
-    {
-        static bool firstTime = true;
-        msg_warning_when(firstTime) << "Multithreading is only partially supported for other methods than 'large'";
-        firstTime = false;
-        HexahedronFEMForceField<DataTypes>::addForce(mparams, f, p, v);
-        return;
-    }
+    SOFA_UNUSED(mparams);
+    SOFA_UNUSED(v);
 
     WDataRefVecDeriv _f = f;
     RDataRefVecCoord _p = p;
@@ -89,115 +84,41 @@ void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::Mech
         this->needUpdateTopology = false;
     }
 
-    const auto* indexedElements = this->getIndexedElements();
-    this->m_potentialEnergy = 0;
+    const auto& indexedElements = *this->getIndexedElements();
+    m_elementsDf.resize(indexedElements.size());
 
-    const auto& elementStiffnesses = this->d_elementStiffnesses.getValue();
-    updateStiffnessMatrices = this->d_updateStiffnessMatrix.getValue();
-    if (updateStiffnessMatrices)
-    {
-        static bool first = true;
-        msg_warning_when(first) << "Updating the stiffness matrix is not fully supported in a multithreaded context. "
-                                   "It may lead to a crash. "
-                                   "Set 'updateStiffnessMatrix' to false to remove this warning.";
-        first = false;
-    }
+    // Each element only writes its own stiffness matrix: the Data is edited once for all the elements
+    ElementStiffness* updatedStiffnesses = this->isUpdatingStiffnessMatrices() ? this->d_elementStiffnesses.beginEdit()->data() : nullptr;
 
+    this->m_potentialEnergy = 0;
     std::mutex mutex;
 
     sofa::simulation::parallelForEachRange(*m_taskScheduler,
-        indexedElements->begin(), indexedElements->end(),
-        [this, &_p, &elementStiffnesses, &mutex, &_f](const auto& range)
+        static_cast<std::size_t>(0), indexedElements.size(),
+        [this, &_p, &indexedElements, updatedStiffnesses, &mutex](const auto& range)
         {
-            auto elementId = std::distance(this->getIndexedElements()->begin(), range.start);
-
-            std::vector<sofa::type::Vec<8, Deriv>> fElements;
-            fElements.reserve(std::distance(range.start, range.end));
-
             SReal potentialEnergy { 0_sreal };
-            for (auto it = range.start; it != range.end; ++it, ++elementId)
+            for (auto elementId = range.start; elementId < range.end; ++elementId)
             {
-                sofa::type::Vec<8, Deriv> forceInElement;
-                this->computeTaskForceLarge(_p, elementId, *it, elementStiffnesses, potentialEnergy, forceInElement);
-                fElements.emplace_back(forceInElement);
+                this->computeElementForce(_p.ref(), static_cast<sofa::Index>(elementId), indexedElements[elementId],
+                    m_elementsDf[elementId], potentialEnergy,
+                    updatedStiffnesses ? updatedStiffnesses + elementId : nullptr);
             }
 
             std::lock_guard guard(mutex);
-
             this->m_potentialEnergy += potentialEnergy;
-
-            auto it = range.start;
-            for (const auto& forceInElement : fElements)
-            {
-                for (int w = 0; w < 8; ++w)
-                {
-                    _f[(*it)[w]] += forceInElement[w];
-                }
-                ++it;
-            }
         });
 
-    this->m_potentialEnergy/=-2.0;
-}
-
-template<class DataTypes>
-void ParallelHexahedronFEMForceField<DataTypes>::computeTaskForceLarge(RDataRefVecCoord &p,
-                                                                      sofa::Index elementId,
-                                                                      const Element& elem,
-                                                                      const VecElementStiffness& elementStiffnesses,
-                                                                      SReal& OutPotentialEnery,
-                                                                      sofa::type::Vec<8, Deriv>& OutF)
-{
-    sofa::type::Vec<8,Coord> nodes;
-    for(int w=0; w<8; ++w)
-        nodes[w] = p[elem[w]];
-
-    Coord horizontal;
-    horizontal = (nodes[1]-nodes[0] + nodes[2]-nodes[3] + nodes[5]-nodes[4] + nodes[6]-nodes[7])*.25;
-    Coord vertical;
-    vertical = (nodes[3]-nodes[0] + nodes[2]-nodes[1] + nodes[7]-nodes[4] + nodes[6]-nodes[5])*.25;
-
-    // 	Transformation R_0_2; // Rotation matrix (deformed and displaced Tetrahedron/world)
-    this->computeRotationLarge(this->_rotations[elementId], horizontal, vertical);
-
-    // positions of the deformed and displaced Tetrahedron in its frame
-    sofa::type::Vec<8,Coord> deformed;
-    for(int w=0; w<8; ++w)
-        deformed[w] = this->_rotations[elementId] * nodes[w];
-
-
-    // displacement
-    sofa::type::Vec<24, Real> D;
-    for(int k=0 ; k<8 ; ++k )
-    {
-        const int index = k*3;
-        for(int j=0 ; j<3 ; ++j )
-            D[index+j] = this->_rotatedInitialElements[elementId][k][j] - deformed[k][j];
-    }
-
-    if(updateStiffnessMatrices)
+    if (updatedStiffnesses)
     {
-        //Not thread safe: a message warned the user earlier that updating the stiffness matrices is not fully supported
-        this->computeElementStiffness((*this->d_elementStiffnesses.beginEdit())[elementId], this->_materialsStiffnesses[elementId], deformed, elementId, this->_sparseGrid ? this->_sparseGrid->getStiffnessCoef(elementId) : 1.0 );
+        this->d_elementStiffnesses.endEdit();
     }
 
-    sofa::type::Vec<24, Real> F; //forces
-    this->computeForce( F, D, elementStiffnesses[elementId] ); // compute force on element
+    gatherElementContributions(_f);
 
-    for(int w=0; w<8; ++w)
-        OutF[w] += this->_rotations[elementId].multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2]  ) );
-
-    OutPotentialEnery += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    OutPotentialEnery += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    OutPotentialEnery += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    OutPotentialEnery += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    OutPotentialEnery += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    OutPotentialEnery += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    OutPotentialEnery += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    OutPotentialEnery += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    this->m_potentialEnergy/=-2.0;
 }
 
-
 template<class DataTypes>
 void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::MechanicalParams *mparams, DataVecDeriv& v, const DataVecDeriv& x)
 {
@@ -214,22 +135,17 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
     m_elementsDf.resize(indexedElements.size());
 
     sofa::simulation::parallelForEachRange(*m_taskScheduler,
-         indexedElements.begin(), indexedElements.end(),
+         static_cast<std::size_t>(0), indexedElements.size(),
          [this, &_dx, &elementStiffnesses, kFactor, &indexedElements](const auto& range)
          {
-             auto elementId = std::distance(indexedElements.begin(), range.start);
-             auto elementsDfIt = m_elementsDf.begin() + elementId;
-             auto elementStiffnessesIt = elementStiffnesses.begin() + elementId;
-             auto rotationIt = this->_rotations.begin() + elementId;
-
-             for (auto it = range.start; it != range.end; ++it, ++elementId)
+             for (auto elementId = range.start; elementId < range.end; ++elementId)
              {
                  sofa::type::Vec<24, Real> X(sofa::type::NOINIT); //displacement
                  sofa::type::Vec<24, Real> F(sofa::type::NOINIT); //force
 
-                 const auto& r = *rotationIt++;
+                 const auto& r = this->_rotations[elementId];
 
-                 const auto& element = *it;
+                 const auto& element = indexedElements[elementId];
                  for (sofa::Size w = 0; w < 8; ++w)
                  {
                      const Coord x_2 = r * _dx[element[w]];
@@ -240,18 +156,25 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
                  }
 
                  // F = K * X
-                 this->computeForce(F, X, *elementStiffnessesIt++);
+                 this->computeForce(F, X, elementStiffnesses[this->getElementStiffnessId(elementId)]);
 
-                 sofa::type::Vec<8, Deriv>& df = *elementsDfIt++;
+                 const Real factor = kFactor * this->getElementStiffnessFactor(elementId);
+                 sofa::type::Vec<8, Deriv>& df = m_elementsDf[elementId];
                  for (sofa::Size w = 0; w < 8; ++w)
                  {
-                     df[w] = -r.multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2])) * kFactor;
+                     df[w] = -r.multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2])) * factor;
                  }
              }
          });
 
+    gatherElementContributions(_df);
+}
+
+template<class DataTypes>
+void ParallelHexahedronFEMForceField<DataTypes>::gatherElementContributions(WDataRefVecDeriv& f)
+{
     sofa::simulation::parallelForEachRange(*m_taskScheduler,
-        static_cast<std::size_t>(0), _df.size(), [&_df, this](const auto& range)
+        static_cast<std::size_t>(0), f.size(), [&f, this](const auto& range)
         {
             for (auto vertexId = range.start; vertexId < range.end; ++vertexId)
             {
@@ -260,11 +183,69 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
                 sofa::Size hexaAroundId {};
                 for (const auto hexaId : around)
                 {
-                    _df[vertexId] += m_elementsDf[hexaId][m_vertexIdInAdjacentHexahedra[vertexId][hexaAroundId]];
+                    f[vertexId] += m_elementsDf[hexaId][m_vertexIdInAdjacentHexahedra[vertexId][hexaAroundId]];
                     hexaAroundId++;
                 }
             }
         });
 }
 
+template<class DataTypes>
+void ParallelHexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(sofa::core::behavior::StiffnessMatrix* matrix)
+{
+    static constexpr std::size_t nbBlocksPerElement = 64;
+
+    const auto& stiffnesses = this->d_elementStiffnesses.getValue();
+    const auto& indexedElements = *this->getIndexedElements();
+
+    auto dfdx = matrix->getForceDerivativeIn(this->mstate)
+                       .withRespectToPositionsIn(this->mstate);
+
+    // The elements are processed by batches, so that the buffer of rotated blocks remains small.
+    // Within a batch, the blocks are computed in parallel, then accumulated sequentially in the global matrix.
+    const std::size_t batchSize = 256 * std::max(m_taskScheduler->getThreadCount(), 1u);
+    m_stiffnessBlocks.resize(std::min(batchSize, indexedElements.size()) * nbBlocksPerElement);
+
+    for (std::size_t batchStart = 0; batchStart < indexedElements.size(); batchStart += batchSize)
+    {
+        const std::size_t batchEnd = std::min(batchStart + batchSize, indexedElements.size());
+
+        sofa::simulation::parallelForEachRange(*m_taskScheduler,
+            batchStart, batchEnd, [this, &stiffnesses, batchStart](const auto& range)
+            {
+                for (auto e = range.start; e < range.end; ++e)
+                {
+                    const ElementStiffness& Ke = stiffnesses[this->getElementStiffnessId(e)];
+                    const auto& Rot = this->_rotations[e];
+                    const Real factor = this->getElementStiffnessFactor(e);
+
+                    Mat33* blocks = m_stiffnessBlocks.data() + (e - batchStart) * nbBlocksPerElement;
+                    for (sofa::Size n1 = 0; n1 < 8; n1++)
+                    {
+                        for (sofa::Size n2 = 0; n2 < 8; n2++)
+                        {
+                            *blocks++ = Rot.multTranspose( Mat33(
+                                    Coord(Ke[3*n1+0][3*n2+0],Ke[3*n1+0][3*n2+1],Ke[3*n1+0][3*n2+2]),
+                                    Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
+                                    Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot * (-factor);
+                        }
+                    }
+                }
+            });
+
+        const Mat33* blocks = m_stiffnessBlocks.data();
+        for (std::size_t e = batchStart; e < batchEnd; ++e)
+        {
+            const auto& element = indexedElements[e];
+            for (sofa::Size n1 = 0; n1 < 8; n1++)
+            {
+                for (sofa::Size n2 = 0; n2 < 8; n2++)
+                {
+                    dfdx(3 * element[n1], 3 * element[n2]) += *blocks++;
+                }
+            }
+        }
+    }
+}
+
 } //namespace sofa::component::forcefield
@@ -47,6 +47,8 @@ public:
     using DataVecDeriv = sofa::core::objectmodel::Data<VecDeriv>;
 
     void init() override;
+
+    bool useSpringArrays() const override { return typeid(*this) == typeid(ParallelMeshSpringForceField<DataTypes>); }
 };
 
 }
@@ -56,6 +56,27 @@ public:
 
     void addForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1, const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2 ) override;
     void addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2, const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2) override;
+
+    bool useSpringArrays() const override { return typeid(*this) == typeid(ParallelSpringForceField<DataTypes>); }
+
+protected:
+
+    /// Group the springs by color: two springs of the same color do not share any particle, so the
+    /// springs of a color can accumulate their contribution concurrently without any lock.
+    /// Springs which cannot be assigned one of the 64 colors are processed sequentially.
+    void updateSpringColors();
+
+    /// Apply the given function on every spring index, in parallel within each color
+    template<class Function>
+    void forEachColoredSpring(Function f);
+
+    sofa::type::vector<sofa::type::vector<sofa::Index> > m_springColors;
+    sofa::type::vector<sofa::Index> m_uncoloredSprings;
+    int m_springColorsCounter { -1 };
+    std::size_t m_nbColoredSprings { 0 };
+
+    /// One energy accumulator per spring, summed after the parallel loop, to avoid any synchronization
+    sofa::type::vector<Real> m_springEnergies;
 };
 
 }
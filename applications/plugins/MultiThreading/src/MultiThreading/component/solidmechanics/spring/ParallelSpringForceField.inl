@@ -25,6 +25,8 @@
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
 
+#include <algorithm>
+
 namespace multithreading::component::solidmechanics::spring
 {
 template <class DataTypes>
@@ -34,12 +36,93 @@ void ParallelSpringForceField<DataTypes>::init()
     initTaskScheduler();
 }
 
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::updateSpringColors()
+{
+    const auto& springs = this->m_springArrays;
+    if (m_springColorsCounter == this->m_springArraysCounter && m_nbColoredSprings == springs.size())
+    {
+        return;
+    }
+    m_springColorsCounter = this->m_springArraysCounter;
+    m_nbColoredSprings = springs.size();
+
+    m_springColors.clear();
+    m_uncoloredSprings.clear();
+
+    // bit c of a mask is set if the particle is already used by a spring of color c
+    sofa::type::vector<std::uint64_t> masks1, masks2;
+    const bool sameState = this->mstate1.get() == this->mstate2.get();
+    for (std::size_t i = 0; i < springs.size(); ++i)
+    {
+        const std::size_t a = springs.m1[i];
+        const std::size_t b = springs.m2[i];
+        if (masks1.size() <= a) masks1.resize(a + 1, 0);
+        if (masks2.size() <= b) masks2.resize(b + 1, 0);
+        if (sameState && masks1.size() <= b) masks1.resize(b + 1, 0);
+    }
+    auto& masksOf2 = sameState ? masks1 : masks2;
+
+    for (std::size_t i = 0; i < springs.size(); ++i)
+    {
+        std::uint64_t& mask1 = masks1[springs.m1[i]];
+        std::uint64_t& mask2 = masksOf2[springs.m2[i]];
+        const std::uint64_t used = mask1 | mask2;
+        if (used == ~std::uint64_t(0))
+        {
+            m_uncoloredSprings.push_back(static_cast<sofa::Index>(i));
+            continue;
+        }
+
+        std::size_t color = 0;
+        while (used & (std::uint64_t(1) << color))
+        {
+            ++color;
+        }
+        if (m_springColors.size() <= color)
+        {
+            m_springColors.resize(color + 1);
+        }
+        m_springColors[color].push_back(static_cast<sofa::Index>(i));
+        mask1 |= std::uint64_t(1) << color;
+        mask2 |= std::uint64_t(1) << color;
+    }
+}
+
+template <class DataTypes>
+template <class Function>
+void ParallelSpringForceField<DataTypes>::forEachColoredSpring(Function f)
+{
+    for (const auto& color : m_springColors)
+    {
+        sofa::simulation::parallelForEachRange(*m_taskScheduler, color.begin(), color.end(),
+            [&f](const auto& range)
+            {
+                for (auto it = range.start; it != range.end; ++it)
+                {
+                    f(*it);
+                }
+            });
+    }
+
+    for (const sofa::Index i : m_uncoloredSprings)
+    {
+        f(i);
+    }
+}
+
 template <class DataTypes>
 void ParallelSpringForceField<DataTypes>::addForce(const sofa::core::MechanicalParams* mparams,
     DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1,
     const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2)
 {
-    SOFA_UNUSED(mparams);
+    if (!this->useSpringArrays())
+    {
+        // a derived component computes its own spring force: keep the sequential virtual calls
+        Inherit1::addForce(mparams, data_f1, data_f2, data_x1, data_x2, data_v1, data_v2);
+        return;
+    }
+
     sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv> > f1 = sofa::helper::getWriteOnlyAccessor(data_f1);
     sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv> > f2 = sofa::helper::getWriteOnlyAccessor(data_f2);
 
@@ -49,52 +132,43 @@ void ParallelSpringForceField<DataTypes>::addForce(const sofa::core::MechanicalP
     const VecCoord& x2 =  data_x2.getValue();
     const VecDeriv& v2 =  data_v2.getValue();
 
-    const sofa::type::vector<Spring>& springs= this->d_springs.getValue();
+    this->updateSpringArrays();
+    updateSpringColors();
+
+    const auto& springs = this->m_springArrays;
     this->dfdx.resize(springs.size());
     f1.resize(x1.size());
     f2.resize(x2.size());
-    this->m_potentialEnergy = 0;
 
-    std::mutex mutex;
+    VecDeriv& f1Ref = f1.wref();
+    VecDeriv& f2Ref = f2.wref();
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &x1, &v1, &x2, &v2, &mutex, &f1, &f2](const auto& range)
-        {
-            sofa::type::vector<std::unique_ptr<SpringForce> > springForces;
-            springForces.reserve(range.end - range.start);
-            for (auto i = range.start; i < range.end; ++i)
-            {
-                std::unique_ptr<SpringForce> springForce = this->computeSpringForce(x1, v1, x2, v2, springs[i]);
-                springForces.push_back(std::move(springForce));
-            }
-
-            std::lock_guard lock(mutex);
-
-            std::size_t i = range.start;
-            for (auto& springForce : springForces)
-            {
-                if (springForce)
-                {
-                    const SpringForce* stiffSpringForce = static_cast<const SpringForce*>(springForce.get());
+    m_springEnergies.resize(springs.size());
+    std::fill(m_springEnergies.begin(), m_springEnergies.end(), 0);
+    auto& energies = m_springEnergies;
 
-                    sofa::Index a = springs[i].m1;
-                    sofa::Index b = springs[i].m2;
-
-                    DataTypes::setDPos( f1[a], DataTypes::getDPos(f1[a]) + std::get<0>(stiffSpringForce->force)) ;
-                    DataTypes::setDPos( f2[b], DataTypes::getDPos(f2[b]) + std::get<1>(stiffSpringForce->force)) ;
-
-                    this->m_potentialEnergy += stiffSpringForce->energy;
+    forEachColoredSpring([this, &springs, &x1, &v1, &x2, &v2, &f1Ref, &f2Ref, &energies](const sofa::Index i)
+    {
+        typename DataTypes::DPos force;
+        if (this->computeSpringForceFromArrays(i, x1, v1, x2, v2, force, energies[i], this->dfdx[i]))
+        {
+            const sofa::Index a = springs.m1[i];
+            const sofa::Index b = springs.m2[i];
+            DataTypes::setDPos( f1Ref[a], DataTypes::getDPos(f1Ref[a]) + force ) ;
+            DataTypes::setDPos( f2Ref[b], DataTypes::getDPos(f2Ref[b]) - force ) ;
+        }
+        else
+        {
+            // set derivative to 0
+            this->dfdx[i].clear();
+        }
+    });
 
-                    this->dfdx[i] = stiffSpringForce->dForce_dX;
-                }
-                else
-                {
-                    // set derivative to 0
-                    this->dfdx[i].clear();
-                }
-                ++i;
-            }
-        });
+    this->m_potentialEnergy = 0;
+    for (const Real energy : energies)
+    {
+        this->m_potentialEnergy += energy;
+    }
 }
 
 template <class DataTypes>
@@ -102,6 +176,12 @@ void ParallelSpringForceField<DataTypes>::addDForce(
     const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2,
     const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2)
 {
+    if (!this->useSpringArrays())
+    {
+        Inherit1::addDForce(mparams, data_df1, data_df2, data_dx1, data_dx2);
+        return;
+    }
+
     sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv>> df1 = sofa::helper::getWriteOnlyAccessor(data_df1);
     sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv>> df2 = sofa::helper::getWriteOnlyAccessor(data_df2);
 
@@ -112,37 +192,28 @@ void ParallelSpringForceField<DataTypes>::addDForce(
     df2.resize(dx2.size());
 
     const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams,this->rayleighStiffness.getValue());
-    const Real bFactor = (Real)sofa::core::mechanicalparams::bFactor(mparams);
 
-    const sofa::type::vector<Spring>& springs= this->d_springs.getValue();
+    this->updateSpringArrays();
+    updateSpringColors();
 
-    std::mutex mutex;
+    const auto& springs = this->m_springArrays;
+    if (this->dfdx.size() < springs.size())
+    {
+        return;
+    }
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &df1, &df2, &dx1, &dx2, kFactor, bFactor, &mutex](const auto& range)
-        {
-            sofa::type::vector<typename DataTypes::DPos> dforces;
-            dforces.reserve(range.end - range.start);
-            for (auto i = range.start; i < range.end; ++i)
-            {
-                dforces.push_back(
-                    this->computeSpringDForce(df1.wref(), dx1, df2.wref(), dx2, i, springs[i], kFactor, bFactor));
-            }
-
-            std::lock_guard lock(mutex);
+    VecDeriv& df1Ref = df1.wref();
+    VecDeriv& df2Ref = df2.wref();
 
-            auto dforceIt = dforces.begin();
-            for (auto i = range.start; i < range.end; ++i)
-            {
-                const auto& dforce = *dforceIt++;
+    forEachColoredSpring([this, &springs, &dx1, &dx2, &df1Ref, &df2Ref, kFactor](const sofa::Index i)
+    {
+        const sofa::Index a = springs.m1[i];
+        const sofa::Index b = springs.m2[i];
+        const typename DataTypes::CPos d = DataTypes::getDPos(dx2[b]) - DataTypes::getDPos(dx1[a]);
+        const typename DataTypes::DPos dforce = this->dfdx[i] * d * kFactor;
 
-                const sofa::Index a = springs[i].m1;
-                const sofa::Index b = springs[i].m2;
-
-                DataTypes::setDPos( df1[a], DataTypes::getDPos(df1[a]) + dforce ) ;
-                DataTypes::setDPos( df2[b], DataTypes::getDPos(df2[b]) - dforce ) ;
-            }
-        }
-    );
+        DataTypes::setDPos( df1Ref[a], DataTypes::getDPos(df1Ref[a]) + dforce ) ;
+        DataTypes::setDPos( df2Ref[b], DataTypes::getDPos(df2Ref[b]) - dforce ) ;
+    });
 }
 }
@@ -0,0 +1,217 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+#include <MultiThreading/component/solidmechanics/spring/ParallelSpringForceField.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/testing/BaseTest.h>
+
+#include <cmath>
+
+namespace sofa
+{
+
+using sofa::defaulttype::Vec3Types;
+using multithreading::component::solidmechanics::spring::ParallelSpringForceField;
+using sofa::component::solidmechanics::spring::SpringForceField;
+using sofa::component::statecontainer::MechanicalObject;
+
+/// Spring force field computing twice the force of a linear spring: it overrides computeSpringForce,
+/// so ParallelSpringForceField must call it instead of its own kernel.
+class DoubleParallelSpringForceField : public ParallelSpringForceField<Vec3Types>
+{
+public:
+    SOFA_CLASS(DoubleParallelSpringForceField, SOFA_TEMPLATE(ParallelSpringForceField, Vec3Types));
+
+protected:
+    std::unique_ptr<SpringForce> computeSpringForce(const VecCoord& p1, const VecDeriv& v1, const VecCoord& p2, const VecDeriv& v2, const Spring& spring) override
+    {
+        std::unique_ptr<SpringForce> springForce = Inherit1::computeSpringForce(p1, v1, p2, v2, spring);
+        if (springForce)
+        {
+            springForce->energy *= 2;
+            springForce->force.first *= 2;
+            springForce->force.second *= 2;
+            springForce->dForce_dX *= 2;
+        }
+        return springForce;
+    }
+};
+
+class ParallelSpringForceField_test : public sofa::testing::BaseTest
+{
+public:
+    using VecCoord = Vec3Types::VecCoord;
+    using VecDeriv = Vec3Types::VecDeriv;
+    using DataVecCoord = sofa::core::objectmodel::Data<VecCoord>;
+    using DataVecDeriv = sofa::core::objectmodel::Data<VecDeriv>;
+
+    static constexpr std::size_t nbStarParticles = 100;
+    static constexpr std::size_t nbParticles = nbStarParticles + 1;
+
+    simulation::Node::SPtr root;
+
+    void onSetUp() override
+    {
+        // several threads, even on a single core machine
+        simulation::MainTaskSchedulerFactory::createInRegistry()->init(2);
+    }
+
+    void onTearDown() override
+    {
+        if (root)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    static VecCoord createPositions()
+    {
+        VecCoord x(nbParticles);
+        for (std::size_t i = 1; i < nbParticles; ++i)
+        {
+            const double angle = 0.3 * static_cast<double>(i);
+            x[i] = { std::cos(angle), std::sin(angle), 0.01 * static_cast<double>(i) };
+        }
+        return x;
+    }
+
+    static VecDeriv createVelocities()
+    {
+        VecDeriv v(nbParticles);
+        for (std::size_t i = 0; i < nbParticles; ++i)
+        {
+            v[i] = { 0.1 * std::sin(0.7 * static_cast<double>(i)), 0.05, -0.02 * static_cast<double>(i % 3) };
+        }
+        return v;
+    }
+
+    /// A star of springs around particle 0, more than the 64 colors, and a chain between the other particles
+    static void addSprings(SpringForceField<Vec3Types>* springs)
+    {
+        for (sofa::Index i = 1; i < nbParticles; ++i)
+        {
+            springs->addSpring(0, i, 100. + i, 0.5, 0.8);
+        }
+        for (sofa::Index i = 1; i + 1 < nbParticles; ++i)
+        {
+            springs->addSpring(i, i + 1, 50., 0.1, 0.2);
+        }
+    }
+
+    template<class ForceField>
+    typename ForceField::SPtr createForceField()
+    {
+        const auto node = root->createChild("node");
+        const auto mstate = core::objectmodel::New<MechanicalObject<Vec3Types> >();
+        mstate->resize(nbParticles);
+        node->addObject(mstate);
+
+        const auto forceField = core::objectmodel::New<ForceField>();
+        addSprings(forceField.get());
+        node->addObject(forceField);
+        return forceField;
+    }
+
+    void compareForces(SpringForceField<Vec3Types>* reference, SpringForceField<Vec3Types>* tested, SReal factor)
+    {
+        const DataVecCoord x(createPositions());
+        const DataVecDeriv v(createVelocities());
+
+        core::MechanicalParams mparams;
+        mparams.setKFactor(1.5);
+
+        DataVecDeriv referenceForce, testedForce;
+        reference->addForce(&mparams, referenceForce, referenceForce, x, x, v, v);
+        tested->addForce(&mparams, testedForce, testedForce, x, x, v, v);
+
+        ASSERT_EQ(referenceForce.getValue().size(), nbParticles);
+        ASSERT_EQ(testedForce.getValue().size(), nbParticles);
+        EXPECT_GT(referenceForce.getValue()[0].norm(), 1.);
+        for (std::size_t i = 0; i < nbParticles; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_NEAR(factor * referenceForce.getValue()[i][j], testedForce.getValue()[i][j], 1e-10) << "particle " << i;
+            }
+        }
+        // getPotentialEnergy computes the energy of the linear springs, whatever the spring force
+        EXPECT_NEAR(reference->getPotentialEnergy(&mparams, x, x), tested->getPotentialEnergy(&mparams, x, x), 1e-10);
+
+        VecDeriv dxValues(nbParticles);
+        for (std::size_t i = 0; i < nbParticles; ++i)
+        {
+            dxValues[i] = { 0.01 * static_cast<double>(i % 5), -0.02, 0.03 * std::cos(static_cast<double>(i)) };
+        }
+        const DataVecDeriv dx(dxValues);
+
+        DataVecDeriv referenceDForce, testedDForce;
+        reference->addDForce(&mparams, referenceDForce, referenceDForce, dx, dx);
+        tested->addDForce(&mparams, testedDForce, testedDForce, dx, dx);
+
+        ASSERT_EQ(referenceDForce.getValue().size(), nbParticles);
+        ASSERT_EQ(testedDForce.getValue().size(), nbParticles);
+        EXPECT_GT(referenceDForce.getValue()[0].norm(), 0.1);
+        for (std::size_t i = 0; i < nbParticles; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_NEAR(factor * referenceDForce.getValue()[i][j], testedDForce.getValue()[i][j], 1e-10) << "particle " << i;
+            }
+        }
+    }
+};
+
+TEST_F(ParallelSpringForceField_test, sameForcesAsSequential)
+{
+    root = simulation::getSimulation()->createNewNode("root");
+    const auto sequential = createForceField<SpringForceField<Vec3Types> >();
+    const auto parallel = createForceField<ParallelSpringForceField<Vec3Types> >();
+    sofa::simulation::node::initRoot(root.get());
+
+    EXPECT_TRUE(sequential->useSpringArrays());
+    EXPECT_TRUE(parallel->useSpringArrays());
+
+    // the star springs beyond the 64 colors are processed sequentially
+    compareForces(sequential.get(), parallel.get(), 1);
+
+    // a second evaluation reuses the coloring and the energy buffer
+    compareForces(sequential.get(), parallel.get(), 1);
+}
+
+TEST_F(ParallelSpringForceField_test, overriddenSpringForce)
+{
+    root = simulation::getSimulation()->createNewNode("root");
+    const auto sequential = createForceField<SpringForceField<Vec3Types> >();
+    const auto overridden = createForceField<DoubleParallelSpringForceField>();
+    sofa::simulation::node::initRoot(root.get());
+
+    EXPECT_FALSE(overridden->useSpringArrays());
+
+    compareForces(sequential.get(), overridden.get(), 2);
+}
+
+}
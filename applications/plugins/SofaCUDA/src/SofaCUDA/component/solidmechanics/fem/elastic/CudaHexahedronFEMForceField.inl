@@ -79,6 +79,15 @@ void HexahedronFEMForceFieldInternalData< gpu::cuda::CudaVectorTypes<TCoord,TDer
   Data& data = *m->data;
   m->setMethod(m->LARGE);
 
+  // the GPU kernels read one stiffness matrix per element
+  if (m->d_shareStiffnessMatrices.getValue())
+  {
+      msg_warning(m) << "shareStiffnessMatrices is not supported on GPU, the stiffness matrices are not shared.";
+      m->d_shareStiffnessMatrices.setValue(false);
+  }
+  m->m_elementStiffnessIds.clear();
+  m->m_elementStiffnessFactors.clear();
+
   const VecCoord& p = m->mstate->read(sofa::core::ConstVecCoordId::restPosition())->getValue();
   m->d_initialPoints.setValue(p);
 
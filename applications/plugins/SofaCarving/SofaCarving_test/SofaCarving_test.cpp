@@ -23,6 +23,7 @@
 #include <SofaCarving/CarvingManager.h>
 #include <sofa/simpleapi/SimpleApi.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 #include <sofa/testing/BaseSimulationTest.h>
 
 using namespace sofa::testing;
@@ -59,6 +60,8 @@ public:
     void doCarving();
     /// Test carving process with penetration parameters. Will check topology after carving.
     void doCarvingWithPenetration();
+    /// Test that the elements carved through both surface models are removed in a single change batch. Will check the mapped surface after each step.
+    void doCarvingInChangeBatch();
 
     /// Unload the scene
     void TearDown() override
@@ -473,6 +476,61 @@ void SofaCarving_test::doCarvingWithPenetration()
 }
 
 
+void SofaCarving_test::doCarvingInChangeBatch()
+{
+    bool res = createScene("0.0");
+    EXPECT_TRUE(res);
+
+    // init scene
+    EXPECT_MSG_NOEMIT(Error);
+    EXPECT_MSG_NOEMIT(Warning);
+    sofa::simulation::node::initRoot(m_root.get());
+
+    sofa::simulation::Node* cylinder = m_root->getChild("cylinder");
+    ASSERT_NE(cylinder, nullptr);
+    sofa::simulation::Node* surface = cylinder->getChild("Surface");
+    ASSERT_NE(surface, nullptr);
+
+    sofa::core::topology::BaseMeshTopology* topo = cylinder->getMeshTopology();
+    sofa::core::topology::BaseMeshTopology* surfaceTopo = surface->getMeshTopology();
+    const auto modifier = cylinder->get<sofa::component::topology::container::dynamic::TetrahedronSetTopologyModifier>();
+    ASSERT_NE(topo, nullptr);
+    ASSERT_NE(surfaceTopo, nullptr);
+    ASSERT_NE(modifier, nullptr);
+
+    const auto countBorderTriangles = [topo]()
+    {
+        std::size_t nbBorderTriangles = 0;
+        for (sofa::Index i = 0; i < topo->getNbTriangles(); ++i)
+        {
+            if (topo->getTetrahedraAroundTriangle(i).size() == 1)
+                ++nbBorderTriangles;
+        }
+        return nbBorderTriangles;
+    };
+
+    // the triangle and the point models both carve the cylinder: their removals are gathered in one batch per step
+    sofa::Size nbTetrahedra = topo->getNbTetrahedra();
+    unsigned int nbCarvingSteps = 0;
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        sofa::simulation::node::animate(m_root.get(), 0.01);
+
+        EXPECT_FALSE(modifier->isInChangeBatch());
+        if (topo->getNbTetrahedra() != nbTetrahedra)
+        {
+            ++nbCarvingSteps;
+            nbTetrahedra = topo->getNbTetrahedra();
+
+            // the surface mapping received the removals and the ending event of the batch
+            EXPECT_EQ(surfaceTopo->getNbTriangles(), countBorderTriangles());
+        }
+    }
+
+    EXPECT_GT(nbCarvingSteps, 0u);
+    EXPECT_LT(topo->getNbTetrahedra(), 2430);
+}
+
 
 TEST_F(SofaCarving_test, testManagerEmpty)
 {
@@ -510,4 +568,9 @@ TEST_F(SofaCarving_test, testdoCarvingWithPenetration)
     doCarvingWithPenetration();
 }
 
+TEST_F(SofaCarving_test, testdoCarvingInChangeBatch)
+{
+    doCarvingInChangeBatch();
+}
+
 
@@ -34,6 +34,8 @@
 #include <sofa/gui/component/performer/TopologicalChangeManager.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 
+#include <algorithm>
+
 namespace sofa::component::collision
 {
 
@@ -82,6 +84,18 @@ void CarvingManager::init()
         m_surfaceCollisionModels.push_back(getContext()->get<core::CollisionModel>(d_surfaceModelPath.getValue()));
     }
 
+    // Search for the tetrahedral topologies modified when carving the surfaces (e.g. through a Tetra2TriangleTopologicalMapping)
+    m_tetrahedronModifiers.clear();
+    for (const auto* surfaceModel : m_surfaceCollisionModels)
+    {
+        if (surfaceModel == nullptr)
+            continue;
+
+        auto* modifier = surfaceModel->getContext()->get<sofa::component::topology::container::dynamic::TetrahedronSetTopologyModifier>(core::objectmodel::BaseContext::SearchUp);
+        if (modifier != nullptr && std::find(m_tetrahedronModifiers.begin(), m_tetrahedronModifiers.end(), modifier) == m_tetrahedronModifiers.end())
+            m_tetrahedronModifiers.push_back(modifier);
+    }
+
     // If no NarrowPhaseDetection is set using the link try to find the component
     if (l_detectionNP.get() == nullptr)
     {
@@ -123,6 +137,10 @@ void CarvingManager::doCarve()
 
     SCOPED_TIMER("CarvingElems");
 
+    // the elements selected on all the surface models are removed at once, using the numbering of the beginning of the time step
+    for (auto* modifier : m_tetrahedronModifiers)
+        modifier->beginChangeBatch();
+
     // loop on the contact to get the one between the CarvingSurface and the CarvingTool collision model
     const SReal& carvDist = d_carvingDistance.getValue();
     auto toolCollisionModel = l_toolModel.get();
@@ -180,6 +198,9 @@ void CarvingManager::doCarve()
             }
         }
     }
+
+    for (auto* modifier : m_tetrahedronModifiers)
+        modifier->endChangeBatch();
 }
 
 void CarvingManager::handleEvent(sofa::core::objectmodel::Event* event)
@@ -30,6 +30,7 @@
 #include <sofa/defaulttype/VecTypes.h>
 #include <sofa/core/behavior/BaseController.h>
 #include <sofa/core/objectmodel/HapticDeviceEvent.h>
+#include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 
 #include <fstream>
 
@@ -97,6 +98,9 @@ public:
 protected:
     // Pointer to the target object collision model
     std::vector<core::CollisionModel*> m_surfaceCollisionModels;
+
+    // Volumetric topologies carved through the surface collision models: the removals of a time step are applied in a single change batch
+    std::vector<sofa::component::topology::container::dynamic::TetrahedronSetTopologyModifier*> m_tetrahedronModifiers;
    
 };
 